@@ -10,6 +10,7 @@
 #include "http_server.h"
 #include "mongoose.h"
 #include "../omnisight_core.h"
+#include "../perception/occupancy_grid.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -33,6 +34,7 @@ static void handle_api_status(struct mg_connection *c, struct mg_http_message *h
 static void handle_api_stats(struct mg_connection *c, struct mg_http_message *hm);
 static void handle_perception_status(struct mg_connection *c, struct mg_http_message *hm);
 static void handle_perception_detections(struct mg_connection *c, struct mg_http_message *hm);
+static void handle_perception_heatmap(struct mg_connection *c, struct mg_http_message *hm);
 static void handle_timeline_predictions(struct mg_connection *c, struct mg_http_message *hm);
 static void handle_timeline_history(struct mg_connection *c, struct mg_http_message *hm);
 static void handle_swarm_network(struct mg_connection *c, struct mg_http_message *hm);
@@ -91,6 +93,7 @@ bool http_server_start(HTTPServer* server) {
     printf("  GET  /api/stats\n");
     printf("  GET  /api/perception/status\n");
     printf("  GET  /api/perception/detections\n");
+    printf("  GET  /api/perception/heatmap\n");
     printf("  GET  /api/timeline/predictions\n");
     printf("  GET  /api/timeline/history\n");
     printf("  GET  /api/swarm/network\n");
@@ -179,6 +182,9 @@ static void event_handler(struct mg_connection *c, int ev, void *ev_data) {
         else if (mg_http_match_uri(hm, "/api/perception/detections")) {
             handle_perception_detections(c, hm);
         }
+        else if (mg_http_match_uri(hm, "/api/perception/heatmap")) {
+            handle_perception_heatmap(c, hm);
+        }
         else if (mg_http_match_uri(hm, "/api/timeline/predictions")) {
             handle_timeline_predictions(c, hm);
         }
@@ -374,6 +380,106 @@ static void handle_perception_detections(struct mg_connection *c, struct mg_http
     free(final_json);
 }
 
+/**
+ * GET /api/perception/heatmap - Occupancy / dwell heatmap
+ *
+ * Query: resolution=N (cells per side, 1..native, default native),
+ *        format=binary for the compact layout of occupancy_grid.h
+ */
+static void handle_perception_heatmap(struct mg_connection *c, struct mg_http_message *hm) {
+    if (!g_server || !g_server->core) {
+        send_error_response(c, 500, "Server not initialized");
+        return;
+    }
+
+    PerceptionEngine* perception = g_server->core->perception;
+    uint32_t native = perception_get_heatmap_resolution(perception);
+    if (native == 0) {
+        send_error_response(c, 500, "Heatmap unavailable");
+        return;
+    }
+
+    // Reads never exceed the native grid, so buffers are sized from it
+    char var[16];
+    uint32_t resolution = native;
+    if (mg_http_get_var(&hm->query, "resolution", var, sizeof(var)) > 0) {
+        int value = atoi(var);
+        if (value <= 0 || (uint32_t)value > native) {
+            send_error_response(c, 400, "Invalid resolution");
+            return;
+        }
+        resolution = (uint32_t)value;
+    }
+
+    bool binary = mg_http_get_var(&hm->query, "format", var, sizeof(var)) > 0 &&
+                  strcmp(var, "binary") == 0;
+
+    if (binary) {
+        size_t size = OCCUPANCY_EXPORT_SIZE(resolution, resolution);
+        uint8_t* buffer = (uint8_t*)malloc(size);
+        size_t len = buffer ? perception_export_heatmap(perception, resolution, resolution,
+                                                        buffer, size) : 0;
+        if (len == 0) {
+            free(buffer);
+            send_error_response(c, 500, "Heatmap unavailable");
+            return;
+        }
+
+        mg_printf(c,
+                  "HTTP/1.1 200 OK\r\n"
+                  "Content-Type: application/octet-stream\r\n"
+                  "Access-Control-Allow-Origin: *\r\n"
+                  "Content-Length: %lu\r\n\r\n",
+                  (unsigned long)len);
+        mg_send(c, buffer, len);
+        free(buffer);
+        return;
+    }
+
+    uint32_t cols = resolution;
+    uint32_t rows = resolution;
+    uint32_t max_cells = resolution * resolution;
+    float* presence = (float*)malloc(max_cells * sizeof(float));
+    float* visits = (float*)malloc(max_cells * sizeof(float));
+    uint64_t timestamp_ms = 0;
+
+    if (!presence || !visits ||
+        !perception_get_heatmap(perception, &cols, &rows, presence, visits, &timestamp_ms)) {
+        free(presence);
+        free(visits);
+        send_error_response(c, 500, "Heatmap unavailable");
+        return;
+    }
+
+    // %.6g is at most 13 characters, plus a separator, per value
+    uint32_t n = cols * rows;
+    size_t cap = 128 + (size_t)n * 2 * 14;
+    char* json = (char*)malloc(cap);
+    if (!json) {
+        free(presence);
+        free(visits);
+        send_error_response(c, 500, "Out of memory");
+        return;
+    }
+
+    size_t len = (size_t)snprintf(json, cap,
+                                  "{\"cols\":%u,\"rows\":%u,\"timestamp_ms\":%llu,\"presence_s\":[",
+                                  cols, rows, (unsigned long long)timestamp_ms);
+    for (uint32_t i = 0; i < n; i++) {
+        len += (size_t)snprintf(json + len, cap - len, "%s%.6g", i ? "," : "", presence[i]);
+    }
+    len += (size_t)snprintf(json + len, cap - len, "],\"visits\":[");
+    for (uint32_t i = 0; i < n; i++) {
+        len += (size_t)snprintf(json + len, cap - len, "%s%.6g", i ? "," : "", visits[i]);
+    }
+    snprintf(json + len, cap - len, "]}");
+
+    send_json_response(c, 200, json);
+    free(json);
+    free(presence);
+    free(visits);
+}
+
 /**
  * GET /api/timeline/predictions - Timeline predictions
  */
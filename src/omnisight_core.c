@@ -37,8 +37,17 @@ struct OmnisightCore {
     TrackedObject current_tracks[50];
     uint32_t num_current_tracks;
 
+    // Perception thread's results when timeline monitoring did not start
+    Timeline sync_timelines[5];
+
+    // Published by timeline_callback
     Timeline current_timelines[5];
     uint32_t num_current_timelines;
+    InterventionPoint current_intervention;
+    bool has_intervention;
+    uint64_t timeline_total_events;
+    uint64_t timeline_total_interventions;
+    float timeline_avg_prediction_ms;
 };
 
 // =======================================================================
@@ -69,6 +78,10 @@ static void send_event(OmnisightCore* core, OmnisightEventType type,
 // Module Integration Callbacks
 // =======================================================================
 
+static void timeline_callback(const Timeline* timelines,
+                              uint32_t num_timelines,
+                              void* user_data);
+
 /**
  * Perception callback - called when new tracked objects available
  */
@@ -92,27 +105,13 @@ static void perception_callback(const TrackedObject* objects,
     snprintf(msg, sizeof(msg), "Tracked %u objects", object_count);
     send_event(core, OMNISIGHT_EVENT_OBJECT_TRACKED, msg, NULL);
 
-    // Forward to timeline if enabled
-    if (core->timeline && core->config.enable_timeline) {
-        Timeline timelines[5];
-        uint32_t num_timelines = timeline_update(
-            core->timeline,
-            objects,
-            object_count,
-            timelines,
-            5
-        );
-
-        if (num_timelines > 0) {
-            pthread_mutex_lock(&core->mutex);
-            memcpy(core->current_timelines, timelines,
-                   num_timelines * sizeof(Timeline));
-            core->num_current_timelines = num_timelines;
-            pthread_mutex_unlock(&core->mutex);
-
-            send_event(core, OMNISIGHT_EVENT_TIMELINE_UPDATED,
-                      "Timelines updated", NULL);
-        }
+    // Hand to the timeline monitor thread; never waits for prediction.
+    // Without a monitor thread the engine is ours, so predict here.
+    if (core->timeline && core->config.enable_timeline &&
+        !timeline_submit_tracks(core->timeline, objects, object_count)) {
+        uint32_t num_timelines = timeline_update(core->timeline, objects, object_count,
+                                                 core->sync_timelines, 5);
+        timeline_callback(core->sync_timelines, num_timelines, core);
     }
 
     // Forward to swarm if enabled
@@ -123,13 +122,42 @@ static void perception_callback(const TrackedObject* objects,
 }
 
 /**
- * Timeline callback - called when timelines updated
+ * Timeline callback - called on the thread that owns the timeline engine
+ * (its monitor thread, or the perception thread as a fallback)
  */
 static void timeline_callback(const Timeline* timelines,
                               uint32_t num_timelines,
                               void* user_data) {
     OmnisightCore* core = (OmnisightCore*)user_data;
 
+    // Publish results; the engine is only safe to query from this thread
+    InterventionPoint intervention;
+    bool has_intervention = timeline_get_best_intervention(core->timeline, &intervention);
+    uint64_t total_timelines, total_events, total_interventions;
+    float avg_prediction_ms;
+    timeline_get_stats(core->timeline, &total_timelines, &total_events,
+                       &total_interventions, &avg_prediction_ms);
+
+    uint32_t count = num_timelines < 5 ? num_timelines : 5;
+    pthread_mutex_lock(&core->mutex);
+    for (uint32_t i = 0; i < count; i++) {
+        // Copy out; the node tree stays with the engine and is reused next update
+        core->current_timelines[i] = timelines[i];
+        core->current_timelines[i].root = NULL;
+    }
+    core->num_current_timelines = count;
+    core->current_intervention = intervention;
+    core->has_intervention = has_intervention;
+    core->timeline_total_events = total_events;
+    core->timeline_total_interventions = total_interventions;
+    core->timeline_avg_prediction_ms = avg_prediction_ms;
+    pthread_mutex_unlock(&core->mutex);
+
+    if (num_timelines > 0) {
+        send_event(core, OMNISIGHT_EVENT_TIMELINE_UPDATED,
+                  "Timelines updated", NULL);
+    }
+
     // Check for high-severity events that need intervention
     for (uint32_t i = 0; i < num_timelines; i++) {
         if (timelines[i].worst_case_severity >= SEVERITY_HIGH) {
@@ -168,23 +196,29 @@ void omnisight_get_default_config(OmnisightConfig* config) {
     config->perception.use_dlpu = true;
     config->perception.inference_threads = 2;
     config->perception.detection_threshold = 0.5f;
+    config->perception.low_detection_threshold = 0.1f;
     config->perception.tracking_threshold = 0.3f;
     config->perception.max_tracked_objects = 50;
     config->perception.loitering_threshold_ms = 30000;  // 30 seconds
-    config->perception.running_velocity_threshold = 5.0f;
+    config->perception.running_velocity_threshold = 5.0f;  // m/s
     config->perception.async_inference = true;
     config->perception.buffer_pool_size = 4;
+    config->perception.enable_motion_compensation = true;
 
     // Timeline defaults
     config->timeline.prediction_horizon_ms = 300000;  // 5 minutes
     config->timeline.time_step_ms = 1000;  // 1 second
     config->timeline.max_timelines = 5;
+    config->timeline.branching_enabled = true;
     config->timeline.branch_threshold = 0.3f;
     config->timeline.merge_threshold = 0.8f;
     config->timeline.event_threshold = 0.5f;
     config->timeline.enable_intervention_search = true;
     config->timeline.max_iterations = 1000;
     config->timeline.use_gpu = true;
+    config->timeline.worker_threads = 0;  // Cores left after perception
+    config->timeline.reserved_cores = config->perception.inference_threads + 1;  // + capture
+    config->timeline.monitor_interval_ms = 200;  // Coalesce frames beyond 5 updates/s
 
     // Swarm defaults
     config->swarm.camera_id = config->camera_id;
@@ -303,6 +337,17 @@ bool omnisight_start(OmnisightCore* core,
     core->callback_user_data = user_data;
     core->is_running = true;
 
+    // Start timeline monitoring before perception: whether it runs decides
+    // which thread owns the engine for perception_callback
+    if (core->timeline && core->config.enable_timeline) {
+        printf("[OMNISIGHT] Starting Timeline Threading™...\n");
+        if (!timeline_start_monitoring(core->timeline, timeline_callback, core)) {
+            printf("[OMNISIGHT] Warning: Timeline start failed (updating on perception thread)\n");
+        } else {
+            printf("[OMNISIGHT] ✓ Timeline Threading™ active\n");
+        }
+    }
+
     // Start perception
     if (core->perception && core->config.enable_perception) {
         printf("[OMNISIGHT] Starting perception engine...\n");
@@ -313,16 +358,6 @@ bool omnisight_start(OmnisightCore* core,
         }
     }
 
-    // Start timeline monitoring
-    if (core->timeline && core->config.enable_timeline) {
-        printf("[OMNISIGHT] Starting Timeline Threading™...\n");
-        if (!timeline_start_monitoring(core->timeline, timeline_callback, core)) {
-            printf("[OMNISIGHT] Warning: Timeline start failed\n");
-        } else {
-            printf("[OMNISIGHT] ✓ Timeline Threading™ active\n");
-        }
-    }
-
     // Start swarm
     if (core->swarm && core->config.enable_swarm) {
         printf("[OMNISIGHT] Starting Swarm Intelligence...\n");
@@ -398,16 +433,11 @@ void omnisight_get_stats(OmnisightCore* core, OmnisightStats* stats) {
         stats->perception_stats.tracked_objects = core->num_current_tracks;
     }
 
-    // Timeline stats
+    // Timeline stats, as of the latest update
     if (core->timeline) {
-        uint64_t total_events, total_interventions;
-        timeline_get_stats(core->timeline,
-                          (uint64_t*)&stats->timeline_stats.active_timelines,
-                          &total_events,
-                          &total_interventions,
-                          &stats->timeline_stats.avg_prediction_ms);
-        stats->timeline_stats.total_events_predicted = total_events;
-        stats->timeline_stats.total_interventions = total_interventions;
+        stats->timeline_stats.avg_prediction_ms = core->timeline_avg_prediction_ms;
+        stats->timeline_stats.total_events_predicted = core->timeline_total_events;
+        stats->timeline_stats.total_interventions = core->timeline_total_interventions;
         stats->timeline_stats.active_timelines = core->num_current_timelines;
     }
 
@@ -454,14 +484,23 @@ uint32_t omnisight_get_timelines(OmnisightCore* core,
 
 bool omnisight_get_intervention(OmnisightCore* core,
                                  InterventionPoint* intervention) {
-    if (!core || !core->timeline) return false;
+    if (!core || !core->timeline || !intervention) return false;
+
+    pthread_mutex_lock(&core->mutex);
+    bool found = core->has_intervention;
+    if (found) {
+        *intervention = core->current_intervention;
+    }
+    pthread_mutex_unlock(&core->mutex);
 
-    return timeline_get_best_intervention(core->timeline, intervention);
+    return found;
 }
 
 void omnisight_refresh_timelines(OmnisightCore* core) {
     if (!core || !core->timeline) return;
 
+    // The monitor thread owns the engine while running; the reset is
+    // queued for it and the next snapshot is predicted from scratch
     timeline_clear(core->timeline);
     send_event(core, OMNISIGHT_EVENT_TIMELINE_UPDATED,
               "Timelines refreshed", NULL);
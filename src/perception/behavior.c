@@ -6,16 +6,26 @@
  */
 
 #include "behavior.h"
+#include "track_index.h"
+#include "track_summary.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <stdio.h>
 
+#ifndef MAX_TRACKS
+#define MAX_TRACKS 100
+#endif
+
 #define MAX_EVENTS 1000
 #define MAX_TRACK_HISTORY 100
 
 /**
  * Track history entry for pattern detection
+ *
+ * Alongside the ring, each entry keeps the step from the previous entry
+ * (length and horizontal direction), and the window sums over those steps
+ * are updated as entries come and go.
  */
 typedef struct {
     uint32_t track_id;
@@ -23,6 +33,14 @@ typedef struct {
     uint64_t timestamps_ms[MAX_TRACK_HISTORY];
     uint32_t entry_count;
     uint32_t current_index;
+
+    float step_length[MAX_TRACK_HISTORY];     // Distance from previous entry
+    int8_t step_direction[MAX_TRACK_HISTORY]; // Sign of dx from previous entry
+    uint8_t direction_change[MAX_TRACK_HISTORY]; // Direction differs from previous step
+    double total_movement;                    // Sum of step_length in window
+    uint32_t direction_changes;               // Sum of direction_change in window
+
+    TrackSummary summary;                     // Decimated history beyond the ring
 } TrackHistory;
 
 /**
@@ -33,7 +51,9 @@ struct BehaviorAnalyzer {
     BehaviorEvent events[MAX_EVENTS];
     uint32_t event_count;
     uint32_t event_write_index;
-    TrackHistory histories[MAX_TRACKS];
+    TrackHistory* histories;
+    uint32_t max_histories;
+    TrackIndex* index;           // track_id -> histories slot, LRU order
     uint64_t total_events;
     float running_avg_threat;
     uint32_t high_threat_count;
@@ -42,6 +62,7 @@ struct BehaviorAnalyzer {
 // Forward declarations
 static void update_track_history(BehaviorAnalyzer* analyzer, const TrackedObject* track);
 static TrackHistory* get_track_history(BehaviorAnalyzer* analyzer, uint32_t track_id);
+static void reset_track_history(TrackHistory* history, uint32_t track_id);
 static void add_behavior_event(
     BehaviorAnalyzer* analyzer,
     uint32_t track_id,
@@ -66,6 +87,16 @@ BehaviorAnalyzer* behavior_init(const BehaviorConfig* config) {
         return NULL;
     }
 
+    analyzer->max_histories = config->max_tracks ? config->max_tracks : MAX_TRACKS;
+    analyzer->histories = (TrackHistory*)calloc(analyzer->max_histories, sizeof(TrackHistory));
+    analyzer->index = track_index_create(analyzer->max_histories);
+    if (!analyzer->histories || !analyzer->index) {
+        track_index_destroy(analyzer->index);
+        free(analyzer->histories);
+        free(analyzer);
+        return NULL;
+    }
+
     analyzer->config = *config;
     analyzer->event_count = 0;
     analyzer->event_write_index = 0;
@@ -73,12 +104,7 @@ BehaviorAnalyzer* behavior_init(const BehaviorConfig* config) {
     analyzer->running_avg_threat = 0.0f;
     analyzer->high_threat_count = 0;
 
-    // Initialize track histories
-    for (int i = 0; i < MAX_TRACKS; i++) {
-        analyzer->histories[i].track_id = 0;
-        analyzer->histories[i].entry_count = 0;
-        analyzer->histories[i].current_index = 0;
-    }
+    analyzer->config.max_tracks = analyzer->max_histories;
 
     return analyzer;
 }
@@ -233,20 +259,8 @@ bool behavior_detect_loitering(
         return false;
     }
 
-    // Calculate total movement
-    float total_movement = 0.0f;
-    uint32_t start_idx = history->current_index;
-
-    for (uint32_t i = 1; i < history->entry_count && i < MAX_TRACK_HISTORY; i++) {
-        uint32_t idx = (start_idx - i + MAX_TRACK_HISTORY) % MAX_TRACK_HISTORY;
-        uint32_t prev_idx = (start_idx - i + 1 + MAX_TRACK_HISTORY) % MAX_TRACK_HISTORY;
-
-        float dx = history->positions[idx].x - history->positions[prev_idx].x;
-        float dy = history->positions[idx].y - history->positions[prev_idx].y;
-        total_movement += sqrtf(dx * dx + dy * dy);
-    }
-
-    float avg_movement = total_movement / fminf(history->entry_count, MAX_TRACK_HISTORY);
+    // Average movement per entry, from the running window sum
+    float avg_movement = (float)(history->total_movement / history->entry_count);
 
     return avg_movement < analyzer->config.loitering_movement_threshold;
 }
@@ -287,23 +301,21 @@ bool behavior_detect_repeated_passes(
     }
 
     // Count how many times object entered a specific zone
-    // Simplified: count direction reversals
-    uint32_t direction_changes = 0;
-    float prev_direction = 0.0f;
-
-    uint32_t start_idx = history->current_index;
-    for (uint32_t i = 1; i < history->entry_count && i < MAX_TRACK_HISTORY; i++) {
-        uint32_t idx = (start_idx - i + MAX_TRACK_HISTORY) % MAX_TRACK_HISTORY;
-        uint32_t prev_idx = (start_idx - i + 1 + MAX_TRACK_HISTORY) % MAX_TRACK_HISTORY;
-
-        float dx = history->positions[idx].x - history->positions[prev_idx].x;
-        float current_direction = (dx > 0) ? 1.0f : -1.0f;
-
-        if (i > 1 && current_direction != prev_direction) {
-            direction_changes++;
-        }
-
-        prev_direction = current_direction;
+    // Simplified: count direction reversals. Windows longer than the ring
+    // are read from the decimated history.
+    uint32_t newest_idx = (history->current_index + MAX_TRACK_HISTORY - 1) % MAX_TRACK_HISTORY;
+    uint32_t oldest_idx = (history->current_index + MAX_TRACK_HISTORY - history->entry_count) % MAX_TRACK_HISTORY;
+    uint64_t newest_ms = history->timestamps_ms[newest_idx];
+    uint64_t window_ms = analyzer->config.repeated_passes_window_ms;
+
+    uint32_t direction_changes = history->direction_changes;
+    if (newest_ms - history->timestamps_ms[oldest_idx] < window_ms) {
+        // Jitter below the loitering movement threshold is not a pass
+        uint64_t window_start_ms = newest_ms > window_ms ? newest_ms - window_ms : 0;
+        TrackSummaryStats window;
+        track_summary_window_stats(&history->summary, window_start_ms,
+                                   analyzer->config.loitering_movement_threshold, &window);
+        direction_changes = window.reversals_x;
     }
 
     return direction_changes >= analyzer->config.repeated_passes_count;
@@ -314,18 +326,34 @@ void behavior_update_config(
     const BehaviorConfig* config
 ) {
     if (analyzer && config) {
+        // History capacity is fixed at init
         analyzer->config = *config;
+        analyzer->config.max_tracks = analyzer->max_histories;
     }
 }
 
+bool behavior_remove_track(BehaviorAnalyzer* analyzer, uint32_t track_id) {
+    if (!analyzer) {
+        return false;
+    }
+
+    int32_t slot = track_index_remove(analyzer->index, track_id);
+    if (slot < 0) {
+        return false;
+    }
+
+    reset_track_history(&analyzer->histories[slot], 0);
+    return true;
+}
+
 void behavior_clear_history(BehaviorAnalyzer* analyzer) {
     if (!analyzer) {
         return;
     }
 
-    for (int i = 0; i < MAX_TRACKS; i++) {
-        analyzer->histories[i].entry_count = 0;
-        analyzer->histories[i].current_index = 0;
+    track_index_clear(analyzer->index);
+    for (uint32_t i = 0; i < analyzer->max_histories; i++) {
+        reset_track_history(&analyzer->histories[i], 0);
     }
 
     analyzer->event_count = 0;
@@ -349,6 +377,8 @@ void behavior_get_stats(
 
 void behavior_destroy(BehaviorAnalyzer* analyzer) {
     if (analyzer) {
+        track_index_destroy(analyzer->index);
+        free(analyzer->histories);
         free(analyzer);
     }
 }
@@ -402,31 +432,63 @@ int behavior_to_string(
 // ============================================================================
 
 static void update_track_history(BehaviorAnalyzer* analyzer, const TrackedObject* track) {
-    TrackHistory* history = NULL;
+    // Find existing history or take a free one; when all are in use the
+    // least recently updated track gives up its slot
+    bool is_new = false;
+    int32_t slot = track_index_acquire(analyzer->index, track->track_id, &is_new, NULL);
+    if (slot < 0) {
+        return;
+    }
+
+    TrackHistory* history = &analyzer->histories[slot];
+    if (is_new) {
+        reset_track_history(history, track->track_id);
+    }
+
+    uint32_t idx = history->current_index;
+
+    // When full, the oldest entry (at idx) drops out of the window, taking
+    // the step into the entry after it and the direction change after that
+    if (history->entry_count == MAX_TRACK_HISTORY) {
+        history->total_movement -= history->step_length[(idx + 1) % MAX_TRACK_HISTORY];
+        history->direction_changes -= history->direction_change[(idx + 2) % MAX_TRACK_HISTORY];
+    }
+
+    // Step from the previous entry
+    float step_length = 0.0f;
+    float speed = 0.0f;
+    int8_t step_direction = 0;
+    uint8_t direction_change = 0;
+
+    if (history->entry_count > 0) {
+        uint32_t prev_idx = (idx + MAX_TRACK_HISTORY - 1) % MAX_TRACK_HISTORY;
+        float dx = track->current_bbox.x - history->positions[prev_idx].x;
+        float dy = track->current_bbox.y - history->positions[prev_idx].y;
 
-    // Find existing history or create new one
-    for (int i = 0; i < MAX_TRACKS; i++) {
-        if (analyzer->histories[i].track_id == track->track_id) {
-            history = &analyzer->histories[i];
-            break;
+        step_length = sqrtf(dx * dx + dy * dy);
+        step_direction = (dx > 0) ? 1 : -1;
+
+        if (history->entry_count > 1) {
+            direction_change = step_direction != history->step_direction[prev_idx];
         }
-        if (analyzer->histories[i].track_id == 0) {
-            history = &analyzer->histories[i];
-            history->track_id = track->track_id;
-            history->entry_count = 0;
-            history->current_index = 0;
-            break;
+
+        uint64_t dt_ms = track->last_seen_ms - history->timestamps_ms[prev_idx];
+        if (track->last_seen_ms > history->timestamps_ms[prev_idx]) {
+            speed = step_length * 1000.0f / dt_ms;
         }
     }
 
-    if (!history) {
-        return;  // No space for new history
-    }
+    track_summary_add(&history->summary, track->current_bbox.x, track->current_bbox.y,
+                      speed, track->last_seen_ms);
 
     // Add current position to history
-    uint32_t idx = history->current_index;
     history->positions[idx] = track->current_bbox;
     history->timestamps_ms[idx] = track->last_seen_ms;
+    history->step_length[idx] = step_length;
+    history->step_direction[idx] = step_direction;
+    history->direction_change[idx] = direction_change;
+    history->total_movement += step_length;
+    history->direction_changes += direction_change;
 
     history->current_index = (history->current_index + 1) % MAX_TRACK_HISTORY;
     if (history->entry_count < MAX_TRACK_HISTORY) {
@@ -435,12 +497,17 @@ static void update_track_history(BehaviorAnalyzer* analyzer, const TrackedObject
 }
 
 static TrackHistory* get_track_history(BehaviorAnalyzer* analyzer, uint32_t track_id) {
-    for (int i = 0; i < MAX_TRACKS; i++) {
-        if (analyzer->histories[i].track_id == track_id) {
-            return &analyzer->histories[i];
-        }
-    }
-    return NULL;
+    int32_t slot = track_index_find(analyzer->index, track_id);
+    return slot >= 0 ? &analyzer->histories[slot] : NULL;
+}
+
+static void reset_track_history(TrackHistory* history, uint32_t track_id) {
+    history->track_id = track_id;
+    history->entry_count = 0;
+    history->current_index = 0;
+    history->total_movement = 0.0;
+    history->direction_changes = 0;
+    track_summary_reset(&history->summary);
 }
 
 static void add_behavior_event(
@@ -16,6 +16,7 @@
 #define OMNISIGHT_BEHAVIOR_H
 
 #include "perception.h"
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -45,6 +46,9 @@ typedef struct {
     uint32_t observation_threshold_ms;    // Time observing area
     float observation_gaze_threshold;     // Head orientation threshold
 
+    // Capacity (fixed at init)
+    uint32_t max_tracks;                  // Track histories kept (0 = 100), LRU-evicted beyond
+
     // Threat scoring weights
     float loitering_weight;
     float running_weight;
@@ -164,6 +168,18 @@ void behavior_update_config(
     const BehaviorConfig* config
 );
 
+/**
+ * Forget a track's history
+ *
+ * Call for every track the tracker deletes so its slot is free for the
+ * next new track.
+ *
+ * @param analyzer Behavior analyzer instance
+ * @param track_id Deleted track
+ * @return true if the track had a history
+ */
+bool behavior_remove_track(BehaviorAnalyzer* analyzer, uint32_t track_id);
+
 /**
  * Clear behavior history
  *
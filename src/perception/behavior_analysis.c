@@ -12,6 +12,7 @@
  */
 
 #include "behavior_analysis.h"
+#include "track_index.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -23,8 +24,22 @@
 #define MAX_TRACK_HISTORIES 100
 #define POSITION_HISTORY_SIZE 60  // 6 seconds @ 10 FPS
 
+/**
+ * FIFO of position sequence numbers, at most one window long
+ */
+typedef struct {
+    uint32_t seq[POSITION_HISTORY_SIZE];
+    uint32_t first;
+    uint32_t count;
+} SeqQueue;
+
 /**
  * Track history storage
+ *
+ * Position k (counting from the track's first position) lives in
+ * positions[k % POSITION_HISTORY_SIZE]. The aggregates below describe
+ * exactly the positions currently in the ring and are updated as one
+ * position enters and at most one leaves, so detectors never rescan it.
  */
 typedef struct {
     uint32_t track_id;
@@ -35,6 +50,24 @@ typedef struct {
     uint64_t last_update_ms;
     bool active;
 
+    // Sliding-window aggregates
+    uint32_t total_positions;        // Sequence number of the next position
+    double velocity_sum;             // Sum of positions[].velocity
+    SeqQueue high_velocity;          // Positions at/above running threshold
+    SeqQueue min_x, max_x;           // Monotonic queues: window extents
+    SeqQueue min_y, max_y;
+    uint8_t turn[POSITION_HISTORY_SIZE]; // Zig-zag turn ending at this position
+    uint32_t turn_count;             // Turns within the window
+
+    // Decimated history beyond the ring (minutes)
+    TrackSummary summary;
+
+    // Zone membership of the latest position
+    bool in_zone;
+    uint32_t zone_id;
+    float zone_sensitivity;
+    uint64_t zone_entered_ms;
+
     // Cached behavior state
     bool is_loitering;
     bool is_running;
@@ -47,8 +80,10 @@ typedef struct {
  */
 struct BehaviorAnalyzer {
     BehaviorAnalyzerConfig config;
-    InternalTrackHistory histories[MAX_TRACK_HISTORIES];
+    InternalTrackHistory* histories;
+    uint32_t max_histories;
     uint32_t num_histories;
+    TrackIndex* index;      // track_id -> histories slot, LRU order
 
     // Statistics
     uint32_t total_tracks_analyzed;
@@ -77,6 +112,12 @@ static float calculate_threat_score(BehaviorAnalyzer* analyzer,
 static float calculate_direction_change(float x1, float y1,
                                        float x2, float y2,
                                        float x3, float y3);
+static void update_zone(BehaviorAnalyzer* analyzer,
+                        InternalTrackHistory* history,
+                        float x, float y, uint64_t timestamp_ms);
+static void window_remove_oldest(InternalTrackHistory* history);
+static void window_add_newest(BehaviorAnalyzer* analyzer,
+                              InternalTrackHistory* history);
 
 // ============================================================================
 // Public API Implementation
@@ -94,6 +135,18 @@ BehaviorAnalyzer* behavior_analyzer_init(const BehaviorAnalyzerConfig* config) {
         return NULL;
     }
 
+    analyzer->max_histories = config->max_tracks ? config->max_tracks : MAX_TRACK_HISTORIES;
+    analyzer->histories = calloc(analyzer->max_histories, sizeof(InternalTrackHistory));
+    analyzer->index = track_index_create(analyzer->max_histories);
+    if (!analyzer->histories || !analyzer->index) {
+        syslog(LOG_ERR, "[Behavior] Failed to allocate %u track histories",
+               analyzer->max_histories);
+        track_index_destroy(analyzer->index);
+        free(analyzer->histories);
+        free(analyzer);
+        return NULL;
+    }
+
     analyzer->config = *config;
     analyzer->num_histories = 0;
     analyzer->total_tracks_analyzed = 0;
@@ -103,6 +156,8 @@ BehaviorAnalyzer* behavior_analyzer_init(const BehaviorAnalyzerConfig* config) {
 
     if (pthread_mutex_init(&analyzer->mutex, NULL) != 0) {
         syslog(LOG_ERR, "[Behavior] Failed to initialize mutex");
+        track_index_destroy(analyzer->index);
+        free(analyzer->histories);
         free(analyzer);
         return NULL;
     }
@@ -115,6 +170,11 @@ BehaviorAnalyzer* behavior_analyzer_init(const BehaviorAnalyzerConfig* config) {
     syslog(LOG_INFO, "[Behavior] Running: vel=%.2fm/s, duration=%.1fs",
            config->running_velocity_threshold,
            config->running_duration_ms / 1000.0f);
+    if (config->enable_zone_analysis) {
+        syslog(LOG_INFO, "[Behavior] Zones: %s, weight=%.2f",
+               config->zone_map ? "shared map" : "no map (disabled)",
+               config->weight_zone);
+    }
 
     return analyzer;
 }
@@ -226,6 +286,11 @@ void behavior_analyzer_update_history(BehaviorAnalyzer* analyzer,
         }
     }
 
+    // Drop the oldest position from the aggregates before it is overwritten
+    if (history->num_positions == POSITION_HISTORY_SIZE) {
+        window_remove_oldest(history);
+    }
+
     // Add to circular buffer
     PositionHistory* pos = &history->positions[history->head];
     pos->x = x;
@@ -238,6 +303,10 @@ void behavior_analyzer_update_history(BehaviorAnalyzer* analyzer,
         history->num_positions++;
     }
 
+    window_add_newest(analyzer, history);
+    track_summary_add(&history->summary, x, y, velocity, timestamp_ms);
+    update_zone(analyzer, history, x, y, timestamp_ms);
+
     if (history->first_seen_ms == 0) {
         history->first_seen_ms = timestamp_ms;
     }
@@ -255,26 +324,25 @@ bool behavior_analyzer_get_history(BehaviorAnalyzer* analyzer,
 
     pthread_mutex_lock(&analyzer->mutex);
 
-    bool found = false;
-    for (uint32_t i = 0; i < MAX_TRACK_HISTORIES; i++) {
-        if (analyzer->histories[i].active &&
-            analyzer->histories[i].track_id == track_id) {
-
-            InternalTrackHistory* internal = &analyzer->histories[i];
-            history->track_id = track_id;
-            history->num_positions = internal->num_positions;
-            history->first_seen_ms = internal->first_seen_ms;
-            history->last_update_ms = internal->last_update_ms;
-
-            // Copy positions in chronological order
-            for (uint32_t j = 0; j < internal->num_positions; j++) {
-                uint32_t idx = (internal->head + POSITION_HISTORY_SIZE - internal->num_positions + j) %
-                              POSITION_HISTORY_SIZE;
-                history->positions[j] = internal->positions[idx];
-            }
-
-            found = true;
-            break;
+    int32_t slot = track_index_find(analyzer->index, track_id);
+    bool found = slot >= 0;
+
+    if (found) {
+        InternalTrackHistory* internal = &analyzer->histories[slot];
+        history->track_id = track_id;
+        history->num_positions = internal->num_positions;
+        history->first_seen_ms = internal->first_seen_ms;
+        history->last_update_ms = internal->last_update_ms;
+        history->summary = internal->summary;
+        history->in_zone = internal->in_zone;
+        history->zone_id = internal->zone_id;
+        history->zone_entered_ms = internal->zone_entered_ms;
+
+        // Copy positions in chronological order
+        for (uint32_t j = 0; j < internal->num_positions; j++) {
+            uint32_t idx = (internal->head + POSITION_HISTORY_SIZE - internal->num_positions + j) %
+                          POSITION_HISTORY_SIZE;
+            history->positions[j] = internal->positions[idx];
         }
     }
 
@@ -290,13 +358,11 @@ void behavior_analyzer_clear_history(BehaviorAnalyzer* analyzer,
 
     pthread_mutex_lock(&analyzer->mutex);
 
-    for (uint32_t i = 0; i < MAX_TRACK_HISTORIES; i++) {
-        if (analyzer->histories[i].active &&
-            analyzer->histories[i].track_id == track_id) {
-            memset(&analyzer->histories[i], 0, sizeof(InternalTrackHistory));
-            analyzer->histories[i].active = false;
-            break;
-        }
+    int32_t slot = track_index_remove(analyzer->index, track_id);
+    if (slot >= 0) {
+        memset(&analyzer->histories[slot], 0, sizeof(InternalTrackHistory));
+        analyzer->histories[slot].active = false;
+        analyzer->num_histories = track_index_count(analyzer->index);
     }
 
     pthread_mutex_unlock(&analyzer->mutex);
@@ -309,7 +375,8 @@ void behavior_analyzer_reset(BehaviorAnalyzer* analyzer) {
 
     pthread_mutex_lock(&analyzer->mutex);
 
-    memset(analyzer->histories, 0, sizeof(analyzer->histories));
+    memset(analyzer->histories, 0, analyzer->max_histories * sizeof(InternalTrackHistory));
+    track_index_clear(analyzer->index);
     analyzer->num_histories = 0;
     analyzer->total_tracks_analyzed = 0;
     analyzer->loitering_detections = 0;
@@ -357,6 +424,8 @@ void behavior_analyzer_destroy(BehaviorAnalyzer* analyzer) {
     pthread_mutex_unlock(&analyzer->mutex);
     pthread_mutex_destroy(&analyzer->mutex);
 
+    track_index_destroy(analyzer->index);
+    free(analyzer->histories);
     free(analyzer);
 
     syslog(LOG_INFO, "[Behavior] Destroyed");
@@ -368,45 +437,32 @@ void behavior_analyzer_destroy(BehaviorAnalyzer* analyzer) {
 
 static InternalTrackHistory* get_or_create_history(BehaviorAnalyzer* analyzer,
                                                    uint32_t track_id) {
-    // Search for existing history
-    for (uint32_t i = 0; i < MAX_TRACK_HISTORIES; i++) {
-        if (analyzer->histories[i].active &&
-            analyzer->histories[i].track_id == track_id) {
-            return &analyzer->histories[i];
-        }
+    // Existing history, else a free slot, else the least recently
+    // updated track's slot
+    bool is_new = false;
+    uint32_t evicted_id = 0;
+    int32_t slot = track_index_acquire(analyzer->index, track_id, &is_new, &evicted_id);
+    if (slot < 0) {
+        return NULL;
     }
 
-    // Find free slot
-    for (uint32_t i = 0; i < MAX_TRACK_HISTORIES; i++) {
-        if (!analyzer->histories[i].active) {
-            memset(&analyzer->histories[i], 0, sizeof(InternalTrackHistory));
-            analyzer->histories[i].active = true;
-            analyzer->histories[i].track_id = track_id;
-            analyzer->total_tracks_analyzed++;
-            return &analyzer->histories[i];
-        }
+    InternalTrackHistory* history = &analyzer->histories[slot];
+    if (!is_new) {
+        return history;
     }
 
-    // No free slots - reuse oldest
-    uint32_t oldest_idx = 0;
-    uint64_t oldest_time = analyzer->histories[0].last_update_ms;
-
-    for (uint32_t i = 1; i < MAX_TRACK_HISTORIES; i++) {
-        if (analyzer->histories[i].last_update_ms < oldest_time) {
-            oldest_time = analyzer->histories[i].last_update_ms;
-            oldest_idx = i;
-        }
+    if (evicted_id != 0) {
+        syslog(LOG_WARNING, "[Behavior] Reusing history slot (track %u evicted)",
+               evicted_id);
     }
 
-    syslog(LOG_WARNING, "[Behavior] Reusing history slot (track %u evicted)",
-           analyzer->histories[oldest_idx].track_id);
-
-    memset(&analyzer->histories[oldest_idx], 0, sizeof(InternalTrackHistory));
-    analyzer->histories[oldest_idx].active = true;
-    analyzer->histories[oldest_idx].track_id = track_id;
+    memset(history, 0, sizeof(InternalTrackHistory));
+    history->active = true;
+    history->track_id = track_id;
+    analyzer->num_histories = track_index_count(analyzer->index);
     analyzer->total_tracks_analyzed++;
 
-    return &analyzer->histories[oldest_idx];
+    return history;
 }
 
 static void detect_loitering(BehaviorAnalyzer* analyzer,
@@ -424,28 +480,47 @@ static void detect_loitering(BehaviorAnalyzer* analyzer,
         return;  // Not enough time elapsed
     }
 
-    // Check if track has stayed within small radius
-    // Get earliest and latest positions
+    // Check if track has stayed within small radius of where the dwell
+    // window starts: bound the distance by the farthest corner of the
+    // window's extent
     uint32_t earliest_idx = (history->head + POSITION_HISTORY_SIZE - history->num_positions) %
                            POSITION_HISTORY_SIZE;
-    uint32_t latest_idx = (history->head + POSITION_HISTORY_SIZE - 1) % POSITION_HISTORY_SIZE;
-
-    float start_x = history->positions[earliest_idx].x;
-    float start_y = history->positions[earliest_idx].y;
-
-    // Check all positions are within radius of start
-    float max_distance = 0.0f;
-    for (uint32_t i = 0; i < history->num_positions; i++) {
-        uint32_t idx = (history->head + POSITION_HISTORY_SIZE - history->num_positions + i) %
-                      POSITION_HISTORY_SIZE;
-        float dist = position_distance(start_x, start_y,
-                                      history->positions[idx].x,
-                                      history->positions[idx].y);
-        if (dist > max_distance) {
-            max_distance = dist;
+    uint64_t window_start_ms = history->last_update_ms - (uint64_t)analyzer->config.loitering_dwell_time_ms;
+
+    float start_x, start_y;
+    float min_x, min_y, max_x, max_y;
+    float avg_velocity;
+
+    if (window_start_ms >= history->positions[earliest_idx].timestamp_ms) {
+        // Dwell window fits in the full-rate ring
+        const PositionHistory* pos = history->positions;
+        start_x = pos[earliest_idx].x;
+        start_y = pos[earliest_idx].y;
+        min_x = pos[history->min_x.seq[history->min_x.first] % POSITION_HISTORY_SIZE].x;
+        max_x = pos[history->max_x.seq[history->max_x.first] % POSITION_HISTORY_SIZE].x;
+        min_y = pos[history->min_y.seq[history->min_y.first] % POSITION_HISTORY_SIZE].y;
+        max_y = pos[history->max_y.seq[history->max_y.first] % POSITION_HISTORY_SIZE].y;
+        avg_velocity = (float)(history->velocity_sum / history->num_positions);
+    } else {
+        // Longer than the ring: use the decimated history
+        TrackSummaryStats window;
+        if (!track_summary_window_stats(&history->summary, window_start_ms, 0.0f, &window)) {
+            return;
         }
+
+        start_x = window.start_x;
+        start_y = window.start_y;
+        min_x = window.min_x;
+        max_x = window.max_x;
+        min_y = window.min_y;
+        max_y = window.max_y;
+        avg_velocity = window.mean_speed;
     }
 
+    float reach_x = fmaxf(start_x - min_x, max_x - start_x);
+    float reach_y = fmaxf(start_y - min_y, max_y - start_y);
+    float max_distance = sqrtf(reach_x * reach_x + reach_y * reach_y);
+
     float max_distance_meters = normalized_to_meters(max_distance,
                                                      analyzer->config.meters_per_normalized_unit);
 
@@ -454,20 +529,6 @@ static void detect_loitering(BehaviorAnalyzer* analyzer,
     }
 
     // Check average velocity is low
-    float avg_velocity = 0.0f;
-    uint32_t velocity_samples = 0;
-
-    for (uint32_t i = 0; i < history->num_positions; i++) {
-        uint32_t idx = (history->head + POSITION_HISTORY_SIZE - history->num_positions + i) %
-                      POSITION_HISTORY_SIZE;
-        avg_velocity += history->positions[idx].velocity;
-        velocity_samples++;
-    }
-
-    if (velocity_samples > 0) {
-        avg_velocity /= velocity_samples;
-    }
-
     if (avg_velocity > analyzer->config.loitering_velocity_threshold) {
         return;  // Moving too fast
     }
@@ -486,29 +547,16 @@ static void detect_running(BehaviorAnalyzer* analyzer,
     }
 
     // Check if sustained high velocity
-    uint32_t high_velocity_count = 0;
-    uint64_t first_high_velocity_time = 0;
-    uint64_t last_high_velocity_time = 0;
-
-    for (uint32_t i = 0; i < history->num_positions; i++) {
-        uint32_t idx = (history->head + POSITION_HISTORY_SIZE - history->num_positions + i) %
-                      POSITION_HISTORY_SIZE;
-
-        if (history->positions[idx].velocity >= analyzer->config.running_velocity_threshold) {
-            high_velocity_count++;
-            if (first_high_velocity_time == 0) {
-                first_high_velocity_time = history->positions[idx].timestamp_ms;
-            }
-            last_high_velocity_time = history->positions[idx].timestamp_ms;
-        }
-    }
-
-    if (high_velocity_count < 3) {
+    const SeqQueue* high = &history->high_velocity;
+    if (high->count < 3) {
         return;  // Not sustained
     }
 
     // Check duration of high velocity
-    uint64_t duration = last_high_velocity_time - first_high_velocity_time;
+    uint32_t first_seq = high->seq[high->first];
+    uint32_t last_seq = high->seq[(high->first + high->count - 1) % POSITION_HISTORY_SIZE];
+    uint64_t duration = history->positions[last_seq % POSITION_HISTORY_SIZE].timestamp_ms -
+                        history->positions[first_seq % POSITION_HISTORY_SIZE].timestamp_ms;
     if (duration < analyzer->config.running_duration_ms) {
         return;  // Not sustained long enough
     }
@@ -526,31 +574,8 @@ static void detect_unusual_movement(BehaviorAnalyzer* analyzer,
         return;  // Need minimum history for direction changes
     }
 
-    // Count significant direction changes (zigzag pattern)
-    uint32_t direction_changes = 0;
-
-    for (uint32_t i = 2; i < history->num_positions; i++) {
-        uint32_t idx1 = (history->head + POSITION_HISTORY_SIZE - history->num_positions + i - 2) %
-                       POSITION_HISTORY_SIZE;
-        uint32_t idx2 = (history->head + POSITION_HISTORY_SIZE - history->num_positions + i - 1) %
-                       POSITION_HISTORY_SIZE;
-        uint32_t idx3 = (history->head + POSITION_HISTORY_SIZE - history->num_positions + i) %
-                       POSITION_HISTORY_SIZE;
-
-        float angle = calculate_direction_change(
-            history->positions[idx1].x, history->positions[idx1].y,
-            history->positions[idx2].x, history->positions[idx2].y,
-            history->positions[idx3].x, history->positions[idx3].y
-        );
-
-        // Direction change > threshold (e.g., 45 degrees)
-        if (fabsf(angle) > analyzer->config.zigzag_threshold) {
-            direction_changes++;
-        }
-    }
-
-    // Unusual if many direction changes
-    if (direction_changes >= analyzer->config.zigzag_count_threshold) {
+    // Unusual if many direction changes (zigzag pattern)
+    if (history->turn_count >= analyzer->config.zigzag_count_threshold) {
         *has_unusual = true;
     }
 }
@@ -571,6 +596,11 @@ static float calculate_threat_score(BehaviorAnalyzer* analyzer,
         score += analyzer->config.weight_unusual_movement;
     }
 
+    // Presence in a sensitive zone
+    if (history->in_zone) {
+        score += analyzer->config.weight_zone * history->zone_sensitivity;
+    }
+
     // Time-based escalation (longer presence = higher threat)
     if (history->first_seen_ms > 0 && history->last_update_ms > 0) {
         uint64_t dwell_time = history->last_update_ms - history->first_seen_ms;
@@ -588,6 +618,43 @@ static float calculate_threat_score(BehaviorAnalyzer* analyzer,
     return score;
 }
 
+/**
+ * Record which zone (the most sensitive one) the latest position is in
+ */
+static void update_zone(BehaviorAnalyzer* analyzer,
+                        InternalTrackHistory* history,
+                        float x, float y, uint64_t timestamp_ms) {
+    if (!analyzer->config.enable_zone_analysis || !analyzer->config.zone_map) {
+        return;
+    }
+
+    const ZoneGrid* grid = zone_map_acquire(analyzer->config.zone_map);
+    uint32_t hits = zone_grid_query(grid, x, y, ZONE_CLASS_ALL);
+
+    const Zone* best = NULL;
+    while (hits) {
+        const Zone* zone = zone_grid_zone(grid, (uint32_t)__builtin_ctz(hits));
+        if (!best || zone->sensitivity > best->sensitivity) {
+            best = zone;
+        }
+        hits &= hits - 1;
+    }
+
+    if (best) {
+        if (!history->in_zone || history->zone_id != best->zone_id) {
+            history->zone_entered_ms = timestamp_ms;
+        }
+        history->in_zone = true;
+        history->zone_id = best->zone_id;
+        history->zone_sensitivity = best->sensitivity;
+    } else {
+        history->in_zone = false;
+        history->zone_sensitivity = 0.0f;
+    }
+
+    zone_map_release(analyzer->config.zone_map, grid);
+}
+
 static float calculate_direction_change(float x1, float y1,
                                        float x2, float y2,
                                        float x3, float y3) {
@@ -611,3 +678,96 @@ static float calculate_direction_change(float x1, float y1,
     // Convert to degrees
     return diff * 180.0f / M_PI;
 }
+
+// ============================================================================
+// Sliding-Window Aggregates
+// ============================================================================
+
+static inline uint32_t seq_queue_back(const SeqQueue* q) {
+    return q->seq[(q->first + q->count - 1) % POSITION_HISTORY_SIZE];
+}
+
+static inline void seq_queue_push(SeqQueue* q, uint32_t seq) {
+    q->seq[(q->first + q->count) % POSITION_HISTORY_SIZE] = seq;
+    q->count++;
+}
+
+static inline void seq_queue_expire(SeqQueue* q, uint32_t seq) {
+    if (q->count > 0 && q->seq[q->first] == seq) {
+        q->first = (q->first + 1) % POSITION_HISTORY_SIZE;
+        q->count--;
+    }
+}
+
+/**
+ * Push onto a monotonic queue whose front is the window minimum of
+ * sign * value. Entries that can never be the extremum again are dropped.
+ */
+static void extent_push(SeqQueue* q, const PositionHistory* positions,
+                        uint32_t seq, bool use_y, float sign) {
+    const PositionHistory* p = &positions[seq % POSITION_HISTORY_SIZE];
+    float value = sign * (use_y ? p->y : p->x);
+
+    while (q->count > 0) {
+        const PositionHistory* b = &positions[seq_queue_back(q) % POSITION_HISTORY_SIZE];
+        if (sign * (use_y ? b->y : b->x) < value) {
+            break;
+        }
+        q->count--;
+    }
+
+    seq_queue_push(q, seq);
+}
+
+/**
+ * Remove the oldest position (about to be overwritten) from the aggregates
+ */
+static void window_remove_oldest(InternalTrackHistory* history) {
+    uint32_t oldest = history->total_positions - history->num_positions;
+    const PositionHistory* pos = &history->positions[oldest % POSITION_HISTORY_SIZE];
+
+    history->velocity_sum -= pos->velocity;
+    seq_queue_expire(&history->high_velocity, oldest);
+    seq_queue_expire(&history->min_x, oldest);
+    seq_queue_expire(&history->max_x, oldest);
+    seq_queue_expire(&history->min_y, oldest);
+    seq_queue_expire(&history->max_y, oldest);
+
+    // The turn through (oldest, oldest + 1, oldest + 2) leaves the window
+    history->turn_count -= history->turn[(oldest + 2) % POSITION_HISTORY_SIZE];
+}
+
+/**
+ * Add the position just written at the ring head to the aggregates
+ */
+static void window_add_newest(BehaviorAnalyzer* analyzer,
+                              InternalTrackHistory* history) {
+    uint32_t seq = history->total_positions++;
+    const PositionHistory* positions = history->positions;
+    const PositionHistory* pos = &positions[seq % POSITION_HISTORY_SIZE];
+
+    history->velocity_sum += pos->velocity;
+
+    if (pos->velocity >= analyzer->config.running_velocity_threshold) {
+        seq_queue_push(&history->high_velocity, seq);
+    }
+
+    extent_push(&history->min_x, positions, seq, false, 1.0f);
+    extent_push(&history->max_x, positions, seq, false, -1.0f);
+    extent_push(&history->min_y, positions, seq, true, 1.0f);
+    extent_push(&history->max_y, positions, seq, true, -1.0f);
+
+    uint8_t turn = 0;
+    if (history->num_positions >= 3) {
+        const PositionHistory* p1 = &positions[(seq - 2) % POSITION_HISTORY_SIZE];
+        const PositionHistory* p2 = &positions[(seq - 1) % POSITION_HISTORY_SIZE];
+
+        float angle = calculate_direction_change(p1->x, p1->y, p2->x, p2->y,
+                                                 pos->x, pos->y);
+
+        // Direction change > threshold (e.g., 45 degrees)
+        turn = fabsf(angle) > analyzer->config.zigzag_threshold;
+    }
+    history->turn[seq % POSITION_HISTORY_SIZE] = turn;
+    history->turn_count += turn;
+}
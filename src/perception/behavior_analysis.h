@@ -15,6 +15,9 @@
 #define OMNISIGHT_BEHAVIOR_ANALYSIS_H
 
 #include "perception.h"
+#include "track_summary.h"
+#include "zone_map.h"
+#include <math.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -44,6 +47,10 @@ typedef struct {
     uint32_t num_positions;
     uint64_t first_seen_ms;
     uint64_t last_update_ms;
+    TrackSummary summary;           // Bucketed history out to minutes (speeds in m/s)
+    bool in_zone;                   // Last position inside a zone (zone analysis)
+    uint32_t zone_id;               // Most sensitive zone containing it
+    uint64_t zone_entered_ms;       // When the track entered that zone
 } TrackHistory;
 
 /**
@@ -63,9 +70,13 @@ typedef struct {
     float zigzag_threshold;             // Direction change threshold (default: 45 degrees)
     uint32_t zigzag_count_threshold;    // Number of changes for unusual (default: 5)
 
-    // Zone analysis (for future use)
+    // Zone analysis (positions in normalized coordinates)
     bool enable_zone_analysis;
-    uint32_t num_zones;
+    ZoneMap* zone_map;                  // Shared zone engine (not owned, may be edited live)
+    float weight_zone;                  // Weight x zone sensitivity while inside a zone
+
+    // Capacity
+    uint32_t max_tracks;                // Track histories kept (0 = 100), LRU-evicted beyond
 
     // Calibration for camera (meters per normalized unit)
     float meters_per_normalized_unit;   // Scene calibration (default: 10.0m)
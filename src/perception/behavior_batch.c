@@ -0,0 +1,871 @@
+/**
+ * @file behavior_batch.c
+ * @brief Batched behavior analysis implementation
+ *
+ * Per frame, tracks are processed in blocks of BLOCK:
+ * 1. gather:  find each track's slot and copy what the block needs out of
+ *             the track structs and slot arrays into packed block arrays
+ * 2. step:    step length, velocity, direction and turn for every track
+ * 3. scatter: append the new position to each slot's ring and move the
+ *             window aggregates (one entry in, at most one out)
+ * 4. detect:  detector masks and threat scores for every track; the few
+ *             tracks that need a long-window answer are compacted and
+ *             resolved afterwards from their ring or decimated history
+ *
+ * Steps 2 and 4 are plain loops over the block arrays with selects in
+ * place of branches, which the compiler vectorizes at -O3 -ffast-math.
+ * Results match behavior.c and behavior_analysis.c for the same inputs.
+ */
+
+#include "behavior_batch.h"
+#include "track_index.h"
+#include "track_summary.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#define DEFAULT_MAX_TRACKS 100
+#define BASIC_RING 100          // Entries per track, as behavior.c
+#define TRAJECTORY_RING 60      // Positions per track, as behavior_analysis.c
+#define BLOCK 64                // Tracks per gather/scatter pass
+#define HIGH_THREAT 0.7f
+
+// Ring entry flags
+#define ENTRY_TURN 0x01         // Direction change / zig-zag turn ends here
+#define ENTRY_FAST 0x02         // Velocity at or above the running threshold
+
+// Detector state latched per track, so a detection is counted once
+#define LATCH_LOITERING 0x01
+#define LATCH_RUNNING 0x02
+#define LATCH_UNUSUAL 0x04
+
+/**
+ * One block of tracks in packed form
+ */
+typedef struct {
+    uint32_t n;
+    uint32_t slot[BLOCK];
+
+    // Gathered
+    uint64_t t[BLOCK];          // Sample time
+    float x[BLOCK], y[BLOCK];   // Position added this frame
+    float px[BLOCK], py[BLOCK]; // Previous position
+    float pdx[BLOCK], pdy[BLOCK]; // Previous step
+    float dt[BLOCK];            // Time since the previous position (ms)
+    uint32_t count[BLOCK];      // Positions before this frame
+    int8_t pdir[BLOCK];         // Horizontal direction of the previous step
+
+    // Step results
+    float dx[BLOCK], dy[BLOCK];
+    float value[BLOCK];         // Step length (basic) or velocity in m/s (trajectory)
+    float speed[BLOCK];         // Speed for the decimated history
+    int8_t dir[BLOCK];
+    uint8_t flags[BLOCK];
+
+    // Detection inputs and results. The detector masks first hold the
+    // integer preconditions checked while gathering.
+    float dwell[BLOCK];         // Time since first seen (ms)
+    float vx[BLOCK], vy[BLOCK];
+    float avg[BLOCK];           // Mean step length over the window (basic)
+    float zone[BLOCK];          // Sensitivity of the zone the track is in (0 = none)
+    uint8_t span_ok[BLOCK];     // Ring covers the repeated-passes window (basic) / has dwell (trajectory)
+    uint8_t loitering[BLOCK];
+    uint8_t running[BLOCK];
+    uint8_t unusual[BLOCK];
+    float score[BLOCK];
+} Block;
+
+struct BehaviorBatch {
+    BehaviorBatchConfig config;
+    uint32_t capacity;
+    uint32_t ring;              // Ring length per slot
+    uint32_t sum_offset;        // Entry after the overwritten one whose value leaves the sum
+    float cos_turn;             // Turn when cos(angle) < cos_turn
+    TrackIndex* index;          // track_id -> slot, LRU order
+
+    // Per-slot state
+    uint32_t* count;            // Entries in the ring
+    uint32_t* head;             // Next ring entry to write
+    float* last_x;
+    float* last_y;
+    uint64_t* last_t;
+    float* last_dx;             // Step into the newest entry
+    float* last_dy;
+    int8_t* last_dir;
+    double* sum;                // Window sum of step length / velocity
+    uint32_t* turns;            // Entries in the window flagged ENTRY_TURN
+    uint32_t* fast;             // Entries in the window flagged ENTRY_FAST
+    uint64_t* first_seen;
+    uint8_t* latched;
+    float* zone_sensitivity;    // Most sensitive zone containing the newest entry, 0 if none
+    TrackSummary* summary;      // Decimated history beyond the ring
+
+    // Rings, slot-major: entry k of slot s at [s * ring + k]
+    float* ring_x;
+    float* ring_y;
+    float* ring_value;
+    uint64_t* ring_t;
+    uint8_t* ring_flags;
+
+    Block block;
+
+    // Statistics
+    uint64_t frames;
+    uint32_t total_tracks_analyzed;
+    uint32_t loitering_detections;
+    uint32_t running_detections;
+    uint32_t unusual_detections;
+    float avg_threat;
+    uint32_t high_threat_count;
+
+    pthread_mutex_t mutex;
+};
+
+// Ring position i (< 2 * ring) folded into the ring; the ring length is
+// not a compile-time constant, so this avoids a division per access
+static inline uint32_t ring_wrap(uint32_t i, uint32_t ring) {
+    return i >= ring ? i - ring : i;
+}
+
+static void apply_config(BehaviorBatch* batch, const BehaviorBatchConfig* config);
+static void reset_slot(BehaviorBatch* batch, uint32_t slot);
+static void gather_block(BehaviorBatch* batch, const TrackedObject* tracks, Block* blk);
+static void step_basic(Block* blk);
+static void step_trajectory(const BehaviorBatch* batch, Block* blk);
+static void scatter_block(BehaviorBatch* batch, const ZoneGrid* grid, Block* blk);
+static float zone_sensitivity(const ZoneGrid* grid, float x, float y);
+static void detect_basic(BehaviorBatch* batch, const TrackedObject* tracks, Block* blk);
+static void detect_trajectory(BehaviorBatch* batch, Block* blk);
+static bool loitering_trajectory(BehaviorBatch* batch, uint32_t slot);
+static bool running_trajectory(const BehaviorBatch* batch, uint32_t slot);
+static uint32_t write_results(BehaviorBatch* batch, TrackedObject* tracks, Block* blk,
+                              float* total_threat);
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+BehaviorBatch* behavior_batch_create(const BehaviorBatchConfig* config) {
+    if (!config) {
+        return NULL;
+    }
+
+    BehaviorBatch* batch = (BehaviorBatch*)calloc(1, sizeof(BehaviorBatch));
+    if (!batch) {
+        return NULL;
+    }
+
+    if (pthread_mutex_init(&batch->mutex, NULL) != 0) {
+        free(batch);
+        return NULL;
+    }
+
+    bool basic = config->rules == BEHAVIOR_RULES_BASIC;
+    uint32_t max_tracks = basic ? config->basic.max_tracks : config->trajectory.max_tracks;
+
+    batch->capacity = max_tracks ? max_tracks : DEFAULT_MAX_TRACKS;
+    batch->ring = basic ? BASIC_RING : TRAJECTORY_RING;
+    batch->sum_offset = basic ? 1 : 0;
+
+    size_t cap = batch->capacity;
+    size_t entries = cap * batch->ring;
+
+    batch->index = track_index_create(batch->capacity);
+    batch->count = (uint32_t*)calloc(cap, sizeof(uint32_t));
+    batch->head = (uint32_t*)calloc(cap, sizeof(uint32_t));
+    batch->last_x = (float*)calloc(cap, sizeof(float));
+    batch->last_y = (float*)calloc(cap, sizeof(float));
+    batch->last_t = (uint64_t*)calloc(cap, sizeof(uint64_t));
+    batch->last_dx = (float*)calloc(cap, sizeof(float));
+    batch->last_dy = (float*)calloc(cap, sizeof(float));
+    batch->last_dir = (int8_t*)calloc(cap, sizeof(int8_t));
+    batch->sum = (double*)calloc(cap, sizeof(double));
+    batch->turns = (uint32_t*)calloc(cap, sizeof(uint32_t));
+    batch->fast = (uint32_t*)calloc(cap, sizeof(uint32_t));
+    batch->first_seen = (uint64_t*)calloc(cap, sizeof(uint64_t));
+    batch->latched = (uint8_t*)calloc(cap, sizeof(uint8_t));
+    batch->zone_sensitivity = (float*)calloc(cap, sizeof(float));
+    batch->summary = (TrackSummary*)calloc(cap, sizeof(TrackSummary));
+    batch->ring_x = (float*)calloc(entries, sizeof(float));
+    batch->ring_y = (float*)calloc(entries, sizeof(float));
+    batch->ring_value = (float*)calloc(entries, sizeof(float));
+    batch->ring_t = (uint64_t*)calloc(entries, sizeof(uint64_t));
+    batch->ring_flags = (uint8_t*)calloc(entries, sizeof(uint8_t));
+
+    if (!batch->index || !batch->count || !batch->head || !batch->last_x ||
+        !batch->last_y || !batch->last_t || !batch->last_dx || !batch->last_dy ||
+        !batch->last_dir || !batch->sum || !batch->turns || !batch->fast ||
+        !batch->first_seen || !batch->latched || !batch->zone_sensitivity ||
+        !batch->summary ||
+        !batch->ring_x || !batch->ring_y || !batch->ring_value || !batch->ring_t ||
+        !batch->ring_flags) {
+        behavior_batch_destroy(batch);
+        return NULL;
+    }
+
+    batch->config.rules = config->rules;
+    apply_config(batch, config);
+
+    return batch;
+}
+
+uint32_t behavior_batch_analyze(
+    BehaviorBatch* batch,
+    TrackedObject* tracks,
+    uint32_t num_tracks
+) {
+    if (!batch || (num_tracks > 0 && !tracks)) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&batch->mutex);
+
+    bool basic = batch->config.rules == BEHAVIOR_RULES_BASIC;
+    const BehaviorAnalyzerConfig* traj = &batch->config.trajectory;
+
+    // One zone view for the whole frame
+    const ZoneGrid* grid = NULL;
+    if (!basic && traj->enable_zone_analysis && traj->zone_map) {
+        grid = zone_map_acquire(traj->zone_map);
+    }
+
+    Block* blk = &batch->block;
+    uint32_t behaviors_flagged = 0;
+    float total_threat = 0.0f;
+    batch->high_threat_count = 0;
+
+    for (uint32_t base = 0; base < num_tracks; base += BLOCK) {
+        blk->n = num_tracks - base < BLOCK ? num_tracks - base : BLOCK;
+
+        gather_block(batch, &tracks[base], blk);
+
+        if (basic) {
+            step_basic(blk);
+        } else {
+            step_trajectory(batch, blk);
+        }
+
+        scatter_block(batch, grid, blk);
+
+        if (basic) {
+            detect_basic(batch, &tracks[base], blk);
+        } else {
+            detect_trajectory(batch, blk);
+        }
+
+        behaviors_flagged += write_results(batch, &tracks[base], blk, &total_threat);
+    }
+
+    if (grid) {
+        zone_map_release(traj->zone_map, grid);
+    }
+
+    if (num_tracks > 0) {
+        batch->avg_threat = 0.9f * batch->avg_threat + 0.1f * (total_threat / num_tracks);
+    }
+    batch->frames++;
+
+    pthread_mutex_unlock(&batch->mutex);
+    return behaviors_flagged;
+}
+
+void behavior_batch_update_config(
+    BehaviorBatch* batch,
+    const BehaviorBatchConfig* config
+) {
+    if (!batch || !config) {
+        return;
+    }
+
+    pthread_mutex_lock(&batch->mutex);
+    apply_config(batch, config);
+    pthread_mutex_unlock(&batch->mutex);
+}
+
+void behavior_batch_get_config(BehaviorBatch* batch, BehaviorBatchConfig* config) {
+    if (!batch || !config) {
+        return;
+    }
+
+    pthread_mutex_lock(&batch->mutex);
+    *config = batch->config;
+    pthread_mutex_unlock(&batch->mutex);
+}
+
+bool behavior_batch_remove_track(BehaviorBatch* batch, uint32_t track_id) {
+    if (!batch) {
+        return false;
+    }
+
+    pthread_mutex_lock(&batch->mutex);
+
+    int32_t slot = track_index_remove(batch->index, track_id);
+    if (slot >= 0) {
+        reset_slot(batch, (uint32_t)slot);
+    }
+
+    pthread_mutex_unlock(&batch->mutex);
+    return slot >= 0;
+}
+
+void behavior_batch_reset(BehaviorBatch* batch) {
+    if (!batch) {
+        return;
+    }
+
+    pthread_mutex_lock(&batch->mutex);
+
+    track_index_clear(batch->index);
+    for (uint32_t s = 0; s < batch->capacity; s++) {
+        reset_slot(batch, s);
+    }
+
+    batch->frames = 0;
+    batch->total_tracks_analyzed = 0;
+    batch->loitering_detections = 0;
+    batch->running_detections = 0;
+    batch->unusual_detections = 0;
+    batch->avg_threat = 0.0f;
+    batch->high_threat_count = 0;
+
+    pthread_mutex_unlock(&batch->mutex);
+}
+
+void behavior_batch_get_stats(BehaviorBatch* batch, BehaviorBatchStats* stats) {
+    if (!batch || !stats) {
+        return;
+    }
+
+    pthread_mutex_lock(&batch->mutex);
+
+    stats->frames = batch->frames;
+    stats->active_tracks = track_index_count(batch->index);
+    stats->total_tracks_analyzed = batch->total_tracks_analyzed;
+    stats->loitering_detections = batch->loitering_detections;
+    stats->running_detections = batch->running_detections;
+    stats->unusual_movement_detections = batch->unusual_detections;
+    stats->avg_threat_score = batch->avg_threat;
+    stats->high_threat_count = batch->high_threat_count;
+
+    pthread_mutex_unlock(&batch->mutex);
+}
+
+void behavior_batch_destroy(BehaviorBatch* batch) {
+    if (!batch) {
+        return;
+    }
+
+    pthread_mutex_destroy(&batch->mutex);
+    track_index_destroy(batch->index);
+    free(batch->count);
+    free(batch->head);
+    free(batch->last_x);
+    free(batch->last_y);
+    free(batch->last_t);
+    free(batch->last_dx);
+    free(batch->last_dy);
+    free(batch->last_dir);
+    free(batch->sum);
+    free(batch->turns);
+    free(batch->fast);
+    free(batch->first_seen);
+    free(batch->latched);
+    free(batch->zone_sensitivity);
+    free(batch->summary);
+    free(batch->ring_x);
+    free(batch->ring_y);
+    free(batch->ring_value);
+    free(batch->ring_t);
+    free(batch->ring_flags);
+    free(batch);
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * Take a new configuration, keeping the rule set and capacity
+ */
+static void apply_config(BehaviorBatch* batch, const BehaviorBatchConfig* config) {
+    BehaviorRules rules = batch->config.rules;
+
+    batch->config = *config;
+    batch->config.rules = rules;
+    batch->config.basic.max_tracks = batch->capacity;
+    batch->config.trajectory.max_tracks = batch->capacity;
+
+    // |angle| > threshold  <=>  cos(angle) < cos(threshold) for 0..180 degrees
+    float threshold = config->trajectory.zigzag_threshold;
+    if (threshold < 0.0f) {
+        batch->cos_turn = 2.0f;
+    } else if (threshold >= 180.0f) {
+        batch->cos_turn = -2.0f;
+    } else {
+        batch->cos_turn = cosf(threshold * (float)M_PI / 180.0f);
+    }
+}
+
+static void reset_slot(BehaviorBatch* batch, uint32_t slot) {
+    batch->count[slot] = 0;
+    batch->head[slot] = 0;
+    batch->last_x[slot] = 0.0f;
+    batch->last_y[slot] = 0.0f;
+    batch->last_t[slot] = 0;
+    batch->last_dx[slot] = 0.0f;
+    batch->last_dy[slot] = 0.0f;
+    batch->last_dir[slot] = 0;
+    batch->sum[slot] = 0.0;
+    batch->turns[slot] = 0;
+    batch->fast[slot] = 0;
+    batch->first_seen[slot] = 0;
+    batch->latched[slot] = 0;
+    batch->zone_sensitivity[slot] = 0.0f;
+    track_summary_reset(&batch->summary[slot]);
+}
+
+/**
+ * Resolve slots and pack the block's inputs
+ */
+static void gather_block(BehaviorBatch* batch, const TrackedObject* tracks, Block* blk) {
+    bool basic = batch->config.rules == BEHAVIOR_RULES_BASIC;
+
+    for (uint32_t i = 0; i < blk->n; i++) {
+        const TrackedObject* track = &tracks[i];
+        const BoundingBox* box = &track->current_bbox;
+
+        // Existing history, else a free slot, else the least recently
+        // updated track's slot
+        bool is_new = false;
+        int32_t found = track_index_acquire(batch->index, track->track_id, &is_new, NULL);
+        uint32_t slot = found >= 0 ? (uint32_t)found : 0;
+        if (is_new) {
+            reset_slot(batch, slot);
+            batch->total_tracks_analyzed++;
+        }
+
+        blk->slot[i] = slot;
+        blk->t[i] = track->last_seen_ms;
+        blk->count[i] = batch->count[slot];
+        blk->px[i] = batch->last_x[slot];
+        blk->py[i] = batch->last_y[slot];
+        blk->pdx[i] = batch->last_dx[slot];
+        blk->pdy[i] = batch->last_dy[slot];
+        blk->pdir[i] = batch->last_dir[slot];
+
+        uint64_t prev_t = batch->last_t[slot];
+        if (basic) {
+            // behavior.c: box corner; speed only for strictly later samples
+            blk->x[i] = box->x;
+            blk->y[i] = box->y;
+            blk->dt[i] = track->last_seen_ms > prev_t ? (float)(track->last_seen_ms - prev_t) : 0.0f;
+        } else {
+            // behavior_analysis.c: box centre; any nonzero difference
+            blk->x[i] = box->x + box->width / 2.0f;
+            blk->y[i] = box->y + box->height / 2.0f;
+            blk->dt[i] = (float)(track->last_seen_ms - prev_t);
+        }
+    }
+}
+
+/**
+ * Step length, horizontal direction and direction changes (behavior.c)
+ */
+static void step_basic(Block* blk) {
+    for (uint32_t i = 0; i < blk->n; i++) {
+        float dx = blk->x[i] - blk->px[i];
+        float dy = blk->y[i] - blk->py[i];
+        float length = sqrtf(dx * dx + dy * dy);
+        bool has_prev = blk->count[i] > 0;
+        bool later = blk->dt[i] > 0.0f;
+        float dt = later ? blk->dt[i] : 1.0f;
+        float speed = length * 1000.0f / dt;
+
+        int8_t dir = dx > 0.0f ? 1 : -1;
+        dir = has_prev ? dir : 0;
+
+        blk->dx[i] = dx;
+        blk->dy[i] = dy;
+        blk->value[i] = has_prev ? length : 0.0f;
+        blk->speed[i] = (has_prev & later) ? speed : 0.0f;
+        blk->dir[i] = dir;
+        blk->flags[i] = ((blk->count[i] > 1) & (dir != blk->pdir[i])) ? ENTRY_TURN : 0;
+    }
+}
+
+/**
+ * Velocity in m/s and zig-zag turns (behavior_analysis.c)
+ *
+ * The turn test compares the cosine of the angle between the previous and
+ * current step instead of differencing two atan2() angles. A zero-length
+ * step counts as pointing along +x, which is what atan2(0, 0) gives.
+ */
+static void step_trajectory(const BehaviorBatch* batch, Block* blk) {
+    const BehaviorAnalyzerConfig* cfg = &batch->config.trajectory;
+    float meters_per_unit = cfg->meters_per_normalized_unit;
+    float fast_threshold = cfg->running_velocity_threshold;
+    float cos_turn = batch->cos_turn;
+
+    for (uint32_t i = 0; i < blk->n; i++) {
+        float dx = blk->x[i] - blk->px[i];
+        float dy = blk->y[i] - blk->py[i];
+        float dist = sqrtf(dx * dx + dy * dy);
+        float dt_sec = blk->dt[i] / 1000.0f;
+        bool has_prev = blk->count[i] > 0;
+        bool later = dt_sec > 0.0f;
+
+        float velocity = (dist * meters_per_unit) / (later ? dt_sec : 1.0f);
+        velocity = (has_prev & later) ? velocity : 0.0f;
+
+        float ax = blk->pdx[i];
+        float ay = blk->pdy[i];
+        float la = sqrtf(ax * ax + ay * ay);
+        float bx = dx;
+        float by = dy;
+        float lb = dist;
+        ax = la > 0.0f ? ax : 1.0f;
+        ay = la > 0.0f ? ay : 0.0f;
+        la = la > 0.0f ? la : 1.0f;
+        bx = lb > 0.0f ? bx : 1.0f;
+        by = lb > 0.0f ? by : 0.0f;
+        lb = lb > 0.0f ? lb : 1.0f;
+        bool turn = (blk->count[i] >= 2) & ((ax * bx + ay * by) < cos_turn * la * lb);
+
+        blk->dx[i] = has_prev ? dx : 0.0f;
+        blk->dy[i] = has_prev ? dy : 0.0f;
+        blk->value[i] = velocity;
+        blk->speed[i] = velocity;
+        blk->dir[i] = 0;
+        blk->flags[i] = (uint8_t)((turn ? ENTRY_TURN : 0) |
+                                  (velocity >= fast_threshold ? ENTRY_FAST : 0));
+    }
+}
+
+/**
+ * Append the block's positions to their rings and move the window sums
+ */
+static void scatter_block(BehaviorBatch* batch, const ZoneGrid* grid, Block* blk) {
+    bool basic = batch->config.rules == BEHAVIOR_RULES_BASIC;
+    uint32_t ring = batch->ring;
+
+    for (uint32_t i = 0; i < blk->n; i++) {
+        uint32_t s = blk->slot[i];
+        size_t base = (size_t)s * ring;
+        uint32_t h = batch->head[s];
+
+        // When full, the entry at the head drops out of the window
+        if (batch->count[s] == ring) {
+            batch->sum[s] -= batch->ring_value[base + ring_wrap(h + batch->sum_offset, ring)];
+            batch->turns[s] -= (batch->ring_flags[base + ring_wrap(h + 2, ring)] & ENTRY_TURN) != 0;
+            batch->fast[s] -= (batch->ring_flags[base + h] & ENTRY_FAST) != 0;
+        }
+
+        batch->ring_x[base + h] = blk->x[i];
+        batch->ring_y[base + h] = blk->y[i];
+        batch->ring_t[base + h] = blk->t[i];
+        batch->ring_value[base + h] = blk->value[i];
+        batch->ring_flags[base + h] = blk->flags[i];
+
+        batch->sum[s] += blk->value[i];
+        batch->turns[s] += (blk->flags[i] & ENTRY_TURN) != 0;
+        batch->fast[s] += (blk->flags[i] & ENTRY_FAST) != 0;
+
+        batch->head[s] = ring_wrap(h + 1, ring);
+        if (batch->count[s] < ring) {
+            batch->count[s]++;
+        }
+
+        batch->last_x[s] = blk->x[i];
+        batch->last_y[s] = blk->y[i];
+        batch->last_t[s] = blk->t[i];
+        batch->last_dx[s] = blk->dx[i];
+        batch->last_dy[s] = blk->dy[i];
+        batch->last_dir[s] = blk->dir[i];
+
+        track_summary_add(&batch->summary[s], blk->x[i], blk->y[i], blk->speed[i], blk->t[i]);
+
+        if (!basic) {
+            if (grid) {
+                batch->zone_sensitivity[s] = zone_sensitivity(grid, blk->x[i], blk->y[i]);
+            }
+            if (batch->first_seen[s] == 0) {
+                batch->first_seen[s] = blk->t[i];
+            }
+        }
+    }
+}
+
+/**
+ * Sensitivity of the most sensitive zone containing a point, 0 if none
+ */
+static float zone_sensitivity(const ZoneGrid* grid, float x, float y) {
+    uint32_t hits = zone_grid_query(grid, x, y, ZONE_CLASS_ALL);
+
+    float best = 0.0f;
+    while (hits) {
+        const Zone* zone = zone_grid_zone(grid, (uint32_t)__builtin_ctz(hits));
+        best = zone->sensitivity > best ? zone->sensitivity : best;
+        hits &= hits - 1;
+    }
+
+    return best;
+}
+
+/**
+ * Loitering, running and repeated passes with behavior.c scoring
+ */
+static void detect_basic(BehaviorBatch* batch, const TrackedObject* tracks, Block* blk) {
+    const BehaviorConfig* cfg = &batch->config.basic;
+    uint32_t ring = batch->ring;
+    uint32_t n = blk->n;
+
+    for (uint32_t i = 0; i < n; i++) {
+        const TrackedObject* track = &tracks[i];
+        uint32_t s = blk->slot[i];
+        size_t base = (size_t)s * ring;
+        uint32_t count = batch->count[s];
+        uint64_t dwell = track->last_seen_ms - track->first_seen_ms;
+
+        uint64_t newest_ms = batch->ring_t[base + ring_wrap(batch->head[s] + ring - 1, ring)];
+        uint64_t oldest_ms = batch->ring_t[base + ring_wrap(batch->head[s] + ring - count, ring)];
+
+        blk->count[i] = count;
+        blk->dwell[i] = (float)dwell;
+        blk->vx[i] = track->velocity_x;
+        blk->vy[i] = track->velocity_y;
+        blk->avg[i] = count ? (float)(batch->sum[s] / count) : 0.0f;
+        blk->span_ok[i] = newest_ms - oldest_ms >= cfg->repeated_passes_window_ms;
+        blk->loitering[i] = dwell >= cfg->loitering_threshold_ms && count >= 10;
+        blk->running[i] = track->frame_count >= cfg->running_frames_threshold;
+        blk->unusual[i] = count >= cfg->repeated_passes_count &&
+                          batch->turns[s] >= cfg->repeated_passes_count;
+    }
+
+    float loiter_threshold = (float)cfg->loitering_threshold_ms;
+    float movement_threshold = cfg->loitering_movement_threshold;
+    float running_threshold = cfg->running_velocity_threshold;
+    float loitering_weight = cfg->loitering_weight;
+    float running_weight = cfg->running_weight;
+
+    for (uint32_t i = 0; i < n; i++) {
+        float velocity = sqrtf(blk->vx[i] * blk->vx[i] + blk->vy[i] * blk->vy[i]);
+
+        // Velocity in pixels/second at 416 px, 10 fps (as behavior.c)
+        float velocity_pixels_per_sec = velocity * 416.0f * 10.0f;
+
+        uint8_t loitering = blk->loitering[i] & (blk->avg[i] < movement_threshold);
+        uint8_t running = blk->running[i] & (velocity_pixels_per_sec >= running_threshold);
+
+        float loiter_severity = fminf(blk->dwell[i] / loiter_threshold, 1.0f);
+        float running_severity = fminf(velocity / running_threshold, 1.0f);
+
+        float score = 0.0f;
+        score += loitering ? loiter_severity * loitering_weight : 0.0f;
+        score += running ? running_severity * running_weight : 0.0f;
+
+        blk->loitering[i] = loitering;
+        blk->running[i] = running;
+        blk->score[i] = score;
+    }
+
+    // Windows longer than the ring are read from the decimated history;
+    // jitter below the loitering movement threshold is not a pass
+    for (uint32_t i = 0; i < n; i++) {
+        if (blk->span_ok[i] || blk->count[i] < cfg->repeated_passes_count) {
+            continue;
+        }
+
+        uint32_t s = blk->slot[i];
+        uint64_t newest_ms = batch->last_t[s];
+        uint64_t window_ms = cfg->repeated_passes_window_ms;
+        uint64_t window_start_ms = newest_ms > window_ms ? newest_ms - window_ms : 0;
+
+        TrackSummaryStats window;
+        track_summary_window_stats(&batch->summary[s], window_start_ms,
+                                   cfg->loitering_movement_threshold, &window);
+        blk->unusual[i] = window.reversals_x >= cfg->repeated_passes_count;
+    }
+
+    float passes_weight = cfg->repeated_passes_weight;
+    for (uint32_t i = 0; i < n; i++) {
+        float score = blk->score[i] + (blk->unusual[i] ? passes_weight : 0.0f);
+        blk->score[i] = fminf(score, 1.0f);
+    }
+}
+
+/**
+ * Loitering, running and zig-zag with behavior_analysis.c scoring
+ */
+static void detect_trajectory(BehaviorBatch* batch, Block* blk) {
+    const BehaviorAnalyzerConfig* cfg = &batch->config.trajectory;
+    uint32_t n = blk->n;
+
+    // Loitering and running candidates still need the window contents
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t s = blk->slot[i];
+        uint32_t count = batch->count[s];
+        float dwell = (float)(batch->last_t[s] - batch->first_seen[s]);
+
+        blk->dwell[i] = dwell;
+        blk->zone[i] = batch->zone_sensitivity[s];
+        blk->span_ok[i] = batch->first_seen[s] > 0 && batch->last_t[s] > 0;
+        blk->loitering[i] = count >= 10 && !(dwell < cfg->loitering_dwell_time_ms);
+        blk->running[i] = count >= 5 && batch->fast[s] >= 3;
+        blk->unusual[i] = count >= 6 && batch->turns[s] >= cfg->zigzag_count_threshold;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        if (blk->loitering[i]) {
+            blk->loitering[i] = loitering_trajectory(batch, blk->slot[i]);
+        }
+        if (blk->running[i]) {
+            blk->running[i] = running_trajectory(batch, blk->slot[i]);
+        }
+    }
+
+    float weight_loitering = cfg->weight_loitering;
+    float weight_running = cfg->weight_running;
+    float weight_unusual = cfg->weight_unusual_movement;
+    float weight_zone = cfg->weight_zone;
+    float weight_dwell = cfg->weight_dwell_time;
+
+    for (uint32_t i = 0; i < n; i++) {
+        float score = 0.0f;
+        score += blk->loitering[i] ? weight_loitering : 0.0f;
+        score += blk->running[i] ? weight_running : 0.0f;
+        score += blk->unusual[i] ? weight_unusual : 0.0f;
+        score += weight_zone * blk->zone[i];
+
+        // Escalate by weight_dwell_time per minute of presence
+        float dwell_minutes = blk->dwell[i] / 60000.0f;
+        score += blk->span_ok[i] ? weight_dwell * dwell_minutes : 0.0f;
+
+        blk->score[i] = score > 1.0f ? 1.0f : score;
+    }
+}
+
+/**
+ * Stayed within the loitering radius of where the dwell window starts, at
+ * low average speed
+ */
+static bool loitering_trajectory(BehaviorBatch* batch, uint32_t slot) {
+    const BehaviorAnalyzerConfig* cfg = &batch->config.trajectory;
+    uint32_t ring = batch->ring;
+    uint32_t count = batch->count[slot];
+    size_t base = (size_t)slot * ring;
+    uint32_t earliest = ring_wrap(batch->head[slot] + ring - count, ring);
+    uint64_t window_start_ms = batch->last_t[slot] - (uint64_t)cfg->loitering_dwell_time_ms;
+
+    float start_x, start_y;
+    float min_x, min_y, max_x, max_y;
+    float avg_velocity;
+
+    if (window_start_ms >= batch->ring_t[base + earliest]) {
+        // Dwell window fits in the ring: extents over the valid entries
+        const float* rx = &batch->ring_x[base];
+        const float* ry = &batch->ring_y[base];
+        min_x = max_x = rx[0];
+        min_y = max_y = ry[0];
+        for (uint32_t k = 1; k < count; k++) {
+            min_x = rx[k] < min_x ? rx[k] : min_x;
+            max_x = rx[k] > max_x ? rx[k] : max_x;
+            min_y = ry[k] < min_y ? ry[k] : min_y;
+            max_y = ry[k] > max_y ? ry[k] : max_y;
+        }
+        start_x = rx[earliest];
+        start_y = ry[earliest];
+        avg_velocity = (float)(batch->sum[slot] / count);
+    } else {
+        // Longer than the ring: use the decimated history
+        TrackSummaryStats window;
+        if (!track_summary_window_stats(&batch->summary[slot], window_start_ms, 0.0f, &window)) {
+            return false;
+        }
+
+        start_x = window.start_x;
+        start_y = window.start_y;
+        min_x = window.min_x;
+        max_x = window.max_x;
+        min_y = window.min_y;
+        max_y = window.max_y;
+        avg_velocity = window.mean_speed;
+    }
+
+    float reach_x = fmaxf(start_x - min_x, max_x - start_x);
+    float reach_y = fmaxf(start_y - min_y, max_y - start_y);
+    float max_distance = sqrtf(reach_x * reach_x + reach_y * reach_y);
+
+    float max_distance_meters = normalized_to_meters(max_distance, cfg->meters_per_normalized_unit);
+
+    return !(max_distance_meters > cfg->loitering_radius_meters) &&
+           !(avg_velocity > cfg->loitering_velocity_threshold);
+}
+
+/**
+ * Fast entries in the window span at least the running duration
+ */
+static bool running_trajectory(const BehaviorBatch* batch, uint32_t slot) {
+    uint32_t ring = batch->ring;
+    uint32_t count = batch->count[slot];
+    size_t base = (size_t)slot * ring;
+    const uint64_t* rt = &batch->ring_t[base];
+    const uint8_t* rf = &batch->ring_flags[base];
+
+    uint64_t first_ms = UINT64_MAX;
+    uint64_t last_ms = 0;
+    for (uint32_t k = 0; k < count; k++) {
+        bool fast = (rf[k] & ENTRY_FAST) != 0;
+        first_ms = (fast && rt[k] < first_ms) ? rt[k] : first_ms;
+        last_ms = (fast && rt[k] > last_ms) ? rt[k] : last_ms;
+    }
+
+    uint64_t duration = last_ms - first_ms;
+    return !(duration < batch->config.trajectory.running_duration_ms);
+}
+
+/**
+ * Write flags and scores back to the tracks and count new detections
+ */
+static uint32_t write_results(BehaviorBatch* batch, TrackedObject* tracks, Block* blk,
+                              float* total_threat) {
+    bool basic = batch->config.rules == BEHAVIOR_RULES_BASIC;
+    BehaviorFlags unusual_flag = basic ? BEHAVIOR_REPEATED_PASSES : BEHAVIOR_SUSPICIOUS_MOVEMENT;
+    uint32_t flagged = 0;
+
+    for (uint32_t i = 0; i < blk->n; i++) {
+        BehaviorFlags behaviors = BEHAVIOR_NORMAL;
+        uint8_t latched = 0;
+
+        if (blk->loitering[i]) {
+            behaviors |= BEHAVIOR_LOITERING;
+            latched |= LATCH_LOITERING;
+        }
+        if (blk->running[i]) {
+            behaviors |= BEHAVIOR_RUNNING;
+            latched |= LATCH_RUNNING;
+        }
+        if (blk->unusual[i]) {
+            behaviors |= unusual_flag;
+            latched |= LATCH_UNUSUAL;
+        }
+
+        uint32_t s = blk->slot[i];
+        uint8_t started = latched & (uint8_t)~batch->latched[s];
+        batch->loitering_detections += (started & LATCH_LOITERING) != 0;
+        batch->running_detections += (started & LATCH_RUNNING) != 0;
+        batch->unusual_detections += (started & LATCH_UNUSUAL) != 0;
+        batch->latched[s] = latched;
+
+        tracks[i].behaviors = behaviors;
+        tracks[i].threat_score = blk->score[i];
+
+        flagged += blk->loitering[i] + blk->running[i] + blk->unusual[i];
+        *total_threat += blk->score[i];
+        if (blk->score[i] > HIGH_THREAT) {
+            batch->high_threat_count++;
+        }
+    }
+
+    return flagged;
+}
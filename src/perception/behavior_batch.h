@@ -0,0 +1,147 @@
+/**
+ * @file behavior_batch.h
+ * @brief Batched behavior analysis for OMNISIGHT
+ *
+ * One analyzer for all tracks of a frame. Per-track history lives in
+ * structure-of-arrays form indexed by history slot; each frame gathers the
+ * tracks into short packed blocks, computes steps, velocities, turns,
+ * dwell times, detector masks and threat scores in straight-line loops
+ * across the block, and scatters only the ring updates back per track.
+ *
+ * The detectors and scoring of both older analyzers are available as rule
+ * sets, so either can be replaced without changing results:
+ * - BEHAVIOR_RULES_BASIC: behavior.h (behavior_analyze())
+ * - BEHAVIOR_RULES_TRAJECTORY: behavior_analysis.h (behavior_analyzer_analyze())
+ */
+
+#ifndef OMNISIGHT_BEHAVIOR_BATCH_H
+#define OMNISIGHT_BEHAVIOR_BATCH_H
+
+#include "perception.h"
+#include "behavior.h"
+#include "behavior_analysis.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct BehaviorBatch BehaviorBatch;
+
+/**
+ * Detector and scoring rules
+ */
+typedef enum {
+    BEHAVIOR_RULES_BASIC = 0,       // Loitering, running, repeated passes (BehaviorConfig)
+    BEHAVIOR_RULES_TRAJECTORY       // Loitering, running, zig-zag, zones (BehaviorAnalyzerConfig)
+} BehaviorRules;
+
+/**
+ * Batch analyzer configuration
+ */
+typedef struct {
+    BehaviorRules rules;
+    BehaviorConfig basic;               // Used with BEHAVIOR_RULES_BASIC
+    BehaviorAnalyzerConfig trajectory;  // Used with BEHAVIOR_RULES_TRAJECTORY
+} BehaviorBatchConfig;
+
+/**
+ * Batch analyzer statistics
+ */
+typedef struct {
+    uint64_t frames;                    // behavior_batch_analyze() calls
+    uint32_t active_tracks;             // Tracks with a history
+    uint32_t total_tracks_analyzed;     // Histories ever started
+    uint32_t loitering_detections;      // Tracks that started loitering
+    uint32_t running_detections;        // Tracks that started running
+    uint32_t unusual_movement_detections; // Zig-zag (trajectory) or repeated passes (basic)
+    float avg_threat_score;             // Running average of the per-frame mean
+    uint32_t high_threat_count;         // Tracks above 0.7 in the last frame
+} BehaviorBatchStats;
+
+/**
+ * Create a batch analyzer
+ *
+ * Capacity is the max_tracks of the selected rule set (0 = 100); beyond
+ * it the least recently updated track loses its history.
+ *
+ * @param config Analyzer configuration
+ * @return Analyzer instance, NULL on failure
+ */
+BehaviorBatch* behavior_batch_create(const BehaviorBatchConfig* config);
+
+/**
+ * Add one frame of tracks and analyze them
+ *
+ * Each track's history is advanced with its current box at last_seen_ms,
+ * then behavior flags and threat score are written back to the track.
+ *
+ * @param batch Analyzer instance
+ * @param tracks Tracks of the frame (modified in-place)
+ * @param num_tracks Number of tracks
+ * @return Number of behaviors flagged in this frame
+ */
+uint32_t behavior_batch_analyze(
+    BehaviorBatch* batch,
+    TrackedObject* tracks,
+    uint32_t num_tracks
+);
+
+/**
+ * Update thresholds and weights
+ *
+ * The rule set and capacity are fixed at creation.
+ *
+ * @param batch Analyzer instance
+ * @param config New configuration
+ */
+void behavior_batch_update_config(
+    BehaviorBatch* batch,
+    const BehaviorBatchConfig* config
+);
+
+/**
+ * Get the current configuration
+ *
+ * @param batch Analyzer instance
+ * @param config Output configuration
+ */
+void behavior_batch_get_config(BehaviorBatch* batch, BehaviorBatchConfig* config);
+
+/**
+ * Forget a track's history
+ *
+ * @param batch Analyzer instance
+ * @param track_id Deleted track
+ * @return true if the track had a history
+ */
+bool behavior_batch_remove_track(BehaviorBatch* batch, uint32_t track_id);
+
+/**
+ * Clear all histories and statistics
+ *
+ * @param batch Analyzer instance
+ */
+void behavior_batch_reset(BehaviorBatch* batch);
+
+/**
+ * Get analyzer statistics
+ *
+ * @param batch Analyzer instance
+ * @param stats Output statistics
+ */
+void behavior_batch_get_stats(BehaviorBatch* batch, BehaviorBatchStats* stats);
+
+/**
+ * Destroy analyzer
+ *
+ * @param batch Analyzer instance
+ */
+void behavior_batch_destroy(BehaviorBatch* batch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OMNISIGHT_BEHAVIOR_BATCH_H
@@ -0,0 +1,725 @@
+/**
+ * @file group_analyzer.c
+ * @brief Group and crowd analysis
+ *
+ * Per frame: tracks are counting-sorted into a uniform grid whose cells
+ * are at least the link distance wide, so every linked pair lies in the
+ * same or in adjacent cells. Each cell is compared with itself and with
+ * four forward neighbours (every pair once), and linked pairs are merged
+ * with union-find. Clusters then vote for the previous group of their
+ * members; votes are resolved greedily from the largest, so each old
+ * group id passes to at most one new cluster.
+ */
+
+#include "group_analyzer.h"
+#include "track_index.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+
+#define DEFAULT_LINK_DISTANCE 0.08f
+#define DEFAULT_VELOCITY_TOLERANCE 0.01f
+#define DEFAULT_MIN_GROUP_SIZE 2
+#define DEFAULT_CROWD_SIZE 8
+#define DEFAULT_GROWTH_WINDOW_MS 5000
+#define DEFAULT_MAX_TRACKS 100
+#define MAX_GRID_SIDE 256
+#define MIN_EXTENT_AREA 1e-4f       // Keeps density finite for stacked boxes
+
+/**
+ * One (cluster, previous group) vote count
+ */
+typedef struct {
+    uint32_t votes;
+    uint32_t cluster;
+    uint32_t prev;                  // Index into the previous frame's groups
+    uint32_t prev_id;
+} Vote;
+
+struct GroupAnalyzer {
+    GroupAnalyzerConfig config;
+    uint32_t capacity;              // Tracks per frame
+    uint32_t max_groups;
+    uint32_t grid_side;
+    float link_sq;
+    float tolerance_sq;
+
+    // Packed tracks of the current frame
+    float* px;
+    float* py;
+    float* vx;
+    float* vy;
+    uint32_t* src;                  // Index into the caller's tracks
+    uint32_t* slot;                 // TrackIndex slot
+
+    // Spatial hash (counting sort by cell)
+    uint32_t* cell;
+    uint32_t* cell_start;           // grid_side^2 + 1
+    uint32_t* order;
+
+    // Union-find and clusters
+    uint32_t* parent;
+    uint32_t* size;
+    int32_t* cluster;               // Per track: cluster index, -1 if ungrouped
+    uint64_t* keys;                 // (cluster << 32 | prev) per voting member
+    Vote* votes;
+    int32_t* cluster_prev;          // Inherited previous group, -1 = new
+    uint8_t* prev_taken;
+
+    // Per-track state across frames
+    TrackIndex* index;
+    uint64_t* slot_frame;           // Frame the slot was last seen in
+    int32_t* slot_group;            // Index into groups of that frame, -1 = none
+
+    // Groups of the latest frame (current) and the one before (scratch)
+    GroupInfo* groups;
+    GroupInfo* scratch;
+    uint32_t num_groups;
+    uint32_t next_group_id;
+    uint64_t last_update_ms;
+
+    GroupAnalyzerStats stats;
+    pthread_mutex_t mutex;
+};
+
+static void apply_defaults(GroupAnalyzerConfig* config);
+static void free_analyzer(GroupAnalyzer* analyzer);
+static uint32_t gather_tracks(GroupAnalyzer* analyzer, const TrackedObject* tracks,
+                              uint32_t num_tracks);
+static void bucket_tracks(GroupAnalyzer* analyzer, uint32_t count);
+static uint32_t link_tracks(GroupAnalyzer* analyzer, uint32_t count);
+static uint32_t find_root(uint32_t* parent, uint32_t i);
+static void unite(GroupAnalyzer* analyzer, uint32_t a, uint32_t b);
+static uint32_t label_clusters(GroupAnalyzer* analyzer, uint32_t count);
+static void match_clusters(GroupAnalyzer* analyzer, uint32_t count, uint32_t clusters);
+static void build_groups(GroupAnalyzer* analyzer, const TrackedObject* tracks,
+                         uint32_t count, uint32_t clusters, uint64_t timestamp_ms);
+static int compare_keys(const void* a, const void* b);
+static int compare_votes(const void* a, const void* b);
+static uint64_t get_time_us(void);
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+GroupAnalyzer* group_analyzer_create(const GroupAnalyzerConfig* config) {
+    GroupAnalyzer* analyzer = (GroupAnalyzer*)calloc(1, sizeof(GroupAnalyzer));
+    if (!analyzer) {
+        return NULL;
+    }
+
+    if (config) {
+        analyzer->config = *config;
+    }
+    apply_defaults(&analyzer->config);
+
+    uint32_t n = analyzer->config.max_tracks;
+    float link = analyzer->config.link_distance;
+    float tolerance = analyzer->config.velocity_tolerance;
+
+    // Cells no narrower than the link distance
+    uint32_t side = (uint32_t)(1.0f / link);
+    if (side < 1) side = 1;
+    if (side > MAX_GRID_SIDE) side = MAX_GRID_SIDE;
+
+    analyzer->capacity = n;
+    analyzer->max_groups = n / analyzer->config.min_group_size;
+    analyzer->grid_side = side;
+    analyzer->link_sq = link * link;
+    analyzer->tolerance_sq = tolerance * tolerance;
+    analyzer->next_group_id = 1;
+
+    analyzer->px = (float*)malloc(n * sizeof(float));
+    analyzer->py = (float*)malloc(n * sizeof(float));
+    analyzer->vx = (float*)malloc(n * sizeof(float));
+    analyzer->vy = (float*)malloc(n * sizeof(float));
+    analyzer->src = (uint32_t*)malloc(n * sizeof(uint32_t));
+    analyzer->slot = (uint32_t*)malloc(n * sizeof(uint32_t));
+    analyzer->cell = (uint32_t*)malloc(n * sizeof(uint32_t));
+    analyzer->cell_start = (uint32_t*)malloc(((size_t)side * side + 1) * sizeof(uint32_t));
+    analyzer->order = (uint32_t*)malloc(n * sizeof(uint32_t));
+    analyzer->parent = (uint32_t*)malloc(n * sizeof(uint32_t));
+    analyzer->size = (uint32_t*)malloc(n * sizeof(uint32_t));
+    analyzer->cluster = (int32_t*)malloc(n * sizeof(int32_t));
+    analyzer->keys = (uint64_t*)malloc(n * sizeof(uint64_t));
+    analyzer->votes = (Vote*)malloc(n * sizeof(Vote));
+    analyzer->cluster_prev = (int32_t*)malloc((analyzer->max_groups + 1) * sizeof(int32_t));
+    analyzer->prev_taken = (uint8_t*)malloc(analyzer->max_groups + 1);
+    analyzer->index = track_index_create(n);
+    analyzer->slot_frame = (uint64_t*)calloc(n, sizeof(uint64_t));
+    analyzer->slot_group = (int32_t*)malloc(n * sizeof(int32_t));
+    analyzer->groups = (GroupInfo*)calloc(analyzer->max_groups + 1, sizeof(GroupInfo));
+    analyzer->scratch = (GroupInfo*)calloc(analyzer->max_groups + 1, sizeof(GroupInfo));
+
+    if (!analyzer->px || !analyzer->py || !analyzer->vx || !analyzer->vy ||
+        !analyzer->src || !analyzer->slot || !analyzer->cell || !analyzer->cell_start ||
+        !analyzer->order || !analyzer->parent || !analyzer->size || !analyzer->cluster ||
+        !analyzer->keys || !analyzer->votes || !analyzer->cluster_prev ||
+        !analyzer->prev_taken || !analyzer->index || !analyzer->slot_frame ||
+        !analyzer->slot_group || !analyzer->groups || !analyzer->scratch) {
+        free_analyzer(analyzer);
+        return NULL;
+    }
+
+    if (pthread_mutex_init(&analyzer->mutex, NULL) != 0) {
+        free_analyzer(analyzer);
+        return NULL;
+    }
+
+    return analyzer;
+}
+
+uint32_t group_analyzer_update(
+    GroupAnalyzer* analyzer,
+    const TrackedObject* tracks,
+    uint32_t num_tracks,
+    uint64_t timestamp_ms
+) {
+    if (!analyzer || (num_tracks > 0 && !tracks)) {
+        return 0;
+    }
+
+    uint64_t start_us = get_time_us();
+
+    pthread_mutex_lock(&analyzer->mutex);
+
+    analyzer->stats.frames++;
+
+    uint32_t count = gather_tracks(analyzer, tracks, num_tracks);
+    bucket_tracks(analyzer, count);
+    analyzer->stats.candidate_pairs = link_tracks(analyzer, count);
+
+    uint32_t clusters = label_clusters(analyzer, count);
+    match_clusters(analyzer, count, clusters);
+    build_groups(analyzer, tracks, count, clusters, timestamp_ms);
+
+    uint32_t num_groups = analyzer->num_groups;
+
+    float elapsed_us = (float)(get_time_us() - start_us);
+    if (analyzer->stats.frames == 1) {
+        analyzer->stats.avg_update_us = elapsed_us;
+    } else {
+        analyzer->stats.avg_update_us = 0.1f * elapsed_us + 0.9f * analyzer->stats.avg_update_us;
+    }
+
+    pthread_mutex_unlock(&analyzer->mutex);
+    return num_groups;
+}
+
+uint32_t group_analyzer_get_groups(
+    GroupAnalyzer* analyzer,
+    GroupInfo* groups,
+    uint32_t max_groups
+) {
+    if (!analyzer || !groups) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&analyzer->mutex);
+
+    uint32_t n = analyzer->num_groups < max_groups ? analyzer->num_groups : max_groups;
+    memcpy(groups, analyzer->groups, n * sizeof(GroupInfo));
+
+    pthread_mutex_unlock(&analyzer->mutex);
+    return n;
+}
+
+uint32_t group_analyzer_get_track_group(GroupAnalyzer* analyzer, uint32_t track_id) {
+    if (!analyzer) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&analyzer->mutex);
+
+    uint32_t group_id = 0;
+    int32_t slot = track_index_find(analyzer->index, track_id);
+    if (slot >= 0 && analyzer->stats.frames > 0 &&
+        analyzer->slot_frame[slot] == analyzer->stats.frames &&
+        analyzer->slot_group[slot] >= 0) {
+        group_id = analyzer->groups[analyzer->slot_group[slot]].group_id;
+    }
+
+    pthread_mutex_unlock(&analyzer->mutex);
+    return group_id;
+}
+
+void group_analyzer_get_config(GroupAnalyzer* analyzer, GroupAnalyzerConfig* config) {
+    if (!analyzer || !config) {
+        return;
+    }
+
+    *config = analyzer->config;
+}
+
+void group_analyzer_get_stats(GroupAnalyzer* analyzer, GroupAnalyzerStats* stats) {
+    if (!analyzer || !stats) {
+        return;
+    }
+
+    pthread_mutex_lock(&analyzer->mutex);
+    *stats = analyzer->stats;
+    pthread_mutex_unlock(&analyzer->mutex);
+}
+
+void group_analyzer_reset(GroupAnalyzer* analyzer) {
+    if (!analyzer) {
+        return;
+    }
+
+    pthread_mutex_lock(&analyzer->mutex);
+
+    track_index_clear(analyzer->index);
+    memset(analyzer->slot_frame, 0, analyzer->capacity * sizeof(uint64_t));
+    memset(&analyzer->stats, 0, sizeof(analyzer->stats));
+    analyzer->num_groups = 0;
+    analyzer->next_group_id = 1;
+    analyzer->last_update_ms = 0;
+
+    pthread_mutex_unlock(&analyzer->mutex);
+}
+
+void group_analyzer_destroy(GroupAnalyzer* analyzer) {
+    if (!analyzer) {
+        return;
+    }
+
+    pthread_mutex_destroy(&analyzer->mutex);
+    free_analyzer(analyzer);
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+static void apply_defaults(GroupAnalyzerConfig* config) {
+    if (!(config->link_distance > 0.0f)) config->link_distance = DEFAULT_LINK_DISTANCE;
+    if (!(config->velocity_tolerance > 0.0f)) config->velocity_tolerance = DEFAULT_VELOCITY_TOLERANCE;
+    if (config->min_group_size < 2) config->min_group_size = DEFAULT_MIN_GROUP_SIZE;
+    if (config->crowd_size == 0) config->crowd_size = DEFAULT_CROWD_SIZE;
+    if (config->growth_window_ms == 0) config->growth_window_ms = DEFAULT_GROWTH_WINDOW_MS;
+    if (config->max_tracks == 0) config->max_tracks = DEFAULT_MAX_TRACKS;
+}
+
+static void free_analyzer(GroupAnalyzer* analyzer) {
+    free(analyzer->px);
+    free(analyzer->py);
+    free(analyzer->vx);
+    free(analyzer->vy);
+    free(analyzer->src);
+    free(analyzer->slot);
+    free(analyzer->cell);
+    free(analyzer->cell_start);
+    free(analyzer->order);
+    free(analyzer->parent);
+    free(analyzer->size);
+    free(analyzer->cluster);
+    free(analyzer->keys);
+    free(analyzer->votes);
+    free(analyzer->cluster_prev);
+    free(analyzer->prev_taken);
+    track_index_destroy(analyzer->index);
+    free(analyzer->slot_frame);
+    free(analyzer->slot_group);
+    free(analyzer->groups);
+    free(analyzer->scratch);
+    free(analyzer);
+}
+
+/**
+ * Pack box centres and velocities of the clustered classes
+ */
+static uint32_t gather_tracks(GroupAnalyzer* analyzer, const TrackedObject* tracks,
+                              uint32_t num_tracks) {
+    uint32_t mask = analyzer->config.class_mask;
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; i < num_tracks && count < analyzer->capacity; i++) {
+        const TrackedObject* track = &tracks[i];
+        if (mask && !(mask & (1u << track->class_id))) {
+            continue;
+        }
+
+        bool is_new = false;
+        int32_t slot = track_index_acquire(analyzer->index, track->track_id, &is_new, NULL);
+        if (slot < 0) {
+            continue;
+        }
+        if (is_new) {
+            analyzer->slot_frame[slot] = 0;
+        }
+
+        const BoundingBox* box = &track->current_bbox;
+        analyzer->px[count] = box->x + 0.5f * box->width;
+        analyzer->py[count] = box->y + 0.5f * box->height;
+        analyzer->vx[count] = track->velocity_x;
+        analyzer->vy[count] = track->velocity_y;
+        analyzer->src[count] = i;
+        analyzer->slot[count] = (uint32_t)slot;
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * Counting sort of the packed tracks by grid cell
+ *
+ * Clamping keeps off-image centres in the border cells; it never pulls
+ * two cells further apart, so linked pairs stay in adjacent cells.
+ */
+static void bucket_tracks(GroupAnalyzer* analyzer, uint32_t count) {
+    uint32_t side = analyzer->grid_side;
+    uint32_t cells = side * side;
+    float scale = (float)side;
+    float last = scale - 1.0f;
+
+    // Selects rather than branches (NaN lands in cell 0)
+    for (uint32_t i = 0; i < count; i++) {
+        float cx = analyzer->px[i] * scale;
+        float cy = analyzer->py[i] * scale;
+        cx = (cx >= 0.0f) ? cx : 0.0f;
+        cy = (cy >= 0.0f) ? cy : 0.0f;
+        cx = (cx <= last) ? cx : last;
+        cy = (cy <= last) ? cy : last;
+        analyzer->cell[i] = (uint32_t)cy * side + (uint32_t)cx;
+    }
+
+    memset(analyzer->cell_start, 0, (cells + 1) * sizeof(uint32_t));
+    for (uint32_t i = 0; i < count; i++) {
+        analyzer->cell_start[analyzer->cell[i] + 1]++;
+    }
+    for (uint32_t c = 0; c < cells; c++) {
+        analyzer->cell_start[c + 1] += analyzer->cell_start[c];
+    }
+
+    // Scatter through cell_start, then shift it back to the bucket starts
+    for (uint32_t i = 0; i < count; i++) {
+        analyzer->order[analyzer->cell_start[analyzer->cell[i]]++] = i;
+    }
+    memmove(&analyzer->cell_start[1], &analyzer->cell_start[0], cells * sizeof(uint32_t));
+    analyzer->cell_start[0] = 0;
+}
+
+/**
+ * Test track a against tracks order[begin, end) and merge linked pairs
+ */
+static uint32_t link_range(GroupAnalyzer* analyzer, uint32_t a, uint32_t begin,
+                           uint32_t end) {
+    const float* px = analyzer->px;
+    const float* py = analyzer->py;
+    const float* vx = analyzer->vx;
+    const float* vy = analyzer->vy;
+
+    for (uint32_t k = begin; k < end; k++) {
+        uint32_t b = analyzer->order[k];
+        float dx = px[a] - px[b];
+        float dy = py[a] - py[b];
+        float dvx = vx[a] - vx[b];
+        float dvy = vy[a] - vy[b];
+
+        if ((dx * dx + dy * dy <= analyzer->link_sq) &
+            (dvx * dvx + dvy * dvy <= analyzer->tolerance_sq)) {
+            unite(analyzer, a, b);
+        }
+    }
+
+    return end - begin;
+}
+
+/**
+ * Link close, co-moving tracks
+ *
+ * Each cell is paired with itself and its E, SW, S and SE neighbours,
+ * which visits every pair of adjacent cells exactly once.
+ *
+ * @return Candidate pairs tested
+ */
+static uint32_t link_tracks(GroupAnalyzer* analyzer, uint32_t count) {
+    static const int32_t forward[4][2] = { {1, 0}, {-1, 1}, {0, 1}, {1, 1} };
+
+    for (uint32_t i = 0; i < count; i++) {
+        analyzer->parent[i] = i;
+        analyzer->size[i] = 1;
+    }
+
+    int32_t side = (int32_t)analyzer->grid_side;
+    const uint32_t* start = analyzer->cell_start;
+    uint32_t pairs = 0;
+
+    // Walk tracks in cell order, so empty cells cost nothing
+    for (uint32_t k = 0; k < count; k++) {
+        uint32_t a = analyzer->order[k];
+        uint32_t c = analyzer->cell[a];
+        int32_t row = (int32_t)c / side;
+        int32_t col = (int32_t)c % side;
+
+        // Same cell: later entries only
+        pairs += link_range(analyzer, a, k + 1, start[c + 1]);
+
+        for (uint32_t f = 0; f < 4; f++) {
+            int32_t ncol = col + forward[f][0];
+            int32_t nrow = row + forward[f][1];
+            if (ncol < 0 || ncol >= side || nrow >= side) {
+                continue;
+            }
+            uint32_t n = (uint32_t)(nrow * side + ncol);
+            pairs += link_range(analyzer, a, start[n], start[n + 1]);
+        }
+    }
+
+    return pairs;
+}
+
+static uint32_t find_root(uint32_t* parent, uint32_t i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];  // Path halving
+        i = parent[i];
+    }
+    return i;
+}
+
+static void unite(GroupAnalyzer* analyzer, uint32_t a, uint32_t b) {
+    uint32_t ra = find_root(analyzer->parent, a);
+    uint32_t rb = find_root(analyzer->parent, b);
+    if (ra == rb) {
+        return;
+    }
+
+    // Union by size; ties keep the lower index as root
+    if (analyzer->size[ra] < analyzer->size[rb] ||
+        (analyzer->size[ra] == analyzer->size[rb] && rb < ra)) {
+        uint32_t t = ra;
+        ra = rb;
+        rb = t;
+    }
+    analyzer->parent[rb] = ra;
+    analyzer->size[ra] += analyzer->size[rb];
+}
+
+/**
+ * Number the clusters of at least min_group_size tracks
+ *
+ * Afterwards cluster[i] holds the cluster of track i (-1 if ungrouped).
+ */
+static uint32_t label_clusters(GroupAnalyzer* analyzer, uint32_t count) {
+    uint32_t min_size = analyzer->config.min_group_size;
+    uint32_t clusters = 0;
+
+    // Roots first, in track order, so numbering is deterministic
+    for (uint32_t i = 0; i < count; i++) {
+        if (analyzer->parent[i] == i) {
+            analyzer->cluster[i] = (analyzer->size[i] >= min_size) ? (int32_t)clusters++ : -1;
+        }
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        analyzer->cluster[i] = analyzer->cluster[find_root(analyzer->parent, i)];
+    }
+
+    return clusters;
+}
+
+/**
+ * Give each cluster the previous group most of its members were in
+ *
+ * Votes are counted by sorting (cluster, previous group) keys, then
+ * granted largest first; ties go to the older group id.
+ */
+static void match_clusters(GroupAnalyzer* analyzer, uint32_t count, uint32_t clusters) {
+    uint64_t prev_frame = analyzer->stats.frames - 1;
+    uint32_t num_keys = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t slot = analyzer->slot[i];
+        if (analyzer->cluster[i] < 0 || prev_frame == 0 ||
+            analyzer->slot_frame[slot] != prev_frame || analyzer->slot_group[slot] < 0) {
+            continue;
+        }
+        analyzer->keys[num_keys++] = ((uint64_t)analyzer->cluster[i] << 32) |
+                                     (uint32_t)analyzer->slot_group[slot];
+    }
+
+    for (uint32_t c = 0; c < clusters; c++) {
+        analyzer->cluster_prev[c] = -1;
+    }
+    if (num_keys == 0) {
+        return;
+    }
+
+    qsort(analyzer->keys, num_keys, sizeof(uint64_t), compare_keys);
+
+    uint32_t num_votes = 0;
+    for (uint32_t k = 0; k < num_keys; ) {
+        uint32_t run = k + 1;
+        while (run < num_keys && analyzer->keys[run] == analyzer->keys[k]) {
+            run++;
+        }
+
+        Vote* vote = &analyzer->votes[num_votes++];
+        vote->votes = run - k;
+        vote->cluster = (uint32_t)(analyzer->keys[k] >> 32);
+        vote->prev = (uint32_t)analyzer->keys[k];
+        vote->prev_id = analyzer->groups[vote->prev].group_id;
+        k = run;
+    }
+
+    qsort(analyzer->votes, num_votes, sizeof(Vote), compare_votes);
+
+    memset(analyzer->prev_taken, 0, analyzer->num_groups);
+    for (uint32_t v = 0; v < num_votes; v++) {
+        const Vote* vote = &analyzer->votes[v];
+        if (analyzer->cluster_prev[vote->cluster] >= 0 || analyzer->prev_taken[vote->prev]) {
+            continue;
+        }
+        analyzer->cluster_prev[vote->cluster] = (int32_t)vote->prev;
+        analyzer->prev_taken[vote->prev] = 1;
+    }
+}
+
+/**
+ * Summarize clusters into groups, carry over matched group state and
+ * record each track's group for the next frame
+ */
+static void build_groups(GroupAnalyzer* analyzer, const TrackedObject* tracks,
+                         uint32_t count, uint32_t clusters, uint64_t timestamp_ms) {
+    GroupInfo* prev = analyzer->groups;
+    GroupInfo* next = analyzer->scratch;
+    const GroupAnalyzerConfig* config = &analyzer->config;
+
+    for (uint32_t c = 0; c < clusters; c++) {
+        GroupInfo* group = &next[c];
+        memset(group, 0, sizeof(GroupInfo));
+        group->extent.x = INFINITY;
+        group->extent.y = INFINITY;
+        group->extent.width = -INFINITY;   // Holds max x until finalized
+        group->extent.height = -INFINITY;  // Holds max y
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (analyzer->cluster[i] < 0) {
+            continue;
+        }
+
+        GroupInfo* group = &next[analyzer->cluster[i]];
+        const TrackedObject* track = &tracks[analyzer->src[i]];
+        const BoundingBox* box = &track->current_bbox;
+
+        if (group->num_members < GROUP_MAX_MEMBERS) {
+            group->members[group->num_members] = track->track_id;
+        }
+        group->num_members++;
+        group->centroid_x += analyzer->px[i];
+        group->centroid_y += analyzer->py[i];
+        group->velocity_x += analyzer->vx[i];
+        group->velocity_y += analyzer->vy[i];
+        group->extent.x = fminf(group->extent.x, box->x);
+        group->extent.y = fminf(group->extent.y, box->y);
+        group->extent.width = fmaxf(group->extent.width, box->x + box->width);
+        group->extent.height = fmaxf(group->extent.height, box->y + box->height);
+    }
+
+    float dt_s = 0.0f;
+    if (analyzer->stats.frames > 1 && timestamp_ms > analyzer->last_update_ms) {
+        dt_s = (float)(timestamp_ms - analyzer->last_update_ms) / 1000.0f;
+    }
+    float alpha = 1.0f - expf(-dt_s * 1000.0f / (float)config->growth_window_ms);
+
+    analyzer->stats.grouped_tracks = 0;
+    analyzer->stats.active_crowds = 0;
+
+    for (uint32_t c = 0; c < clusters; c++) {
+        GroupInfo* group = &next[c];
+        float inv = 1.0f / (float)group->num_members;
+
+        group->centroid_x *= inv;
+        group->centroid_y *= inv;
+        group->velocity_x *= inv;
+        group->velocity_y *= inv;
+        group->extent.width -= group->extent.x;
+        group->extent.height -= group->extent.y;
+        group->density = (float)group->num_members /
+                         fmaxf(group->extent.width * group->extent.height, MIN_EXTENT_AREA);
+        group->is_crowd = group->num_members >= config->crowd_size;
+
+        bool was_crowd = false;
+        if (analyzer->cluster_prev[c] >= 0) {
+            const GroupInfo* old = &prev[analyzer->cluster_prev[c]];
+            group->group_id = old->group_id;
+            group->first_seen_ms = old->first_seen_ms;
+            group->peak_members = old->peak_members;
+            group->growth_rate = old->growth_rate;
+            if (dt_s > 0.0f) {
+                float rate = ((float)group->num_members - (float)old->num_members) / dt_s;
+                group->growth_rate += alpha * (rate - group->growth_rate);
+            }
+            was_crowd = old->is_crowd;
+        } else {
+            group->group_id = analyzer->next_group_id++;
+            group->first_seen_ms = timestamp_ms;
+            analyzer->stats.groups_formed++;
+        }
+
+        if (group->num_members > group->peak_members) {
+            group->peak_members = group->num_members;
+        }
+        if (group->is_crowd) {
+            analyzer->stats.active_crowds++;
+            if (!was_crowd) {
+                analyzer->stats.crowds_formed++;
+            }
+        }
+        analyzer->stats.grouped_tracks += group->num_members;
+    }
+
+    // Largest first (ties: older id). The previous groups are no longer
+    // needed, so the sorted list goes into their buffer and cluster_prev
+    // becomes the cluster -> position map.
+    Vote* order = analyzer->votes;
+    for (uint32_t c = 0; c < clusters; c++) {
+        order[c].votes = next[c].num_members;
+        order[c].prev_id = next[c].group_id;
+        order[c].cluster = c;
+    }
+    qsort(order, clusters, sizeof(Vote), compare_votes);
+
+    int32_t* position = analyzer->cluster_prev;
+    for (uint32_t r = 0; r < clusters; r++) {
+        prev[r] = next[order[r].cluster];
+        position[order[r].cluster] = (int32_t)r;
+    }
+
+    analyzer->groups = prev;
+    analyzer->scratch = next;
+    analyzer->num_groups = clusters;
+    analyzer->last_update_ms = timestamp_ms > analyzer->last_update_ms
+        ? timestamp_ms : analyzer->last_update_ms;
+    analyzer->stats.active_groups = clusters;
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t slot = analyzer->slot[i];
+        analyzer->slot_frame[slot] = analyzer->stats.frames;
+        analyzer->slot_group[slot] = analyzer->cluster[i] >= 0
+            ? position[analyzer->cluster[i]] : -1;
+    }
+}
+
+static int compare_keys(const void* a, const void* b) {
+    uint64_t ka = *(const uint64_t*)a;
+    uint64_t kb = *(const uint64_t*)b;
+    return (ka > kb) - (ka < kb);
+}
+
+static int compare_votes(const void* a, const void* b) {
+    const Vote* va = (const Vote*)a;
+    const Vote* vb = (const Vote*)b;
+    if (va->votes != vb->votes) return va->votes > vb->votes ? -1 : 1;
+    if (va->prev_id != vb->prev_id) return va->prev_id < vb->prev_id ? -1 : 1;
+    return (va->cluster > vb->cluster) - (va->cluster < vb->cluster);
+}
+
+static uint64_t get_time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)(ts.tv_nsec / 1000);
+}
@@ -0,0 +1,159 @@
+/**
+ * @file group_analyzer.h
+ * @brief Group and crowd analysis for OMNISIGHT
+ *
+ * Clusters the tracks of each frame into groups: two tracks are linked
+ * when their centres are within a link distance and they move alike, and
+ * a group is a connected set of linked tracks. Candidate pairs come from
+ * a spatial hash with cells of the link distance, so a frame costs
+ * O(tracks + close pairs) rather than O(tracks^2).
+ *
+ * Group identities persist across frames: each new cluster inherits the
+ * id of the previous group most of its members belonged to. Per group the
+ * analyzer keeps size, centroid, density and a smoothed growth rate, which
+ * the timeline's event predictor uses for crowd formation.
+ */
+
+#ifndef OMNISIGHT_GROUP_ANALYZER_H
+#define OMNISIGHT_GROUP_ANALYZER_H
+
+#include "perception.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GROUP_MAX_MEMBERS 32        // Track ids listed per GroupInfo
+
+typedef struct GroupAnalyzer GroupAnalyzer;
+
+/**
+ * Group analyzer configuration (zero fields take the defaults)
+ */
+typedef struct {
+    float link_distance;        // Max centre distance, normalized (default: 0.08)
+    float velocity_tolerance;   // Max velocity difference, normalized/frame (default: 0.01)
+    uint32_t min_group_size;    // Smallest reported group (default: 2)
+    uint32_t crowd_size;        // Members that make a crowd (default: 8)
+    uint32_t growth_window_ms;  // Growth rate smoothing time constant (default: 5000)
+    uint32_t class_mask;        // Bit (1u << ObjectClass) per clustered class (0 = all)
+    uint32_t max_tracks;        // Tracks per frame (0 = 100)
+} GroupAnalyzerConfig;
+
+/**
+ * One group of the latest frame
+ */
+typedef struct {
+    uint32_t group_id;          // Stable across frames
+    uint32_t num_members;
+    uint32_t members[GROUP_MAX_MEMBERS]; // First track ids (all: group_analyzer_get_track_group())
+    float centroid_x, centroid_y; // Mean box centre, normalized
+    float velocity_x, velocity_y; // Mean velocity, normalized/frame
+    BoundingBox extent;         // Union of member boxes
+    float density;              // Members per unit of normalized extent area
+    float growth_rate;          // Smoothed members per second (negative = dispersing)
+    uint32_t peak_members;      // Largest size since the group formed
+    bool is_crowd;              // num_members >= crowd_size
+    uint64_t first_seen_ms;     // When the group formed
+} GroupInfo;
+
+/**
+ * Group analyzer statistics
+ */
+typedef struct {
+    uint64_t frames;
+    uint32_t active_groups;     // Groups in the latest frame
+    uint32_t active_crowds;
+    uint32_t grouped_tracks;    // Tracks in a group in the latest frame
+    uint32_t groups_formed;     // New group ids handed out
+    uint32_t crowds_formed;     // Groups that reached crowd_size
+    uint32_t candidate_pairs;   // Pairs tested in the latest frame
+    float avg_update_us;        // Moving average cost of group_analyzer_update()
+} GroupAnalyzerStats;
+
+/**
+ * Create a group analyzer
+ *
+ * @param config Configuration (NULL = defaults)
+ * @return Analyzer instance, NULL on failure
+ */
+GroupAnalyzer* group_analyzer_create(const GroupAnalyzerConfig* config);
+
+/**
+ * Cluster one frame of tracks
+ *
+ * Tracks beyond max_tracks are ignored.
+ *
+ * @param analyzer Analyzer instance
+ * @param tracks Current tracks
+ * @param num_tracks Number of tracks
+ * @param timestamp_ms Frame time (must not decrease)
+ * @return Number of groups in the frame
+ */
+uint32_t group_analyzer_update(
+    GroupAnalyzer* analyzer,
+    const TrackedObject* tracks,
+    uint32_t num_tracks,
+    uint64_t timestamp_ms
+);
+
+/**
+ * Copy the groups of the latest frame, largest first
+ *
+ * @param analyzer Analyzer instance
+ * @param groups Output array
+ * @param max_groups Array capacity
+ * @return Number of groups written
+ */
+uint32_t group_analyzer_get_groups(
+    GroupAnalyzer* analyzer,
+    GroupInfo* groups,
+    uint32_t max_groups
+);
+
+/**
+ * Group of a track in the latest frame
+ *
+ * @param analyzer Analyzer instance
+ * @param track_id Track to look up
+ * @return Group id, 0 if the track is not in a group
+ */
+uint32_t group_analyzer_get_track_group(GroupAnalyzer* analyzer, uint32_t track_id);
+
+/**
+ * Get the current configuration
+ *
+ * @param analyzer Analyzer instance
+ * @param config Output configuration (defaults filled in)
+ */
+void group_analyzer_get_config(GroupAnalyzer* analyzer, GroupAnalyzerConfig* config);
+
+/**
+ * Get analyzer statistics
+ *
+ * @param analyzer Analyzer instance
+ * @param stats Output statistics
+ */
+void group_analyzer_get_stats(GroupAnalyzer* analyzer, GroupAnalyzerStats* stats);
+
+/**
+ * Forget all groups and statistics
+ *
+ * @param analyzer Analyzer instance
+ */
+void group_analyzer_reset(GroupAnalyzer* analyzer);
+
+/**
+ * Destroy analyzer
+ *
+ * @param analyzer Analyzer instance
+ */
+void group_analyzer_destroy(GroupAnalyzer* analyzer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OMNISIGHT_GROUP_ANALYZER_H
@@ -0,0 +1,310 @@
+/**
+ * @file kalman_batch.c
+ * @brief Batched constant-velocity Kalman filter implementation
+ *
+ * Per channel and slot the filter keeps [p, v] and the covariance block
+ *
+ *     | p_pp  p_pv |
+ *     | p_pv  p_vv |
+ *
+ * Predict (F = [1 dt; 0 1]):
+ *     p_pp += dt * (2 p_pv + dt p_vv) + q_p
+ *     p_pv += dt p_vv
+ *     p_vv += q_v
+ *
+ * Update with a position measurement (H = [1 0]):
+ *     S = p_pp + r,  k_p = p_pp / S,  k_v = p_pv / S
+ *     p_vv -= k_v p_pv,  p_pv *= (1 - k_p),  p_pp *= (1 - k_p)
+ *
+ * All loops run over contiguous arrays without branches so the compiler
+ * can vectorize them (NEON on ARTPEC, SSE/AVX on the host).
+ */
+
+#include "kalman_batch.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Batch filter state (structure of arrays)
+ */
+struct KalmanBatch {
+    KalmanBatchConfig config;
+    uint32_t capacity;
+
+    float* pos[KALMAN_BATCH_CHANNELS];
+    float* vel[KALMAN_BATCH_CHANNELS];
+    float* p_pp[KALMAN_BATCH_CHANNELS];
+    float* p_pv[KALMAN_BATCH_CHANNELS];
+    float* p_vv[KALMAN_BATCH_CHANNELS];
+
+    // Staged measurements
+    float* meas[KALMAN_BATCH_CHANNELS];
+    float* has_meas;  // 1.0 where a measurement is staged, else 0.0
+
+    float* storage;   // Single allocation backing all arrays
+};
+
+// Arrays per channel: pos, vel, p_pp, p_pv, p_vv, meas
+#define ARRAYS_PER_CHANNEL 6
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+KalmanBatch* kalman_batch_init(uint32_t capacity, const KalmanBatchConfig* config) {
+    if (!config || capacity == 0) {
+        return NULL;
+    }
+
+    KalmanBatch* batch = (KalmanBatch*)calloc(1, sizeof(KalmanBatch));
+    if (!batch) {
+        return NULL;
+    }
+
+    size_t num_arrays = KALMAN_BATCH_CHANNELS * ARRAYS_PER_CHANNEL + 1;
+    batch->storage = (float*)calloc(num_arrays * capacity, sizeof(float));
+    if (!batch->storage) {
+        free(batch);
+        return NULL;
+    }
+
+    batch->config = *config;
+    batch->capacity = capacity;
+
+    float* cursor = batch->storage;
+    for (int c = 0; c < KALMAN_BATCH_CHANNELS; c++) {
+        batch->pos[c] = cursor;  cursor += capacity;
+        batch->vel[c] = cursor;  cursor += capacity;
+        batch->p_pp[c] = cursor; cursor += capacity;
+        batch->p_pv[c] = cursor; cursor += capacity;
+        batch->p_vv[c] = cursor; cursor += capacity;
+        batch->meas[c] = cursor; cursor += capacity;
+    }
+    batch->has_meas = cursor;
+
+    return batch;
+}
+
+void kalman_batch_init_slot(KalmanBatch* batch, uint32_t slot, const float* measurement) {
+    if (!batch || !measurement || slot >= batch->capacity) {
+        return;
+    }
+
+    for (int c = 0; c < KALMAN_BATCH_CHANNELS; c++) {
+        batch->pos[c][slot] = measurement[c];
+        batch->vel[c][slot] = 0.0f;
+        batch->p_pp[c][slot] = batch->config.initial_pos_variance[c];
+        batch->p_pv[c][slot] = 0.0f;
+        batch->p_vv[c][slot] = batch->config.initial_vel_variance[c];
+    }
+    batch->has_meas[slot] = 0.0f;
+}
+
+void kalman_batch_set_measurement(KalmanBatch* batch, uint32_t slot, const float* measurement) {
+    if (!batch || !measurement || slot >= batch->capacity) {
+        return;
+    }
+
+    for (int c = 0; c < KALMAN_BATCH_CHANNELS; c++) {
+        batch->meas[c][slot] = measurement[c];
+    }
+    batch->has_meas[slot] = 1.0f;
+}
+
+void kalman_batch_predict(KalmanBatch* batch, float dt) {
+    if (!batch) {
+        return;
+    }
+
+    const uint32_t n = batch->capacity;
+
+    for (int c = 0; c < KALMAN_BATCH_CHANNELS; c++) {
+        float* pos = batch->pos[c];
+        const float* vel = batch->vel[c];
+        float* p_pp = batch->p_pp[c];
+        float* p_pv = batch->p_pv[c];
+        float* p_vv = batch->p_vv[c];
+        const float q_p = batch->config.process_noise_pos[c];
+        const float q_v = batch->config.process_noise_vel[c];
+
+        for (uint32_t i = 0; i < n; i++) {
+            pos[i] += dt * vel[i];
+            p_pp[i] += dt * (2.0f * p_pv[i] + dt * p_vv[i]) + q_p;
+            p_pv[i] += dt * p_vv[i];
+            p_vv[i] += q_v;
+        }
+    }
+}
+
+void kalman_batch_update(KalmanBatch* batch) {
+    if (!batch) {
+        return;
+    }
+
+    const uint32_t n = batch->capacity;
+    const float* has_meas = batch->has_meas;
+
+    for (int c = 0; c < KALMAN_BATCH_CHANNELS; c++) {
+        float* pos = batch->pos[c];
+        float* vel = batch->vel[c];
+        float* p_pp = batch->p_pp[c];
+        float* p_pv = batch->p_pv[c];
+        float* p_vv = batch->p_vv[c];
+        const float* meas = batch->meas[c];
+        const float r = batch->config.measurement_noise[c];
+
+        for (uint32_t i = 0; i < n; i++) {
+            // Gains are zeroed by the mask where nothing was measured
+            float inv_s = has_meas[i] / (p_pp[i] + r);
+            float k_p = p_pp[i] * inv_s;
+            float k_v = p_pv[i] * inv_s;
+            float innovation = has_meas[i] * (meas[i] - pos[i]);
+
+            pos[i] += k_p * innovation;
+            vel[i] += k_v * innovation;
+            p_vv[i] -= k_v * p_pv[i];
+            p_pv[i] *= (1.0f - k_p);
+            p_pp[i] *= (1.0f - k_p);
+        }
+    }
+
+    memset(batch->has_meas, 0, n * sizeof(float));
+}
+
+void kalman_batch_warp(KalmanBatch* batch, float scale, float dx, float dy) {
+    if (!batch) {
+        return;
+    }
+
+    const uint32_t n = batch->capacity;
+    const float scale_sq = scale * scale;
+
+    for (int c = 0; c < KALMAN_BATCH_CHANNELS; c++) {
+        float* pos = batch->pos[c];
+        float* vel = batch->vel[c];
+        float* p_pp = batch->p_pp[c];
+        float* p_pv = batch->p_pv[c];
+        float* p_vv = batch->p_vv[c];
+
+        // Channels 0/1 are image positions, 2/3 are sizes
+        const float center = (c < 2) ? 0.5f : 0.0f;
+        const float offset = (c == 0) ? dx : (c == 1) ? dy : 0.0f;
+
+        for (uint32_t i = 0; i < n; i++) {
+            pos[i] = (pos[i] - center) * scale + center + offset;
+            vel[i] *= scale;
+            p_pp[i] *= scale_sq;
+            p_pv[i] *= scale_sq;
+            p_vv[i] *= scale_sq;
+        }
+    }
+}
+
+void kalman_batch_get_state(
+    const KalmanBatch* batch,
+    uint32_t slot,
+    float* position,
+    float* velocity
+) {
+    if (!batch || slot >= batch->capacity) {
+        return;
+    }
+
+    for (int c = 0; c < KALMAN_BATCH_CHANNELS; c++) {
+        if (position) position[c] = batch->pos[c][slot];
+        if (velocity) velocity[c] = batch->vel[c][slot];
+    }
+}
+
+void kalman_batch_get_covariance(
+    const KalmanBatch* batch,
+    uint32_t slot,
+    uint32_t channel,
+    float* p_pos,
+    float* p_pos_vel,
+    float* p_vel
+) {
+    if (!batch || slot >= batch->capacity || channel >= KALMAN_BATCH_CHANNELS) {
+        return;
+    }
+
+    if (p_pos) *p_pos = batch->p_pp[channel][slot];
+    if (p_pos_vel) *p_pos_vel = batch->p_pv[channel][slot];
+    if (p_vel) *p_vel = batch->p_vv[channel][slot];
+}
+
+void kalman_batch_save_slot(const KalmanBatch* batch, uint32_t slot, KalmanSlotState* state) {
+    if (!batch || !state || slot >= batch->capacity) {
+        return;
+    }
+
+    for (int c = 0; c < KALMAN_BATCH_CHANNELS; c++) {
+        state->pos[c] = batch->pos[c][slot];
+        state->vel[c] = batch->vel[c][slot];
+        state->p_pp[c] = batch->p_pp[c][slot];
+        state->p_pv[c] = batch->p_pv[c][slot];
+        state->p_vv[c] = batch->p_vv[c][slot];
+    }
+}
+
+void kalman_batch_restore_slot(
+    KalmanBatch* batch,
+    uint32_t slot,
+    const KalmanSlotState* state,
+    float dt,
+    const float* measurement
+) {
+    if (!batch || !state || !measurement || slot >= batch->capacity) {
+        return;
+    }
+
+    for (int c = 0; c < KALMAN_BATCH_CHANNELS; c++) {
+        // Predict, as kalman_batch_predict()
+        float pos = state->pos[c] + dt * state->vel[c];
+        float vel = state->vel[c];
+        float p_pp = state->p_pp[c] + dt * (2.0f * state->p_pv[c] + dt * state->p_vv[c]) +
+                     batch->config.process_noise_pos[c];
+        float p_pv = state->p_pv[c] + dt * state->p_vv[c];
+        float p_vv = state->p_vv[c] + batch->config.process_noise_vel[c];
+
+        // Correct, as kalman_batch_update()
+        float inv_s = 1.0f / (p_pp + batch->config.measurement_noise[c]);
+        float k_p = p_pp * inv_s;
+        float k_v = p_pv * inv_s;
+        float innovation = measurement[c] - pos;
+
+        batch->pos[c][slot] = pos + k_p * innovation;
+        batch->vel[c][slot] = vel + k_v * innovation;
+        batch->p_vv[c][slot] = p_vv - k_v * p_pv;
+        batch->p_pv[c][slot] = p_pv * (1.0f - k_p);
+        batch->p_pp[c][slot] = p_pp * (1.0f - k_p);
+    }
+    batch->has_meas[slot] = 0.0f;
+}
+
+void kalman_batch_warp_saved(KalmanSlotState* state, float scale, float dx, float dy) {
+    if (!state) {
+        return;
+    }
+
+    const float scale_sq = scale * scale;
+
+    for (int c = 0; c < KALMAN_BATCH_CHANNELS; c++) {
+        // Same mapping as kalman_batch_warp()
+        const float center = (c < 2) ? 0.5f : 0.0f;
+        const float offset = (c == 0) ? dx : (c == 1) ? dy : 0.0f;
+
+        state->pos[c] = (state->pos[c] - center) * scale + center + offset;
+        state->vel[c] *= scale;
+        state->p_pp[c] *= scale_sq;
+        state->p_pv[c] *= scale_sq;
+        state->p_vv[c] *= scale_sq;
+    }
+}
+
+void kalman_batch_destroy(KalmanBatch* batch) {
+    if (batch) {
+        free(batch->storage);
+        free(batch);
+    }
+}
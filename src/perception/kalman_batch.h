@@ -0,0 +1,198 @@
+/**
+ * @file kalman_batch.h
+ * @brief Batched constant-velocity Kalman filter for OMNISIGHT tracking
+ *
+ * Keeps the state and covariance of every track in structure-of-arrays
+ * form and steps all of them in a single pass per channel.
+ *
+ * The constant-velocity model decouples per measured channel (x/vx,
+ * y/vy, w/vw, h/vh), so the full covariance is block diagonal with one
+ * 2x2 block per channel. Each block is stored as three floats and
+ * predicted/updated in closed form instead of with dense matrix
+ * arithmetic.
+ */
+
+#ifndef OMNISIGHT_KALMAN_BATCH_H
+#define OMNISIGHT_KALMAN_BATCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KALMAN_BATCH_CHANNELS 4  // Measured channels: center x, center y, width, height
+
+typedef struct KalmanBatch KalmanBatch;
+
+/**
+ * One slot's state and covariance, kept outside the batch
+ * (kalman_batch_save_slot / kalman_batch_restore_slot)
+ */
+typedef struct {
+    float pos[KALMAN_BATCH_CHANNELS];
+    float vel[KALMAN_BATCH_CHANNELS];
+    float p_pp[KALMAN_BATCH_CHANNELS];  // Covariance blocks, as kalman_batch_get_covariance()
+    float p_pv[KALMAN_BATCH_CHANNELS];
+    float p_vv[KALMAN_BATCH_CHANNELS];
+} KalmanSlotState;
+
+/**
+ * Per-channel noise model
+ *
+ * A channel with zero initial velocity variance and zero velocity
+ * process noise degenerates to a random walk (velocity stays 0).
+ */
+typedef struct {
+    float process_noise_pos[KALMAN_BATCH_CHANNELS];    // Position process noise per step
+    float process_noise_vel[KALMAN_BATCH_CHANNELS];    // Velocity process noise per step
+    float measurement_noise[KALMAN_BATCH_CHANNELS];    // Measurement noise (must be > 0)
+    float initial_pos_variance[KALMAN_BATCH_CHANNELS]; // Position variance at track birth
+    float initial_vel_variance[KALMAN_BATCH_CHANNELS]; // Velocity variance at track birth
+} KalmanBatchConfig;
+
+/**
+ * Create a batch filter
+ *
+ * @param capacity Number of track slots
+ * @param config Noise model
+ * @return Batch instance, NULL on failure
+ */
+KalmanBatch* kalman_batch_init(uint32_t capacity, const KalmanBatchConfig* config);
+
+/**
+ * (Re)initialize a slot from a first measurement
+ *
+ * @param batch Batch instance
+ * @param slot Slot index
+ * @param measurement Measurement [KALMAN_BATCH_CHANNELS]
+ */
+void kalman_batch_init_slot(KalmanBatch* batch, uint32_t slot, const float* measurement);
+
+/**
+ * Stage a measurement for a slot, applied by the next kalman_batch_update()
+ *
+ * @param batch Batch instance
+ * @param slot Slot index
+ * @param measurement Measurement [KALMAN_BATCH_CHANNELS]
+ */
+void kalman_batch_set_measurement(KalmanBatch* batch, uint32_t slot, const float* measurement);
+
+/**
+ * Predict all slots forward by dt
+ *
+ * @param batch Batch instance
+ * @param dt Time step (frames)
+ */
+void kalman_batch_predict(KalmanBatch* batch, float dt);
+
+/**
+ * Apply all staged measurements in one pass and clear them
+ *
+ * Slots without a staged measurement are left unchanged.
+ *
+ * @param batch Batch instance
+ */
+void kalman_batch_update(KalmanBatch* batch);
+
+/**
+ * Apply a global image warp to all slots (camera motion compensation)
+ *
+ * Positions in channels 0/1 map as p' = (p - 0.5) * scale + 0.5 + offset,
+ * sizes in channels 2/3 as s' = s * scale. Velocities and covariances are
+ * scaled accordingly.
+ *
+ * @param batch Batch instance
+ * @param scale Zoom ratio about the image center
+ * @param dx Horizontal offset
+ * @param dy Vertical offset
+ */
+void kalman_batch_warp(KalmanBatch* batch, float scale, float dx, float dy);
+
+/**
+ * Read a slot's state
+ *
+ * @param batch Batch instance
+ * @param slot Slot index
+ * @param position Output positions [KALMAN_BATCH_CHANNELS] (may be NULL)
+ * @param velocity Output velocities [KALMAN_BATCH_CHANNELS] (may be NULL)
+ */
+void kalman_batch_get_state(
+    const KalmanBatch* batch,
+    uint32_t slot,
+    float* position,
+    float* velocity
+);
+
+/**
+ * Read one channel's 2x2 covariance block for a slot
+ *
+ * @param batch Batch instance
+ * @param slot Slot index
+ * @param channel Channel index
+ * @param p_pos Output position variance
+ * @param p_pos_vel Output position/velocity covariance
+ * @param p_vel Output velocity variance
+ */
+void kalman_batch_get_covariance(
+    const KalmanBatch* batch,
+    uint32_t slot,
+    uint32_t channel,
+    float* p_pos,
+    float* p_pos_vel,
+    float* p_vel
+);
+
+/**
+ * Copy a slot's state and covariance out of the batch
+ *
+ * @param batch Batch instance
+ * @param slot Slot index
+ * @param state Output state
+ */
+void kalman_batch_save_slot(const KalmanBatch* batch, uint32_t slot, KalmanSlotState* state);
+
+/**
+ * (Re)initialize a slot from a saved state and a new measurement
+ *
+ * The saved state is predicted dt frames forward and corrected with the
+ * measurement, as kalman_batch_predict() and kalman_batch_update() would
+ * have done had the slot stayed in the batch.
+ *
+ * @param batch Batch instance
+ * @param slot Slot index
+ * @param state Saved state
+ * @param dt Frames since the state was saved
+ * @param measurement Measurement [KALMAN_BATCH_CHANNELS]
+ */
+void kalman_batch_restore_slot(
+    KalmanBatch* batch,
+    uint32_t slot,
+    const KalmanSlotState* state,
+    float dt,
+    const float* measurement
+);
+
+/**
+ * Apply the image warp of kalman_batch_warp() to a saved state
+ *
+ * @param state Saved state
+ * @param scale Zoom ratio about the image center
+ * @param dx Horizontal offset
+ * @param dy Vertical offset
+ */
+void kalman_batch_warp_saved(KalmanSlotState* state, float scale, float dx, float dy);
+
+/**
+ * Destroy batch filter
+ *
+ * @param batch Batch instance
+ */
+void kalman_batch_destroy(KalmanBatch* batch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OMNISIGHT_KALMAN_BATCH_H
@@ -0,0 +1,411 @@
+/**
+ * @file motion_estimator.c
+ * @brief Global camera-motion estimation implementation
+ *
+ * Image path: the luma plane is box-downscaled to a 64x64 grid,
+ * mean-removed and Hann-windowed, then registered against the previous
+ * frame by phase correlation. The 2D FFT runs as a radix-2 transform
+ * over all columns at once (the innermost loop walks a contiguous row),
+ * followed by a transpose and a second batched pass, so every butterfly
+ * loop vectorizes.
+ */
+
+#include "motion_estimator.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define G MOTION_GRID_SIZE
+#define GRID_CELLS (G * G)
+#define ROWS_PER_CELL 4  // Luma rows sampled per grid row when downscaling
+#define SHIFT_DEADBAND 0.25f  // Shifts below this (grid cells) count as static
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+struct MotionEstimator {
+    float min_confidence;
+
+    // Previous frame spectrum (transposed layout, see fft_2d)
+    float* prev_re;
+    float* prev_im;
+    bool has_prev;
+
+    // Scratch
+    float* cur_re;
+    float* cur_im;
+    float* tmp;
+    uint32_t* row_sum;
+    uint32_t row_sum_width;
+
+    // Tables
+    float window[GRID_CELLS];
+    float twiddle_cos[G / 2];
+    float twiddle_sin[G / 2];
+    uint32_t bit_reverse[G];
+
+    MotionEstimatorStats stats;
+};
+
+// Forward declarations
+static void downscale_luma(
+    MotionEstimator* est,
+    const uint8_t* luma,
+    uint32_t width,
+    uint32_t height,
+    uint32_t stride,
+    float* grid
+);
+static void fft_2d(MotionEstimator* est, float* re, float* im, bool inverse);
+static float parabolic_offset(float left, float center, float right);
+static void record_stats(
+    MotionEstimator* est,
+    const struct timespec* start,
+    const CameraMotion* motion,
+    bool reported
+);
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+MotionEstimator* motion_estimator_init(float min_confidence) {
+    MotionEstimator* est = (MotionEstimator*)calloc(1, sizeof(MotionEstimator));
+    if (!est) {
+        return NULL;
+    }
+
+    est->min_confidence = min_confidence > 0.0f ? min_confidence : 0.1f;
+
+    float* block = (float*)calloc(5 * GRID_CELLS, sizeof(float));
+    if (!block) {
+        free(est);
+        return NULL;
+    }
+    est->prev_re = block;
+    est->prev_im = block + GRID_CELLS;
+    est->cur_re = block + 2 * GRID_CELLS;
+    est->cur_im = block + 3 * GRID_CELLS;
+    est->tmp = block + 4 * GRID_CELLS;
+
+    for (int y = 0; y < G; y++) {
+        float wy = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * y / (G - 1));
+        for (int x = 0; x < G; x++) {
+            float wx = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * x / (G - 1));
+            est->window[y * G + x] = wx * wy;
+        }
+    }
+
+    for (int k = 0; k < G / 2; k++) {
+        est->twiddle_cos[k] = cosf(2.0f * (float)M_PI * k / G);
+        est->twiddle_sin[k] = sinf(2.0f * (float)M_PI * k / G);
+    }
+
+    int bits = 0;
+    while ((1 << bits) < G) bits++;
+    for (uint32_t i = 0; i < G; i++) {
+        uint32_t r = 0;
+        for (int b = 0; b < bits; b++) {
+            if (i & (1u << b)) r |= 1u << (bits - 1 - b);
+        }
+        est->bit_reverse[i] = r;
+    }
+
+    return est;
+}
+
+bool motion_estimator_process_luma(
+    MotionEstimator* estimator,
+    const uint8_t* luma,
+    uint32_t width,
+    uint32_t height,
+    uint32_t stride,
+    CameraMotion* motion
+) {
+    if (!estimator || !luma || !motion || width < G || height < G) {
+        return false;
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    motion->dx = 0.0f;
+    motion->dy = 0.0f;
+    motion->scale = 1.0f;
+    motion->confidence = 0.0f;
+
+    float* re = estimator->cur_re;
+    float* im = estimator->cur_im;
+
+    // Downscale, remove mean, window
+    downscale_luma(estimator, luma, width, height, stride, re);
+
+    float mean = 0.0f;
+    for (int i = 0; i < GRID_CELLS; i++) {
+        mean += re[i];
+    }
+    mean /= GRID_CELLS;
+
+    for (int i = 0; i < GRID_CELLS; i++) {
+        re[i] = (re[i] - mean) * estimator->window[i];
+        im[i] = 0.0f;
+    }
+
+    fft_2d(estimator, re, im, false);
+
+    if (!estimator->has_prev) {
+        memcpy(estimator->prev_re, re, GRID_CELLS * sizeof(float));
+        memcpy(estimator->prev_im, im, GRID_CELLS * sizeof(float));
+        estimator->has_prev = true;
+        record_stats(estimator, &start, motion, false);
+        return false;
+    }
+
+    // Normalized cross-power spectrum: F_cur * conj(F_prev) / |...|.
+    // The previous spectrum is swapped in afterwards.
+    float* prev_re = estimator->prev_re;
+    float* prev_im = estimator->prev_im;
+    float* cross_re = estimator->tmp;
+
+    for (int i = 0; i < GRID_CELLS; i++) {
+        float cr = re[i] * prev_re[i] + im[i] * prev_im[i];
+        float ci = im[i] * prev_re[i] - re[i] * prev_im[i];
+        float mag = sqrtf(cr * cr + ci * ci) + 1e-12f;
+
+        prev_re[i] = re[i];
+        prev_im[i] = im[i];
+        cross_re[i] = cr / mag;
+        im[i] = ci / mag;
+    }
+    memcpy(re, cross_re, GRID_CELLS * sizeof(float));
+
+    fft_2d(estimator, re, im, true);
+
+    // Correlation peak; fft_2d returns the inverse in [y][x] layout
+    int peak = 0;
+    for (int i = 1; i < GRID_CELLS; i++) {
+        if (re[i] > re[peak]) peak = i;
+    }
+
+    int py = peak / G;
+    int px = peak % G;
+    float peak_value = re[peak];
+
+    float sub_x = parabolic_offset(
+        re[py * G + (px + G - 1) % G], peak_value, re[py * G + (px + 1) % G]);
+    float sub_y = parabolic_offset(
+        re[((py + G - 1) % G) * G + px], peak_value, re[((py + 1) % G) * G + px]);
+
+    float shift_x = (px >= G / 2 ? px - G : px) + sub_x;
+    float shift_y = (py >= G / 2 ? py - G : py) + sub_y;
+
+    motion->confidence = fminf(1.0f, fmaxf(0.0f, peak_value));
+
+    bool reported = motion->confidence >= estimator->min_confidence &&
+                    (fabsf(shift_x) >= SHIFT_DEADBAND || fabsf(shift_y) >= SHIFT_DEADBAND);
+    if (reported) {
+        // Grid cells cover (width / G) x (height / G) source pixels
+        motion->dx = shift_x * (float)(width / G) / width;
+        motion->dy = shift_y * (float)(height / G) / height;
+    }
+
+    record_stats(estimator, &start, motion, reported);
+    return reported;
+}
+
+void motion_estimator_reset(MotionEstimator* estimator) {
+    if (!estimator) {
+        return;
+    }
+
+    estimator->has_prev = false;
+}
+
+void motion_estimator_get_stats(MotionEstimator* estimator, MotionEstimatorStats* stats) {
+    if (!estimator || !stats) {
+        return;
+    }
+
+    *stats = estimator->stats;
+}
+
+void motion_estimator_destroy(MotionEstimator* estimator) {
+    if (estimator) {
+        free(estimator->prev_re);  // Owns the whole float block
+        free(estimator->row_sum);
+        free(estimator);
+    }
+}
+
+// ============================================================================
+// Internal Functions
+// ============================================================================
+
+/**
+ * Box-downscale luma to the G x G grid. Each grid row sums a few evenly
+ * spaced source rows across the full width, then pools columns.
+ */
+static void downscale_luma(
+    MotionEstimator* est,
+    const uint8_t* luma,
+    uint32_t width,
+    uint32_t height,
+    uint32_t stride,
+    float* grid
+) {
+    if (est->row_sum_width < width) {
+        free(est->row_sum);
+        est->row_sum = (uint32_t*)malloc(width * sizeof(uint32_t));
+        est->row_sum_width = est->row_sum ? width : 0;
+    }
+    uint32_t* row_sum = est->row_sum;
+    if (!row_sum) {
+        memset(grid, 0, GRID_CELLS * sizeof(float));
+        return;
+    }
+
+    uint32_t cell_w = width / G;
+    uint32_t cell_h = height / G;
+    uint32_t row_step = cell_h > ROWS_PER_CELL ? cell_h / ROWS_PER_CELL : 1;
+    uint32_t rows_used = cell_h > ROWS_PER_CELL ? ROWS_PER_CELL : cell_h;
+    float norm = 1.0f / (float)(cell_w * rows_used);
+
+    for (uint32_t gy = 0; gy < G; gy++) {
+        memset(row_sum, 0, width * sizeof(uint32_t));
+
+        for (uint32_t r = 0; r < rows_used; r++) {
+            const uint8_t* src = luma + (size_t)(gy * cell_h + r * row_step) * stride;
+            for (uint32_t x = 0; x < cell_w * G; x++) {
+                row_sum[x] += src[x];
+            }
+        }
+
+        for (uint32_t gx = 0; gx < G; gx++) {
+            uint32_t sum = 0;
+            const uint32_t* cell = row_sum + gx * cell_w;
+            for (uint32_t x = 0; x < cell_w; x++) {
+                sum += cell[x];
+            }
+            grid[gy * G + gx] = sum * norm;
+        }
+    }
+}
+
+/**
+ * In-place radix-2 FFT along the first index of a G x G array, for all
+ * columns at once
+ */
+static void fft_columns(MotionEstimator* est, float* re, float* im, bool inverse) {
+    float* row_tmp = est->tmp;
+
+    // Bit-reversal permutation of rows
+    for (uint32_t i = 0; i < G; i++) {
+        uint32_t j = est->bit_reverse[i];
+        if (j <= i) continue;
+
+        memcpy(row_tmp, re + i * G, G * sizeof(float));
+        memcpy(re + i * G, re + j * G, G * sizeof(float));
+        memcpy(re + j * G, row_tmp, G * sizeof(float));
+
+        memcpy(row_tmp, im + i * G, G * sizeof(float));
+        memcpy(im + i * G, im + j * G, G * sizeof(float));
+        memcpy(im + j * G, row_tmp, G * sizeof(float));
+    }
+
+    float sign = inverse ? 1.0f : -1.0f;
+
+    for (uint32_t len = 2; len <= G; len <<= 1) {
+        uint32_t half = len / 2;
+        uint32_t step = G / len;
+
+        for (uint32_t start = 0; start < G; start += len) {
+            for (uint32_t k = 0; k < half; k++) {
+                float wr = est->twiddle_cos[k * step];
+                float wi = sign * est->twiddle_sin[k * step];
+
+                float* ar = re + (start + k) * G;
+                float* ai = im + (start + k) * G;
+                float* br = re + (start + k + half) * G;
+                float* bi = im + (start + k + half) * G;
+
+                for (uint32_t c = 0; c < G; c++) {
+                    float tr = br[c] * wr - bi[c] * wi;
+                    float ti = br[c] * wi + bi[c] * wr;
+                    br[c] = ar[c] - tr;
+                    bi[c] = ai[c] - ti;
+                    ar[c] += tr;
+                    ai[c] += ti;
+                }
+            }
+        }
+    }
+}
+
+static void transpose(float* data, float* scratch) {
+    for (uint32_t y = 0; y < G; y++) {
+        for (uint32_t x = 0; x < G; x++) {
+            scratch[x * G + y] = data[y * G + x];
+        }
+    }
+    memcpy(data, scratch, GRID_CELLS * sizeof(float));
+}
+
+/**
+ * 2D FFT: columns, transpose, columns. The forward result is left
+ * transposed ([kx][ky]); the inverse undoes that, so a forward/inverse
+ * pair returns data in its original [y][x] layout. Inverse is scaled.
+ */
+static void fft_2d(MotionEstimator* est, float* re, float* im, bool inverse) {
+    fft_columns(est, re, im, inverse);
+    transpose(re, est->tmp);
+    transpose(im, est->tmp);
+    fft_columns(est, re, im, inverse);
+
+    if (inverse) {
+        float scale = 1.0f / GRID_CELLS;
+        for (int i = 0; i < GRID_CELLS; i++) {
+            re[i] *= scale;
+            im[i] *= scale;
+        }
+    }
+}
+
+/**
+ * Sub-cell peak position from three samples (-0.5 .. 0.5)
+ */
+static float parabolic_offset(float left, float center, float right) {
+    float denom = left - 2.0f * center + right;
+    if (fabsf(denom) < 1e-12f) {
+        return 0.0f;
+    }
+
+    float offset = 0.5f * (left - right) / denom;
+    return fmaxf(-0.5f, fminf(0.5f, offset));
+}
+
+static void record_stats(
+    MotionEstimator* est,
+    const struct timespec* start,
+    const CameraMotion* motion,
+    bool reported
+) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    float elapsed_ms = (end.tv_sec - start->tv_sec) * 1000.0f +
+                       (end.tv_nsec - start->tv_nsec) / 1000000.0f;
+
+    MotionEstimatorStats* stats = &est->stats;
+    stats->frames++;
+    stats->last_ms = elapsed_ms;
+    stats->avg_ms += (elapsed_ms - stats->avg_ms) / stats->frames;
+    if (elapsed_ms > stats->max_ms) {
+        stats->max_ms = elapsed_ms;
+    }
+    if (reported) {
+        stats->frames_with_motion++;
+    }
+    stats->last_motion = *motion;
+}
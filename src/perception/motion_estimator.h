@@ -0,0 +1,105 @@
+/**
+ * @file motion_estimator.h
+ * @brief Global camera-motion estimation for OMNISIGHT tracking
+ *
+ * Estimates how the whole image moved between consecutive frames so the
+ * tracker can warp its predictions before association, by phase
+ * correlation of a downscaled luma plane (translation only).
+ *
+ * Motion is expressed in normalized image coordinates: a point p in the
+ * previous frame appears at (p - 0.5) * scale + 0.5 + (dx, dy).
+ */
+
+#ifndef OMNISIGHT_MOTION_ESTIMATOR_H
+#define OMNISIGHT_MOTION_ESTIMATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOTION_GRID_SIZE 64  // Phase correlation grid (power of two)
+
+typedef struct MotionEstimator MotionEstimator;
+
+/**
+ * Global motion between two frames
+ */
+typedef struct {
+    float dx;          // Horizontal shift (fraction of frame width)
+    float dy;          // Vertical shift (fraction of frame height)
+    float scale;       // Zoom ratio about the image center (1 = none)
+    float confidence;  // 0-1 (correlation peak height)
+} CameraMotion;
+
+/**
+ * Estimator statistics
+ */
+typedef struct {
+    uint64_t frames;           // Frames processed
+    uint64_t frames_with_motion; // Frames where motion was reported
+    float last_ms;             // Cost of the last estimate
+    float avg_ms;              // Mean cost per frame
+    float max_ms;              // Worst cost per frame
+    CameraMotion last_motion;  // Last reported motion
+} MotionEstimatorStats;
+
+/**
+ * Create a motion estimator
+ *
+ * @param min_confidence Image-based estimates below this are discarded (0 = 0.1)
+ * @return Estimator instance, NULL on failure
+ */
+MotionEstimator* motion_estimator_init(float min_confidence);
+
+/**
+ * Estimate motion from a luma plane (e.g. the Y plane of an NV12 frame)
+ *
+ * The first frame only primes the estimator.
+ *
+ * @param estimator Estimator instance
+ * @param luma 8-bit luma plane
+ * @param width Plane width (>= MOTION_GRID_SIZE)
+ * @param height Plane height (>= MOTION_GRID_SIZE)
+ * @param stride Bytes per row
+ * @param motion Output motion
+ * @return true if motion was estimated with sufficient confidence
+ */
+bool motion_estimator_process_luma(
+    MotionEstimator* estimator,
+    const uint8_t* luma,
+    uint32_t width,
+    uint32_t height,
+    uint32_t stride,
+    CameraMotion* motion
+);
+
+/**
+ * Forget the previous frame (e.g. after a stream restart)
+ *
+ * @param estimator Estimator instance
+ */
+void motion_estimator_reset(MotionEstimator* estimator);
+
+/**
+ * Get estimator statistics
+ *
+ * @param estimator Estimator instance
+ * @param stats Output statistics
+ */
+void motion_estimator_get_stats(MotionEstimator* estimator, MotionEstimatorStats* stats);
+
+/**
+ * Destroy estimator
+ *
+ * @param estimator Estimator instance
+ */
+void motion_estimator_destroy(MotionEstimator* estimator);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OMNISIGHT_MOTION_ESTIMATOR_H
@@ -0,0 +1,357 @@
+/**
+ * @file occupancy_grid.c
+ * @brief Streaming occupancy / dwell-time heatmap
+ *
+ * Stored cell values are true values times `scale`. Advancing time by dt
+ * multiplies `scale` by 2^(dt / half_life) instead of decaying every
+ * cell; a reader divides by `scale`. Per frame, ground points are binned
+ * in one branch-free pass over the tracks, then scattered into the grid.
+ */
+
+#include "occupancy_grid.h"
+#include "track_index.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#define DEFAULT_MAX_TRACKS 100
+#define MAX_RESOLUTION 1024
+#define RESCALE_LIMIT 1048576.0     // Fold scale back into the cells beyond 2^20
+#define MAX_FRAME_GAP_MS 1000       // Presence credited across a stall
+#define BIN_BATCH 64
+
+struct OccupancyGrid {
+    uint32_t resolution;
+    float half_life_ms;
+    float* presence;        // Scaled object-seconds, resolution^2
+    float* visits;          // Scaled entry counts
+    double scale;
+
+    TrackIndex* index;      // track_id -> slot for last_cell
+    int32_t* last_cell;
+
+    uint64_t last_update_ms;
+    bool has_update;
+
+    pthread_mutex_t mutex;  // Update vs readers; held for microseconds
+};
+
+static void rescale(OccupancyGrid* grid);
+static void bin_ground_points(const OccupancyGrid* grid, const TrackedObject* tracks,
+                              uint32_t count, int32_t* cells);
+static void resample(const OccupancyGrid* grid, const float* src, uint32_t cols,
+                     uint32_t rows, float* dst);
+static void clamp_size(const OccupancyGrid* grid, uint32_t* cols, uint32_t* rows);
+static uint8_t* put_u16(uint8_t* p, uint16_t v);
+static uint8_t* put_u32(uint8_t* p, uint32_t v);
+static uint8_t* put_f32(uint8_t* p, float v);
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+OccupancyGrid* occupancy_grid_create(
+    uint32_t resolution,
+    uint32_t half_life_ms,
+    uint32_t max_tracks
+) {
+    if (resolution == 0) resolution = OCCUPANCY_GRID_DEFAULT_RESOLUTION;
+    if (half_life_ms == 0) half_life_ms = OCCUPANCY_GRID_DEFAULT_HALF_LIFE_MS;
+    if (max_tracks == 0) max_tracks = DEFAULT_MAX_TRACKS;
+
+    if (resolution > MAX_RESOLUTION) {
+        return NULL;
+    }
+
+    OccupancyGrid* grid = (OccupancyGrid*)calloc(1, sizeof(OccupancyGrid));
+    if (!grid) {
+        return NULL;
+    }
+
+    size_t cells = (size_t)resolution * resolution;
+    grid->resolution = resolution;
+    grid->half_life_ms = (float)half_life_ms;
+    grid->presence = (float*)calloc(cells, sizeof(float));
+    grid->visits = (float*)calloc(cells, sizeof(float));
+    grid->index = track_index_create(max_tracks);
+    grid->last_cell = (int32_t*)calloc(max_tracks, sizeof(int32_t));
+    grid->scale = 1.0;
+
+    if (!grid->presence || !grid->visits || !grid->index || !grid->last_cell ||
+        pthread_mutex_init(&grid->mutex, NULL) != 0) {
+        track_index_destroy(grid->index);
+        free(grid->presence);
+        free(grid->visits);
+        free(grid->last_cell);
+        free(grid);
+        return NULL;
+    }
+
+    return grid;
+}
+
+void occupancy_grid_update(
+    OccupancyGrid* grid,
+    const TrackedObject* tracks,
+    uint32_t num_tracks,
+    uint64_t timestamp_ms
+) {
+    if (!grid || (num_tracks > 0 && !tracks)) {
+        return;
+    }
+
+    pthread_mutex_lock(&grid->mutex);
+
+    uint64_t dt_ms = 0;
+    if (grid->has_update && timestamp_ms > grid->last_update_ms) {
+        dt_ms = timestamp_ms - grid->last_update_ms;
+    }
+    if (!grid->has_update || timestamp_ms > grid->last_update_ms) {
+        grid->last_update_ms = timestamp_ms;
+    }
+    grid->has_update = true;
+
+    // Decay everything by advancing the scale
+    if (dt_ms > 0) {
+        grid->scale *= exp2((double)dt_ms / grid->half_life_ms);
+        if (grid->scale > RESCALE_LIMIT) {
+            rescale(grid);
+        }
+    }
+
+    float weight = (float)grid->scale;
+    float dwell = (float)(dt_ms < MAX_FRAME_GAP_MS ? dt_ms : MAX_FRAME_GAP_MS) / 1000.0f * weight;
+
+    int32_t cells[BIN_BATCH];
+    for (uint32_t base = 0; base < num_tracks; base += BIN_BATCH) {
+        uint32_t count = num_tracks - base < BIN_BATCH ? num_tracks - base : BIN_BATCH;
+        bin_ground_points(grid, &tracks[base], count, cells);
+
+        for (uint32_t i = 0; i < count; i++) {
+            int32_t cell = cells[i];
+            grid->presence[cell] += dwell;
+
+            bool is_new = false;
+            int32_t slot = track_index_acquire(grid->index, tracks[base + i].track_id,
+                                               &is_new, NULL);
+            if (slot >= 0 && (is_new || grid->last_cell[slot] != cell)) {
+                grid->visits[cell] += weight;
+                grid->last_cell[slot] = cell;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&grid->mutex);
+}
+
+bool occupancy_grid_read(
+    OccupancyGrid* grid,
+    uint32_t* cols,
+    uint32_t* rows,
+    float* presence_s,
+    float* visits,
+    uint64_t* timestamp_ms
+) {
+    if (!grid || !cols || !rows) {
+        return false;
+    }
+
+    clamp_size(grid, cols, rows);
+
+    pthread_mutex_lock(&grid->mutex);
+
+    if (presence_s) resample(grid, grid->presence, *cols, *rows, presence_s);
+    if (visits) resample(grid, grid->visits, *cols, *rows, visits);
+    if (timestamp_ms) *timestamp_ms = grid->last_update_ms;
+
+    pthread_mutex_unlock(&grid->mutex);
+    return true;
+}
+
+size_t occupancy_grid_export(
+    OccupancyGrid* grid,
+    uint32_t cols,
+    uint32_t rows,
+    uint8_t* buffer,
+    size_t size
+) {
+    if (!grid || !buffer) {
+        return 0;
+    }
+
+    clamp_size(grid, &cols, &rows);
+    size_t needed = OCCUPANCY_EXPORT_SIZE(cols, rows);
+    if (size < needed) {
+        return 0;
+    }
+
+    uint32_t n = cols * rows;
+    float* values = (float*)malloc(2 * (size_t)n * sizeof(float));
+    if (!values) {
+        return 0;
+    }
+
+    uint64_t timestamp_ms = 0;
+    occupancy_grid_read(grid, &cols, &rows, values, values + n, &timestamp_ms);
+
+    float max_presence = 0.0f;
+    float max_visits = 0.0f;
+    for (uint32_t i = 0; i < n; i++) {
+        max_presence = fmaxf(max_presence, values[i]);
+        max_visits = fmaxf(max_visits, values[n + i]);
+    }
+
+    uint8_t* p = buffer;
+    memcpy(p, "OHM1", 4);
+    p += 4;
+    p = put_u16(p, (uint16_t)cols);
+    p = put_u16(p, (uint16_t)rows);
+    p = put_u32(p, (uint32_t)timestamp_ms);
+    p = put_u32(p, (uint32_t)(timestamp_ms >> 32));
+    p = put_u32(p, (uint32_t)grid->half_life_ms);
+    p = put_f32(p, max_presence);
+    p = put_f32(p, max_visits);
+
+    float q_presence = max_presence > 0.0f ? 65535.0f / max_presence : 0.0f;
+    float q_visits = max_visits > 0.0f ? 65535.0f / max_visits : 0.0f;
+    for (uint32_t i = 0; i < n; i++) {
+        p = put_u16(p, (uint16_t)(values[i] * q_presence + 0.5f));
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        p = put_u16(p, (uint16_t)(values[n + i] * q_visits + 0.5f));
+    }
+
+    free(values);
+    return (size_t)(p - buffer);
+}
+
+uint32_t occupancy_grid_resolution(const OccupancyGrid* grid) {
+    return grid ? grid->resolution : 0;
+}
+
+void occupancy_grid_reset(OccupancyGrid* grid) {
+    if (!grid) {
+        return;
+    }
+
+    pthread_mutex_lock(&grid->mutex);
+
+    size_t cells = (size_t)grid->resolution * grid->resolution;
+    memset(grid->presence, 0, cells * sizeof(float));
+    memset(grid->visits, 0, cells * sizeof(float));
+    grid->scale = 1.0;
+    grid->has_update = false;
+    grid->last_update_ms = 0;
+    track_index_clear(grid->index);
+
+    pthread_mutex_unlock(&grid->mutex);
+}
+
+void occupancy_grid_destroy(OccupancyGrid* grid) {
+    if (!grid) {
+        return;
+    }
+
+    pthread_mutex_destroy(&grid->mutex);
+    track_index_destroy(grid->index);
+    free(grid->presence);
+    free(grid->visits);
+    free(grid->last_cell);
+    free(grid);
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * Apply the accumulated decay to every cell and restart the scale at 1
+ */
+static void rescale(OccupancyGrid* grid) {
+    size_t cells = (size_t)grid->resolution * grid->resolution;
+    float inv = (float)(1.0 / grid->scale);
+
+    for (size_t i = 0; i < cells; i++) {
+        grid->presence[i] *= inv;
+        grid->visits[i] *= inv;
+    }
+    grid->scale = 1.0;
+}
+
+/**
+ * Cell of each track's ground point (bottom centre of the box)
+ *
+ * Ground points are gathered out of the (large) track structs first, so
+ * the binning itself is a straight-line loop over packed floats that the
+ * compiler vectorizes.
+ */
+static void bin_ground_points(const OccupancyGrid* grid, const TrackedObject* tracks,
+                              uint32_t count, int32_t* cells) {
+    float gx[BIN_BATCH];
+    float gy[BIN_BATCH];
+
+    for (uint32_t i = 0; i < count; i++) {
+        const BoundingBox* box = &tracks[i].current_bbox;
+        gx[i] = box->x + 0.5f * box->width;
+        gy[i] = box->y + box->height;
+    }
+
+    float res = (float)grid->resolution;
+    float last = res - 1.0f;
+    int32_t stride = (int32_t)grid->resolution;
+
+    // Clamps written as selects (NaN lands in cell 0)
+    for (uint32_t i = 0; i < count; i++) {
+        float cx = gx[i] * res;
+        float cy = gy[i] * res;
+        cx = (cx >= 0.0f) ? cx : 0.0f;
+        cy = (cy >= 0.0f) ? cy : 0.0f;
+        cx = (cx <= last) ? cx : last;
+        cy = (cy <= last) ? cy : last;
+        cells[i] = (int32_t)cy * stride + (int32_t)cx;
+    }
+}
+
+/**
+ * Sum native cells into a cols x rows grid and remove the decay scale
+ */
+static void resample(const OccupancyGrid* grid, const float* src, uint32_t cols,
+                     uint32_t rows, float* dst) {
+    uint32_t res = grid->resolution;
+    float inv = (float)(1.0 / grid->scale);
+
+    memset(dst, 0, (size_t)cols * rows * sizeof(float));
+    for (uint32_t r = 0; r < res; r++) {
+        float* out = &dst[(size_t)(r * rows / res) * cols];
+        const float* in = &src[(size_t)r * res];
+        for (uint32_t c = 0; c < res; c++) {
+            out[c * cols / res] += in[c] * inv;
+        }
+    }
+}
+
+static void clamp_size(const OccupancyGrid* grid, uint32_t* cols, uint32_t* rows) {
+    if (*cols == 0 || *cols > grid->resolution) *cols = grid->resolution;
+    if (*rows == 0 || *rows > grid->resolution) *rows = grid->resolution;
+}
+
+static uint8_t* put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+static uint8_t* put_u32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+    return p + 4;
+}
+
+static uint8_t* put_f32(uint8_t* p, float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return put_u32(p, bits);
+}
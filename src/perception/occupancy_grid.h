@@ -0,0 +1,147 @@
+/**
+ * @file occupancy_grid.h
+ * @brief Streaming occupancy / dwell-time heatmap for OMNISIGHT
+ *
+ * Accumulates, per cell of a grid over the normalized image, how long
+ * tracked objects have stood there (presence, in object-seconds) and how
+ * often a track entered the cell (visits). Both decay exponentially with
+ * a configurable half-life, so the grid answers "where do people hang
+ * around lately" without replaying track history.
+ *
+ * Decay is applied lazily: new contributions are weighted by a growing
+ * scale factor and readers divide it out, so a frame update touches only
+ * the cells that tracks occupy. The whole grid is rescaled only when the
+ * factor gets large (once per ~20 half-lives).
+ */
+
+#ifndef OMNISIGHT_OCCUPANCY_GRID_H
+#define OMNISIGHT_OCCUPANCY_GRID_H
+
+#include "perception.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OCCUPANCY_GRID_DEFAULT_RESOLUTION 64
+#define OCCUPANCY_GRID_DEFAULT_HALF_LIFE_MS 600000   // 10 minutes
+
+/**
+ * Binary export layout (little-endian):
+ *   char[4]  magic "OHM1"
+ *   uint16   cols, rows
+ *   uint64   timestamp_ms of the last update
+ *   uint32   half_life_ms
+ *   float32  max_presence_s, max_visits
+ *   uint16   presence[rows * cols]   (row-major, value / max * 65535)
+ *   uint16   visits[rows * cols]
+ */
+#define OCCUPANCY_EXPORT_HEADER_SIZE 28
+#define OCCUPANCY_EXPORT_SIZE(cols, rows) \
+    (OCCUPANCY_EXPORT_HEADER_SIZE + (size_t)(cols) * (rows) * 2 * sizeof(uint16_t))
+
+typedef struct OccupancyGrid OccupancyGrid;
+
+/**
+ * Create an empty grid
+ *
+ * @param resolution Cells per side (0 = OCCUPANCY_GRID_DEFAULT_RESOLUTION)
+ * @param half_life_ms Decay half-life (0 = OCCUPANCY_GRID_DEFAULT_HALF_LIFE_MS)
+ * @param max_tracks Tracks followed for visit counting (0 = 100)
+ * @return Grid instance, NULL on failure
+ */
+OccupancyGrid* occupancy_grid_create(
+    uint32_t resolution,
+    uint32_t half_life_ms,
+    uint32_t max_tracks
+);
+
+/**
+ * Add one frame of tracks
+ *
+ * Each track's ground point (bottom centre of its box) is credited with
+ * the time since the previous frame; entering a new cell counts a visit.
+ *
+ * @param grid Grid instance
+ * @param tracks Current tracks
+ * @param num_tracks Number of tracks
+ * @param timestamp_ms Frame time (must not decrease)
+ */
+void occupancy_grid_update(
+    OccupancyGrid* grid,
+    const TrackedObject* tracks,
+    uint32_t num_tracks,
+    uint64_t timestamp_ms
+);
+
+/**
+ * Read the decayed grid at a chosen resolution
+ *
+ * Cells are summed into the output, so totals do not depend on the
+ * resolution. Sizes above the native resolution are clamped to it.
+ *
+ * @param grid Grid instance
+ * @param cols In: requested columns (0 = native); out: columns used
+ * @param rows In: requested rows (0 = native); out: rows used
+ * @param presence_s Output presence per cell, rows * cols, row-major (may be NULL)
+ * @param visits Output visits per cell (may be NULL)
+ * @param timestamp_ms Output time of the last update (may be NULL)
+ * @return true on success
+ */
+bool occupancy_grid_read(
+    OccupancyGrid* grid,
+    uint32_t* cols,
+    uint32_t* rows,
+    float* presence_s,
+    float* visits,
+    uint64_t* timestamp_ms
+);
+
+/**
+ * Export the grid in the compact binary layout above
+ *
+ * @param grid Grid instance
+ * @param cols Columns (0 = native, clamped like occupancy_grid_read())
+ * @param rows Rows (0 = native)
+ * @param buffer Output buffer
+ * @param size Buffer size (OCCUPANCY_EXPORT_SIZE(cols, rows) is enough)
+ * @return Bytes written, 0 if the buffer is too small
+ */
+size_t occupancy_grid_export(
+    OccupancyGrid* grid,
+    uint32_t cols,
+    uint32_t rows,
+    uint8_t* buffer,
+    size_t size
+);
+
+/**
+ * Native resolution (cells per side)
+ *
+ * @param grid Grid instance
+ * @return Resolution
+ */
+uint32_t occupancy_grid_resolution(const OccupancyGrid* grid);
+
+/**
+ * Clear all accumulated occupancy
+ *
+ * @param grid Grid instance
+ */
+void occupancy_grid_reset(OccupancyGrid* grid);
+
+/**
+ * Destroy grid
+ *
+ * @param grid Grid instance
+ */
+void occupancy_grid_destroy(OccupancyGrid* grid);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OMNISIGHT_OCCUPANCY_GRID_H
@@ -9,7 +9,11 @@
 #include "vdo_capture.h"
 #include "larod_inference.h"
 #include "tracker.h"
-#include "behavior.h"
+#include "behavior_batch.h"
+#include "track_snapshot.h"
+#include "occupancy_grid.h"
+#include "group_analyzer.h"
+#include "zone_map.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -23,7 +27,24 @@ struct PerceptionEngine {
     VdoCapture* vdo;
     LarodInference* larod;
     Tracker* tracker;
-    BehaviorAnalyzer* behavior;
+    BehaviorBatch* behavior;
+
+    // Latest frame's tracks, readable without engine->mutex
+    TrackSnapshot* snapshot;
+
+    // Occupancy / dwell heatmap, readable without engine->mutex
+    OccupancyGrid* heatmap;
+
+    // Groups and crowds, readable without engine->mutex
+    GroupAnalyzer* groups;
+
+    // Zones weighted into threat scores; editable while running
+    ZoneMap* zones;
+
+    // Global camera motion (NULL when compensation is disabled)
+    MotionEstimator* motion;
+    pthread_mutex_t motion_stats_mutex;  // Guards motion_stats only
+    MotionEstimatorStats motion_stats;   // Copy published after each frame
 
     PerceptionCallback callback;
     void* callback_user_data;
@@ -42,6 +63,7 @@ struct PerceptionEngine {
 // Forward declarations
 static void* capture_thread_func(void* arg);
 static void process_frame(PerceptionEngine* engine, VdoBuffer* buffer);
+static void estimate_camera_motion(PerceptionEngine* engine, VdoBuffer* buffer);
 
 // ============================================================================
 // Public API Implementation
@@ -67,6 +89,16 @@ PerceptionEngine* perception_init(const PerceptionConfig* config) {
     engine->avg_fps = 0.0f;
 
     pthread_mutex_init(&engine->mutex, NULL);
+    pthread_mutex_init(&engine->motion_stats_mutex, NULL);
+
+    engine->snapshot = track_snapshot_create();
+    if (!engine->snapshot) {
+        syslog(LOG_ERR, "[Perception] Failed to allocate track snapshot");
+        pthread_mutex_destroy(&engine->motion_stats_mutex);
+        pthread_mutex_destroy(&engine->mutex);
+        free(engine);
+        return NULL;
+    }
 
     // Initialize VDO capture
     VdoCaptureConfig vdo_config = {
@@ -85,6 +117,13 @@ PerceptionEngine* perception_init(const PerceptionConfig* config) {
         printf("[Perception] Warning: VDO capture initialization failed (placeholder mode)\n");
     }
 
+    // Low-score detections are kept for the tracker's second association
+    // round, so inference filters at the lower of the two thresholds
+    float low_threshold = config->low_detection_threshold;
+    if (low_threshold <= 0.0f || low_threshold > config->detection_threshold) {
+        low_threshold = config->detection_threshold;
+    }
+
     // Initialize Larod inference
     LarodInferenceConfig larod_config = {
         .model_path = config->model_path,
@@ -92,7 +131,7 @@ PerceptionEngine* perception_init(const PerceptionConfig* config) {
         .width = config->frame_width,
         .height = config->frame_height,
         .input_format = VDO_FORMAT_YUV,
-        .confidence_threshold = config->detection_threshold,
+        .confidence_threshold = low_threshold,
         .max_detections = config->max_tracked_objects
     };
 
@@ -111,7 +150,14 @@ PerceptionEngine* perception_init(const PerceptionConfig* config) {
         .min_hits = 3,
         .max_tracks = config->max_tracked_objects,
         .use_kalman_filter = true,
-        .feature_similarity_weight = 0.3f
+        .feature_similarity_weight = 0.3f,
+        .high_confidence_threshold = config->detection_threshold,
+        .low_confidence_threshold = low_threshold,
+        .low_score_iou_threshold = 0.5f,
+        .reid_gallery_size = 64,
+        .reid_ttl_ms = 10000,
+        .reid_similarity_threshold = 0.7f,
+        .reid_max_distance = 0.25f
     };
 
     engine->tracker = tracker_init(&tracker_config);
@@ -122,24 +168,51 @@ PerceptionEngine* perception_init(const PerceptionConfig* config) {
         return NULL;
     }
 
-    // Initialize behavior analyzer
-    BehaviorConfig behavior_config = {
-        .loitering_threshold_ms = config->loitering_threshold_ms,
-        .loitering_movement_threshold = 0.05f,
+    // Initialize camera motion estimator
+    if (config->enable_motion_compensation) {
+        engine->motion = motion_estimator_init(0.0f);
+        if (!engine->motion) {
+            syslog(LOG_ERR, "[Perception] Motion estimator initialization failed");
+            printf("[Perception] Error: Motion estimator initialization failed\n");
+            perception_destroy(engine);
+            return NULL;
+        }
+    }
+
+    // Initialize zones (empty until configured through perception_get_zone_map())
+    engine->zones = zone_map_create(ZONE_MAP_DEFAULT_RESOLUTION);
+    if (!engine->zones) {
+        syslog(LOG_ERR, "[Perception] Zone map initialization failed");
+        printf("[Perception] Error: Zone map initialization failed\n");
+        perception_destroy(engine);
+        return NULL;
+    }
+
+    // Initialize behavior analyzer (all tracks of a frame in one batch)
+    BehaviorAnalyzerConfig behavior_config = {
+        .loitering_dwell_time_ms = (float)config->loitering_threshold_ms,
+        .loitering_velocity_threshold = 0.5f,
+        .loitering_radius_meters = 2.0f,
         .running_velocity_threshold = config->running_velocity_threshold,
-        .running_frames_threshold = 5,
-        .repeated_passes_count = 3,
-        .repeated_passes_window_ms = 60000,
-        .observation_threshold_ms = 10000,
-        .observation_gaze_threshold = 0.8f,
-        .loitering_weight = 0.3f,
-        .running_weight = 0.5f,
-        .concealing_weight = 0.8f,
-        .repeated_passes_weight = 0.4f,
-        .observation_weight = 0.6f
+        .running_duration_ms = 1000,
+        .zigzag_threshold = 45.0f,
+        .zigzag_count_threshold = 5,
+        .enable_zone_analysis = true,
+        .zone_map = engine->zones,
+        .weight_zone = 0.25f,
+        .meters_per_normalized_unit = 10.0f,
+        .weight_loitering = 0.3f,
+        .weight_running = 0.4f,
+        .weight_unusual_movement = 0.5f,
+        .weight_dwell_time = 0.2f
+    };
+
+    BehaviorBatchConfig batch_config = {
+        .rules = BEHAVIOR_RULES_TRAJECTORY,
+        .trajectory = behavior_config
     };
 
-    engine->behavior = behavior_init(&behavior_config);
+    engine->behavior = behavior_batch_create(&batch_config);
     if (!engine->behavior) {
         syslog(LOG_ERR, "[Perception] Behavior analyzer initialization failed");
         printf("[Perception] Error: Behavior analyzer initialization failed\n");
@@ -147,6 +220,31 @@ PerceptionEngine* perception_init(const PerceptionConfig* config) {
         return NULL;
     }
 
+    engine->heatmap = occupancy_grid_create(config->heatmap_resolution,
+                                            config->heatmap_half_life_ms,
+                                            config->max_tracked_objects);
+    if (!engine->heatmap) {
+        syslog(LOG_ERR, "[Perception] Occupancy heatmap initialization failed");
+        printf("[Perception] Error: Occupancy heatmap initialization failed\n");
+        perception_destroy(engine);
+        return NULL;
+    }
+
+    GroupAnalyzerConfig group_config = {
+        .link_distance = config->group_link_distance,
+        .crowd_size = config->crowd_size,
+        .class_mask = 1u << OBJECT_CLASS_PERSON,
+        .max_tracks = TRACK_SNAPSHOT_MAX_TRACKS
+    };
+
+    engine->groups = group_analyzer_create(&group_config);
+    if (!engine->groups) {
+        syslog(LOG_ERR, "[Perception] Group analyzer initialization failed");
+        printf("[Perception] Error: Group analyzer initialization failed\n");
+        perception_destroy(engine);
+        return NULL;
+    }
+
     printf("[Perception] Engine initialized successfully\n");
     printf("[Perception] Frame size: %ux%u @ %u FPS\n",
            config->frame_width, config->frame_height, config->target_fps);
@@ -260,9 +358,21 @@ void perception_destroy(PerceptionEngine* engine) {
     }
 
     if (engine->behavior) {
-        behavior_destroy(engine->behavior);
+        behavior_batch_destroy(engine->behavior);
+    }
+
+    // After the analyzer, which reads it
+    zone_map_destroy(engine->zones);
+
+    if (engine->motion) {
+        motion_estimator_destroy(engine->motion);
     }
 
+    occupancy_grid_destroy(engine->heatmap);
+    group_analyzer_destroy(engine->groups);
+    track_snapshot_destroy(engine->snapshot);
+
+    pthread_mutex_destroy(&engine->motion_stats_mutex);
     pthread_mutex_destroy(&engine->mutex);
 
     free(engine);
@@ -305,11 +415,73 @@ uint32_t perception_get_tracked_objects(
         return 0;
     }
 
-    pthread_mutex_lock(&engine->mutex);
-    uint32_t count = tracker_get_tracks(engine->tracker, objects, max_objects);
-    pthread_mutex_unlock(&engine->mutex);
+    return track_snapshot_read(engine->snapshot, objects, max_objects, NULL);
+}
 
-    return count;
+uint32_t perception_get_tracked_snapshot(
+    PerceptionEngine* engine,
+    TrackedObject* objects,
+    uint32_t max_objects,
+    uint64_t* version
+) {
+    if (!engine || !objects) {
+        return 0;
+    }
+
+    return track_snapshot_read(engine->snapshot, objects, max_objects, version);
+}
+
+uint64_t perception_get_tracks_version(PerceptionEngine* engine) {
+    if (!engine) {
+        return 0;
+    }
+
+    return track_snapshot_version(engine->snapshot);
+}
+
+bool perception_get_heatmap(
+    PerceptionEngine* engine,
+    uint32_t* cols,
+    uint32_t* rows,
+    float* presence_s,
+    float* visits,
+    uint64_t* timestamp_ms
+) {
+    if (!engine) {
+        return false;
+    }
+
+    return occupancy_grid_read(engine->heatmap, cols, rows, presence_s, visits, timestamp_ms);
+}
+
+uint32_t perception_get_heatmap_resolution(PerceptionEngine* engine) {
+    if (!engine) {
+        return 0;
+    }
+
+    return occupancy_grid_resolution(engine->heatmap);
+}
+
+size_t perception_export_heatmap(
+    PerceptionEngine* engine,
+    uint32_t cols,
+    uint32_t rows,
+    uint8_t* buffer,
+    size_t size
+) {
+    if (!engine) {
+        return 0;
+    }
+
+    return occupancy_grid_export(engine->heatmap, cols, rows, buffer, size);
+}
+
+GroupAnalyzer* perception_get_group_analyzer(PerceptionEngine* engine) {
+    return engine ? engine->groups : NULL;
+}
+
+ZoneMap* perception_get_zone_map(PerceptionEngine* engine) {
+    return engine ? engine->zones : NULL;
 }
 
 void perception_update_behavior_params(
@@ -327,10 +499,11 @@ void perception_update_behavior_params(
     engine->config.running_velocity_threshold = running_threshold;
 
     // Update behavior analyzer config
-    BehaviorConfig config;
-    config.loitering_threshold_ms = loitering_ms;
-    config.running_velocity_threshold = running_threshold;
-    behavior_update_config(engine->behavior, &config);
+    BehaviorBatchConfig config;
+    behavior_batch_get_config(engine->behavior, &config);
+    config.trajectory.loitering_dwell_time_ms = (float)loitering_ms;
+    config.trajectory.running_velocity_threshold = running_threshold;
+    behavior_batch_update_config(engine->behavior, &config);
 
     pthread_mutex_unlock(&engine->mutex);
 }
@@ -354,6 +527,18 @@ void perception_get_stats(
     pthread_mutex_unlock(&engine->mutex);
 }
 
+void perception_get_motion_stats(PerceptionEngine* engine, MotionEstimatorStats* stats) {
+    if (!engine || !stats) {
+        return;
+    }
+
+    // The capture thread holds engine->mutex for a whole frame; read the
+    // copy it publishes instead
+    pthread_mutex_lock(&engine->motion_stats_mutex);
+    *stats = engine->motion_stats;
+    pthread_mutex_unlock(&engine->motion_stats_mutex);
+}
+
 // ============================================================================
 // Internal Functions
 // ============================================================================
@@ -443,25 +628,44 @@ static void process_frame(PerceptionEngine* engine, VdoBuffer* buffer) {
         return;
     }
 
-    // Step 2: Update tracker with detections
-    TrackedObject tracks[50];
+    // Step 2: Compensate global camera motion before association
+    if (engine->motion) {
+        estimate_camera_motion(engine, buffer);
+    }
+
+    // Step 3: Update tracker with detections
+    TrackedObject tracks[TRACK_SNAPSHOT_MAX_TRACKS];
     uint32_t num_tracks = tracker_update(
         engine->tracker,
         detections,
         num_detections,
         tracks,
-        50
+        TRACK_SNAPSHOT_MAX_TRACKS
     );
 
-    // Step 3: Analyze behaviors on tracked objects
-    behavior_analyze(engine->behavior, tracks, num_tracks);
+    // Step 4: Analyze behaviors on tracked objects, releasing the
+    // histories of tracks the tracker just deleted
+    uint32_t deleted_ids[32];
+    uint32_t num_deleted;
+    while ((num_deleted = tracker_drain_deleted_tracks(engine->tracker, deleted_ids, 32)) > 0) {
+        for (uint32_t i = 0; i < num_deleted; i++) {
+            behavior_batch_remove_track(engine->behavior, deleted_ids[i]);
+        }
+    }
+
+    behavior_batch_analyze(engine->behavior, tracks, num_tracks);
+    occupancy_grid_update(engine->heatmap, tracks, num_tracks, buffer->timestamp_ms);
+    group_analyzer_update(engine->groups, tracks, num_tracks, buffer->timestamp_ms);
+
+    // Publish for lock-free readers (also when empty, so tracks disappear)
+    track_snapshot_publish(engine->snapshot, tracks, num_tracks);
 
-    // Step 4: Call user callback with tracked objects
+    // Step 5: Call user callback with tracked objects
     if (engine->callback && num_tracks > 0) {
         engine->callback(tracks, num_tracks, engine->callback_user_data);
     }
 
-    // Step 5: Update statistics
+    // Step 6: Update statistics
     engine->frames_processed++;
 
     // Get inference performance stats
@@ -477,7 +681,7 @@ static void process_frame(PerceptionEngine* engine, VdoBuffer* buffer) {
         engine->avg_inference_ms = avg_inference_ms;
     }
 
-    // Step 6: Adaptive framerate adjustment
+    // Step 7: Adaptive framerate adjustment
     if (engine->vdo && avg_inference_ms > 0.0f) {
         if (vdo_capture_update_framerate(engine->vdo, (unsigned int)avg_inference_ms)) {
             VdoFrameInfo frame_info;
@@ -489,3 +693,34 @@ static void process_frame(PerceptionEngine* engine, VdoBuffer* buffer) {
         }
     }
 }
+
+/**
+ * Estimate global camera motion for this frame and hand it to the tracker.
+ * The NV12 luma plane is registered against the previous frame.
+ */
+static void estimate_camera_motion(PerceptionEngine* engine, VdoBuffer* buffer) {
+    CameraMotion motion;
+    bool moved = false;
+
+    VdoFrameInfo frame_info;
+    const uint8_t* luma = (const uint8_t*)vdo_buffer_get_data(buffer);
+
+    if (luma && vdo_capture_get_frame_info(engine->vdo, &frame_info)) {
+        moved = motion_estimator_process_luma(
+            engine->motion,
+            luma,
+            frame_info.width,
+            frame_info.height,
+            frame_info.pitch,
+            &motion
+        );
+    }
+
+    if (moved) {
+        tracker_set_camera_motion(engine->tracker, motion.dx, motion.dy, motion.scale);
+    }
+
+    pthread_mutex_lock(&engine->motion_stats_mutex);
+    motion_estimator_get_stats(engine->motion, &engine->motion_stats);
+    pthread_mutex_unlock(&engine->motion_stats_mutex);
+}
@@ -17,6 +17,8 @@
 #ifndef OMNISIGHT_PERCEPTION_H
 #define OMNISIGHT_PERCEPTION_H
 
+#include "motion_estimator.h"
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -28,6 +30,8 @@ extern "C" {
 typedef struct PerceptionEngine PerceptionEngine;
 typedef struct DetectedObject DetectedObject;
 typedef struct TrackedObject TrackedObject;
+typedef struct GroupAnalyzer GroupAnalyzer;
+typedef struct ZoneMap ZoneMap;
 
 /**
  * Object classification types
@@ -112,17 +116,29 @@ typedef struct {
     uint32_t inference_threads;
 
     // Detection thresholds
-    float detection_threshold;    // Minimum confidence
+    float detection_threshold;    // Minimum confidence to start a track
+    float low_detection_threshold; // Minimum confidence to extend a track (0 = detection_threshold)
     float tracking_threshold;     // Minimum IoU for tracking
     uint32_t max_tracked_objects;
 
-    // Behavior detection
+    // Behavior detection (behavior_analysis.h rules, plus zones)
     uint32_t loitering_threshold_ms;
-    float running_velocity_threshold;
+    float running_velocity_threshold;  // Meters per second
 
     // Performance
     bool async_inference;
     uint32_t buffer_pool_size;
+
+    // Camera motion
+    bool enable_motion_compensation; // Warp track predictions by global camera motion
+
+    // Occupancy heatmap
+    uint32_t heatmap_resolution;    // Grid cells per side (0 = 64)
+    uint32_t heatmap_half_life_ms;  // Decay half-life (0 = 10 minutes)
+
+    // Groups and crowds (people only)
+    float group_link_distance;      // Max centre distance within a group (0 = 0.08)
+    uint32_t crowd_size;            // Members that make a crowd (0 = 8)
 } PerceptionConfig;
 
 /**
@@ -206,12 +222,42 @@ uint32_t perception_get_tracked_objects(
     uint32_t max_objects
 );
 
+/**
+ * Get the latest published track snapshot without blocking
+ *
+ * Tracks are published once per processed frame. Reading never waits
+ * for the capture thread and never delays it.
+ *
+ * @param engine Perception engine instance
+ * @param objects Output array for tracked objects
+ * @param max_objects Maximum objects to return
+ * @param version Output snapshot version (may be NULL)
+ * @return Number of tracked objects
+ */
+uint32_t perception_get_tracked_snapshot(
+    PerceptionEngine* engine,
+    TrackedObject* objects,
+    uint32_t max_objects,
+    uint64_t* version
+);
+
+/**
+ * Get the version of the latest published track snapshot
+ *
+ * Consumers compare this with the version of their last copy to skip
+ * unchanged data.
+ *
+ * @param engine Perception engine instance
+ * @return Snapshot version, 0 if nothing has been published yet
+ */
+uint64_t perception_get_tracks_version(PerceptionEngine* engine);
+
 /**
  * Update behavior analysis parameters
  *
  * @param engine Perception engine instance
  * @param loitering_ms Milliseconds before flagging loitering
- * @param running_threshold Velocity threshold for running detection
+ * @param running_threshold Velocity threshold for running detection (m/s)
  */
 void perception_update_behavior_params(
     PerceptionEngine* engine,
@@ -234,6 +280,90 @@ void perception_get_stats(
     uint32_t* dropped_frames
 );
 
+/**
+ * Get camera-motion estimation statistics (per-frame cost, last motion)
+ *
+ * @param engine Perception engine instance
+ * @param stats Output statistics (zeroed if motion compensation is off)
+ */
+void perception_get_motion_stats(PerceptionEngine* engine, MotionEstimatorStats* stats);
+
+/**
+ * Read the occupancy / dwell heatmap at a chosen resolution
+ *
+ * Updated every frame after behavior analysis; reading does not wait
+ * for frame processing.
+ *
+ * @param engine Perception engine instance
+ * @param cols In: requested columns (0 = native); out: columns used
+ * @param rows In: requested rows (0 = native); out: rows used
+ * @param presence_s Output decayed object-seconds per cell, rows * cols (may be NULL)
+ * @param visits Output decayed track entries per cell (may be NULL)
+ * @param timestamp_ms Output time of the last update (may be NULL)
+ * @return true on success
+ */
+bool perception_get_heatmap(
+    PerceptionEngine* engine,
+    uint32_t* cols,
+    uint32_t* rows,
+    float* presence_s,
+    float* visits,
+    uint64_t* timestamp_ms
+);
+
+/**
+ * Get the heatmap's native resolution
+ *
+ * Reads and exports never exceed it, so it bounds their buffer sizes.
+ *
+ * @param engine Perception engine instance
+ * @return Cells per side, 0 if engine is NULL
+ */
+uint32_t perception_get_heatmap_resolution(PerceptionEngine* engine);
+
+/**
+ * Export the heatmap in the compact binary layout of occupancy_grid.h
+ *
+ * @param engine Perception engine instance
+ * @param cols Columns (0 = native)
+ * @param rows Rows (0 = native)
+ * @param buffer Output buffer
+ * @param size Buffer size
+ * @return Bytes written, 0 on failure or if the buffer is too small
+ */
+size_t perception_export_heatmap(
+    PerceptionEngine* engine,
+    uint32_t cols,
+    uint32_t rows,
+    uint8_t* buffer,
+    size_t size
+);
+
+/**
+ * Get the group / crowd analyzer (see group_analyzer.h)
+ *
+ * Updated every frame after behavior analysis. The analyzer stays owned
+ * by the engine and may be read from any thread, e.g. passed to the
+ * timeline's event predictor for crowd formation.
+ *
+ * @param engine Perception engine instance
+ * @return Group analyzer, NULL if engine is NULL
+ */
+GroupAnalyzer* perception_get_group_analyzer(PerceptionEngine* engine);
+
+/**
+ * Get the zones used by behavior analysis (see zone_map.h)
+ *
+ * Empty at start. Tracks inside a zone get weight_zone x its sensitivity
+ * added to their threat score. The map stays owned by the engine and may
+ * be edited from any thread while running; it can also be handed to the
+ * timeline's event predictor (EventPredictorConfig.zone_map).
+ *
+ * @param engine Perception engine instance
+ * @return Zone map, NULL if engine is NULL
+ */
+ZoneMap* perception_get_zone_map(PerceptionEngine* engine);
+
 #ifdef __cplusplus
 }
 #endif
@@ -7,6 +7,10 @@
  */
 
 #include "perception.h"
+#include "track_snapshot.h"
+#include "occupancy_grid.h"
+#include "group_analyzer.h"
+#include "zone_map.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -30,6 +34,10 @@ struct PerceptionEngine {
     uint32_t next_track_id;
     TrackedObject simulated_tracks[10];
     uint32_t num_simulated_tracks;
+    TrackSnapshot* snapshot;
+    OccupancyGrid* heatmap;
+    GroupAnalyzer* groups;
+    ZoneMap* zones;             // Configurable, not used by the simulation
 
     // Statistics
     float avg_inference_ms;
@@ -158,6 +166,14 @@ static void generate_simulated_tracks(PerceptionEngine* engine) {
         engine->num_simulated_tracks++;
     }
 
+    track_snapshot_publish(engine->snapshot, engine->simulated_tracks,
+                           engine->num_simulated_tracks);
+    uint64_t now_ms = get_current_time_ms();
+    occupancy_grid_update(engine->heatmap, engine->simulated_tracks,
+                          engine->num_simulated_tracks, now_ms);
+    group_analyzer_update(engine->groups, engine->simulated_tracks,
+                          engine->num_simulated_tracks, now_ms);
+
     pthread_mutex_unlock(&engine->mutex);
 }
 
@@ -230,6 +246,26 @@ PerceptionEngine* perception_init(const PerceptionConfig* config) {
 
     pthread_mutex_init(&engine->mutex, NULL);
 
+    engine->snapshot = track_snapshot_create();
+    engine->heatmap = occupancy_grid_create(config->heatmap_resolution,
+                                            config->heatmap_half_life_ms, 0);
+    GroupAnalyzerConfig group_config = {
+        .link_distance = config->group_link_distance,
+        .crowd_size = config->crowd_size,
+        .class_mask = 1u << OBJECT_CLASS_PERSON
+    };
+    engine->groups = group_analyzer_create(&group_config);
+    engine->zones = zone_map_create(ZONE_MAP_DEFAULT_RESOLUTION);
+    if (!engine->snapshot || !engine->heatmap || !engine->groups || !engine->zones) {
+        track_snapshot_destroy(engine->snapshot);
+        occupancy_grid_destroy(engine->heatmap);
+        group_analyzer_destroy(engine->groups);
+        zone_map_destroy(engine->zones);
+        pthread_mutex_destroy(&engine->mutex);
+        free(engine);
+        return NULL;
+    }
+
     printf("[Perception] ✓ Stub engine initialized\n");
     printf("[Perception]   - Target FPS: %u\n", config->target_fps);
     printf("[Perception]   - Resolution: %ux%u\n",
@@ -285,6 +321,10 @@ void perception_destroy(PerceptionEngine* engine) {
         perception_stop(engine);
     }
 
+    occupancy_grid_destroy(engine->heatmap);
+    group_analyzer_destroy(engine->groups);
+    zone_map_destroy(engine->zones);
+    track_snapshot_destroy(engine->snapshot);
     pthread_mutex_destroy(&engine->mutex);
     free(engine);
 
@@ -326,13 +366,57 @@ uint32_t perception_get_tracked_objects(PerceptionEngine* engine,
                                          uint32_t max_objects) {
     if (!engine || !objects) return 0;
 
-    pthread_mutex_lock(&engine->mutex);
-    uint32_t count = engine->num_simulated_tracks < max_objects ?
-                     engine->num_simulated_tracks : max_objects;
-    memcpy(objects, engine->simulated_tracks, count * sizeof(TrackedObject));
-    pthread_mutex_unlock(&engine->mutex);
+    return track_snapshot_read(engine->snapshot, objects, max_objects, NULL);
+}
 
-    return count;
+uint32_t perception_get_tracked_snapshot(PerceptionEngine* engine,
+                                          TrackedObject* objects,
+                                          uint32_t max_objects,
+                                          uint64_t* version) {
+    if (!engine || !objects) return 0;
+
+    return track_snapshot_read(engine->snapshot, objects, max_objects, version);
+}
+
+uint64_t perception_get_tracks_version(PerceptionEngine* engine) {
+    if (!engine) return 0;
+
+    return track_snapshot_version(engine->snapshot);
+}
+
+bool perception_get_heatmap(PerceptionEngine* engine,
+                            uint32_t* cols,
+                            uint32_t* rows,
+                            float* presence_s,
+                            float* visits,
+                            uint64_t* timestamp_ms) {
+    if (!engine) return false;
+
+    return occupancy_grid_read(engine->heatmap, cols, rows, presence_s, visits, timestamp_ms);
+}
+
+uint32_t perception_get_heatmap_resolution(PerceptionEngine* engine) {
+    if (!engine) return 0;
+
+    return occupancy_grid_resolution(engine->heatmap);
+}
+
+size_t perception_export_heatmap(PerceptionEngine* engine,
+                                 uint32_t cols,
+                                 uint32_t rows,
+                                 uint8_t* buffer,
+                                 size_t size) {
+    if (!engine) return 0;
+
+    return occupancy_grid_export(engine->heatmap, cols, rows, buffer, size);
+}
+
+GroupAnalyzer* perception_get_group_analyzer(PerceptionEngine* engine) {
+    return engine ? engine->groups : NULL;
+}
+
+ZoneMap* perception_get_zone_map(PerceptionEngine* engine) {
+    return engine ? engine->zones : NULL;
 }
 
 void perception_update_behavior_params(PerceptionEngine* engine,
@@ -354,3 +438,9 @@ void perception_get_stats(PerceptionEngine* engine,
     if (avg_fps) *avg_fps = engine->avg_fps;
     if (dropped_frames) *dropped_frames = engine->dropped_frames;
 }
+
+void perception_get_motion_stats(PerceptionEngine* engine, MotionEstimatorStats* stats) {
+    if (!engine || !stats) return;
+
+    memset(stats, 0, sizeof(*stats));
+}
@@ -0,0 +1,273 @@
+/**
+ * @file track_index.c
+ * @brief Open-addressing track_id -> slot map with an LRU list
+ *
+ * The hash table holds slot numbers and is probed linearly. It is sized
+ * to at least twice the slot count, so probe sequences stay short, and
+ * removals shift the following entries back instead of leaving
+ * tombstones. In-use slots form a doubly linked recency list (head = most
+ * recently used); free slots are chained through the same next links.
+ */
+
+#include "track_index.h"
+#include <stdlib.h>
+
+#define EMPTY -1
+
+struct TrackIndex {
+    uint32_t capacity;
+    uint32_t mask;           // Hash table size - 1
+    int32_t* table;          // Bucket -> slot, EMPTY if unused
+    uint32_t* slot_track;    // Slot -> track_id
+    int32_t* prev;           // Recency list, towards the head
+    int32_t* next;           // Recency list towards the tail, or free list
+    bool* in_use;
+    int32_t head;            // Most recently used slot
+    int32_t tail;            // Least recently used slot
+    int32_t free_head;
+    uint32_t count;
+};
+
+static uint32_t hash_track_id(const TrackIndex* index, uint32_t track_id);
+static int32_t find_bucket(const TrackIndex* index, uint32_t track_id);
+static void remove_bucket(TrackIndex* index, uint32_t bucket);
+static void list_unlink(TrackIndex* index, int32_t slot);
+static void list_push_front(TrackIndex* index, int32_t slot);
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+TrackIndex* track_index_create(uint32_t capacity) {
+    if (capacity == 0 || capacity > (1u << 24)) {
+        return NULL;
+    }
+
+    TrackIndex* index = (TrackIndex*)calloc(1, sizeof(TrackIndex));
+    if (!index) {
+        return NULL;
+    }
+
+    uint32_t table_size = 8;
+    while (table_size < capacity * 2) {
+        table_size <<= 1;
+    }
+
+    index->capacity = capacity;
+    index->mask = table_size - 1;
+    index->table = (int32_t*)malloc(table_size * sizeof(int32_t));
+    index->slot_track = (uint32_t*)calloc(capacity, sizeof(uint32_t));
+    index->prev = (int32_t*)malloc(capacity * sizeof(int32_t));
+    index->next = (int32_t*)malloc(capacity * sizeof(int32_t));
+    index->in_use = (bool*)calloc(capacity, sizeof(bool));
+
+    if (!index->table || !index->slot_track || !index->prev ||
+        !index->next || !index->in_use) {
+        track_index_destroy(index);
+        return NULL;
+    }
+
+    track_index_clear(index);
+    return index;
+}
+
+int32_t track_index_find(const TrackIndex* index, uint32_t track_id) {
+    if (!index) {
+        return EMPTY;
+    }
+
+    int32_t bucket = find_bucket(index, track_id);
+    return bucket >= 0 ? index->table[bucket] : EMPTY;
+}
+
+int32_t track_index_acquire(
+    TrackIndex* index,
+    uint32_t track_id,
+    bool* is_new,
+    uint32_t* evicted_id
+) {
+    if (is_new) *is_new = false;
+    if (evicted_id) *evicted_id = 0;
+
+    if (!index) {
+        return EMPTY;
+    }
+
+    int32_t bucket = find_bucket(index, track_id);
+    if (bucket >= 0) {
+        int32_t slot = index->table[bucket];
+        if (index->head != slot) {
+            list_unlink(index, slot);
+            list_push_front(index, slot);
+        }
+        return slot;
+    }
+
+    // Take a free slot, or hand over the least recently used one
+    int32_t slot = index->free_head;
+    if (slot != EMPTY) {
+        index->free_head = index->next[slot];
+    } else {
+        slot = index->tail;
+        if (evicted_id) *evicted_id = index->slot_track[slot];
+        remove_bucket(index, (uint32_t)find_bucket(index, index->slot_track[slot]));
+        list_unlink(index, slot);
+        index->count--;
+    }
+
+    uint32_t b = hash_track_id(index, track_id);
+    while (index->table[b] != EMPTY) {
+        b = (b + 1) & index->mask;
+    }
+    index->table[b] = slot;
+
+    index->slot_track[slot] = track_id;
+    index->in_use[slot] = true;
+    list_push_front(index, slot);
+    index->count++;
+
+    if (is_new) *is_new = true;
+    return slot;
+}
+
+int32_t track_index_remove(TrackIndex* index, uint32_t track_id) {
+    if (!index) {
+        return EMPTY;
+    }
+
+    int32_t bucket = find_bucket(index, track_id);
+    if (bucket < 0) {
+        return EMPTY;
+    }
+
+    int32_t slot = index->table[bucket];
+    remove_bucket(index, (uint32_t)bucket);
+    list_unlink(index, slot);
+
+    index->in_use[slot] = false;
+    index->next[slot] = index->free_head;
+    index->free_head = slot;
+    index->count--;
+
+    return slot;
+}
+
+bool track_index_slot_track(const TrackIndex* index, uint32_t slot, uint32_t* track_id) {
+    if (!index || slot >= index->capacity || !index->in_use[slot]) {
+        return false;
+    }
+
+    if (track_id) *track_id = index->slot_track[slot];
+    return true;
+}
+
+uint32_t track_index_count(const TrackIndex* index) {
+    return index ? index->count : 0;
+}
+
+void track_index_clear(TrackIndex* index) {
+    if (!index) {
+        return;
+    }
+
+    for (uint32_t b = 0; b <= index->mask; b++) {
+        index->table[b] = EMPTY;
+    }
+
+    for (uint32_t s = 0; s < index->capacity; s++) {
+        index->in_use[s] = false;
+        index->prev[s] = EMPTY;
+        index->next[s] = (s + 1 < index->capacity) ? (int32_t)(s + 1) : EMPTY;
+    }
+
+    index->head = EMPTY;
+    index->tail = EMPTY;
+    index->free_head = 0;
+    index->count = 0;
+}
+
+void track_index_destroy(TrackIndex* index) {
+    if (index) {
+        free(index->table);
+        free(index->slot_track);
+        free(index->prev);
+        free(index->next);
+        free(index->in_use);
+        free(index);
+    }
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+static uint32_t hash_track_id(const TrackIndex* index, uint32_t track_id) {
+    // Track IDs are sequential; scramble them so neighbours spread out
+    uint32_t h = track_id * 2654435761u;
+    return (h ^ (h >> 16)) & index->mask;
+}
+
+static int32_t find_bucket(const TrackIndex* index, uint32_t track_id) {
+    uint32_t b = hash_track_id(index, track_id);
+
+    while (index->table[b] != EMPTY) {
+        if (index->slot_track[index->table[b]] == track_id) {
+            return (int32_t)b;
+        }
+        b = (b + 1) & index->mask;
+    }
+
+    return EMPTY;
+}
+
+/**
+ * Empty a bucket and shift later members of its probe run back so every
+ * remaining entry is still reachable from its home bucket.
+ */
+static void remove_bucket(TrackIndex* index, uint32_t bucket) {
+    uint32_t hole = bucket;
+    uint32_t b = bucket;
+
+    index->table[hole] = EMPTY;
+
+    for (;;) {
+        b = (b + 1) & index->mask;
+        if (index->table[b] == EMPTY) {
+            break;
+        }
+
+        uint32_t home = hash_track_id(index, index->slot_track[index->table[b]]);
+
+        // Leave the entry if its home lies cyclically in (hole, b]
+        bool stays = (hole <= b) ? (home > hole && home <= b)
+                                 : (home > hole || home <= b);
+        if (!stays) {
+            index->table[hole] = index->table[b];
+            index->table[b] = EMPTY;
+            hole = b;
+        }
+    }
+}
+
+static void list_unlink(TrackIndex* index, int32_t slot) {
+    int32_t p = index->prev[slot];
+    int32_t n = index->next[slot];
+
+    if (p != EMPTY) index->next[p] = n; else index->head = n;
+    if (n != EMPTY) index->prev[n] = p; else index->tail = p;
+
+    index->prev[slot] = EMPTY;
+    index->next[slot] = EMPTY;
+}
+
+static void list_push_front(TrackIndex* index, int32_t slot) {
+    index->prev[slot] = EMPTY;
+    index->next[slot] = index->head;
+
+    if (index->head != EMPTY) {
+        index->prev[index->head] = slot;
+    } else {
+        index->tail = slot;
+    }
+    index->head = slot;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file track_index.h
+ * @brief Fixed-capacity track_id -> slot index with LRU eviction
+ *
+ * Maps tracker IDs to slots of a caller-owned array (per-track histories
+ * in the behavior analyzers). Lookups go through an open-addressing hash
+ * table and slots are kept on a recency list, so finding, creating,
+ * evicting and freeing a slot are all O(1) regardless of capacity.
+ */
+
+#ifndef OMNISIGHT_TRACK_INDEX_H
+#define OMNISIGHT_TRACK_INDEX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TrackIndex TrackIndex;
+
+/**
+ * Create an index over slots [0, capacity)
+ *
+ * @param capacity Number of slots
+ * @return Index instance, NULL on failure
+ */
+TrackIndex* track_index_create(uint32_t capacity);
+
+/**
+ * Find the slot of a track without changing its recency
+ *
+ * @param index Index instance
+ * @param track_id Track identifier
+ * @return Slot, or -1 if the track has none
+ */
+int32_t track_index_find(const TrackIndex* index, uint32_t track_id);
+
+/**
+ * Find or assign the slot of a track and mark it most recently used
+ *
+ * When every slot is taken the least recently used track is evicted and
+ * its slot handed over.
+ *
+ * @param index Index instance
+ * @param track_id Track identifier
+ * @param is_new Set true if the slot was newly assigned (caller resets it)
+ * @param evicted_id Set to the evicted track's ID, 0 if none (may be NULL)
+ * @return Slot, or -1 if the index has no capacity
+ */
+int32_t track_index_acquire(
+    TrackIndex* index,
+    uint32_t track_id,
+    bool* is_new,
+    uint32_t* evicted_id
+);
+
+/**
+ * Release the slot of a track
+ *
+ * @param index Index instance
+ * @param track_id Track identifier
+ * @return Released slot, or -1 if the track had none
+ */
+int32_t track_index_remove(TrackIndex* index, uint32_t track_id);
+
+/**
+ * Get the track holding a slot
+ *
+ * @param index Index instance
+ * @param slot Slot
+ * @param track_id Output track identifier
+ * @return true if the slot is in use
+ */
+bool track_index_slot_track(const TrackIndex* index, uint32_t slot, uint32_t* track_id);
+
+/**
+ * Number of slots in use
+ *
+ * @param index Index instance
+ * @return Slot count
+ */
+uint32_t track_index_count(const TrackIndex* index);
+
+/**
+ * Release every slot
+ *
+ * @param index Index instance
+ */
+void track_index_clear(TrackIndex* index);
+
+/**
+ * Destroy index
+ *
+ * @param index Index instance
+ */
+void track_index_destroy(TrackIndex* index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OMNISIGHT_TRACK_INDEX_H
@@ -0,0 +1,138 @@
+/**
+ * @file track_snapshot.c
+ * @brief Seqlock double-buffered track snapshots
+ *
+ * Version v lives in buffers[v & 1]. Publishing v + 1 writes the other
+ * buffer, bracketed by its sequence counter (odd while writing), then
+ * advances the version. A reader picks the buffer of the version it
+ * loaded, copies it, and accepts the copy if the buffer's sequence
+ * counter was even and unchanged across the copy.
+ */
+
+#include "track_snapshot.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    atomic_uint seq;           // Odd while the writer is filling this buffer
+    uint32_t num_tracks;
+    TrackedObject tracks[TRACK_SNAPSHOT_MAX_TRACKS];
+} SnapshotBuffer;
+
+struct TrackSnapshot {
+    SnapshotBuffer buffers[2];
+    atomic_uint_fast64_t version;   // Latest published version, 0 = none
+    atomic_uint_fast64_t read_retries;
+};
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+TrackSnapshot* track_snapshot_create(void) {
+    TrackSnapshot* snapshot = (TrackSnapshot*)calloc(1, sizeof(TrackSnapshot));
+    if (!snapshot) {
+        return NULL;
+    }
+
+    atomic_init(&snapshot->buffers[0].seq, 0);
+    atomic_init(&snapshot->buffers[1].seq, 0);
+    atomic_init(&snapshot->version, 0);
+    atomic_init(&snapshot->read_retries, 0);
+
+    return snapshot;
+}
+
+uint64_t track_snapshot_publish(
+    TrackSnapshot* snapshot,
+    const TrackedObject* tracks,
+    uint32_t num_tracks
+) {
+    if (!snapshot) {
+        return 0;
+    }
+
+    if (!tracks || num_tracks > TRACK_SNAPSHOT_MAX_TRACKS) {
+        num_tracks = tracks ? TRACK_SNAPSHOT_MAX_TRACKS : 0;
+    }
+
+    uint64_t next = atomic_load_explicit(&snapshot->version, memory_order_relaxed) + 1;
+    SnapshotBuffer* buffer = &snapshot->buffers[next & 1];
+
+    unsigned seq = atomic_load_explicit(&buffer->seq, memory_order_relaxed);
+    atomic_store_explicit(&buffer->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    buffer->num_tracks = num_tracks;
+    if (num_tracks > 0) {
+        memcpy(buffer->tracks, tracks, num_tracks * sizeof(TrackedObject));
+    }
+
+    atomic_store_explicit(&buffer->seq, seq + 2, memory_order_release);
+    atomic_store_explicit(&snapshot->version, next, memory_order_release);
+
+    return next;
+}
+
+uint32_t track_snapshot_read(
+    TrackSnapshot* snapshot,
+    TrackedObject* tracks,
+    uint32_t max_tracks,
+    uint64_t* version
+) {
+    if (!snapshot || !tracks) {
+        return 0;
+    }
+
+    for (;;) {
+        uint64_t v = atomic_load_explicit(&snapshot->version, memory_order_acquire);
+        if (v == 0) {
+            if (version) *version = 0;
+            return 0;
+        }
+
+        SnapshotBuffer* buffer = &snapshot->buffers[v & 1];
+
+        unsigned seq_before = atomic_load_explicit(&buffer->seq, memory_order_acquire);
+
+        if ((seq_before & 1) == 0) {
+            uint32_t count = buffer->num_tracks;
+            if (count > max_tracks) count = max_tracks;
+            if (count > TRACK_SNAPSHOT_MAX_TRACKS) count = TRACK_SNAPSHOT_MAX_TRACKS;
+
+            memcpy(tracks, buffer->tracks, count * sizeof(TrackedObject));
+
+            atomic_thread_fence(memory_order_acquire);
+            unsigned seq_after = atomic_load_explicit(&buffer->seq, memory_order_relaxed);
+
+            if (seq_after == seq_before) {
+                if (version) *version = v;
+                return count;
+            }
+        }
+
+        // Writer lapped us while copying; the newer version is complete
+        atomic_fetch_add_explicit(&snapshot->read_retries, 1, memory_order_relaxed);
+    }
+}
+
+uint64_t track_snapshot_version(TrackSnapshot* snapshot) {
+    if (!snapshot) {
+        return 0;
+    }
+
+    return atomic_load_explicit(&snapshot->version, memory_order_acquire);
+}
+
+uint64_t track_snapshot_read_retries(TrackSnapshot* snapshot) {
+    if (!snapshot) {
+        return 0;
+    }
+
+    return atomic_load_explicit(&snapshot->read_retries, memory_order_relaxed);
+}
+
+void track_snapshot_destroy(TrackSnapshot* snapshot) {
+    free(snapshot);
+}
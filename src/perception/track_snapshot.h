@@ -0,0 +1,95 @@
+/**
+ * @file track_snapshot.h
+ * @brief Lock-free publication of per-frame track lists for OMNISIGHT
+ *
+ * The perception thread publishes each frame's tracks as an immutable
+ * snapshot; any number of readers (core, HTTP, IPC) copy the latest one
+ * without taking a lock. Neither side ever blocks the other.
+ *
+ * Implemented as a seqlock over two buffers: the writer always fills the
+ * buffer that is not currently published, so a reader only has to retry
+ * if it is still copying when the writer comes around a second time.
+ */
+
+#ifndef OMNISIGHT_TRACK_SNAPSHOT_H
+#define OMNISIGHT_TRACK_SNAPSHOT_H
+
+#include "perception.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRACK_SNAPSHOT_MAX_TRACKS 50  // Tracks held per snapshot
+
+typedef struct TrackSnapshot TrackSnapshot;
+
+/**
+ * Create an empty snapshot holder (version 0)
+ *
+ * @return Snapshot instance, NULL on failure
+ */
+TrackSnapshot* track_snapshot_create(void);
+
+/**
+ * Publish a new frame's tracks (single writer only)
+ *
+ * @param snapshot Snapshot instance
+ * @param tracks Tracks to publish
+ * @param num_tracks Number of tracks (clamped to TRACK_SNAPSHOT_MAX_TRACKS)
+ * @return Version number of the published snapshot
+ */
+uint64_t track_snapshot_publish(
+    TrackSnapshot* snapshot,
+    const TrackedObject* tracks,
+    uint32_t num_tracks
+);
+
+/**
+ * Copy the latest snapshot (safe from any thread, never blocks)
+ *
+ * @param snapshot Snapshot instance
+ * @param tracks Output array
+ * @param max_tracks Size of output array
+ * @param version Output version of the copied snapshot (may be NULL)
+ * @return Number of tracks copied
+ */
+uint32_t track_snapshot_read(
+    TrackSnapshot* snapshot,
+    TrackedObject* tracks,
+    uint32_t max_tracks,
+    uint64_t* version
+);
+
+/**
+ * Get the latest published version without copying
+ *
+ * Consumers can compare this with the version of their last copy and
+ * skip unchanged data.
+ *
+ * @param snapshot Snapshot instance
+ * @return Latest version, 0 if nothing has been published
+ */
+uint64_t track_snapshot_version(TrackSnapshot* snapshot);
+
+/**
+ * Number of reads that had to retry because the writer overtook them
+ *
+ * @param snapshot Snapshot instance
+ * @return Retry count
+ */
+uint64_t track_snapshot_read_retries(TrackSnapshot* snapshot);
+
+/**
+ * Destroy snapshot holder
+ *
+ * @param snapshot Snapshot instance
+ */
+void track_snapshot_destroy(TrackSnapshot* snapshot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OMNISIGHT_TRACK_SNAPSHOT_H
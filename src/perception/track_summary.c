@@ -0,0 +1,256 @@
+/**
+ * @file track_summary.c
+ * @brief Multi-resolution bucketed track history
+ *
+ * Every level sees every sample; a level closes its open bucket once the
+ * next sample would make it span more than the level's bucket length.
+ * Levels are independent, so a window query reads a single level and
+ * never has to stitch resolutions together.
+ */
+
+#include "track_summary.h"
+#include <math.h>
+#include <string.h>
+
+static const uint32_t BUCKET_MS[TRACK_SUMMARY_LEVELS] = {1000, 5000};
+
+static void level_close_bucket(TrackSummaryLevel* level);
+static void level_add(TrackSummaryLevel* level, float x, float y, float speed,
+                      uint64_t timestamp_ms);
+static uint32_t select_level(const TrackSummary* summary, uint64_t since_ms);
+static void open_bucket_snapshot(const TrackSummaryLevel* level, HistoryBucket* bucket);
+static void fold_bucket(TrackSummaryCache* acc, const HistoryBucket* bucket);
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+uint32_t track_summary_bucket_ms(uint32_t level) {
+    return level < TRACK_SUMMARY_LEVELS ? BUCKET_MS[level] : 0;
+}
+
+void track_summary_reset(TrackSummary* summary) {
+    if (summary) {
+        memset(summary, 0, sizeof(TrackSummary));
+    }
+}
+
+void track_summary_add(
+    TrackSummary* summary,
+    float x,
+    float y,
+    float speed,
+    uint64_t timestamp_ms
+) {
+    if (!summary) {
+        return;
+    }
+
+    for (uint32_t l = 0; l < TRACK_SUMMARY_LEVELS; l++) {
+        TrackSummaryLevel* level = &summary->levels[l];
+
+        if (level->open.num_samples > 0 &&
+            timestamp_ms - level->open.start_ms >= BUCKET_MS[l]) {
+            level_close_bucket(level);
+        }
+
+        level_add(level, x, y, speed, timestamp_ms);
+    }
+}
+
+uint32_t track_summary_window(
+    const TrackSummary* summary,
+    uint64_t since_ms,
+    HistoryBucket* buckets,
+    uint32_t max_buckets
+) {
+    if (!summary || !buckets) {
+        return 0;
+    }
+
+    const TrackSummaryLevel* level = &summary->levels[select_level(summary, since_ms)];
+
+    // Skip closed buckets that ended before the window
+    uint32_t first = 0;
+    while (first < level->count &&
+           level->buckets[(level->head + first) % TRACK_SUMMARY_BUCKETS].end_ms < since_ms) {
+        first++;
+    }
+
+    uint32_t n = 0;
+    for (uint32_t i = first; i < level->count && n < max_buckets; i++) {
+        buckets[n++] = level->buckets[(level->head + i) % TRACK_SUMMARY_BUCKETS];
+    }
+
+    if (level->open.num_samples > 0 && n < max_buckets) {
+        open_bucket_snapshot(level, &buckets[n++]);
+    }
+
+    return n;
+}
+
+bool track_summary_window_stats(
+    TrackSummary* summary,
+    uint64_t since_ms,
+    float min_displacement,
+    TrackSummaryStats* stats
+) {
+    if (!summary || !stats) {
+        return false;
+    }
+
+    uint32_t l = select_level(summary, since_ms);
+    const TrackSummaryLevel* level = &summary->levels[l];
+    TrackSummaryCache* cache = &summary->cache;
+    uint32_t oldest = level->closed_total - level->count;
+
+    // The window start only moves forward between queries, so the scan
+    // for its first bucket can resume where the last query stopped
+    uint32_t first = oldest;
+    if (cache->valid && cache->level == l && since_ms >= cache->since_ms &&
+        cache->first > oldest) {
+        first = cache->first;
+    }
+    while (first < level->closed_total &&
+           level->buckets[first % TRACK_SUMMARY_BUCKETS].end_ms < since_ms) {
+        first++;
+    }
+
+    // Refold the closed buckets only if the set changed
+    if (!cache->valid || cache->level != l || cache->first != first ||
+        cache->closed_total != level->closed_total ||
+        cache->min_displacement != min_displacement) {
+        memset(cache, 0, sizeof(TrackSummaryCache));
+        cache->level = l;
+        cache->first = first;
+        cache->closed_total = level->closed_total;
+        cache->min_displacement = min_displacement;
+
+        for (uint32_t k = first; k < level->closed_total; k++) {
+            fold_bucket(cache, &level->buckets[k % TRACK_SUMMARY_BUCKETS]);
+        }
+        cache->valid = true;
+    }
+    cache->since_ms = since_ms;
+
+    // Fold the open bucket into a copy
+    TrackSummaryCache acc = *cache;
+    if (level->open.num_samples > 0) {
+        HistoryBucket open;
+        open_bucket_snapshot(level, &open);
+        fold_bucket(&acc, &open);
+    }
+
+    *stats = acc.stats;
+    stats->mean_speed = acc.stats.num_samples > 0 ?
+        (float)(acc.speed_sum / acc.stats.num_samples) : 0.0f;
+
+    return stats->num_samples > 0;
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * Finest level whose retained history reaches since_ms (or that still
+ * holds the track's whole life), else the coarsest
+ */
+static uint32_t select_level(const TrackSummary* summary, uint64_t since_ms) {
+    for (uint32_t l = 0; l < TRACK_SUMMARY_LEVELS; l++) {
+        const TrackSummaryLevel* level = &summary->levels[l];
+        if (!level->dropped || level->buckets[level->head].start_ms <= since_ms) {
+            return l;
+        }
+    }
+    return TRACK_SUMMARY_LEVELS - 1;
+}
+
+static void open_bucket_snapshot(const TrackSummaryLevel* level, HistoryBucket* bucket) {
+    *bucket = level->open;
+    bucket->centroid_x = (float)(level->sum_x / level->open.num_samples);
+    bucket->centroid_y = (float)(level->sum_y / level->open.num_samples);
+    bucket->mean_speed = (float)(level->sum_speed / level->open.num_samples);
+}
+
+/**
+ * Append one bucket (in time order) to running window aggregates
+ */
+static void fold_bucket(TrackSummaryCache* acc, const HistoryBucket* bucket) {
+    TrackSummaryStats* stats = &acc->stats;
+
+    if (stats->num_buckets == 0) {
+        stats->start_x = bucket->centroid_x;
+        stats->start_y = bucket->centroid_y;
+        stats->min_x = bucket->min_x;
+        stats->min_y = bucket->min_y;
+        stats->max_x = bucket->max_x;
+        stats->max_y = bucket->max_y;
+        acc->anchor_x = bucket->centroid_x;
+    } else {
+        if (bucket->min_x < stats->min_x) stats->min_x = bucket->min_x;
+        if (bucket->min_y < stats->min_y) stats->min_y = bucket->min_y;
+        if (bucket->max_x > stats->max_x) stats->max_x = bucket->max_x;
+        if (bucket->max_y > stats->max_y) stats->max_y = bucket->max_y;
+
+        float dx = bucket->centroid_x - acc->anchor_x;
+        if (fabsf(dx) >= acc->min_displacement) {
+            int direction = (dx > 0) ? 1 : -1;
+            if (acc->direction != 0 && direction != acc->direction) {
+                stats->reversals_x++;
+            }
+            acc->direction = direction;
+            acc->anchor_x = bucket->centroid_x;
+        }
+    }
+
+    stats->num_buckets++;
+    stats->num_samples += bucket->num_samples;
+    acc->speed_sum += (double)bucket->mean_speed * bucket->num_samples;
+}
+
+static void level_close_bucket(TrackSummaryLevel* level) {
+    HistoryBucket* bucket = &level->open;
+    bucket->centroid_x = (float)(level->sum_x / bucket->num_samples);
+    bucket->centroid_y = (float)(level->sum_y / bucket->num_samples);
+    bucket->mean_speed = (float)(level->sum_speed / bucket->num_samples);
+
+    // Bucket k always lives at k % TRACK_SUMMARY_BUCKETS
+    level->buckets[level->closed_total % TRACK_SUMMARY_BUCKETS] = *bucket;
+    level->closed_total++;
+
+    if (level->count < TRACK_SUMMARY_BUCKETS) {
+        level->count++;
+    } else {
+        level->head = (level->head + 1) % TRACK_SUMMARY_BUCKETS;
+        level->dropped = true;
+    }
+
+    memset(bucket, 0, sizeof(HistoryBucket));
+    level->sum_x = 0.0;
+    level->sum_y = 0.0;
+    level->sum_speed = 0.0;
+}
+
+static void level_add(TrackSummaryLevel* level, float x, float y, float speed,
+                      uint64_t timestamp_ms) {
+    HistoryBucket* bucket = &level->open;
+
+    if (bucket->num_samples == 0) {
+        bucket->start_ms = timestamp_ms;
+        bucket->min_x = bucket->max_x = x;
+        bucket->min_y = bucket->max_y = y;
+    } else {
+        if (x < bucket->min_x) bucket->min_x = x;
+        if (x > bucket->max_x) bucket->max_x = x;
+        if (y < bucket->min_y) bucket->min_y = y;
+        if (y > bucket->max_y) bucket->max_y = y;
+    }
+
+    bucket->end_ms = timestamp_ms;
+    bucket->num_samples++;
+
+    level->sum_x += x;
+    level->sum_y += y;
+    level->sum_speed += speed;
+}
@@ -0,0 +1,175 @@
+/**
+ * @file track_summary.h
+ * @brief Time-decimated long-horizon track history for OMNISIGHT
+ *
+ * The behavior analyzers keep a few seconds of positions at full rate.
+ * Loitering and repeated-pass windows reach back tens of seconds to
+ * minutes, so each track also keeps a TrackSummary: fixed-size rings of
+ * buckets at progressively coarser time resolution, each bucket holding
+ * the centroid, extent and mean speed of the samples that fell into it.
+ *
+ * Level 0 covers TRACK_SUMMARY_BUCKETS seconds in 1 s buckets, level 1
+ * covers TRACK_SUMMARY_BUCKETS x 5 s. Memory per track is constant
+ * (sizeof(TrackSummary), about 6 KB) regardless of frame rate or how long
+ * the track lives.
+ */
+
+#ifndef OMNISIGHT_TRACK_SUMMARY_H
+#define OMNISIGHT_TRACK_SUMMARY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRACK_SUMMARY_LEVELS 2
+#define TRACK_SUMMARY_BUCKETS 60
+
+/**
+ * Summary of the samples in one time bucket
+ */
+typedef struct {
+    uint64_t start_ms;          // First sample time
+    uint64_t end_ms;            // Last sample time
+    float centroid_x;           // Mean position
+    float centroid_y;
+    float min_x, min_y;         // Extent of the samples
+    float max_x, max_y;
+    float mean_speed;           // Mean of the per-sample speeds (caller units)
+    uint32_t num_samples;
+} HistoryBucket;
+
+/**
+ * Aggregates over a window of buckets
+ */
+typedef struct {
+    uint32_t num_buckets;       // Buckets in the window (including the open one)
+    uint32_t num_samples;
+    float start_x;              // Centroid of the oldest bucket
+    float start_y;
+    float min_x, min_y;         // Extent of all samples
+    float max_x, max_y;
+    float mean_speed;           // Mean over all samples
+    uint32_t reversals_x;       // Reversals of horizontal travel between centroids
+} TrackSummaryStats;
+
+/**
+ * One resolution level: closed buckets plus the bucket being filled
+ */
+typedef struct {
+    HistoryBucket buckets[TRACK_SUMMARY_BUCKETS];  // Ring, oldest at head
+    uint32_t head;
+    uint32_t count;
+    uint32_t closed_total;      // Buckets ever closed (bucket k is at k % TRACK_SUMMARY_BUCKETS)
+    bool dropped;               // Oldest buckets have been overwritten
+
+    HistoryBucket open;         // Accumulating (num_samples may be 0)
+    double sum_x;
+    double sum_y;
+    double sum_speed;
+} TrackSummaryLevel;
+
+/**
+ * Stats over the closed buckets of the last queried window. Closed
+ * buckets change once per bucket length, so most queries only have to
+ * fold in the open bucket.
+ */
+typedef struct {
+    bool valid;
+    uint32_t level;
+    uint32_t first;             // Absolute number of the oldest bucket in the window
+    uint32_t closed_total;      // Level's closed_total when computed
+    uint64_t since_ms;
+    float min_displacement;
+    TrackSummaryStats stats;
+    double speed_sum;
+    int direction;              // Reversal state after the last closed bucket
+    float anchor_x;
+} TrackSummaryCache;
+
+/**
+ * Multi-resolution history of one track
+ */
+typedef struct {
+    TrackSummaryLevel levels[TRACK_SUMMARY_LEVELS];
+    TrackSummaryCache cache;
+} TrackSummary;
+
+/**
+ * Bucket length of a level
+ *
+ * @param level Level index
+ * @return Bucket length in milliseconds
+ */
+uint32_t track_summary_bucket_ms(uint32_t level);
+
+/**
+ * Empty a summary
+ *
+ * @param summary Summary to reset
+ */
+void track_summary_reset(TrackSummary* summary);
+
+/**
+ * Add one sample (timestamps must not decrease)
+ *
+ * @param summary Track summary
+ * @param x Position X
+ * @param y Position Y
+ * @param speed Instantaneous speed
+ * @param timestamp_ms Sample time
+ */
+void track_summary_add(
+    TrackSummary* summary,
+    float x,
+    float y,
+    float speed,
+    uint64_t timestamp_ms
+);
+
+/**
+ * Get the buckets covering [since_ms, latest sample]
+ *
+ * Uses the finest level that still reaches back to since_ms (or holds
+ * the track's whole life); the bucket being filled is included last.
+ *
+ * @param summary Track summary
+ * @param since_ms Start of the window
+ * @param buckets Output buckets, oldest first
+ * @param max_buckets Size of output array (TRACK_SUMMARY_BUCKETS + 1 holds any window)
+ * @return Number of buckets returned
+ */
+uint32_t track_summary_window(
+    const TrackSummary* summary,
+    uint64_t since_ms,
+    HistoryBucket* buckets,
+    uint32_t max_buckets
+);
+
+/**
+ * Aggregate the window [since_ms, latest sample] without copying it
+ *
+ * Selects the level like track_summary_window(). Horizontal moves between
+ * consecutive centroids smaller than min_displacement (jitter of a
+ * standing object) neither set nor reverse the direction of travel.
+ *
+ * @param summary Track summary (its query cache is updated)
+ * @param since_ms Start of the window
+ * @param min_displacement Deadband for reversals_x
+ * @param stats Output aggregates
+ * @return true if the window holds any samples
+ */
+bool track_summary_window_stats(
+    TrackSummary* summary,
+    uint64_t since_ms,
+    float min_displacement,
+    TrackSummaryStats* stats
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OMNISIGHT_TRACK_SUMMARY_H
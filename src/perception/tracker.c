@@ -6,23 +6,25 @@
  */
 
 #include "tracker.h"
+#include "kalman_batch.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <float.h>
+#include <time.h>
 
 #define MAX_TRACKS 100
+#define MAX_DELETED (MAX_TRACKS + TRACKER_MAX_GALLERY)  // Room for a full tracker_clear()
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 
-/**
- * Kalman filter state for single track
- */
-typedef struct {
-    float x, y, w, h;      // Position and size
-    float vx, vy;          // Velocity
-    float P[6][6];         // Covariance matrix
-} KalmanState;
+// Kalman noise model (normalized image coordinates, one step per frame)
+#define KALMAN_POS_PROCESS_NOISE   1e-5f
+#define KALMAN_VEL_PROCESS_NOISE   1e-5f
+#define KALMAN_MEASUREMENT_NOISE   1e-4f
+#define KALMAN_INITIAL_VARIANCE    10.0f
+
+#define FEATURE_DIM 128
 
 /**
  * Internal track representation
@@ -43,10 +45,31 @@ typedef struct {
     uint64_t first_seen_ms;
     uint64_t last_seen_ms;
     float features[128];
-    KalmanState kalman;
     bool active;
 } InternalTrack;
 
+/**
+ * Recently lost track kept for re-identification
+ */
+typedef struct {
+    uint32_t track_id;
+    ObjectClass class_id;
+    BoundingBox bbox;          // Last corrected box
+    float velocity_x;          // Last velocity (per frame)
+    float velocity_y;
+    float ms_per_frame;        // Observed frame interval, for extrapolation
+    KalmanSlotState motion;    // Filter state when deleted (use_kalman_filter)
+    uint64_t motion_ms;        // Time that state was predicted to
+    uint32_t hits;
+    uint32_t frame_count;
+    uint64_t first_seen_ms;
+    uint64_t lost_ms;          // Time of last detection
+    float inv_feature_norm;    // 1 / |features|, 0 if no appearance
+    int32_t prev_in_class;     // Neighbours in the class bucket, -1 at the ends
+    int32_t next_in_class;
+    bool valid;
+} GalleryEntry;
+
 /**
  * Tracker structure
  */
@@ -57,13 +80,75 @@ struct Tracker {
     uint64_t total_tracks_created;
     uint64_t total_tracks_lost;
     uint32_t active_count;
+
+    // Motion state for all slots (slot i belongs to tracks[i])
+    KalmanBatch* kalman;
+
+    // Association quality counters
+    uint64_t total_low_score_matches;
+    uint64_t total_id_switches;
+    uint64_t total_fragmentations;
+
+    // Re-identification gallery. Features live in one contiguous
+    // reid_gallery_size x FEATURE_DIM matrix so a query is a single
+    // sweep of dot products. Valid entries are also chained per class
+    // so a lookup only visits entries of the detection's class.
+    GalleryEntry* gallery;
+    float* gallery_features;
+    uint32_t gallery_count;
+    int32_t gallery_class_head[OBJECT_CLASS_MAX];  // -1 if the bucket is empty
+    uint64_t current_time_ms;  // Latest detection timestamp seen
+
+    uint64_t total_reid_lookups;
+    uint64_t total_reid_hits;
+    uint64_t total_reid_lookup_ns;
+    uint64_t max_reid_lookup_ns;
+
+    // Track IDs deleted since tracker_drain_deleted_tracks() last ran
+    uint32_t deleted_ids[MAX_DELETED];
+    uint32_t num_deleted;
+
+    // Camera motion reported since the last update
+    bool has_camera_motion;
+    float camera_dx;
+    float camera_dy;
+    float camera_scale;
 };
 
 // Forward declarations
-static void kalman_init(KalmanState* k, const BoundingBox* bbox);
-static void kalman_predict(KalmanState* k);
-static void kalman_update(KalmanState* k, const BoundingBox* bbox);
-static void kalman_get_state(const KalmanState* k, BoundingBox* bbox, float* vx, float* vy);
+static KalmanBatch* kalman_create(void);
+static void kalman_measurement_from_bbox(const BoundingBox* bbox, float* measurement);
+static void kalman_get_state(
+    const KalmanBatch* kalman,
+    uint32_t slot,
+    BoundingBox* bbox,
+    float* vx,
+    float* vy
+);
+static uint32_t associate_greedy(
+    Tracker* tracker,
+    const DetectedObject* detections,
+    const uint32_t* candidates,
+    uint32_t num_candidates,
+    float threshold,
+    bool use_features,
+    bool* matched_track,
+    bool* matched_detection
+);
+static void apply_match(
+    Tracker* tracker,
+    InternalTrack* track,
+    const DetectedObject* det,
+    bool update_features
+);
+static void apply_camera_motion(Tracker* tracker);
+static void gallery_insert(Tracker* tracker, uint32_t track_slot);
+static int gallery_lookup(Tracker* tracker, const DetectedObject* det);
+static void gallery_remove(Tracker* tracker, uint32_t index);
+static void gallery_clear(Tracker* tracker);
+static void gallery_drop(Tracker* tracker, uint32_t index);
+static void gallery_expire(Tracker* tracker);
+static void record_deleted(Tracker* tracker, uint32_t track_id);
 
 // ============================================================================
 // Public API Implementation
@@ -80,11 +165,48 @@ Tracker* tracker_init(const TrackerConfig* config) {
     }
 
     tracker->config = *config;
+    if (tracker->config.low_score_iou_threshold <= 0.0f) {
+        tracker->config.low_score_iou_threshold = 0.5f;
+    }
     tracker->next_track_id = 1;
     tracker->total_tracks_created = 0;
     tracker->total_tracks_lost = 0;
     tracker->active_count = 0;
 
+    if (tracker->config.use_kalman_filter) {
+        tracker->kalman = kalman_create();
+        if (!tracker->kalman) {
+            free(tracker);
+            return NULL;
+        }
+    }
+
+    if (tracker->config.reid_gallery_size > TRACKER_MAX_GALLERY) {
+        tracker->config.reid_gallery_size = TRACKER_MAX_GALLERY;
+    }
+    if (tracker->config.reid_gallery_size > 0) {
+        if (tracker->config.reid_ttl_ms == 0) {
+            tracker->config.reid_ttl_ms = 10000;
+        }
+        if (tracker->config.reid_similarity_threshold <= 0.0f) {
+            tracker->config.reid_similarity_threshold = 0.7f;
+        }
+        if (tracker->config.reid_max_distance <= 0.0f) {
+            tracker->config.reid_max_distance = 0.25f;
+        }
+
+        tracker->gallery = (GalleryEntry*)calloc(
+            tracker->config.reid_gallery_size, sizeof(GalleryEntry));
+        tracker->gallery_features = (float*)calloc(
+            (size_t)tracker->config.reid_gallery_size * FEATURE_DIM, sizeof(float));
+
+        if (!tracker->gallery || !tracker->gallery_features) {
+            tracker_destroy(tracker);
+            return NULL;
+        }
+        gallery_clear(tracker);
+    }
+
     // Initialize all tracks as inactive
     for (uint32_t i = 0; i < MAX_TRACKS; i++) {
         tracker->tracks[i].active = false;
@@ -104,14 +226,32 @@ uint32_t tracker_update(
         return 0;
     }
 
-    // Step 1: Predict positions for all active tracks
+    for (uint32_t j = 0; j < num_detections; j++) {
+        if (detections[j].timestamp_ms > tracker->current_time_ms) {
+            tracker->current_time_ms = detections[j].timestamp_ms;
+        }
+    }
+    if (tracker->gallery) {
+        gallery_expire(tracker);
+    }
+
+    // Step 1: Compensate camera motion, then predict positions for all
+    // active tracks (one batched pass)
+    if (tracker->has_camera_motion) {
+        apply_camera_motion(tracker);
+    }
+
+    if (tracker->config.use_kalman_filter) {
+        kalman_batch_predict(tracker->kalman, 1.0f);
+    }
+
     for (uint32_t i = 0; i < MAX_TRACKS; i++) {
         if (!tracker->tracks[i].active) continue;
 
         if (tracker->config.use_kalman_filter) {
-            kalman_predict(&tracker->tracks[i].kalman);
             kalman_get_state(
-                &tracker->tracks[i].kalman,
+                tracker->kalman,
+                i,
                 &tracker->tracks[i].predicted_bbox,
                 &tracker->tracks[i].velocity_x,
                 &tracker->tracks[i].velocity_y
@@ -124,95 +264,75 @@ uint32_t tracker_update(
         }
     }
 
-    // Step 2: Compute IoU matrix between predictions and detections
-    float iou_matrix[MAX_TRACKS][num_detections];
-    bool matched_detection[num_detections];
-    bool matched_track[MAX_TRACKS];
-
-    memset(matched_detection, 0, sizeof(matched_detection));
-    memset(matched_track, 0, sizeof(matched_track));
-
-    for (uint32_t i = 0; i < MAX_TRACKS; i++) {
-        if (!tracker->tracks[i].active) continue;
-
-        for (uint32_t j = 0; j < num_detections; j++) {
-            float iou = tracker_calculate_iou(
-                &tracker->tracks[i].predicted_bbox,
-                &detections[j].bbox
-            );
+    // Step 2: Split detections by confidence (ByteTrack-style)
+    // High-score detections drive the first association and may spawn new
+    // tracks; low-score detections (typically partially occluded objects)
+    // are only allowed to extend tracks left unmatched by the first round.
+    uint32_t high_indices[num_detections > 0 ? num_detections : 1];
+    uint32_t low_indices[num_detections > 0 ? num_detections : 1];
+    uint32_t num_high = 0;
+    uint32_t num_low = 0;
 
-            // Add feature similarity if available
-            if (tracker->config.feature_similarity_weight > 0.0f) {
-                float feature_sim = tracker_calculate_feature_similarity(
-                    tracker->tracks[i].features,
-                    detections[j].features,
-                    128
-                );
-                iou = iou * (1.0f - tracker->config.feature_similarity_weight) +
-                      feature_sim * tracker->config.feature_similarity_weight;
-            }
+    for (uint32_t j = 0; j < num_detections; j++) {
+        float confidence = detections[j].confidence;
 
-            iou_matrix[i][j] = iou;
+        if (confidence >= tracker->config.high_confidence_threshold) {
+            high_indices[num_high++] = j;
+        } else if (confidence >= tracker->config.low_confidence_threshold) {
+            low_indices[num_low++] = j;
         }
     }
 
-    // Step 3: Match tracks to detections (greedy assignment)
-    for (uint32_t iter = 0; iter < num_detections; iter++) {
-        float best_iou = tracker->config.iou_threshold;
-        int best_track = -1;
-        int best_detection = -1;
-
-        for (uint32_t i = 0; i < MAX_TRACKS; i++) {
-            if (!tracker->tracks[i].active || matched_track[i]) continue;
-
-            for (uint32_t j = 0; j < num_detections; j++) {
-                if (matched_detection[j]) continue;
+    bool matched_detection[num_detections > 0 ? num_detections : 1];
+    bool matched_track[MAX_TRACKS];
 
-                if (iou_matrix[i][j] > best_iou) {
-                    best_iou = iou_matrix[i][j];
-                    best_track = i;
-                    best_detection = j;
-                }
-            }
-        }
+    memset(matched_detection, 0, sizeof(matched_detection));
+    memset(matched_track, 0, sizeof(matched_track));
 
-        if (best_track >= 0 && best_detection >= 0) {
-            // Update matched track
-            InternalTrack* track = &tracker->tracks[best_track];
-            const DetectedObject* det = &detections[best_detection];
+    // Step 3: First association - high-score detections, IoU + appearance
+    if (num_high > 0) {
+        associate_greedy(
+            tracker,
+            detections,
+            high_indices,
+            num_high,
+            tracker->config.iou_threshold,
+            true,
+            matched_track,
+            matched_detection
+        );
+    }
 
-            track->bbox = det->bbox;
-            track->class_id = det->class_id;
-            track->confidence = det->confidence;
-            track->hits++;
-            track->miss_count = 0;
-            track->frame_count++;
-            track->last_seen_ms = det->timestamp_ms;
+    // Step 3b: Second association - low-score detections, IoU only, against
+    // tracks the first round could not match
+    if (num_low > 0) {
+        uint32_t low_matches = associate_greedy(
+            tracker,
+            detections,
+            low_indices,
+            num_low,
+            tracker->config.low_score_iou_threshold,
+            false,
+            matched_track,
+            matched_detection
+        );
+        tracker->total_low_score_matches += low_matches;
+    }
 
-            // Update Kalman filter
-            if (tracker->config.use_kalman_filter) {
-                kalman_update(&track->kalman, &det->bbox);
-                kalman_get_state(
-                    &track->kalman,
-                    &track->bbox,
-                    &track->velocity_x,
-                    &track->velocity_y
-                );
-            } else {
-                // Simple velocity update
-                track->velocity_x = det->bbox.x - track->bbox.x;
-                track->velocity_y = det->bbox.y - track->bbox.y;
-            }
+    // Step 3c: Correct all matched tracks with their staged measurements
+    if (tracker->config.use_kalman_filter) {
+        kalman_batch_update(tracker->kalman);
 
-            // Update features (exponential moving average)
-            for (int k = 0; k < 128; k++) {
-                track->features[k] = 0.9f * track->features[k] + 0.1f * det->features[k];
-            }
+        for (uint32_t i = 0; i < MAX_TRACKS; i++) {
+            if (!tracker->tracks[i].active || !matched_track[i]) continue;
 
-            matched_track[best_track] = true;
-            matched_detection[best_detection] = true;
-        } else {
-            break;  // No more matches possible
+            kalman_get_state(
+                tracker->kalman,
+                i,
+                &tracker->tracks[i].bbox,
+                &tracker->tracks[i].velocity_x,
+                &tracker->tracks[i].velocity_y
+            );
         }
     }
 
@@ -221,10 +341,25 @@ uint32_t tracker_update(
         if (!tracker->tracks[i].active) continue;
 
         if (!matched_track[i]) {
+            // A confirmed track dropping out is a trajectory fragmentation
+            if (tracker->tracks[i].miss_count == 0 &&
+                tracker->tracks[i].hits >= tracker->config.min_hits) {
+                tracker->total_fragmentations++;
+            }
+
             tracker->tracks[i].miss_count++;
 
-            // Delete track if too many misses
+            // Delete track if too many misses; confirmed tracks are kept
+            // in the gallery so they can be re-identified, and their ID is
+            // only reported deleted once the gallery lets go of it
             if (tracker->tracks[i].miss_count >= tracker->config.max_age) {
+                if (tracker->gallery &&
+                    tracker->tracks[i].hits >= tracker->config.min_hits) {
+                    gallery_insert(tracker, i);
+                } else {
+                    record_deleted(tracker, tracker->tracks[i].track_id);
+                }
+
                 tracker->tracks[i].active = false;
                 tracker->active_count--;
                 tracker->total_tracks_lost++;
@@ -232,8 +367,9 @@ uint32_t tracker_update(
         }
     }
 
-    // Step 5: Create new tracks for unmatched detections
-    for (uint32_t j = 0; j < num_detections; j++) {
+    // Step 5: Create new tracks for unmatched high-score detections
+    for (uint32_t h = 0; h < num_high; h++) {
+        uint32_t j = high_indices[h];
         if (matched_detection[j]) continue;
 
         // Find free slot
@@ -249,7 +385,21 @@ uint32_t tracker_update(
             InternalTrack* track = &tracker->tracks[free_slot];
             const DetectedObject* det = &detections[j];
 
-            track->track_id = tracker->next_track_id++;
+            // A new identity spawned on top of a still-alive unmatched track
+            // means the old identity was switched rather than continued
+            for (uint32_t i = 0; i < MAX_TRACKS; i++) {
+                if (!tracker->tracks[i].active || matched_track[i]) continue;
+                if (tracker_calculate_iou(&tracker->tracks[i].predicted_bbox, &det->bbox) >=
+                    tracker->config.low_score_iou_threshold) {
+                    tracker->total_id_switches++;
+                    break;
+                }
+            }
+
+            // Revive a recently lost identity instead of minting a new one
+            int reid = gallery_lookup(tracker, det);
+
+            track->track_id = reid >= 0 ? tracker->gallery[reid].track_id : tracker->next_track_id++;
             track->class_id = det->class_id;
             track->bbox = det->bbox;
             track->predicted_bbox = det->bbox;
@@ -266,12 +416,47 @@ uint32_t tracker_update(
             memcpy(track->features, det->features, sizeof(track->features));
             track->active = true;
 
-            if (tracker->config.use_kalman_filter) {
-                kalman_init(&track->kalman, &det->bbox);
+            if (reid >= 0) {
+                const GalleryEntry* entry = &tracker->gallery[reid];
+                const float* features =
+                    &tracker->gallery_features[(size_t)reid * FEATURE_DIM];
+
+                track->hits = entry->hits + 1;
+                track->frame_count = entry->frame_count + 1;
+                track->first_seen_ms = entry->first_seen_ms;
+                track->velocity_x = entry->velocity_x;
+                track->velocity_y = entry->velocity_y;
+                for (int k = 0; k < FEATURE_DIM; k++) {
+                    track->features[k] = 0.9f * features[k] + 0.1f * det->features[k];
+                }
+
+                // Resume the lost filter rather than restarting at rest
+                if (tracker->config.use_kalman_filter) {
+                    float measurement[KALMAN_BATCH_CHANNELS];
+                    kalman_measurement_from_bbox(&det->bbox, measurement);
+
+                    float frames = 0.0f;
+                    if (entry->ms_per_frame > 0.0f && det->timestamp_ms > entry->motion_ms) {
+                        frames = (float)(det->timestamp_ms - entry->motion_ms) / entry->ms_per_frame;
+                    }
+                    kalman_batch_restore_slot(tracker->kalman, (uint32_t)free_slot,
+                                              &entry->motion, frames, measurement);
+                    kalman_get_state(tracker->kalman, (uint32_t)free_slot, &track->bbox,
+                                     &track->velocity_x, &track->velocity_y);
+                }
+
+                gallery_remove(tracker, (uint32_t)reid);
+            } else if (tracker->config.use_kalman_filter) {
+                float measurement[KALMAN_BATCH_CHANNELS];
+                kalman_measurement_from_bbox(&det->bbox, measurement);
+                kalman_batch_init_slot(tracker->kalman, (uint32_t)free_slot, measurement);
             }
 
+            matched_track[free_slot] = true;
             tracker->active_count++;
-            tracker->total_tracks_created++;
+            if (reid < 0) {
+                tracker->total_tracks_created++;
+            }
         }
     }
 
@@ -303,6 +488,24 @@ uint32_t tracker_update(
     return output_count;
 }
 
+void tracker_set_camera_motion(Tracker* tracker, float dx, float dy, float scale) {
+    if (!tracker || scale <= 0.0f) {
+        return;
+    }
+
+    if (!tracker->has_camera_motion) {
+        tracker->camera_dx = 0.0f;
+        tracker->camera_dy = 0.0f;
+        tracker->camera_scale = 1.0f;
+        tracker->has_camera_motion = true;
+    }
+
+    // Compose with motion already pending
+    tracker->camera_dx = tracker->camera_dx * scale + dx;
+    tracker->camera_dy = tracker->camera_dy * scale + dy;
+    tracker->camera_scale *= scale;
+}
+
 uint32_t tracker_get_tracks(
     Tracker* tracker,
     TrackedObject* tracks,
@@ -383,6 +586,7 @@ bool tracker_remove_track(Tracker* tracker, uint32_t track_id) {
         if (tracker->tracks[i].active && tracker->tracks[i].track_id == track_id) {
             tracker->tracks[i].active = false;
             tracker->active_count--;
+            record_deleted(tracker, track_id);
             return true;
         }
     }
@@ -390,16 +594,49 @@ bool tracker_remove_track(Tracker* tracker, uint32_t track_id) {
     return false;
 }
 
+uint32_t tracker_drain_deleted_tracks(
+    Tracker* tracker,
+    uint32_t* track_ids,
+    uint32_t max_ids
+) {
+    if (!tracker || !track_ids) {
+        return 0;
+    }
+
+    uint32_t count = MIN(tracker->num_deleted, max_ids);
+    memcpy(track_ids, tracker->deleted_ids, count * sizeof(uint32_t));
+
+    // Keep whatever did not fit for the next call
+    memmove(tracker->deleted_ids, tracker->deleted_ids + count,
+            (tracker->num_deleted - count) * sizeof(uint32_t));
+    tracker->num_deleted -= count;
+
+    return count;
+}
+
 void tracker_clear(Tracker* tracker) {
     if (!tracker) {
         return;
     }
 
+    // Every dropped ID is reported, as if each track had been lost
     for (uint32_t i = 0; i < MAX_TRACKS; i++) {
+        if (tracker->tracks[i].active) {
+            record_deleted(tracker, tracker->tracks[i].track_id);
+        }
         tracker->tracks[i].active = false;
     }
 
     tracker->active_count = 0;
+
+    if (tracker->gallery) {
+        for (uint32_t g = 0; g < tracker->config.reid_gallery_size; g++) {
+            if (tracker->gallery[g].valid) {
+                record_deleted(tracker, tracker->gallery[g].track_id);
+            }
+        }
+        gallery_clear(tracker);
+    }
 }
 
 void tracker_get_stats(
@@ -417,8 +654,33 @@ void tracker_get_stats(
     if (lost_tracks) *lost_tracks = tracker->total_tracks_lost;
 }
 
+void tracker_get_detailed_stats(Tracker* tracker, TrackerStats* stats) {
+    if (!tracker || !stats) {
+        return;
+    }
+
+    stats->active_tracks = tracker->active_count;
+    stats->total_tracks = tracker->total_tracks_created;
+    stats->lost_tracks = tracker->total_tracks_lost;
+    stats->low_score_matches = tracker->total_low_score_matches;
+    stats->id_switches = tracker->total_id_switches;
+    stats->fragmentations = tracker->total_fragmentations;
+
+    stats->gallery_entries = tracker->gallery_count;
+    stats->reid_lookups = tracker->total_reid_lookups;
+    stats->reid_hits = tracker->total_reid_hits;
+    stats->reid_hit_rate = tracker->total_reid_lookups > 0 ?
+        (float)tracker->total_reid_hits / tracker->total_reid_lookups : 0.0f;
+    stats->avg_reid_lookup_us = tracker->total_reid_lookups > 0 ?
+        tracker->total_reid_lookup_ns / 1000.0f / tracker->total_reid_lookups : 0.0f;
+    stats->max_reid_lookup_us = tracker->max_reid_lookup_ns / 1000.0f;
+}
+
 void tracker_destroy(Tracker* tracker) {
     if (tracker) {
+        kalman_batch_destroy(tracker->kalman);
+        free(tracker->gallery);
+        free(tracker->gallery_features);
         free(tracker);
     }
 }
@@ -496,69 +758,481 @@ float tracker_calculate_feature_similarity(
 }
 
 // ============================================================================
-// Kalman Filter Implementation
+// Association Helpers
+// ============================================================================
+
+/**
+ * Greedy highest-score-first assignment of candidate detections to
+ * unmatched active tracks
+ *
+ * @return Number of matches made
+ */
+static uint32_t associate_greedy(
+    Tracker* tracker,
+    const DetectedObject* detections,
+    const uint32_t* candidates,
+    uint32_t num_candidates,
+    float threshold,
+    bool use_features,
+    bool* matched_track,
+    bool* matched_detection
+) {
+    if (num_candidates == 0) {
+        return 0;
+    }
+
+    // Score matrix between predictions and candidate detections
+    float score_matrix[MAX_TRACKS][num_candidates];
+
+    for (uint32_t i = 0; i < MAX_TRACKS; i++) {
+        if (!tracker->tracks[i].active || matched_track[i]) continue;
+
+        for (uint32_t c = 0; c < num_candidates; c++) {
+            const DetectedObject* det = &detections[candidates[c]];
+            float score = tracker_calculate_iou(
+                &tracker->tracks[i].predicted_bbox,
+                &det->bbox
+            );
+
+            // Add feature similarity if available
+            if (use_features && tracker->config.feature_similarity_weight > 0.0f) {
+                float feature_sim = tracker_calculate_feature_similarity(
+                    tracker->tracks[i].features,
+                    det->features,
+                    128
+                );
+                score = score * (1.0f - tracker->config.feature_similarity_weight) +
+                        feature_sim * tracker->config.feature_similarity_weight;
+            }
+
+            score_matrix[i][c] = score;
+        }
+    }
+
+    uint32_t matches = 0;
+
+    for (uint32_t iter = 0; iter < num_candidates; iter++) {
+        float best_score = threshold;
+        int best_track = -1;
+        int best_candidate = -1;
+
+        for (uint32_t i = 0; i < MAX_TRACKS; i++) {
+            if (!tracker->tracks[i].active || matched_track[i]) continue;
+
+            for (uint32_t c = 0; c < num_candidates; c++) {
+                if (matched_detection[candidates[c]]) continue;
+
+                if (score_matrix[i][c] > best_score) {
+                    best_score = score_matrix[i][c];
+                    best_track = i;
+                    best_candidate = c;
+                }
+            }
+        }
+
+        if (best_track < 0 || best_candidate < 0) {
+            break;  // No more matches possible
+        }
+
+        uint32_t det_idx = candidates[best_candidate];
+        apply_match(tracker, &tracker->tracks[best_track], &detections[det_idx], use_features);
+
+        matched_track[best_track] = true;
+        matched_detection[det_idx] = true;
+        matches++;
+    }
+
+    return matches;
+}
+
+/**
+ * Update a track with its matched detection
+ */
+static void apply_match(
+    Tracker* tracker,
+    InternalTrack* track,
+    const DetectedObject* det,
+    bool update_features
+) {
+    track->class_id = det->class_id;
+    track->confidence = det->confidence;
+    track->hits++;
+    track->miss_count = 0;
+    track->frame_count++;
+    track->last_seen_ms = det->timestamp_ms;
+
+    // Stage the Kalman correction; all matches are applied in one batched
+    // update once association is complete
+    if (tracker->config.use_kalman_filter) {
+        float measurement[KALMAN_BATCH_CHANNELS];
+        kalman_measurement_from_bbox(&det->bbox, measurement);
+        kalman_batch_set_measurement(
+            tracker->kalman,
+            (uint32_t)(track - tracker->tracks),
+            measurement
+        );
+        track->bbox = det->bbox;
+    } else {
+        // Simple velocity update
+        track->velocity_x = det->bbox.x - track->bbox.x;
+        track->velocity_y = det->bbox.y - track->bbox.y;
+        track->bbox = det->bbox;
+    }
+
+    // Update features (exponential moving average). Low-score detections
+    // are usually occluded, so their appearance is not trusted.
+    if (update_features) {
+        for (int k = 0; k < 128; k++) {
+            track->features[k] = 0.9f * track->features[k] + 0.1f * det->features[k];
+        }
+    }
+}
+
 // ============================================================================
+// Camera Motion Compensation
+// ============================================================================
+
+static void warp_bbox(BoundingBox* bbox, float dx, float dy, float scale) {
+    float cx = (bbox->x + bbox->width / 2.0f - 0.5f) * scale + 0.5f + dx;
+    float cy = (bbox->y + bbox->height / 2.0f - 0.5f) * scale + 0.5f + dy;
+
+    bbox->width *= scale;
+    bbox->height *= scale;
+    bbox->x = cx - bbox->width / 2.0f;
+    bbox->y = cy - bbox->height / 2.0f;
+}
+
+/**
+ * Move every track (and gallery entry) into the current frame's image
+ * coordinates so that prediction and association see a static camera
+ */
+static void apply_camera_motion(Tracker* tracker) {
+    float dx = tracker->camera_dx;
+    float dy = tracker->camera_dy;
+    float scale = tracker->camera_scale;
+
+    if (tracker->config.use_kalman_filter) {
+        kalman_batch_warp(tracker->kalman, scale, dx, dy);
+    }
+
+    for (uint32_t i = 0; i < MAX_TRACKS; i++) {
+        InternalTrack* track = &tracker->tracks[i];
+        if (!track->active) continue;
+
+        warp_bbox(&track->bbox, dx, dy, scale);
+        track->velocity_x *= scale;
+        track->velocity_y *= scale;
+    }
+
+    for (uint32_t g = 0; g < tracker->config.reid_gallery_size; g++) {
+        GalleryEntry* entry = &tracker->gallery[g];
+        if (!entry->valid) continue;
+
+        warp_bbox(&entry->bbox, dx, dy, scale);
+        entry->velocity_x *= scale;
+        entry->velocity_y *= scale;
+        kalman_batch_warp_saved(&entry->motion, scale, dx, dy);
+    }
+
+    tracker->has_camera_motion = false;
+}
+
+/**
+ * Queue a deleted ID for tracker_drain_deleted_tracks(). If nobody drains
+ * the queue the oldest IDs are dropped.
+ */
+static void record_deleted(Tracker* tracker, uint32_t track_id) {
+    if (tracker->num_deleted == MAX_DELETED) {
+        memmove(tracker->deleted_ids, tracker->deleted_ids + 1,
+                (MAX_DELETED - 1) * sizeof(uint32_t));
+        tracker->num_deleted--;
+    }
 
-static void kalman_init(KalmanState* k, const BoundingBox* bbox) {
-    memset(k, 0, sizeof(KalmanState));
+    tracker->deleted_ids[tracker->num_deleted++] = track_id;
+}
 
-    k->x = bbox->x + bbox->width / 2.0f;
-    k->y = bbox->y + bbox->height / 2.0f;
-    k->w = bbox->width;
-    k->h = bbox->height;
-    k->vx = 0.0f;
-    k->vy = 0.0f;
+// ============================================================================
+// Re-identification Gallery
+// ============================================================================
 
-    // Initialize covariance matrix (simplified)
-    for (int i = 0; i < 6; i++) {
-        for (int j = 0; j < 6; j++) {
-            k->P[i][j] = (i == j) ? 10.0f : 0.0f;
+static void gallery_clear(Tracker* tracker) {
+    for (uint32_t g = 0; g < tracker->config.reid_gallery_size; g++) {
+        tracker->gallery[g].valid = false;
+    }
+    for (int c = 0; c < OBJECT_CLASS_MAX; c++) {
+        tracker->gallery_class_head[c] = -1;
+    }
+    tracker->gallery_count = 0;
+}
+
+/**
+ * Classes outside the enum share the UNKNOWN bucket
+ */
+static int gallery_bucket(ObjectClass class_id) {
+    return (unsigned)class_id < OBJECT_CLASS_MAX ? (int)class_id : OBJECT_CLASS_UNKNOWN;
+}
+
+static void gallery_link(Tracker* tracker, uint32_t index) {
+    GalleryEntry* entry = &tracker->gallery[index];
+    int32_t* head = &tracker->gallery_class_head[gallery_bucket(entry->class_id)];
+
+    entry->prev_in_class = -1;
+    entry->next_in_class = *head;
+    if (*head >= 0) {
+        tracker->gallery[*head].prev_in_class = (int32_t)index;
+    }
+    *head = (int32_t)index;
+}
+
+static void gallery_unlink(Tracker* tracker, uint32_t index) {
+    GalleryEntry* entry = &tracker->gallery[index];
+
+    if (entry->prev_in_class >= 0) {
+        tracker->gallery[entry->prev_in_class].next_in_class = entry->next_in_class;
+    } else {
+        tracker->gallery_class_head[gallery_bucket(entry->class_id)] = entry->next_in_class;
+    }
+    if (entry->next_in_class >= 0) {
+        tracker->gallery[entry->next_in_class].prev_in_class = entry->prev_in_class;
+    }
+}
+
+static void gallery_remove(Tracker* tracker, uint32_t index) {
+    gallery_unlink(tracker, index);
+    tracker->gallery[index].valid = false;
+    tracker->gallery_count--;
+}
+
+/**
+ * Forget a lost track for good: its ID is reported deleted
+ */
+static void gallery_drop(Tracker* tracker, uint32_t index) {
+    record_deleted(tracker, tracker->gallery[index].track_id);
+    gallery_remove(tracker, index);
+}
+
+/**
+ * Drop entries lost longer than the TTL ago
+ */
+static void gallery_expire(Tracker* tracker) {
+    for (uint32_t g = 0; g < tracker->config.reid_gallery_size; g++) {
+        const GalleryEntry* entry = &tracker->gallery[g];
+        if (entry->valid &&
+            tracker->current_time_ms - entry->lost_ms > tracker->config.reid_ttl_ms) {
+            gallery_drop(tracker, g);
         }
     }
 }
 
-static void kalman_predict(KalmanState* k) {
-    // Simple constant velocity model
-    k->x += k->vx;
-    k->y += k->vy;
+/**
+ * Remember a confirmed track that is being deleted. Takes a free or
+ * expired slot, otherwise evicts (and reports deleted) the entry lost
+ * longest ago.
+ */
+static void gallery_insert(Tracker* tracker, uint32_t track_slot) {
+    const InternalTrack* track = &tracker->tracks[track_slot];
+    int slot = -1;
+    uint64_t oldest_ms = UINT64_MAX;
+
+    for (uint32_t g = 0; g < tracker->config.reid_gallery_size; g++) {
+        GalleryEntry* entry = &tracker->gallery[g];
+
+        if (entry->valid &&
+            tracker->current_time_ms - entry->lost_ms > tracker->config.reid_ttl_ms) {
+            gallery_drop(tracker, g);
+        }
+
+        if (!entry->valid) {
+            slot = g;
+            break;
+        }
+        if (entry->lost_ms < oldest_ms) {
+            oldest_ms = entry->lost_ms;
+            slot = g;
+        }
+    }
+
+    GalleryEntry* entry = &tracker->gallery[slot];
+    float* features = &tracker->gallery_features[(size_t)slot * FEATURE_DIM];
+
+    if (entry->valid) {
+        record_deleted(tracker, entry->track_id);
+        gallery_unlink(tracker, (uint32_t)slot);
+    } else {
+        tracker->gallery_count++;
+    }
 
-    // Increase uncertainty
-    for (int i = 0; i < 6; i++) {
-        k->P[i][i] += 0.1f;
+    entry->track_id = track->track_id;
+    entry->class_id = track->class_id;
+    entry->bbox = track->bbox;
+    entry->velocity_x = track->velocity_x;
+    entry->velocity_y = track->velocity_y;
+    entry->ms_per_frame = track->frame_count > 1 ?
+        (float)(track->last_seen_ms - track->first_seen_ms) / (track->frame_count - 1) : 0.0f;
+    entry->hits = track->hits;
+    entry->frame_count = track->frame_count;
+    entry->first_seen_ms = track->first_seen_ms;
+    entry->lost_ms = track->last_seen_ms;
+    if (tracker->config.use_kalman_filter) {
+        // The filter has coasted one frame per miss since the last detection
+        kalman_batch_save_slot(tracker->kalman, track_slot, &entry->motion);
+        entry->motion_ms = entry->lost_ms + (uint64_t)(track->miss_count * entry->ms_per_frame);
     }
+    entry->valid = true;
+    gallery_link(tracker, (uint32_t)slot);
+
+    float norm = 0.0f;
+    for (int k = 0; k < FEATURE_DIM; k++) {
+        features[k] = track->features[k];
+        norm += features[k] * features[k];
+    }
+    entry->inv_feature_norm = norm > 1e-12f ? 1.0f / sqrtf(norm) : 0.0f;
 }
 
-static void kalman_update(KalmanState* k, const BoundingBox* bbox) {
-    float measured_x = bbox->x + bbox->width / 2.0f;
-    float measured_y = bbox->y + bbox->height / 2.0f;
-    float measured_w = bbox->width;
-    float measured_h = bbox->height;
+/**
+ * Find the most similar lost track for a detection
+ *
+ * Only the detection's class bucket is walked. Candidates must be within
+ * TTL and lie near either the last seen position or the position
+ * extrapolated with the last velocity. Among those the highest cosine
+ * similarity above the threshold wins.
+ *
+ * @return Gallery index, -1 if none
+ */
+static int gallery_lookup(Tracker* tracker, const DetectedObject* det) {
+    if (!tracker->gallery || tracker->gallery_count == 0) {
+        return -1;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    float det_norm = 0.0f;
+    for (int k = 0; k < FEATURE_DIM; k++) {
+        det_norm += det->features[k] * det->features[k];
+    }
+
+    int best = -1;
+
+    if (det_norm > 1e-12f) {
+        float inv_det_norm = 1.0f / sqrtf(det_norm);
+        float best_similarity = tracker->config.reid_similarity_threshold;
+        float max_dist_sq = tracker->config.reid_max_distance * tracker->config.reid_max_distance;
+        float det_cx = det->bbox.x + det->bbox.width / 2.0f;
+        float det_cy = det->bbox.y + det->bbox.height / 2.0f;
+
+        int32_t next;
+        for (int32_t g = tracker->gallery_class_head[gallery_bucket(det->class_id)]; g >= 0; g = next) {
+            GalleryEntry* entry = &tracker->gallery[g];
+            next = entry->next_in_class;
+
+            uint64_t elapsed_ms = det->timestamp_ms > entry->lost_ms ?
+                det->timestamp_ms - entry->lost_ms : 0;
+            if (elapsed_ms > tracker->config.reid_ttl_ms) {
+                gallery_drop(tracker, (uint32_t)g);
+                continue;
+            }
+
+            if (entry->class_id != det->class_id || entry->inv_feature_norm == 0.0f) {
+                continue;
+            }
 
-    // Kalman gain (simplified, assuming measurement noise is low)
-    float K = 0.5f;
+            // Spatial gate
+            float cx = entry->bbox.x + entry->bbox.width / 2.0f;
+            float cy = entry->bbox.y + entry->bbox.height / 2.0f;
+            float dx = det_cx - cx;
+            float dy = det_cy - cy;
+            bool near = dx * dx + dy * dy <= max_dist_sq;
+
+            if (!near && entry->ms_per_frame > 0.0f) {
+                float frames = elapsed_ms / entry->ms_per_frame;
+                dx -= entry->velocity_x * frames;
+                dy -= entry->velocity_y * frames;
+                near = dx * dx + dy * dy <= max_dist_sq;
+            }
+            if (!near) continue;
 
-    // Update state
-    k->x = k->x + K * (measured_x - k->x);
-    k->y = k->y + K * (measured_y - k->y);
-    k->w = k->w + K * (measured_w - k->w);
-    k->h = k->h + K * (measured_h - k->h);
+            // Appearance
+            const float* features = &tracker->gallery_features[(size_t)g * FEATURE_DIM];
+            float dot = 0.0f;
+            for (int k = 0; k < FEATURE_DIM; k++) {
+                dot += features[k] * det->features[k];
+            }
 
-    // Update velocity
-    k->vx = measured_x - k->x;
-    k->vy = measured_y - k->y;
+            float similarity = dot * entry->inv_feature_norm * inv_det_norm;
+            if (similarity > best_similarity) {
+                best_similarity = similarity;
+                best = g;
+            }
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    uint64_t elapsed_ns = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000ULL +
+                          (uint64_t)(end.tv_nsec - start.tv_nsec);
 
-    // Reduce uncertainty
-    for (int i = 0; i < 6; i++) {
-        k->P[i][i] *= (1.0f - K);
+    tracker->total_reid_lookups++;
+    tracker->total_reid_lookup_ns += elapsed_ns;
+    if (elapsed_ns > tracker->max_reid_lookup_ns) {
+        tracker->max_reid_lookup_ns = elapsed_ns;
     }
+    if (best >= 0) {
+        tracker->total_reid_hits++;
+    }
+
+    return best;
 }
 
-static void kalman_get_state(const KalmanState* k, BoundingBox* bbox, float* vx, float* vy) {
-    bbox->x = k->x - k->w / 2.0f;
-    bbox->y = k->y - k->h / 2.0f;
-    bbox->width = k->w;
-    bbox->height = k->h;
+// ============================================================================
+// Kalman Filter Implementation
+// ============================================================================
+
+static KalmanBatch* kalman_create(void) {
+    KalmanBatchConfig config;
+
+    for (int c = 0; c < KALMAN_BATCH_CHANNELS; c++) {
+        config.process_noise_pos[c] = KALMAN_POS_PROCESS_NOISE;
+        config.measurement_noise[c] = KALMAN_MEASUREMENT_NOISE;
+        config.initial_pos_variance[c] = KALMAN_INITIAL_VARIANCE;
+    }
+
+    // Center moves with constant velocity, size follows a random walk
+    for (int c = 0; c < 2; c++) {
+        config.process_noise_vel[c] = KALMAN_VEL_PROCESS_NOISE;
+        config.initial_vel_variance[c] = KALMAN_INITIAL_VARIANCE;
+    }
+    for (int c = 2; c < KALMAN_BATCH_CHANNELS; c++) {
+        config.process_noise_vel[c] = 0.0f;
+        config.initial_vel_variance[c] = 0.0f;
+    }
+
+    return kalman_batch_init(MAX_TRACKS, &config);
+}
+
+static void kalman_measurement_from_bbox(const BoundingBox* bbox, float* measurement) {
+    measurement[0] = bbox->x + bbox->width / 2.0f;
+    measurement[1] = bbox->y + bbox->height / 2.0f;
+    measurement[2] = bbox->width;
+    measurement[3] = bbox->height;
+}
+
+static void kalman_get_state(
+    const KalmanBatch* kalman,
+    uint32_t slot,
+    BoundingBox* bbox,
+    float* vx,
+    float* vy
+) {
+    float position[KALMAN_BATCH_CHANNELS];
+    float velocity[KALMAN_BATCH_CHANNELS];
+
+    kalman_batch_get_state(kalman, slot, position, velocity);
+
+    bbox->x = position[0] - position[2] / 2.0f;
+    bbox->y = position[1] - position[3] / 2.0f;
+    bbox->width = position[2];
+    bbox->height = position[3];
 
-    if (vx) *vx = k->vx;
-    if (vy) *vy = k->vy;
+    if (vx) *vx = velocity[0];
+    if (vy) *vy = velocity[1];
 }
@@ -17,6 +17,8 @@
 extern "C" {
 #endif
 
+#define TRACKER_MAX_GALLERY 256  // Upper bound on reid_gallery_size (~600 bytes per entry)
+
 typedef struct Tracker Tracker;
 
 /**
@@ -29,8 +31,39 @@ typedef struct {
     uint32_t max_tracks;          // Maximum simultaneous tracks
     bool use_kalman_filter;       // Enable Kalman filtering
     float feature_similarity_weight; // Weight of feature similarity (0-1)
+
+    // Two-stage (ByteTrack-style) association
+    float high_confidence_threshold; // Detections at/above this match first and may spawn tracks (0 = all)
+    float low_confidence_threshold;  // Detections below this are ignored entirely
+    float low_score_iou_threshold;   // IoU threshold for second-stage matching of low-score detections
+
+    // Re-identification of recently lost tracks
+    uint32_t reid_gallery_size;      // Lost tracks remembered (0 = disabled, max TRACKER_MAX_GALLERY)
+    uint32_t reid_ttl_ms;            // How long a lost track stays in the gallery
+    float reid_similarity_threshold; // Min cosine similarity of appearance features to revive
+    float reid_max_distance;         // Max center distance (normalized) from last/extrapolated position
 } TrackerConfig;
 
+/**
+ * Tracker association statistics
+ */
+typedef struct {
+    uint32_t active_tracks;       // Currently active tracks
+    uint64_t total_tracks;        // Total tracks created
+    uint64_t lost_tracks;         // Tracks deleted after max_age
+    uint64_t low_score_matches;   // Tracks extended by a low-score detection
+    uint64_t id_switches;         // New tracks spawned on top of an unmatched existing track
+    uint64_t fragmentations;      // Times a confirmed track went from matched to missed
+
+    // Re-identification gallery
+    uint32_t gallery_entries;     // Lost tracks currently in the gallery
+    uint64_t reid_lookups;        // Gallery queries before spawning a new track
+    uint64_t reid_hits;           // Queries that revived a lost track
+    float reid_hit_rate;          // reid_hits / reid_lookups
+    float avg_reid_lookup_us;     // Mean gallery query latency
+    float max_reid_lookup_us;     // Worst gallery query latency
+} TrackerStats;
+
 /**
  * Initialize tracker
  *
@@ -57,6 +90,21 @@ uint32_t tracker_update(
     uint32_t max_tracks
 );
 
+/**
+ * Report global camera motion since the previous update
+ *
+ * Applied to every track's prediction on the next tracker_update(),
+ * before association. Repeated calls between updates compose. A point p
+ * of the previous frame appears at (p - 0.5) * scale + 0.5 + (dx, dy)
+ * in normalized image coordinates.
+ *
+ * @param tracker Tracker instance
+ * @param dx Horizontal image shift
+ * @param dy Vertical image shift
+ * @param scale Zoom ratio about the image center (1 = none)
+ */
+void tracker_set_camera_motion(Tracker* tracker, float dx, float dy, float scale);
+
 /**
  * Get all active tracks
  *
@@ -94,9 +142,32 @@ bool tracker_get_track_by_id(
  */
 bool tracker_remove_track(Tracker* tracker, uint32_t track_id);
 
+/**
+ * Take the IDs of tracks deleted since the previous call
+ *
+ * Covers tracks aged out by tracker_update(), tracker_remove_track() and
+ * tracker_clear(), so per-track state kept elsewhere (behavior histories)
+ * can be released as soon as the tracker lets go of the ID. A confirmed track that moves
+ * into the re-identification gallery is reported only when its entry
+ * expires or is evicted; until then it may come back with its history.
+ *
+ * @param tracker Tracker instance
+ * @param track_ids Output array of deleted IDs
+ * @param max_ids Size of output array
+ * @return Number of IDs returned
+ */
+uint32_t tracker_drain_deleted_tracks(
+    Tracker* tracker,
+    uint32_t* track_ids,
+    uint32_t max_ids
+);
+
 /**
  * Clear all tracks
  *
+ * Active tracks and re-identification entries are all reported by
+ * tracker_drain_deleted_tracks().
+ *
  * @param tracker Tracker instance
  */
 void tracker_clear(Tracker* tracker);
@@ -116,6 +187,14 @@ void tracker_get_stats(
     uint64_t* lost_tracks
 );
 
+/**
+ * Get detailed tracker statistics including association quality counters
+ *
+ * @param tracker Tracker instance
+ * @param stats Output statistics
+ */
+void tracker_get_detailed_stats(Tracker* tracker, TrackerStats* stats);
+
 /**
  * Destroy tracker and free resources
  *
@@ -0,0 +1,497 @@
+/**
+ * @file zone_map.c
+ * @brief Rasterized zone lookup with lock-free grid publication
+ *
+ * The map owns two grids. The published one is read-only; an edit
+ * rebuilds the other one and swaps the index. Readers announce themselves
+ * in a per-grid counter and recheck the index afterwards, so a writer
+ * never starts overwriting a grid that a reader has pinned: it waits for
+ * that grid's counter to drain, while new readers already go to the
+ * freshly published grid. Edits are serialized by a mutex.
+ *
+ * Cell classification errs towards "boundary": cells are tested slightly
+ * enlarged, so float rounding in the point -> cell mapping can only send
+ * a point to an exact test, never to a wrong answer.
+ */
+
+#include "zone_map.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#define MAX_RESOLUTION 1024
+#define CELL_MARGIN 1e-3f    // Cell enlargement for classification (cell units)
+
+/**
+ * Zones in one cell: covering it entirely, or crossing it
+ */
+typedef struct {
+    uint32_t inside;
+    uint32_t edge;
+} ZoneCell;
+
+struct ZoneGrid {
+    uint64_t version;
+    uint32_t num_zones;
+    Zone zones[ZONE_MAP_MAX_ZONES];
+
+    uint32_t resolution;
+    float min_x, min_y;          // Bounds of all zones
+    float max_x, max_y;
+    float cell_w, cell_h;
+    float inv_cell_w, inv_cell_h;
+    ZoneCell* cells;             // resolution x resolution, row-major
+};
+
+struct ZoneMap {
+    ZoneGrid grids[2];
+    atomic_uint current;         // Index of the published grid
+    atomic_uint readers[2];      // Pins per grid
+    uint64_t version;
+    pthread_mutex_t edit_mutex;
+};
+
+static bool zone_valid(const Zone* zone);
+static void zone_bounds(const Zone* zone, float* min_x, float* min_y,
+                        float* max_x, float* max_y);
+static bool zone_contains(const Zone* zone, float x, float y);
+static int classify_cell(const Zone* zone, float x0, float y0, float x1, float y1);
+static bool segment_hits_rect(float ax, float ay, float bx, float by,
+                              float x0, float y0, float x1, float y1);
+static void build_grid(ZoneGrid* grid, const Zone* zones, uint32_t num_zones);
+static void publish(ZoneMap* map, const Zone* zones, uint32_t num_zones);
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+ZoneMap* zone_map_create(uint32_t resolution) {
+    if (resolution == 0) {
+        resolution = ZONE_MAP_DEFAULT_RESOLUTION;
+    }
+    if (resolution > MAX_RESOLUTION) {
+        return NULL;
+    }
+
+    ZoneMap* map = (ZoneMap*)calloc(1, sizeof(ZoneMap));
+    if (!map) {
+        return NULL;
+    }
+
+    for (int g = 0; g < 2; g++) {
+        map->grids[g].resolution = resolution;
+        map->grids[g].cells = (ZoneCell*)calloc((size_t)resolution * resolution,
+                                                sizeof(ZoneCell));
+        if (!map->grids[g].cells) {
+            free(map->grids[0].cells);
+            free(map);
+            return NULL;
+        }
+    }
+
+    if (pthread_mutex_init(&map->edit_mutex, NULL) != 0) {
+        free(map->grids[0].cells);
+        free(map->grids[1].cells);
+        free(map);
+        return NULL;
+    }
+
+    atomic_init(&map->current, 0);
+    atomic_init(&map->readers[0], 0);
+    atomic_init(&map->readers[1], 0);
+
+    return map;
+}
+
+bool zone_map_set(ZoneMap* map, const Zone* zone) {
+    if (!map || !zone || !zone_valid(zone)) {
+        return false;
+    }
+
+    pthread_mutex_lock(&map->edit_mutex);
+
+    // Only edits swap grids and we hold the edit lock, so the published
+    // grid is stable here
+    const ZoneGrid* cur = &map->grids[atomic_load(&map->current)];
+    Zone zones[ZONE_MAP_MAX_ZONES];
+    uint32_t n = cur->num_zones;
+    memcpy(zones, cur->zones, n * sizeof(Zone));
+
+    uint32_t i = 0;
+    while (i < n && zones[i].zone_id != zone->zone_id) {
+        i++;
+    }
+
+    bool ok = true;
+    if (i < n) {
+        zones[i] = *zone;
+    } else if (n < ZONE_MAP_MAX_ZONES) {
+        zones[n++] = *zone;
+    } else {
+        ok = false;
+    }
+
+    if (ok) {
+        publish(map, zones, n);
+    }
+
+    pthread_mutex_unlock(&map->edit_mutex);
+    return ok;
+}
+
+bool zone_map_remove(ZoneMap* map, uint32_t zone_id) {
+    if (!map) {
+        return false;
+    }
+
+    pthread_mutex_lock(&map->edit_mutex);
+
+    const ZoneGrid* cur = &map->grids[atomic_load(&map->current)];
+    Zone zones[ZONE_MAP_MAX_ZONES];
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < cur->num_zones; i++) {
+        if (cur->zones[i].zone_id != zone_id) {
+            zones[n++] = cur->zones[i];
+        }
+    }
+
+    bool found = n < cur->num_zones;
+    if (found) {
+        publish(map, zones, n);
+    }
+
+    pthread_mutex_unlock(&map->edit_mutex);
+    return found;
+}
+
+bool zone_map_replace_all(ZoneMap* map, const Zone* zones, uint32_t num_zones) {
+    if (!map || num_zones > ZONE_MAP_MAX_ZONES || (num_zones > 0 && !zones)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < num_zones; i++) {
+        if (!zone_valid(&zones[i])) {
+            return false;
+        }
+        for (uint32_t j = 0; j < i; j++) {
+            if (zones[j].zone_id == zones[i].zone_id) {
+                return false;
+            }
+        }
+    }
+
+    pthread_mutex_lock(&map->edit_mutex);
+    publish(map, zones, num_zones);
+    pthread_mutex_unlock(&map->edit_mutex);
+
+    return true;
+}
+
+const ZoneGrid* zone_map_acquire(ZoneMap* map) {
+    if (!map) {
+        return NULL;
+    }
+
+    for (;;) {
+        unsigned idx = atomic_load(&map->current);
+        atomic_fetch_add(&map->readers[idx], 1);
+
+        // If an edit swapped grids in between, the writer may already be
+        // rebuilding this one; back off and take the new grid instead
+        if (atomic_load(&map->current) == idx) {
+            return &map->grids[idx];
+        }
+        atomic_fetch_sub(&map->readers[idx], 1);
+    }
+}
+
+void zone_map_release(ZoneMap* map, const ZoneGrid* grid) {
+    if (!map || !grid) {
+        return;
+    }
+
+    unsigned idx = (grid == &map->grids[1]) ? 1 : 0;
+    atomic_fetch_sub(&map->readers[idx], 1);
+}
+
+uint32_t zone_grid_query(const ZoneGrid* grid, float x, float y, uint32_t classes) {
+    if (!grid || grid->num_zones == 0) {
+        return 0;
+    }
+
+    // Written so NaN fails too
+    if (!(x >= grid->min_x && x <= grid->max_x &&
+          y >= grid->min_y && y <= grid->max_y)) {
+        return 0;
+    }
+
+    uint32_t res = grid->resolution;
+    uint32_t cx = (uint32_t)((x - grid->min_x) * grid->inv_cell_w);
+    uint32_t cy = (uint32_t)((y - grid->min_y) * grid->inv_cell_h);
+    if (cx >= res) cx = res - 1;
+    if (cy >= res) cy = res - 1;
+
+    const ZoneCell* cell = &grid->cells[cy * res + cx];
+    uint32_t candidates = cell->inside | cell->edge;
+    uint32_t result = 0;
+
+    while (candidates) {
+        uint32_t slot = (uint32_t)__builtin_ctz(candidates);
+        uint32_t bit = 1u << slot;
+        candidates &= candidates - 1;
+
+        const Zone* zone = &grid->zones[slot];
+        if (!(zone->classes & classes)) {
+            continue;
+        }
+        if ((cell->inside & bit) || zone_contains(zone, x, y)) {
+            result |= bit;
+        }
+    }
+
+    return result;
+}
+
+const Zone* zone_grid_zone(const ZoneGrid* grid, uint32_t slot) {
+    if (!grid || slot >= grid->num_zones) {
+        return NULL;
+    }
+    return &grid->zones[slot];
+}
+
+uint32_t zone_grid_count(const ZoneGrid* grid) {
+    return grid ? grid->num_zones : 0;
+}
+
+uint64_t zone_grid_version(const ZoneGrid* grid) {
+    return grid ? grid->version : 0;
+}
+
+void zone_map_destroy(ZoneMap* map) {
+    if (!map) {
+        return;
+    }
+
+    pthread_mutex_destroy(&map->edit_mutex);
+    free(map->grids[0].cells);
+    free(map->grids[1].cells);
+    free(map);
+}
+
+// ============================================================================
+// Internal Helper Functions
+// ============================================================================
+
+/**
+ * Rebuild the unpublished grid and swap it in (edit lock held)
+ */
+static void publish(ZoneMap* map, const Zone* zones, uint32_t num_zones) {
+    unsigned next = 1 - atomic_load(&map->current);
+
+    // Readers still pinning the previous-but-one grid
+    while (atomic_load(&map->readers[next]) != 0) {
+        sched_yield();
+    }
+
+    ZoneGrid* grid = &map->grids[next];
+    build_grid(grid, zones, num_zones);
+    grid->version = ++map->version;
+
+    atomic_store(&map->current, next);
+}
+
+static void build_grid(ZoneGrid* grid, const Zone* zones, uint32_t num_zones) {
+    uint32_t res = grid->resolution;
+
+    grid->num_zones = num_zones;
+    if (num_zones > 0) {
+        memcpy(grid->zones, zones, num_zones * sizeof(Zone));
+    }
+    memset(grid->cells, 0, (size_t)res * res * sizeof(ZoneCell));
+
+    if (num_zones == 0) {
+        grid->min_x = grid->min_y = 0.0f;
+        grid->max_x = grid->max_y = 0.0f;
+        return;
+    }
+
+    zone_bounds(&zones[0], &grid->min_x, &grid->min_y, &grid->max_x, &grid->max_y);
+    for (uint32_t i = 1; i < num_zones; i++) {
+        float x0, y0, x1, y1;
+        zone_bounds(&zones[i], &x0, &y0, &x1, &y1);
+        if (x0 < grid->min_x) grid->min_x = x0;
+        if (y0 < grid->min_y) grid->min_y = y0;
+        if (x1 > grid->max_x) grid->max_x = x1;
+        if (y1 > grid->max_y) grid->max_y = y1;
+    }
+
+    // A degenerate extent still needs non-zero cells
+    float w = fmaxf(grid->max_x - grid->min_x, 1e-6f);
+    float h = fmaxf(grid->max_y - grid->min_y, 1e-6f);
+    grid->cell_w = w / res;
+    grid->cell_h = h / res;
+    grid->inv_cell_w = res / w;
+    grid->inv_cell_h = res / h;
+
+    float margin_x = grid->cell_w * CELL_MARGIN;
+    float margin_y = grid->cell_h * CELL_MARGIN;
+
+    for (uint32_t slot = 0; slot < num_zones; slot++) {
+        const Zone* zone = &zones[slot];
+        uint32_t bit = 1u << slot;
+
+        // Cells overlapped by the zone's bounding box
+        float x0, y0, x1, y1;
+        zone_bounds(zone, &x0, &y0, &x1, &y1);
+        uint32_t c0 = (uint32_t)fmaxf((x0 - grid->min_x) * grid->inv_cell_w - 1.0f, 0.0f);
+        uint32_t r0 = (uint32_t)fmaxf((y0 - grid->min_y) * grid->inv_cell_h - 1.0f, 0.0f);
+        uint32_t c1 = (uint32_t)fminf((x1 - grid->min_x) * grid->inv_cell_w + 1.0f, res - 1.0f);
+        uint32_t r1 = (uint32_t)fminf((y1 - grid->min_y) * grid->inv_cell_h + 1.0f, res - 1.0f);
+
+        for (uint32_t r = r0; r <= r1; r++) {
+            float cy0 = grid->min_y + r * grid->cell_h - margin_y;
+            float cy1 = grid->min_y + (r + 1) * grid->cell_h + margin_y;
+
+            for (uint32_t c = c0; c <= c1; c++) {
+                float cx0 = grid->min_x + c * grid->cell_w - margin_x;
+                float cx1 = grid->min_x + (c + 1) * grid->cell_w + margin_x;
+
+                int coverage = classify_cell(zone, cx0, cy0, cx1, cy1);
+                if (coverage > 0) {
+                    grid->cells[r * res + c].inside |= bit;
+                } else if (coverage == 0) {
+                    grid->cells[r * res + c].edge |= bit;
+                }
+            }
+        }
+    }
+}
+
+static bool zone_valid(const Zone* zone) {
+    if (zone->shape == ZONE_SHAPE_CIRCLE) {
+        return isfinite(zone->center_x) && isfinite(zone->center_y) &&
+               isfinite(zone->radius) && zone->radius > 0.0f;
+    }
+
+    if (zone->shape != ZONE_SHAPE_POLYGON ||
+        zone->num_vertices < 3 || zone->num_vertices > ZONE_MAX_VERTICES) {
+        return false;
+    }
+    for (uint32_t i = 0; i < zone->num_vertices; i++) {
+        if (!isfinite(zone->vertices[i][0]) || !isfinite(zone->vertices[i][1])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void zone_bounds(const Zone* zone, float* min_x, float* min_y,
+                        float* max_x, float* max_y) {
+    if (zone->shape == ZONE_SHAPE_CIRCLE) {
+        *min_x = zone->center_x - zone->radius;
+        *min_y = zone->center_y - zone->radius;
+        *max_x = zone->center_x + zone->radius;
+        *max_y = zone->center_y + zone->radius;
+        return;
+    }
+
+    *min_x = *max_x = zone->vertices[0][0];
+    *min_y = *max_y = zone->vertices[0][1];
+    for (uint32_t i = 1; i < zone->num_vertices; i++) {
+        *min_x = fminf(*min_x, zone->vertices[i][0]);
+        *min_y = fminf(*min_y, zone->vertices[i][1]);
+        *max_x = fmaxf(*max_x, zone->vertices[i][0]);
+        *max_y = fmaxf(*max_y, zone->vertices[i][1]);
+    }
+}
+
+static bool zone_contains(const Zone* zone, float x, float y) {
+    if (zone->shape == ZONE_SHAPE_CIRCLE) {
+        float dx = x - zone->center_x;
+        float dy = y - zone->center_y;
+        return dx * dx + dy * dy < zone->radius * zone->radius;
+    }
+
+    // Crossing number
+    bool inside = false;
+    uint32_t n = zone->num_vertices;
+    for (uint32_t i = 0, j = n - 1; i < n; j = i++) {
+        float xi = zone->vertices[i][0], yi = zone->vertices[i][1];
+        float xj = zone->vertices[j][0], yj = zone->vertices[j][1];
+        if ((yi > y) != (yj > y) &&
+            x < (xj - xi) * (y - yi) / (yj - yi) + xi) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+/**
+ * Classify a cell rectangle against a zone
+ *
+ * @return 1 if every point is inside, -1 if none is, 0 if the boundary crosses it
+ */
+static int classify_cell(const Zone* zone, float x0, float y0, float x1, float y1) {
+    if (zone->shape == ZONE_SHAPE_CIRCLE) {
+        float cx = zone->center_x;
+        float cy = zone->center_y;
+        float r2 = zone->radius * zone->radius;
+
+        float near_x = fmaxf(fmaxf(x0 - cx, cx - x1), 0.0f);
+        float near_y = fmaxf(fmaxf(y0 - cy, cy - y1), 0.0f);
+        if (near_x * near_x + near_y * near_y >= r2) {
+            return -1;
+        }
+
+        float far_x = fmaxf(fabsf(x0 - cx), fabsf(x1 - cx));
+        float far_y = fmaxf(fabsf(y0 - cy), fabsf(y1 - cy));
+        return (far_x * far_x + far_y * far_y < r2) ? 1 : 0;
+    }
+
+    uint32_t n = zone->num_vertices;
+    for (uint32_t i = 0, j = n - 1; i < n; j = i++) {
+        if (segment_hits_rect(zone->vertices[j][0], zone->vertices[j][1],
+                              zone->vertices[i][0], zone->vertices[i][1],
+                              x0, y0, x1, y1)) {
+            return 0;
+        }
+    }
+
+    // No edge crosses the cell, so it lies wholly on one side
+    return zone_contains(zone, 0.5f * (x0 + x1), 0.5f * (y0 + y1)) ? 1 : -1;
+}
+
+/**
+ * Segment vs closed rectangle (Liang-Barsky clip)
+ */
+static bool segment_hits_rect(float ax, float ay, float bx, float by,
+                              float x0, float y0, float x1, float y1) {
+    float dx = bx - ax;
+    float dy = by - ay;
+    float p[4] = {-dx, dx, -dy, dy};
+    float q[4] = {ax - x0, x1 - ax, ay - y0, y1 - ay};
+    float t0 = 0.0f;
+    float t1 = 1.0f;
+
+    for (int k = 0; k < 4; k++) {
+        if (p[k] == 0.0f) {
+            if (q[k] < 0.0f) {
+                return false;
+            }
+        } else {
+            float t = q[k] / p[k];
+            if (p[k] < 0.0f) {
+                if (t > t1) return false;
+                if (t > t0) t0 = t;
+            } else {
+                if (t < t0) return false;
+                if (t < t1) t1 = t;
+            }
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file zone_map.h
+ * @brief Rasterized zone lookup shared by behavior analysis and event prediction
+ *
+ * Zones are circles or polygons in caller coordinates (normalized image
+ * coordinates for perception, pixels for the timeline). Each edit
+ * rasterizes the whole zone set into a coarse grid over its bounding box.
+ * Every cell records which zones cover it completely and which zones only
+ * cross it, so a point query is one cell read; exact shape tests are
+ * needed only for zones whose boundary runs through that cell.
+ *
+ * Edits build a new grid off to the side and publish it in one step.
+ * Readers pin the current grid for as long as they need a consistent view
+ * (e.g. one prediction pass) and never wait for a writer.
+ */
+
+#ifndef OMNISIGHT_ZONE_MAP_H
+#define OMNISIGHT_ZONE_MAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ZONE_MAP_MAX_ZONES 32        // Zones per map (one bit each in a cell)
+#define ZONE_MAX_VERTICES 16         // Vertices per polygon
+#define ZONE_MAP_DEFAULT_RESOLUTION 64
+
+#define ZONE_CLASS_ALL 0xFFFFFFFFu
+
+typedef struct ZoneMap ZoneMap;
+typedef struct ZoneGrid ZoneGrid;
+
+/**
+ * Zone shape
+ */
+typedef enum {
+    ZONE_SHAPE_CIRCLE = 0,
+    ZONE_SHAPE_POLYGON
+} ZoneShape;
+
+/**
+ * Zone definition
+ */
+typedef struct {
+    uint32_t zone_id;           // Caller identifier, unique within a map
+    ZoneShape shape;
+
+    float center_x, center_y;   // Circle
+    float radius;
+
+    uint32_t num_vertices;      // Polygon (simple, either winding)
+    float vertices[ZONE_MAX_VERTICES][2];
+
+    uint32_t classes;           // Caller-defined class bits the zone applies to
+    float sensitivity;          // [0.0, 1.0]
+} Zone;
+
+/**
+ * Create an empty zone map
+ *
+ * @param resolution Grid cells per side (0 = ZONE_MAP_DEFAULT_RESOLUTION)
+ * @return Zone map instance, NULL on failure
+ */
+ZoneMap* zone_map_create(uint32_t resolution);
+
+/**
+ * Add a zone, or replace the zone with the same ID
+ *
+ * @param map Zone map instance
+ * @param zone Zone definition
+ * @return true on success, false if the zone is invalid or the map is full
+ */
+bool zone_map_set(ZoneMap* map, const Zone* zone);
+
+/**
+ * Remove a zone
+ *
+ * @param map Zone map instance
+ * @param zone_id Zone identifier
+ * @return true if the zone existed
+ */
+bool zone_map_remove(ZoneMap* map, uint32_t zone_id);
+
+/**
+ * Replace the whole zone set in one edit
+ *
+ * @param map Zone map instance
+ * @param zones Zone definitions (may be NULL if num_zones is 0)
+ * @param num_zones Number of zones
+ * @return true on success; on failure the previous set stays published
+ */
+bool zone_map_replace_all(ZoneMap* map, const Zone* zones, uint32_t num_zones);
+
+/**
+ * Pin the current grid (never blocks)
+ *
+ * The grid stays valid and unchanged until released; edits made meanwhile
+ * become visible on the next acquire. Release before acquiring again.
+ *
+ * @param map Zone map instance
+ * @return Current grid
+ */
+const ZoneGrid* zone_map_acquire(ZoneMap* map);
+
+/**
+ * Unpin a grid returned by zone_map_acquire()
+ *
+ * @param map Zone map instance
+ * @param grid Pinned grid
+ */
+void zone_map_release(ZoneMap* map, const ZoneGrid* grid);
+
+/**
+ * Find the zones containing a point
+ *
+ * @param grid Pinned grid
+ * @param x Point X
+ * @param y Point Y
+ * @param classes Only consider zones sharing one of these class bits
+ * @return Bitmask of zone slots (see zone_grid_zone()), lowest slot = oldest zone
+ */
+uint32_t zone_grid_query(const ZoneGrid* grid, float x, float y, uint32_t classes);
+
+/**
+ * Get the zone in a slot
+ *
+ * @param grid Pinned grid
+ * @param slot Slot number (bit position in a query result)
+ * @return Zone definition, NULL if the slot is empty
+ */
+const Zone* zone_grid_zone(const ZoneGrid* grid, uint32_t slot);
+
+/**
+ * Number of zones in a grid
+ *
+ * @param grid Pinned grid
+ * @return Zone count
+ */
+uint32_t zone_grid_count(const ZoneGrid* grid);
+
+/**
+ * Edit number that produced a grid (0 = never edited)
+ *
+ * @param grid Pinned grid
+ * @return Grid version
+ */
+uint64_t zone_grid_version(const ZoneGrid* grid);
+
+/**
+ * Destroy zone map (no grid may be pinned)
+ *
+ * @param map Zone map instance
+ */
+void zone_map_destroy(ZoneMap* map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OMNISIGHT_ZONE_MAP_H
@@ -11,27 +11,82 @@
  */
 
 #include "event_predictor.h"
+#include "proximity_index.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <stdio.h>
 #include <time.h>
+#include <stdatomic.h>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+#define DEFAULT_CROWD_HORIZON_MS 30000.0f
+#define MAX_CROWD_CANDIDATES 64     // Largest groups considered per call
+#define MIN_SHARDED_TRAJECTORIES 8  // Smaller scenes are checked on the caller
+#define MIN_INDEXED_TRAJECTORIES 64 // Smaller scenes are cheaper to scan pair by pair
+#define ASSAULT_CONTACT_DISTANCE 50.0f  // Closest approach for an assault (pixels)
+#define ACCOMPLICE_DISTANCE 100.0f  // Accomplice range at theft zone entry (pixels)
+#define MAX_ACCOMPLICES 3
+#define EXIT_MS 10000               // Time after theft zone entry to the exit speed
+#define PAIR_BOUND_SLACK 1.001f     // Float rounding allowance on pair bounds
+#define NO_STEP UINT32_MAX
+
+/**
+ * Events found for one trajectory by a sharded pass
+ *
+ * Collision and assault hold the row's first hit (the trajectory paired
+ * with a later one), theft the hit with this trajectory as the thief;
+ * EventJob records which rows hit.
+ */
+typedef struct {
+    PredictedEvent collision, assault, theft, loitering, trespassing;
+    bool has_loitering, has_trespassing;
+} TrajectoryEvents;
+
+/**
+ * What the scorers need from one trajectory, from a single walk over it
+ *
+ * Loitering, theft and trespassing read only this record (plus the one
+ * predicted state an event is reported at); collision and assault use it
+ * to skip pairs that cannot meet.
+ */
+typedef struct {
+    float min_x, max_x, min_y, max_y;  // Extent of the predicted positions
+    uint64_t dwell_ms;                 // First to last predicted state
+    float peak_speed;                  // Fastest move between two steps (INFINITY if unknown)
+    uint32_t theft_entry;              // First step in a theft zone (NO_STEP = none)
+    float theft_sensitivity;
+    float exit_speed;                  // Speed EXIT_MS after theft entry (0 = past horizon)
+    uint32_t trespass_entry;           // First step in a trespassing zone (NO_STEP = none)
+    float trespass_sensitivity;
+} TrajectoryFeatures;
+
 /**
  * Internal event predictor state
  */
 struct EventPredictor {
     EventPredictorConfig config;
     SceneContext scene;
+    ZoneMap* zones;             // Protected zones, rasterized
+    bool owns_zones;
+    WorkerPool* workers;        // Shared, not owned (NULL = single-threaded)
+    ProximityIndex* proximity;  // Rebuilt for each prediction pass
+
+    // Per-trajectory results of a sharded pass, grown to the largest scene
+    TrajectoryEvents* shards;
+    uint32_t shards_capacity;
+
+    // Per-trajectory features of the current pass, grown likewise
+    TrajectoryFeatures* features;
+    uint32_t features_capacity;
 
     // Statistics
     struct {
         uint64_t num_predictions;
-        uint64_t events_by_type[10];  // Count per EventType
+        uint64_t events_by_type[EVENT_MAX];  // Count per EventType
         float avg_confidence;
     } stats;
 };
@@ -75,10 +130,10 @@ static float calculate_historical_risk(
 
     // Check incident history
     for (uint32_t i = 0; i < predictor->scene.num_incidents; i++) {
-        const auto* incident = &predictor->scene.incident_history[i];
+        const struct SceneIncident* incident = &predictor->scene.incident_history[i];
 
         // Only consider relevant event types
-        if (incident->type != event_type && incident->type != EVENT_TYPE_OTHER) {
+        if (incident->type != event_type && incident->type != EVENT_NONE) {
             continue;
         }
 
@@ -98,103 +153,412 @@ static float calculate_historical_risk(
 }
 
 /**
- * Check if location is in a protected zone
+ * Count a predicted event in the statistics
  */
-static bool is_in_protected_zone(
-    const EventPredictor* predictor,
-    float x,
-    float y,
-    EventType event_type,
-    float* sensitivity
-) {
-    for (uint32_t i = 0; i < predictor->scene.num_zones; i++) {
-        const auto* zone = &predictor->scene.zones[i];
+static void count_event(EventPredictor* predictor, EventType type) {
+    predictor->stats.num_predictions++;
+    predictor->stats.events_by_type[type]++;
+}
+
+/**
+ * Zone classes protecting against an event type
+ */
+static uint32_t event_zone_classes(EventType event_type) {
+    return (event_type == EVENT_NONE) ? ZONE_CLASS_ALL : (1u << event_type);
+}
+
+/**
+ * Load the scene's circular zones into a zone map
+ */
+static bool load_scene_zones(ZoneMap* map, const SceneContext* scene) {
+    Zone zones[ZONE_MAP_MAX_ZONES];
+    uint32_t n = 0;
 
-        // Check if zone protects against this event type
-        if (zone->protected_event != event_type && zone->protected_event != EVENT_TYPE_OTHER) {
+    for (uint32_t i = 0; i < scene->num_zones && i < sizeof(scene->zones) / sizeof(scene->zones[0]); i++) {
+        if (n == ZONE_MAP_MAX_ZONES || scene->zones[i].radius <= 0.0f) {
             continue;
         }
 
-        float dist = distance(x, y, zone->x, zone->y);
-        if (dist < zone->radius) {
-            if (sensitivity) {
-                *sensitivity = zone->sensitivity;
-            }
-            return true;
-        }
+        memset(&zones[n], 0, sizeof(Zone));
+        zones[n].zone_id = i;
+        zones[n].shape = ZONE_SHAPE_CIRCLE;
+        zones[n].center_x = scene->zones[i].x;
+        zones[n].center_y = scene->zones[i].y;
+        zones[n].radius = scene->zones[i].radius;
+        zones[n].classes = event_zone_classes(scene->zones[i].protected_event);
+        zones[n].sensitivity = scene->zones[i].sensitivity;
+        n++;
     }
 
-    return false;
+    return zone_map_replace_all(map, zones, n);
 }
 
-// ============================================================================
-// Event Prediction Functions
-// ============================================================================
-
-bool event_predict_loitering(
+/**
+ * Index the trajectories of one prediction pass
+ *
+ * The contact radius covers both pair checks, so every collision and
+ * assault pair is in contact.
+ *
+ * @return The index, or NULL to scan instead (small scene or no memory)
+ */
+static const ProximityIndex* index_trajectories(
     EventPredictor* predictor,
-    const PredictedTrajectory* trajectory,
-    PredictedEvent* event
+    const PredictedTrajectory* trajectories,
+    uint32_t num_trajectories
 ) {
-    if (!predictor || !trajectory || !event) {
-        return false;
+    if (num_trajectories < MIN_INDEXED_TRAJECTORIES) {
+        return NULL;
     }
 
-    // Analyze trajectory for loitering patterns
-    // Loitering = staying in small area for extended time
+    float radius = fmaxf(predictor->config.collision_distance_threshold,
+                         ASSAULT_CONTACT_DISTANCE);
+    if (!proximity_index_build(predictor->proximity, trajectories, num_trajectories, radius)) {
+        return NULL;
+    }
+    return predictor->proximity;
+}
 
-    if (trajectory->num_predictions < 10) {
-        return false;  // Not enough data
+/**
+ * Slots of the zones protecting against an event type
+ */
+static uint32_t zone_slots(const ZoneGrid* zones, EventType event_type) {
+    uint32_t slots = 0;
+    for (uint32_t slot = 0; slot < zone_grid_count(zones); slot++) {
+        if (zone_grid_zone(zones, slot)->classes & event_zone_classes(event_type)) {
+            slots |= 1u << slot;
+        }
     }
+    return slots;
+}
+
+/**
+ * Fill the feature record of one trajectory
+ *
+ * One pass over the predictions, one zone grid read per step for theft
+ * and trespassing together until both entries are found. The oldest
+ * matching zone supplies each sensitivity.
+ */
+static void extract_features(
+    const ZoneGrid* zones,
+    const PredictedTrajectory* trajectory,
+    TrajectoryFeatures* features
+) {
+    const PredictedState* states = trajectory->predictions;
+    uint32_t n = trajectory->num_predictions;
+
+    uint32_t theft_slots = zone_slots(zones, EVENT_THEFT);
+    uint32_t trespass_slots = zone_slots(zones, EVENT_TRESPASSING);
+    uint32_t classes = event_zone_classes(EVENT_THEFT) |
+                       event_zone_classes(EVENT_TRESPASSING);
 
-    // Calculate area covered by trajectory
     float min_x = INFINITY, max_x = -INFINITY;
     float min_y = INFINITY, max_y = -INFINITY;
+    float peak = 0.0f;
+    uint32_t theft_entry = NO_STEP, trespass_entry = NO_STEP;
+    float theft_sensitivity = 0.0f, trespass_sensitivity = 0.0f;
+    float exit_speed = 0.0f;
+    bool exit_found = false;
 
-    for (uint32_t i = 0; i < trajectory->num_predictions; i++) {
-        float x = trajectory->predictions[i].x;
-        float y = trajectory->predictions[i].y;
+    for (uint32_t step = 0; step < n; step++) {
+        float x = states[step].x;
+        float y = states[step].y;
 
         if (x < min_x) min_x = x;
         if (x > max_x) max_x = x;
         if (y < min_y) min_y = y;
         if (y > max_y) max_y = y;
+
+        if (step > 0) {
+            float moved = distance(states[step - 1].x, states[step - 1].y, x, y);
+            float dt = (float)(states[step].timestamp_ms - states[step - 1].timestamp_ms) / 1000.0f;
+            float speed = moved / dt;
+            if (isnan(speed) || !(dt > 0.0f)) {
+                peak = INFINITY;  // Gap in the path: no bound
+            } else if (speed > peak) {
+                peak = speed;
+            }
+        }
+
+        if (theft_entry == NO_STEP || trespass_entry == NO_STEP) {
+            uint32_t hits = zone_grid_query(zones, x, y, classes);
+            uint32_t theft_hits = hits & theft_slots;
+            uint32_t trespass_hits = hits & trespass_slots;
+
+            if (theft_entry == NO_STEP && theft_hits) {
+                theft_entry = step;
+                theft_sensitivity =
+                    zone_grid_zone(zones, (uint32_t)__builtin_ctz(theft_hits))->sensitivity;
+            }
+            if (trespass_entry == NO_STEP && trespass_hits) {
+                trespass_entry = step;
+                trespass_sensitivity =
+                    zone_grid_zone(zones, (uint32_t)__builtin_ctz(trespass_hits))->sensitivity;
+            }
+        }
+
+        if (theft_entry != NO_STEP && !exit_found &&
+            states[step].timestamp_ms - states[theft_entry].timestamp_ms >= EXIT_MS) {
+            exit_speed = sqrtf(states[step].vx * states[step].vx +
+                               states[step].vy * states[step].vy);
+            exit_found = true;
+        }
     }
 
-    float area_width = max_x - min_x;
-    float area_height = max_y - min_y;
-    float area = area_width * area_height;
+    features->min_x = min_x;
+    features->max_x = max_x;
+    features->min_y = min_y;
+    features->max_y = max_y;
+    features->dwell_ms = n > 0 ? states[n - 1].timestamp_ms - states[0].timestamp_ms : 0;
+    features->peak_speed = peak;
+    features->theft_entry = theft_entry;
+    features->theft_sensitivity = theft_sensitivity;
+    features->exit_speed = exit_speed;
+    features->trespass_entry = trespass_entry;
+    features->trespass_sensitivity = trespass_sensitivity;
+}
+
+/**
+ * Feature record of a single trajectory, outside a prediction pass
+ */
+static const TrajectoryFeatures* describe_trajectory(
+    EventPredictor* predictor,
+    const PredictedTrajectory* trajectory,
+    TrajectoryFeatures* features
+) {
+    const ZoneGrid* zones = zone_map_acquire(predictor->zones);
+    extract_features(zones, trajectory, features);
+    zone_map_release(predictor->zones, zones);
+    return features;
+}
+
+typedef struct {
+    const ZoneGrid* zones;
+    const PredictedTrajectory* trajectories;
+    TrajectoryFeatures* features;
+} FeatureJob;
+
+static void extract_features_task(void* context, uint32_t task) {
+    FeatureJob* job = context;
+    extract_features(job->zones, &job->trajectories[task], &job->features[task]);
+}
+
+/**
+ * Feature records of every trajectory of one prediction pass
+ *
+ * Sharded across the worker pool for larger scenes.
+ *
+ * @return One record per trajectory, or NULL when storage could not grow
+ */
+static const TrajectoryFeatures* describe_trajectories(
+    EventPredictor* predictor,
+    const PredictedTrajectory* trajectories,
+    uint32_t num_trajectories
+) {
+    if (num_trajectories > predictor->features_capacity) {
+        TrajectoryFeatures* features = realloc(predictor->features,
+                                               num_trajectories * sizeof(TrajectoryFeatures));
+        if (!features) {
+            return NULL;
+        }
+        predictor->features = features;
+        predictor->features_capacity = num_trajectories;
+    }
+
+    FeatureJob job = {
+        .zones = zone_map_acquire(predictor->zones),
+        .trajectories = trajectories,
+        .features = predictor->features
+    };
+
+    if (worker_pool_num_threads(predictor->workers) > 1 &&
+        num_trajectories >= MIN_SHARDED_TRAJECTORIES) {
+        worker_pool_run(predictor->workers, num_trajectories, extract_features_task, &job);
+    } else {
+        for (uint32_t i = 0; i < num_trajectories; i++) {
+            extract_features_task(&job, i);
+        }
+    }
+
+    zone_map_release(predictor->zones, job.zones);
+    return predictor->features;
+}
+
+/**
+ * Time a step stands for: since the step before it (step 0: the next step's)
+ */
+static float step_seconds(const PredictedTrajectory* trajectory, uint32_t step) {
+    uint32_t k = step > 0 ? step : 1;
+    if (k >= trajectory->num_predictions) {
+        return 1.0f;
+    }
+    return (float)(trajectory->predictions[k].timestamp_ms -
+                   trajectory->predictions[k - 1].timestamp_ms) / 1000.0f;
+}
+
+/**
+ * First step at or past the middle of a trajectory's time span
+ */
+static uint32_t middle_step(const PredictedTrajectory* trajectory) {
+    const PredictedState* states = trajectory->predictions;
+    uint32_t n = trajectory->num_predictions;
+    uint64_t middle_ms = states[0].timestamp_ms +
+                         (states[n - 1].timestamp_ms - states[0].timestamp_ms) / 2;
+    uint32_t step = 0;
+    while (step + 1 < n && states[step].timestamp_ms < middle_ms) {
+        step++;
+    }
+    return step;
+}
+
+/**
+ * Whether two trajectories' extents come within a distance of each other
+ *
+ * False means no step of one is within the distance of any step of the
+ * other.
+ */
+static bool extents_within(
+    const TrajectoryFeatures* a,
+    const TrajectoryFeatures* b,
+    float reach
+) {
+    float gap_x = fmaxf(b->min_x - a->max_x, a->min_x - b->max_x);
+    float gap_y = fmaxf(b->min_y - a->max_y, a->min_y - b->max_y);
+    return !(fmaxf(gap_x, gap_y) > reach * PAIR_BOUND_SLACK);
+}
+
+/**
+ * Whether the gap between two trajectories can close faster than a speed
+ *
+ * Over any run of steps the gap shrinks by at most the elapsed time times
+ * the sum of both peak speeds, so the average closing speed never exceeds
+ * that sum.
+ */
+static bool may_close_faster(
+    const TrajectoryFeatures* a,
+    const TrajectoryFeatures* b,
+    float speed
+) {
+    float bound = (a->peak_speed + b->peak_speed) * PAIR_BOUND_SLACK +
+                  (PAIR_BOUND_SLACK - 1.0f);
+    return !(bound <= speed);
+}
+
+/**
+ * Check of one pair of trajectories (without counting)
+ *
+ * The feature records, when given, let a check reject the pair without
+ * walking the trajectories.
+ */
+typedef bool (*PairCheck)(
+    EventPredictor* predictor,
+    const PredictedTrajectory* traj1,
+    const PredictedTrajectory* traj2,
+    const TrajectoryFeatures* features1,
+    const TrajectoryFeatures* features2,
+    PredictedEvent* event
+);
+
+/**
+ * First pair (i, j), in j order, that passes a pair check
+ *
+ * Visits j > i; with changed set, every j != i except earlier changed
+ * trajectories, whose pairs with i ran in their own row. Features may be
+ * NULL (the checks then walk every pair they are given). With an index
+ * only trajectories in contact with i are checked; a pair out of contact
+ * fails every check, so the result is that of the full scan.
+ */
+static bool predict_row(
+    EventPredictor* predictor,
+    const ProximityIndex* index,
+    PairCheck check,
+    const PredictedTrajectory* trajectories,
+    const TrajectoryFeatures* features,
+    uint32_t num_trajectories,
+    uint32_t i,
+    const bool* changed,
+    PredictedEvent* event
+) {
+    uint32_t first = changed ? 0 : i + 1;
+
+    if (!index) {
+        for (uint32_t j = first; j < num_trajectories; j++) {
+            if (j == i || (changed && changed[j] && j < i)) continue;
+            if (check(predictor, &trajectories[i], &trajectories[j],
+                      features ? &features[i] : NULL, features ? &features[j] : NULL, event)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint64_t contacts[PROXIMITY_INDEX_WORDS(PROXIMITY_INDEX_MAX_TRAJECTORIES)];
+    if (proximity_index_contacts(index, i, contacts) == 0) {
+        return false;
+    }
+
+    for (uint32_t w = first / 64; w < PROXIMITY_INDEX_WORDS(num_trajectories); w++) {
+        for (uint64_t bits = contacts[w]; bits; bits &= bits - 1) {
+            uint32_t j = w * 64 + (uint32_t)__builtin_ctzll(bits);
+            if (j < first || (changed && changed[j] && j < i)) continue;
+            if (check(predictor, &trajectories[i], &trajectories[j],
+                      features ? &features[i] : NULL, features ? &features[j] : NULL, event)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// Event Prediction Functions
+// ============================================================================
+
+/**
+ * Loitering check for one trajectory
+ */
+static bool check_loitering(
+    EventPredictor* predictor,
+    const PredictedTrajectory* trajectory,
+    const TrajectoryFeatures* features,
+    PredictedEvent* event
+) {
+    // Loitering = staying in small area for extended time
+
+    if (trajectory->num_predictions < 10) {
+        return false;  // Not enough data
+    }
 
-    // Calculate time span
-    uint64_t time_span_ms = trajectory->predictions[trajectory->num_predictions - 1].timestamp_ms -
-                           trajectory->predictions[0].timestamp_ms;
+    // Area covered by trajectory
+    float area_width = features->max_x - features->min_x;
+    float area_height = features->max_y - features->min_y;
+    float area = area_width * area_height;
 
     // Loitering detection: small area for long time
     float loitering_threshold_area = 1000.0f;  // pixels^2
     bool is_loitering = (area < loitering_threshold_area) &&
-                       (time_span_ms > predictor->config.loitering_threshold_ms);
+                       (features->dwell_ms > predictor->config.loitering_threshold_ms);
 
     if (!is_loitering) {
         return false;
     }
 
     // Calculate center of loitering area
-    float center_x = (min_x + max_x) / 2;
-    float center_y = (min_y + max_y) / 2;
+    float center_x = (features->min_x + features->max_x) / 2;
+    float center_y = (features->min_y + features->max_y) / 2;
 
     // Build predicted event
     memset(event, 0, sizeof(PredictedEvent));
-    event->type = EVENT_TYPE_LOITERING;
-    event->timestamp_ms = trajectory->predictions[trajectory->num_predictions / 2].timestamp_ms;
+    event->type = EVENT_LOITERING;
+    event->timestamp_ms = trajectory->predictions[middle_step(trajectory)].timestamp_ms;
     event->location_x = center_x;
     event->location_y = center_y;
-    event->num_involved_tracks = 1;
+    event->num_involved = 1;
     event->involved_tracks[0] = trajectory->track_id;
 
     // Calculate probability
     float base_prob = 0.6f;
     float history_factor = calculate_historical_risk(predictor, center_x, center_y,
-                                                     EVENT_TYPE_LOITERING);
+                                                     EVENT_LOITERING);
     float context_factor = predictor->scene.time_of_day_risk;
 
     event->probability = clamp(
@@ -205,250 +569,321 @@ bool event_predict_loitering(
     // Calculate severity
     event->severity = event_calculate_severity(predictor, event);
 
-    predictor->stats.num_predictions++;
-    predictor->stats.events_by_type[EVENT_TYPE_LOITERING]++;
+    return true;
+}
+
+bool event_predict_loitering(
+    EventPredictor* predictor,
+    const PredictedTrajectory* trajectory,
+    PredictedEvent* event
+) {
+    if (!predictor || !trajectory || !event) {
+        return false;
+    }
+
+    TrajectoryFeatures features;
+    if (!check_loitering(predictor, trajectory,
+                         describe_trajectory(predictor, trajectory, &features), event)) {
+        return false;
+    }
 
+    count_event(predictor, EVENT_LOITERING);
     return true;
 }
 
-bool event_predict_theft(
+/**
+ * Theft check for trajectory i (accomplices from all trajectories)
+ *
+ * Accomplices come from the index when there is one, a scan otherwise.
+ */
+static bool predict_theft_at(
     EventPredictor* predictor,
+    const ProximityIndex* index,
     const PredictedTrajectory* trajectories,
+    const TrajectoryFeatures* features,
     uint32_t num_trajectories,
+    uint32_t i,
     PredictedEvent* event
 ) {
-    if (!predictor || !trajectories || !event || num_trajectories == 0) {
-        return false;
-    }
+    const PredictedTrajectory* traj = &trajectories[i];
 
-    // Theft pattern detection:
-    // 1. Approach to protected area
-    // 2. Loitering/concealment behavior
-    // 3. Rapid exit (optional: with accomplices)
+    if (traj->num_predictions < 10) return false;
 
-    for (uint32_t i = 0; i < num_trajectories; i++) {
-        const PredictedTrajectory* traj = &trajectories[i];
-
-        if (traj->num_predictions < 10) continue;
-
-        // Check for approach to protected zone
-        float sensitivity = 0.0f;
-        bool enters_zone = false;
-        uint32_t entry_step = 0;
-
-        for (uint32_t step = 0; step < traj->num_predictions; step++) {
-            if (is_in_protected_zone(predictor,
-                                    traj->predictions[step].x,
-                                    traj->predictions[step].y,
-                                    EVENT_TYPE_THEFT,
-                                    &sensitivity)) {
-                enters_zone = true;
-                entry_step = step;
-                break;
-            }
-        }
+    // Check for approach to protected zone
+    uint32_t entry_step = features->theft_entry;
+    if (entry_step == NO_STEP) return false;
 
-        if (!enters_zone) continue;
+    // Check for suspicious behaviors
+    bool has_loitering = (traj->predictions[entry_step].behaviors & BEHAVIOR_LOITERING) != 0;
+    bool has_concealing = (traj->predictions[entry_step].behaviors & BEHAVIOR_CONCEALING) != 0;
+    float threat_score = traj->predictions[entry_step].threat_score;
 
-        // Check for suspicious behaviors
-        bool has_loitering = (traj->predictions[entry_step].behaviors & BEHAVIOR_LOITERING) != 0;
-        bool has_concealing = (traj->predictions[entry_step].behaviors & BEHAVIOR_CONCEALING) != 0;
-        float threat_score = traj->predictions[entry_step].threat_score;
+    // Check for rapid exit after zone entry
+    bool rapid_exit = features->exit_speed > 50.0f;  // Fast movement
 
-        // Check for rapid exit after zone entry
-        bool rapid_exit = false;
-        if (entry_step + 10 < traj->num_predictions) {
-            float exit_speed = sqrtf(
-                traj->predictions[entry_step + 10].vx * traj->predictions[entry_step + 10].vx +
-                traj->predictions[entry_step + 10].vy * traj->predictions[entry_step + 10].vy
-            );
-            rapid_exit = exit_speed > 50.0f;  // Fast movement
-        }
+    // Theft likelihood calculation
+    float theft_likelihood = 0.0f;
+    theft_likelihood += has_loitering ? 0.3f : 0.0f;
+    theft_likelihood += has_concealing ? 0.4f : 0.0f;
+    theft_likelihood += rapid_exit ? 0.2f : 0.0f;
+    theft_likelihood += threat_score * 0.3f;
+    theft_likelihood *= features->theft_sensitivity;  // Zone sensitivity
 
-        // Theft likelihood calculation
-        float theft_likelihood = 0.0f;
-        theft_likelihood += has_loitering ? 0.3f : 0.0f;
-        theft_likelihood += has_concealing ? 0.4f : 0.0f;
-        theft_likelihood += rapid_exit ? 0.2f : 0.0f;
-        theft_likelihood += threat_score * 0.3f;
-        theft_likelihood *= sensitivity;  // Zone sensitivity
+    if (theft_likelihood < predictor->config.theft_proximity_threshold) {
+        return false;
+    }
 
-        if (theft_likelihood < predictor->config.theft_proximity_threshold) {
-            continue;
-        }
+    // Check for accomplices
+    uint32_t num_accomplices = 0;
+    uint32_t accomplice_ids[MAX_ACCOMPLICES];
 
-        // Check for accomplices
-        uint32_t num_accomplices = 0;
-        uint32_t accomplice_ids[3];
+    if (index) {
+        uint32_t nearby[MAX_ACCOMPLICES];
+        num_accomplices = proximity_index_nearby(index, i, entry_step, ACCOMPLICE_DISTANCE,
+                                                 nearby, MAX_ACCOMPLICES);
+        for (uint32_t k = 0; k < num_accomplices; k++) {
+            accomplice_ids[k] = trajectories[nearby[k]].track_id;
+        }
+    }
 
-        for (uint32_t j = 0; j < num_trajectories && num_accomplices < 3; j++) {
-            if (j == i) continue;
+    for (uint32_t j = 0; !index && j < num_trajectories && num_accomplices < MAX_ACCOMPLICES; j++) {
+        if (j == i) continue;
 
-            const PredictedTrajectory* other = &trajectories[j];
+        const PredictedTrajectory* other = &trajectories[j];
 
-            // Check if other trajectory is nearby at entry time
-            if (entry_step < other->num_predictions) {
-                float dist = distance(
-                    traj->predictions[entry_step].x,
-                    traj->predictions[entry_step].y,
-                    other->predictions[entry_step].x,
-                    other->predictions[entry_step].y
-                );
+        // Check if other trajectory is nearby at entry time
+        if (entry_step < other->num_predictions) {
+            float dist = distance(
+                traj->predictions[entry_step].x,
+                traj->predictions[entry_step].y,
+                other->predictions[entry_step].x,
+                other->predictions[entry_step].y
+            );
 
-                if (dist < 100.0f) {  // Within 100 pixels
-                    accomplice_ids[num_accomplices++] = other->track_id;
-                }
+            if (dist < ACCOMPLICE_DISTANCE) {
+                accomplice_ids[num_accomplices++] = other->track_id;
             }
         }
+    }
 
-        // Build predicted event
-        memset(event, 0, sizeof(PredictedEvent));
-        event->type = EVENT_TYPE_THEFT;
-        event->timestamp_ms = traj->predictions[entry_step].timestamp_ms;
-        event->location_x = traj->predictions[entry_step].x;
-        event->location_y = traj->predictions[entry_step].y;
-        event->num_involved_tracks = 1 + num_accomplices;
-        event->involved_tracks[0] = traj->track_id;
-        for (uint32_t k = 0; k < num_accomplices; k++) {
-            event->involved_tracks[k + 1] = accomplice_ids[k];
-        }
+    // Build predicted event
+    memset(event, 0, sizeof(PredictedEvent));
+    event->type = EVENT_THEFT;
+    event->timestamp_ms = traj->predictions[entry_step].timestamp_ms;
+    event->location_x = traj->predictions[entry_step].x;
+    event->location_y = traj->predictions[entry_step].y;
+    event->num_involved = 1 + num_accomplices;
+    event->involved_tracks[0] = traj->track_id;
+    for (uint32_t k = 0; k < num_accomplices; k++) {
+        event->involved_tracks[k + 1] = accomplice_ids[k];
+    }
 
-        // Probability increases with accomplices
-        float accomplice_factor = 1.0f + num_accomplices * 0.2f;
-        float history_factor = calculate_historical_risk(
-            predictor,
-            event->location_x,
-            event->location_y,
-            EVENT_TYPE_THEFT
-        );
+    // Probability increases with accomplices
+    float accomplice_factor = 1.0f + num_accomplices * 0.2f;
+    float history_factor = calculate_historical_risk(
+        predictor,
+        event->location_x,
+        event->location_y,
+        EVENT_THEFT
+    );
 
-        event->probability = clamp(
-            theft_likelihood * accomplice_factor * (1.0f + history_factor * 0.5f),
-            0.0f, 1.0f
-        );
+    event->probability = clamp(
+        theft_likelihood * accomplice_factor * (1.0f + history_factor * 0.5f),
+        0.0f, 1.0f
+    );
+
+    event->severity = event_calculate_severity(predictor, event);
 
-        event->severity = event_calculate_severity(predictor, event);
+    return true;
+}
 
-        predictor->stats.num_predictions++;
-        predictor->stats.events_by_type[EVENT_TYPE_THEFT]++;
+/**
+ * First theft, in trajectory order
+ *
+ * Without features (no storage for them) each trajectory is described
+ * on the way.
+ */
+static bool find_theft(
+    EventPredictor* predictor,
+    const ProximityIndex* index,
+    const PredictedTrajectory* trajectories,
+    const TrajectoryFeatures* features,
+    uint32_t num_trajectories,
+    PredictedEvent* event
+) {
+    // Theft pattern detection:
+    // 1. Approach to protected area
+    // 2. Loitering/concealment behavior
+    // 3. Rapid exit (optional: with accomplices)
 
-        return true;
+    for (uint32_t i = 0; i < num_trajectories; i++) {
+        TrajectoryFeatures own;
+        const TrajectoryFeatures* f = features ? &features[i] :
+            describe_trajectory(predictor, &trajectories[i], &own);
+        if (predict_theft_at(predictor, index, trajectories, f, num_trajectories, i, event)) {
+            return true;
+        }
     }
 
     return false;
 }
 
-bool event_predict_assault(
+bool event_predict_theft(
     EventPredictor* predictor,
     const PredictedTrajectory* trajectories,
     uint32_t num_trajectories,
     PredictedEvent* event
 ) {
-    if (!predictor || !trajectories || !event || num_trajectories < 2) {
+    if (!predictor || !trajectories || !event || num_trajectories == 0) {
         return false;
     }
 
-    // Assault pattern detection:
-    // 1. Rapid approach to person
-    // 2. Following behavior
-    // 3. Aggressive posture/movement
+    const ProximityIndex* index = index_trajectories(predictor, trajectories, num_trajectories);
+    const TrajectoryFeatures* features = describe_trajectories(predictor, trajectories,
+                                                               num_trajectories);
+    if (!find_theft(predictor, index, trajectories, features, num_trajectories, event)) {
+        return false;
+    }
 
-    for (uint32_t i = 0; i < num_trajectories; i++) {
-        const PredictedTrajectory* traj1 = &trajectories[i];
+    count_event(predictor, EVENT_THEFT);
+    return true;
+}
 
-        for (uint32_t j = i + 1; j < num_trajectories; j++) {
-            const PredictedTrajectory* traj2 = &trajectories[j];
+/**
+ * Assault check for one pair of trajectories
+ */
+static bool predict_assault_pair(
+    EventPredictor* predictor,
+    const PredictedTrajectory* traj1,
+    const PredictedTrajectory* traj2,
+    const TrajectoryFeatures* features1,
+    const TrajectoryFeatures* features2,
+    PredictedEvent* event
+) {
+    if (features1 &&
+        (!extents_within(features1, features2, ASSAULT_CONTACT_DISTANCE) ||
+         !may_close_faster(features1, features2, predictor->config.assault_velocity_threshold))) {
+        return false;  // Never close enough, or never fast enough
+    }
 
-            // Check for rapid approach between two objects
-            float initial_dist = distance(
-                traj1->predictions[0].x, traj1->predictions[0].y,
-                traj2->predictions[0].x, traj2->predictions[0].y
-            );
+    // Check for rapid approach between two objects
+    float initial_dist = distance(
+        traj1->predictions[0].x, traj1->predictions[0].y,
+        traj2->predictions[0].x, traj2->predictions[0].y
+    );
 
-            // Find minimum distance in future
-            float min_dist = initial_dist;
-            uint32_t min_dist_step = 0;
-            uint32_t max_steps = traj1->num_predictions < traj2->num_predictions ?
-                                traj1->num_predictions : traj2->num_predictions;
-
-            for (uint32_t step = 1; step < max_steps; step++) {
-                float dist = distance(
-                    traj1->predictions[step].x, traj1->predictions[step].y,
-                    traj2->predictions[step].x, traj2->predictions[step].y
-                );
-
-                if (dist < min_dist) {
-                    min_dist = dist;
-                    min_dist_step = step;
-                }
-            }
+    // Find minimum distance in future
+    float min_dist = initial_dist;
+    uint32_t min_dist_step = 0;
+    uint32_t max_steps = traj1->num_predictions < traj2->num_predictions ?
+                        traj1->num_predictions : traj2->num_predictions;
 
-            // Check for rapid approach
-            float approach_speed = (initial_dist - min_dist) / (min_dist_step * 1.0f);
-            bool is_rapid_approach = approach_speed > predictor->config.assault_velocity_threshold;
+    for (uint32_t step = 1; step < max_steps; step++) {
+        float dist = distance(
+            traj1->predictions[step].x, traj1->predictions[step].y,
+            traj2->predictions[step].x, traj2->predictions[step].y
+        );
 
-            if (!is_rapid_approach || min_dist > 50.0f) {
-                continue;  // Not close enough or not approaching
-            }
+        if (dist < min_dist) {
+            min_dist = dist;
+            min_dist_step = step;
+        }
+    }
 
-            // Check for following behavior
-            bool is_following = false;
-            float avg_dist = 0.0f;
-            for (uint32_t step = min_dist_step; step < max_steps; step++) {
-                float dist = distance(
-                    traj1->predictions[step].x, traj1->predictions[step].y,
-                    traj2->predictions[step].x, traj2->predictions[step].y
-                );
-                avg_dist += dist;
-            }
-            avg_dist /= (max_steps - min_dist_step);
-            is_following = avg_dist < 80.0f;  // Stays close
+    // Check for rapid approach (pixels per second)
+    float approach_s = (float)(traj1->predictions[min_dist_step].timestamp_ms -
+                               traj1->predictions[0].timestamp_ms) / 1000.0f;
+    float approach_speed = (initial_dist - min_dist) / approach_s;
+    bool is_rapid_approach = approach_speed > predictor->config.assault_velocity_threshold;
 
-            // Check threat scores
-            float threat1 = traj1->predictions[min_dist_step].threat_score;
-            float threat2 = traj2->predictions[min_dist_step].threat_score;
-            float max_threat = threat1 > threat2 ? threat1 : threat2;
+    if (!is_rapid_approach || min_dist > ASSAULT_CONTACT_DISTANCE) {
+        return false;  // Not close enough or not approaching
+    }
 
-            // Calculate assault likelihood
-            float assault_likelihood = 0.0f;
-            assault_likelihood += is_rapid_approach ? 0.4f : 0.0f;
-            assault_likelihood += is_following ? 0.3f : 0.0f;
-            assault_likelihood += max_threat * 0.5f;
+    // Check for following behavior: distance averaged over time, each step
+    // weighted by its length
+    bool is_following = false;
+    float avg_dist = 0.0f;
+    float total_s = 0.0f;
+    for (uint32_t step = min_dist_step; step < max_steps; step++) {
+        float dist = distance(
+            traj1->predictions[step].x, traj1->predictions[step].y,
+            traj2->predictions[step].x, traj2->predictions[step].y
+        );
+        float step_s = step_seconds(traj1, step);
+        avg_dist += dist * step_s;
+        total_s += step_s;
+    }
+    avg_dist /= total_s;
+    is_following = avg_dist < 80.0f;  // Stays close
 
-            if (assault_likelihood < 0.5f) {
-                continue;
-            }
+    // Check threat scores
+    float threat1 = traj1->predictions[min_dist_step].threat_score;
+    float threat2 = traj2->predictions[min_dist_step].threat_score;
+    float max_threat = threat1 > threat2 ? threat1 : threat2;
 
-            // Build predicted event
-            memset(event, 0, sizeof(PredictedEvent));
-            event->type = EVENT_TYPE_ASSAULT;
-            event->timestamp_ms = traj1->predictions[min_dist_step].timestamp_ms;
-            event->location_x = (traj1->predictions[min_dist_step].x +
-                                traj2->predictions[min_dist_step].x) / 2;
-            event->location_y = (traj1->predictions[min_dist_step].y +
-                                traj2->predictions[min_dist_step].y) / 2;
-            event->num_involved_tracks = 2;
-            event->involved_tracks[0] = traj1->track_id;
-            event->involved_tracks[1] = traj2->track_id;
-
-            float history_factor = calculate_historical_risk(
-                predictor,
-                event->location_x,
-                event->location_y,
-                EVENT_TYPE_ASSAULT
-            );
-            float time_factor = predictor->scene.time_of_day_risk;
+    // Calculate assault likelihood
+    float assault_likelihood = 0.0f;
+    assault_likelihood += is_rapid_approach ? 0.4f : 0.0f;
+    assault_likelihood += is_following ? 0.3f : 0.0f;
+    assault_likelihood += max_threat * 0.5f;
 
-            event->probability = clamp(
-                assault_likelihood * (1.0f + history_factor * 0.3f) * time_factor,
-                0.0f, 1.0f
-            );
+    if (assault_likelihood < 0.5f) {
+        return false;
+    }
+
+    // Build predicted event
+    memset(event, 0, sizeof(PredictedEvent));
+    event->type = EVENT_ASSAULT;
+    event->timestamp_ms = traj1->predictions[min_dist_step].timestamp_ms;
+    event->location_x = (traj1->predictions[min_dist_step].x +
+                        traj2->predictions[min_dist_step].x) / 2;
+    event->location_y = (traj1->predictions[min_dist_step].y +
+                        traj2->predictions[min_dist_step].y) / 2;
+    event->num_involved = 2;
+    event->involved_tracks[0] = traj1->track_id;
+    event->involved_tracks[1] = traj2->track_id;
+
+    float history_factor = calculate_historical_risk(
+        predictor,
+        event->location_x,
+        event->location_y,
+        EVENT_ASSAULT
+    );
+    float time_factor = predictor->scene.time_of_day_risk;
+
+    event->probability = clamp(
+        assault_likelihood * (1.0f + history_factor * 0.3f) * time_factor,
+        0.0f, 1.0f
+    );
+
+    event->severity = event_calculate_severity(predictor, event);
+
+    return true;
+}
 
-            event->severity = event_calculate_severity(predictor, event);
+bool event_predict_assault(
+    EventPredictor* predictor,
+    const PredictedTrajectory* trajectories,
+    uint32_t num_trajectories,
+    PredictedEvent* event
+) {
+    if (!predictor || !trajectories || !event || num_trajectories < 2) {
+        return false;
+    }
 
-            predictor->stats.num_predictions++;
-            predictor->stats.events_by_type[EVENT_TYPE_ASSAULT]++;
+    // Assault pattern detection:
+    // 1. Rapid approach to person
+    // 2. Following behavior
+    // 3. Aggressive posture/movement
 
+    const ProximityIndex* index = index_trajectories(predictor, trajectories, num_trajectories);
+    const TrajectoryFeatures* features = describe_trajectories(predictor, trajectories,
+                                                               num_trajectories);
+    for (uint32_t i = 0; i < num_trajectories; i++) {
+        if (predict_row(predictor, index, predict_assault_pair, trajectories, features,
+                        num_trajectories, i, NULL, event)) {
+            count_event(predictor, EVENT_ASSAULT);
             return true;
         }
     }
@@ -456,6 +891,54 @@ bool event_predict_assault(
     return false;
 }
 
+/**
+ * Collision check for one pair of trajectories
+ */
+static bool predict_collision_pair(
+    EventPredictor* predictor,
+    const PredictedTrajectory* traj1,
+    const PredictedTrajectory* traj2,
+    const TrajectoryFeatures* features1,
+    const TrajectoryFeatures* features2,
+    PredictedEvent* event
+) {
+    if (features1 &&
+        !extents_within(features1, features2, predictor->config.collision_distance_threshold)) {
+        return false;
+    }
+
+    uint64_t collision_time = 0;
+    float collision_x = 0, collision_y = 0;
+
+    if (!trajectory_detect_collision(
+        traj1,
+        traj2,
+        predictor->config.collision_distance_threshold,
+        &collision_time,
+        &collision_x,
+        &collision_y
+    )) {
+        return false;
+    }
+
+    // Collision predicted
+    memset(event, 0, sizeof(PredictedEvent));
+    event->type = EVENT_COLLISION;
+    event->timestamp_ms = collision_time;
+    event->location_x = collision_x;
+    event->location_y = collision_y;
+    event->num_involved = 2;
+    event->involved_tracks[0] = traj1->track_id;
+    event->involved_tracks[1] = traj2->track_id;
+
+    // Probability based on confidence of both trajectories
+    event->probability = (traj1->overall_confidence + traj2->overall_confidence) / 2;
+
+    event->severity = event_calculate_severity(predictor, event);
+
+    return true;
+}
+
 bool event_predict_collision(
     EventPredictor* predictor,
     const PredictedTrajectory* trajectories,
@@ -467,46 +950,51 @@ bool event_predict_collision(
     }
 
     // Check all pairs of trajectories for potential collisions
+    const ProximityIndex* index = index_trajectories(predictor, trajectories, num_trajectories);
+    const TrajectoryFeatures* features = describe_trajectories(predictor, trajectories,
+                                                               num_trajectories);
     for (uint32_t i = 0; i < num_trajectories; i++) {
-        for (uint32_t j = i + 1; j < num_trajectories; j++) {
-            uint64_t collision_time = 0;
-            float collision_x = 0, collision_y = 0;
-
-            if (trajectory_detect_collision(
-                &trajectories[i],
-                &trajectories[j],
-                predictor->config.collision_distance_threshold,
-                &collision_time,
-                &collision_x,
-                &collision_y
-            )) {
-                // Collision predicted
-                memset(event, 0, sizeof(PredictedEvent));
-                event->type = EVENT_TYPE_COLLISION;
-                event->timestamp_ms = collision_time;
-                event->location_x = collision_x;
-                event->location_y = collision_y;
-                event->num_involved_tracks = 2;
-                event->involved_tracks[0] = trajectories[i].track_id;
-                event->involved_tracks[1] = trajectories[j].track_id;
-
-                // Probability based on confidence of both trajectories
-                event->probability = (trajectories[i].overall_confidence +
-                                     trajectories[j].overall_confidence) / 2;
-
-                event->severity = event_calculate_severity(predictor, event);
-
-                predictor->stats.num_predictions++;
-                predictor->stats.events_by_type[EVENT_TYPE_COLLISION]++;
-
-                return true;
-            }
+        if (predict_row(predictor, index, predict_collision_pair, trajectories, features,
+                        num_trajectories, i, NULL, event)) {
+            count_event(predictor, EVENT_COLLISION);
+            return true;
         }
     }
 
     return false;
 }
 
+/**
+ * Trespassing check for one trajectory
+ */
+static bool check_trespassing(
+    EventPredictor* predictor,
+    const PredictedTrajectory* trajectory,
+    const TrajectoryFeatures* features,
+    PredictedEvent* event
+) {
+    // Check if trajectory enters any protected zone
+    uint32_t step = features->trespass_entry;
+    if (step == NO_STEP) {
+        return false;
+    }
+
+    // Trespassing predicted
+    memset(event, 0, sizeof(PredictedEvent));
+    event->type = EVENT_TRESPASSING;
+    event->timestamp_ms = trajectory->predictions[step].timestamp_ms;
+    event->location_x = trajectory->predictions[step].x;
+    event->location_y = trajectory->predictions[step].y;
+    event->num_involved = 1;
+    event->involved_tracks[0] = trajectory->track_id;
+
+    event->probability = trajectory->predictions[step].confidence * features->trespass_sensitivity;
+
+    event->severity = event_calculate_severity(predictor, event);
+
+    return true;
+}
+
 bool event_predict_trespassing(
     EventPredictor* predictor,
     const PredictedTrajectory* trajectory,
@@ -516,35 +1004,108 @@ bool event_predict_trespassing(
         return false;
     }
 
-    // Check if trajectory enters any protected zone
-    for (uint32_t step = 0; step < trajectory->num_predictions; step++) {
-        float sensitivity = 0.0f;
-        if (is_in_protected_zone(predictor,
-                                 trajectory->predictions[step].x,
-                                 trajectory->predictions[step].y,
-                                 EVENT_TYPE_TRESPASSING,
-                                 &sensitivity)) {
-            // Trespassing predicted
-            memset(event, 0, sizeof(PredictedEvent));
-            event->type = EVENT_TYPE_TRESPASSING;
-            event->timestamp_ms = trajectory->predictions[step].timestamp_ms;
-            event->location_x = trajectory->predictions[step].x;
-            event->location_y = trajectory->predictions[step].y;
-            event->num_involved_tracks = 1;
-            event->involved_tracks[0] = trajectory->track_id;
-
-            event->probability = trajectory->predictions[step].confidence * sensitivity;
-
-            event->severity = event_calculate_severity(predictor, event);
-
-            predictor->stats.num_predictions++;
-            predictor->stats.events_by_type[EVENT_TYPE_TRESPASSING]++;
+    TrajectoryFeatures features;
+    if (!check_trespassing(predictor, trajectory,
+                           describe_trajectory(predictor, trajectory, &features), event)) {
+        return false;
+    }
 
-            return true;
+    count_event(predictor, EVENT_TRESPASSING);
+    return true;
+}
+
+/**
+ * Crowd formation check on the live groups
+ */
+static bool check_crowd_formation(
+    EventPredictor* predictor,
+    PredictedEvent* event
+) {
+    if (!predictor->config.groups) {
+        return false;
+    }
+
+    GroupInfo groups[MAX_CROWD_CANDIDATES];
+    uint32_t num_groups = group_analyzer_get_groups(predictor->config.groups, groups,
+                                                    MAX_CROWD_CANDIDATES);
+    if (num_groups == 0) {
+        return false;
+    }
+
+    GroupAnalyzerConfig group_config;
+    group_analyzer_get_config(predictor->config.groups, &group_config);
+    float crowd_size = (float)group_config.crowd_size;
+    float horizon_ms = predictor->config.crowd_horizon_ms > 0.0f
+        ? predictor->config.crowd_horizon_ms : DEFAULT_CROWD_HORIZON_MS;
+
+    // Pick the group most likely to be a crowd within the horizon
+    const GroupInfo* best = NULL;
+    float best_probability = 0.0f;
+    float best_eta_ms = 0.0f;
+
+    for (uint32_t i = 0; i < num_groups; i++) {
+        const GroupInfo* group = &groups[i];
+        float members = (float)group->num_members;
+        float probability;
+        float eta_ms = 0.0f;
+
+        if (group->is_crowd) {
+            // Already a crowd; more likely to persist while still growing
+            float growth = group->growth_rate * (horizon_ms / 1000.0f) / crowd_size;
+            probability = 0.6f + 0.4f * clamp(growth, 0.0f, 1.0f);
+        } else if (group->growth_rate > 0.0f) {
+            eta_ms = (crowd_size - members) / group->growth_rate * 1000.0f;
+            if (eta_ms > horizon_ms) {
+                continue;
+            }
+            probability = (members / crowd_size) * (1.0f - eta_ms / horizon_ms);
+        } else {
+            continue;
+        }
+
+        if (probability > best_probability) {
+            best = group;
+            best_probability = probability;
+            best_eta_ms = eta_ms;
         }
     }
 
-    return false;
+    if (!best) {
+        return false;
+    }
+
+    memset(event, 0, sizeof(PredictedEvent));
+    event->type = EVENT_CROWD_FORMATION;
+    event->timestamp_ms = get_current_time_ms() + (uint64_t)best_eta_ms;
+    event->location_x = best->centroid_x;
+    event->location_y = best->centroid_y;
+
+    uint32_t max_involved = sizeof(event->involved_tracks) / sizeof(event->involved_tracks[0]);
+    uint32_t listed = best->num_members < GROUP_MAX_MEMBERS ? best->num_members : GROUP_MAX_MEMBERS;
+    event->num_involved = listed < max_involved ? listed : max_involved;
+    memcpy(event->involved_tracks, best->members,
+           event->num_involved * sizeof(event->involved_tracks[0]));
+
+    event->probability = clamp(best_probability, 0.0f, 1.0f);
+    event->severity = event_calculate_severity(predictor, event);
+
+    return true;
+}
+
+bool event_predict_crowd_formation(
+    EventPredictor* predictor,
+    PredictedEvent* event
+) {
+    if (!predictor || !event) {
+        return false;
+    }
+
+    if (!check_crowd_formation(predictor, event)) {
+        return false;
+    }
+
+    count_event(predictor, EVENT_CROWD_FORMATION);
+    return true;
 }
 
 // ============================================================================
@@ -573,20 +1134,273 @@ EventPredictor* event_predictor_init(const EventPredictorConfig* config) {
         memset(&predictor->scene, 0, sizeof(SceneContext));
     }
 
+    // Protected zones: shared engine, or one built from the scene
+    if (config->zone_map) {
+        predictor->zones = config->zone_map;
+        predictor->owns_zones = false;
+    } else {
+        predictor->zones = zone_map_create(ZONE_MAP_DEFAULT_RESOLUTION);
+        predictor->owns_zones = true;
+        if (!predictor->zones || !load_scene_zones(predictor->zones, &predictor->scene)) {
+            fprintf(stderr, "[EventPredict] ERROR: Failed to build zone map\n");
+            zone_map_destroy(predictor->zones);
+            free(predictor);
+            return NULL;
+        }
+    }
+
+    predictor->workers = config->workers;
+
+    predictor->proximity = proximity_index_create();
+    if (!predictor->proximity) {
+        if (predictor->owns_zones) {
+            zone_map_destroy(predictor->zones);
+        }
+        free(predictor);
+        return NULL;
+    }
+
     // Initialize statistics
     memset(&predictor->stats, 0, sizeof(predictor->stats));
 
+    const ZoneGrid* zones = zone_map_acquire(predictor->zones);
     printf("[EventPredict] Initialized (%u zones, %u incidents)\n",
-           predictor->scene.num_zones, predictor->scene.num_incidents);
+           zone_grid_count(zones), predictor->scene.num_incidents);
+    zone_map_release(predictor->zones, zones);
 
     return predictor;
 }
 
+ZoneMap* event_predictor_get_zone_map(EventPredictor* predictor) {
+    return predictor ? predictor->zones : NULL;
+}
+
 void event_predictor_destroy(EventPredictor* predictor) {
     if (!predictor) return;
+    if (predictor->owns_zones) {
+        zone_map_destroy(predictor->zones);
+    }
+    proximity_index_destroy(predictor->proximity);
+    free(predictor->shards);
+    free(predictor->features);
     free(predictor);
 }
 
+/**
+ * Shared state of one sharded event pass
+ *
+ * Tasks [0, n) take the collision row of trajectory i, [n, 2n) its
+ * assault row, [2n, 3n) theft, [3n, 4n) loitering and trespassing, and
+ * task 4n crowd formation. Only the first collision / assault / theft
+ * hit is reported, so rows after a known hit are skipped; rows before it
+ * always run, which keeps the result that of the sequential scan.
+ */
+typedef struct {
+    EventPredictor* predictor;
+    const ProximityIndex* index;   // NULL = scan
+    const PredictedTrajectory* trajectories;
+    const TrajectoryFeatures* features;
+    uint32_t num_trajectories;
+    TrajectoryEvents* shards;
+    atomic_uint first_collision;   // Lowest row with a hit so far
+    atomic_uint first_assault;
+    atomic_uint first_theft;
+    PredictedEvent crowd;
+    bool has_crowd;
+} EventJob;
+
+static void lower_to(atomic_uint* first, uint32_t row) {
+    uint32_t seen = atomic_load_explicit(first, memory_order_relaxed);
+    while (row < seen &&
+           !atomic_compare_exchange_weak_explicit(first, &seen, row,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+}
+
+static void predict_events_task(void* context, uint32_t task) {
+    EventJob* job = context;
+    EventPredictor* predictor = job->predictor;
+    const PredictedTrajectory* trajectories = job->trajectories;
+    uint32_t n = job->num_trajectories;
+
+    if (task == 4 * n) {
+        job->has_crowd = check_crowd_formation(predictor, &job->crowd);
+        return;
+    }
+
+    uint32_t i = task % n;
+    TrajectoryEvents* shard = &job->shards[i];
+
+    switch (task / n) {
+        case 0:
+            if (i > atomic_load_explicit(&job->first_collision, memory_order_relaxed)) break;
+            if (predict_row(predictor, job->index, predict_collision_pair, trajectories,
+                            job->features, n, i, NULL, &shard->collision)) {
+                lower_to(&job->first_collision, i);
+            }
+            break;
+
+        case 1:
+            if (i > atomic_load_explicit(&job->first_assault, memory_order_relaxed)) break;
+            if (predict_row(predictor, job->index, predict_assault_pair, trajectories,
+                            job->features, n, i, NULL, &shard->assault)) {
+                lower_to(&job->first_assault, i);
+            }
+            break;
+
+        case 2:
+            if (i > atomic_load_explicit(&job->first_theft, memory_order_relaxed)) break;
+            if (predict_theft_at(predictor, job->index, trajectories, &job->features[i], n, i,
+                                 &shard->theft)) {
+                lower_to(&job->first_theft, i);
+            }
+            break;
+
+        default:
+            shard->has_loitering = check_loitering(predictor, &trajectories[i], &job->features[i],
+                                                   &shard->loitering);
+            shard->has_trespassing = check_trespassing(predictor, &trajectories[i],
+                                                       &job->features[i], &shard->trespassing);
+            break;
+    }
+}
+
+/**
+ * event_predictor_predict() with the checks sharded across the worker pool
+ *
+ * Merges in the sequential order and counts the same events, so results
+ * and statistics do not depend on the number of threads.
+ */
+static uint32_t predict_sharded(
+    EventPredictor* predictor,
+    const ProximityIndex* index,
+    const PredictedTrajectory* trajectories,
+    const TrajectoryFeatures* features,
+    uint32_t n,
+    PredictedEvent* events,
+    uint32_t max_events
+) {
+    EventJob job = {
+        .predictor = predictor,
+        .index = index,
+        .trajectories = trajectories,
+        .features = features,
+        .num_trajectories = n,
+        .shards = predictor->shards,
+        .has_crowd = false
+    };
+    atomic_init(&job.first_collision, UINT32_MAX);
+    atomic_init(&job.first_assault, UINT32_MAX);
+    atomic_init(&job.first_theft, UINT32_MAX);
+
+    worker_pool_run(predictor->workers, 4 * n + 1, predict_events_task, &job);
+
+    uint32_t num_events = 0;
+    uint32_t first[3] = {
+        atomic_load(&job.first_collision),
+        atomic_load(&job.first_assault),
+        atomic_load(&job.first_theft)
+    };
+
+    // Collision, assault, theft, crowd formation: the first hit of each
+    if (first[0] < n) {
+        count_event(predictor, EVENT_COLLISION);
+        events[num_events++] = job.shards[first[0]].collision;
+    }
+    if (first[1] < n) {
+        count_event(predictor, EVENT_ASSAULT);
+        if (num_events < max_events) {
+            events[num_events++] = job.shards[first[1]].assault;
+        }
+    }
+    if (first[2] < n) {
+        count_event(predictor, EVENT_THEFT);
+        if (num_events < max_events) {
+            events[num_events++] = job.shards[first[2]].theft;
+        }
+    }
+    if (job.has_crowd) {
+        count_event(predictor, EVENT_CROWD_FORMATION);
+        if (num_events < max_events) {
+            events[num_events++] = job.crowd;
+        }
+    }
+
+    // Loitering and trespassing (per trajectory)
+    for (uint32_t i = 0; i < n && num_events < max_events; i++) {
+        const TrajectoryEvents* shard = &job.shards[i];
+
+        if (shard->has_loitering) {
+            count_event(predictor, EVENT_LOITERING);
+            if (num_events < max_events) {
+                events[num_events++] = shard->loitering;
+            }
+        }
+
+        if (shard->has_trespassing) {
+            count_event(predictor, EVENT_TRESPASSING);
+            if (num_events < max_events) {
+                events[num_events++] = shard->trespassing;
+            }
+        }
+    }
+
+    return num_events;
+}
+
+/**
+ * Make room for one TrajectoryEvents per trajectory
+ */
+static bool reserve_shards(EventPredictor* predictor, uint32_t n) {
+    if (n <= predictor->shards_capacity) {
+        return true;
+    }
+
+    TrajectoryEvents* shards = realloc(predictor->shards, n * sizeof(TrajectoryEvents));
+    if (!shards) {
+        return false;
+    }
+    predictor->shards = shards;
+    predictor->shards_capacity = n;
+    return true;
+}
+
+/**
+ * Loitering and trespassing of one trajectory, counted and appended
+ *
+ * Without a feature record (no storage for them) the trajectory is
+ * described here.
+ */
+static void score_trajectory(
+    EventPredictor* predictor,
+    const PredictedTrajectory* trajectory,
+    const TrajectoryFeatures* features,
+    PredictedEvent* events,
+    uint32_t* num_events,
+    uint32_t max_events
+) {
+    TrajectoryFeatures own;
+    if (!features) {
+        features = describe_trajectory(predictor, trajectory, &own);
+    }
+
+    PredictedEvent candidate;
+    if (check_loitering(predictor, trajectory, features, &candidate)) {
+        count_event(predictor, EVENT_LOITERING);
+        if (*num_events < max_events) {
+            events[(*num_events)++] = candidate;
+        }
+    }
+
+    if (check_trespassing(predictor, trajectory, features, &candidate)) {
+        count_event(predictor, EVENT_TRESPASSING);
+        if (*num_events < max_events) {
+            events[(*num_events)++] = candidate;
+        }
+    }
+}
+
 uint32_t event_predictor_predict(
     EventPredictor* predictor,
     const PredictedTrajectory* trajectories,
@@ -598,27 +1412,56 @@ uint32_t event_predictor_predict(
         return 0;
     }
 
+    // One index serves every proximity query of this pass, one feature
+    // record per trajectory every scorer
+    const ProximityIndex* index = index_trajectories(predictor, trajectories, num_trajectories);
+    const TrajectoryFeatures* features = describe_trajectories(predictor, trajectories,
+                                                               num_trajectories);
+
+    if (worker_pool_num_threads(predictor->workers) > 1 &&
+        num_trajectories >= MIN_SHARDED_TRAJECTORIES && features &&
+        reserve_shards(predictor, num_trajectories)) {
+        return predict_sharded(predictor, index, trajectories, features, num_trajectories,
+                               events, max_events);
+    }
+
     uint32_t num_events = 0;
 
     // Try to predict each event type
     PredictedEvent candidate;
 
     // Collision (check first - highest priority)
-    if (event_predict_collision(predictor, trajectories, num_trajectories, &candidate)) {
-        if (num_events < max_events) {
+    for (uint32_t i = 0; i < num_trajectories; i++) {
+        if (predict_row(predictor, index, predict_collision_pair, trajectories, features,
+                        num_trajectories, i, NULL, &candidate)) {
+            count_event(predictor, EVENT_COLLISION);
             events[num_events++] = candidate;
+            break;
         }
     }
 
     // Assault
-    if (event_predict_assault(predictor, trajectories, num_trajectories, &candidate)) {
+    for (uint32_t i = 0; i < num_trajectories; i++) {
+        if (predict_row(predictor, index, predict_assault_pair, trajectories, features,
+                        num_trajectories, i, NULL, &candidate)) {
+            count_event(predictor, EVENT_ASSAULT);
+            if (num_events < max_events) {
+                events[num_events++] = candidate;
+            }
+            break;
+        }
+    }
+
+    // Theft
+    if (find_theft(predictor, index, trajectories, features, num_trajectories, &candidate)) {
+        count_event(predictor, EVENT_THEFT);
         if (num_events < max_events) {
             events[num_events++] = candidate;
         }
     }
 
-    // Theft
-    if (event_predict_theft(predictor, trajectories, num_trajectories, &candidate)) {
+    // Crowd formation (per group, from perception)
+    if (event_predict_crowd_formation(predictor, &candidate)) {
         if (num_events < max_events) {
             events[num_events++] = candidate;
         }
@@ -626,19 +1469,77 @@ uint32_t event_predictor_predict(
 
     // Loitering and trespassing (per trajectory)
     for (uint32_t i = 0; i < num_trajectories && num_events < max_events; i++) {
-        if (event_predict_loitering(predictor, &trajectories[i], &candidate)) {
+        score_trajectory(predictor, &trajectories[i], features ? &features[i] : NULL,
+                         events, &num_events, max_events);
+    }
+
+    return num_events;
+}
+
+uint32_t event_predictor_predict_changed(
+    EventPredictor* predictor,
+    const PredictedTrajectory* trajectories,
+    uint32_t num_trajectories,
+    const bool* changed,
+    PredictedEvent* events,
+    uint32_t max_events
+) {
+    if (!predictor || !trajectories || !changed || !events || max_events == 0) {
+        return 0;
+    }
+
+    uint32_t num_events = 0;
+    PredictedEvent candidate;
+
+    const ProximityIndex* index = index_trajectories(predictor, trajectories, num_trajectories);
+    const TrajectoryFeatures* features = describe_trajectories(predictor, trajectories,
+                                                               num_trajectories);
+
+    // Collision and assault: only pairs with a changed trajectory, each pair once
+    for (uint32_t i = 0; i < num_trajectories; i++) {
+        if (changed[i] &&
+            predict_row(predictor, index, predict_collision_pair, trajectories, features,
+                        num_trajectories, i, changed, &candidate)) {
+            count_event(predictor, EVENT_COLLISION);
+            events[num_events++] = candidate;
+            break;
+        }
+    }
+    for (uint32_t i = 0; i < num_trajectories; i++) {
+        if (changed[i] &&
+            predict_row(predictor, index, predict_assault_pair, trajectories, features,
+                        num_trajectories, i, changed, &candidate)) {
+            count_event(predictor, EVENT_ASSAULT);
             if (num_events < max_events) {
                 events[num_events++] = candidate;
             }
+            break;
         }
+    }
 
-        if (event_predict_trespassing(predictor, &trajectories[i], &candidate)) {
-            if (num_events < max_events) {
-                events[num_events++] = candidate;
-            }
+    // Theft depends on accomplices, crowd formation on the group analyzer:
+    // both are cheap next to the pairwise checks and always rerun
+    if (find_theft(predictor, index, trajectories, features, num_trajectories, &candidate)) {
+        count_event(predictor, EVENT_THEFT);
+        if (num_events < max_events) {
+            events[num_events++] = candidate;
         }
     }
 
+    if (event_predict_crowd_formation(predictor, &candidate)) {
+        if (num_events < max_events) {
+            events[num_events++] = candidate;
+        }
+    }
+
+    // Loitering and trespassing of changed trajectories
+    for (uint32_t i = 0; i < num_trajectories && num_events < max_events; i++) {
+        if (!changed[i]) continue;
+
+        score_trajectory(predictor, &trajectories[i], features ? &features[i] : NULL,
+                         events, &num_events, max_events);
+    }
+
     return num_events;
 }
 
@@ -654,18 +1555,18 @@ SeverityLevel event_calculate_severity(
     float severity_score = 0.0f;
 
     switch (event->type) {
-        case EVENT_TYPE_ASSAULT:
-        case EVENT_TYPE_THEFT:
+        case EVENT_ASSAULT:
+        case EVENT_THEFT:
             severity_score = 0.8f;
             break;
 
-        case EVENT_TYPE_COLLISION:
-        case EVENT_TYPE_TRESPASSING:
+        case EVENT_COLLISION:
+        case EVENT_TRESPASSING:
             severity_score = 0.6f;
             break;
 
-        case EVENT_TYPE_LOITERING:
-        case EVENT_TYPE_SUSPICIOUS_BEHAVIOR:
+        case EVENT_LOITERING:
+        case EVENT_SUSPICIOUS_BEHAVIOR:
             severity_score = 0.4f;
             break;
 
@@ -15,6 +15,9 @@
 
 #include "timeline.h"
 #include "trajectory_predictor.h"
+#include "zone_map.h"
+#include "group_analyzer.h"
+#include "worker_pool.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -27,7 +30,7 @@ typedef struct EventPredictor EventPredictor;
 /**
  * Scene context for event prediction
  */
-typedef struct {
+typedef struct SceneContext {
     // Protected zones
     uint32_t num_zones;
     struct {
@@ -38,7 +41,7 @@ typedef struct {
 
     // Historical data
     uint32_t num_incidents;
-    struct {
+    struct SceneIncident {
         EventType type;
         uint64_t timestamp_ms;
         float location_x, location_y;
@@ -58,6 +61,7 @@ typedef struct {
     float theft_proximity_threshold;
     float assault_velocity_threshold;
     float collision_distance_threshold;
+    float crowd_horizon_ms;     // Look-ahead for growing groups (0 = 30000)
 
     // Weights for event scoring
     float trajectory_weight;
@@ -67,6 +71,18 @@ typedef struct {
 
     // Scene context
     const SceneContext* scene;
+
+    // Shared zone engine (not owned). NULL = the predictor builds its own
+    // from scene->zones; when set, scene->zones is ignored.
+    ZoneMap* zone_map;
+
+    // Live groups from perception (not owned, e.g.
+    // perception_get_group_analyzer()). NULL = no crowd prediction.
+    GroupAnalyzer* groups;
+
+    // Worker pool the checks are sharded across (not owned, e.g. the
+    // timeline engine's). NULL = single-threaded.
+    WorkerPool* workers;
 } EventPredictorConfig;
 
 /**
@@ -95,6 +111,32 @@ uint32_t event_predictor_predict(
     uint32_t max_events
 );
 
+/**
+ * Predict the events that can differ after some trajectories changed
+ *
+ * Runs the same checks as event_predictor_predict(), but collision and
+ * assault only on pairs with at least one changed trajectory, and
+ * loitering and trespassing only on changed trajectories. Theft and crowd
+ * formation are always checked. Events of unchanged trajectories (and
+ * pairs of them) are left to the caller to carry over.
+ *
+ * @param predictor Event predictor instance
+ * @param trajectories Predicted trajectories
+ * @param num_trajectories Number of trajectories
+ * @param changed Per trajectory: true if it changed since the last call
+ * @param events Output array for predicted events
+ * @param max_events Maximum events to return
+ * @return Number of events predicted
+ */
+uint32_t event_predictor_predict_changed(
+    EventPredictor* predictor,
+    const PredictedTrajectory* trajectories,
+    uint32_t num_trajectories,
+    const bool* changed,
+    PredictedEvent* events,
+    uint32_t max_events
+);
+
 /**
  * Predict loitering event
  *
@@ -181,6 +223,23 @@ bool event_predict_trespassing(
     PredictedEvent* event
 );
 
+/**
+ * Predict crowd formation
+ *
+ * Uses the group analyzer's current groups: a group that already is a
+ * crowd, or whose smoothed growth rate brings it to the crowd size within
+ * crowd_horizon_ms. The most likely group is reported, located at its
+ * centroid (normalized), with its first members as involved tracks.
+ *
+ * @param predictor Event predictor instance
+ * @param event Output predicted event
+ * @return true if crowd formation predicted
+ */
+bool event_predict_crowd_formation(
+    EventPredictor* predictor,
+    PredictedEvent* event
+);
+
 /**
  * Calculate event severity based on context
  *
@@ -204,6 +263,19 @@ void event_predictor_update_context(
     const PredictedEvent* event
 );
 
+/**
+ * Get the zone map used for protected-zone checks
+ *
+ * Zones may be edited through it while predictions run; each prediction
+ * call sees either the old or the new zone set, never a mix.
+ * Zone classes are bit (1u << EventType); ZONE_CLASS_ALL matches every
+ * event type like protected_event = EVENT_NONE.
+ *
+ * @param predictor Event predictor instance
+ * @return Zone map
+ */
+ZoneMap* event_predictor_get_zone_map(EventPredictor* predictor);
+
 /**
  * Destroy event predictor
  *
@@ -0,0 +1,571 @@
+/**
+ * @file particle_sampler.c
+ * @brief Monte Carlo sampling of track futures for Timeline Threading
+ *
+ * A particle follows its base trajectory's velocity plus a fixed
+ * perturbation, so the rollout works for every motion model: step k
+ * moves the particle by (base velocity at k + perturbation) * step length.
+ * From its switch step on, the velocity is scaled and rotated (stop, turn,
+ * run). A batch keeps each of these values in its own array, one lane per
+ * particle, so the step loop has no branches and vectorizes.
+ *
+ * Futures are compared by each track's offset from its base position at
+ * the checkpoints, scaled to CLUSTER_LOOKAHEAD_S of lookahead: velocity
+ * noise grows with time, a switch moves a track off by more. Clustering
+ * is leader based, in particle order: a particle joins the first cluster
+ * whose leader is within the radius at every checkpoint, or leads a new
+ * one. Once PARTICLE_SAMPLER_MAX_CLUSTERS exist, it joins the nearest.
+ * The result depends on the particle order only, never on the threads.
+ */
+
+#include "particle_sampler.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define NUM_CHECKPOINTS 3               // Horizon thirds
+#define DEFAULT_CLUSTER_RADIUS 100.0f
+#define CLUSTER_LOOKAHEAD_S 10.0f       // Lookahead the cluster radius applies at
+#define VELOCITY_NOISE 0.1f             // Velocity spread, fraction of the speed
+#define MIN_VELOCITY_NOISE 1.0f         // Velocity spread of a still track (px/s)
+#define BASE_SWITCH_PROBABILITY 0.2f
+#define THREAT_SWITCH_PROBABILITY 0.3f  // Added at threat score 1
+#define MAX_TURN (M_PI / 2)             // Largest turn at a switch
+#define MAX_BATCHES (PARTICLE_SAMPLER_MAX_PARTICLES / PARTICLE_SAMPLER_BATCH)
+#define NO_SWITCH INT32_MAX
+
+typedef enum {
+    SWITCH_NONE,
+    SWITCH_STOP,
+    SWITCH_TURN,
+    SWITCH_RUN
+} SwitchKind;
+
+/**
+ * Random draws of one track in one particle
+ */
+typedef struct {
+    float dvx, dvy;                 // Velocity perturbation
+    int32_t switch_step;            // First step after the switch (NO_SWITCH = none)
+    SwitchKind kind;
+    float a, b;                     // After the switch, v -> (a vx - b vy, b vx + a vy)
+} Perturbation;
+
+/**
+ * One batch of particles of one track
+ */
+typedef struct {
+    float x[PARTICLE_SAMPLER_BATCH];
+    float y[PARTICLE_SAMPLER_BATCH];
+    float dvx[PARTICLE_SAMPLER_BATCH];
+    float dvy[PARTICLE_SAMPLER_BATCH];
+    float da[PARTICLE_SAMPLER_BATCH];       // a - 1
+    float b[PARTICLE_SAMPLER_BATCH];
+    int32_t switch_step[PARTICLE_SAMPLER_BATCH];
+} ParticleBatch;
+
+struct ParticleSampler {
+    ParticleSamplerConfig config;
+    uint32_t num_batches;
+
+    // Current run
+    const PredictedTrajectory* const* trajectories;
+    uint32_t num_trajectories;
+    uint64_t deadline_us;           // 0 = no budget
+    bool batch_done[MAX_BATCHES];
+    uint32_t num_sampled;
+
+    // Scaled offsets at the checkpoints: [checkpoint][track][particle]
+    float* signature_x;
+    float* signature_y;
+
+    // Cluster of each particle
+    uint32_t* cluster_of;
+};
+
+// ============================================================================
+// Random Numbers
+// ============================================================================
+
+/**
+ * SplitMix64 finalizer: a bijective mix of a 64-bit counter
+ */
+static uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Uniform draw in [0, 1) for (seed, particle, track, draw)
+ */
+static float uniform(uint64_t seed, uint32_t particle, uint32_t track_id, uint32_t draw) {
+    uint64_t counter = ((((uint64_t)particle << 32) | track_id) << 3) | draw;
+    uint64_t bits = mix64(seed + counter * 0x9e3779b97f4a7c15ULL);
+    return (float)(bits >> 40) * (1.0f / 16777216.0f);
+}
+
+/**
+ * First step at or after a time (the last step if none)
+ */
+static uint32_t first_step_at(const PredictedState* states, uint32_t n, uint64_t time_ms) {
+    uint32_t low = 0, high = n - 1;
+    while (low < high) {
+        uint32_t mid = (low + high) / 2;
+        if (states[mid].timestamp_ms < time_ms) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/**
+ * Draw the perturbation of one track in one particle
+ */
+static void draw_perturbation(
+    uint64_t seed,
+    const PredictedTrajectory* base,
+    uint32_t particle,
+    Perturbation* perturbation
+) {
+    float u[6];
+    for (uint32_t d = 0; d < 6; d++) {
+        u[d] = uniform(seed, particle, base->track_id, d);
+    }
+
+    const PredictedState* first = &base->predictions[0];
+    float speed = sqrtf(first->vx * first->vx + first->vy * first->vy);
+    float sigma = VELOCITY_NOISE * speed + MIN_VELOCITY_NOISE;
+
+    // Box-Muller: two normal draws
+    float radius = sigma * sqrtf(-2.0f * logf(1.0f - u[0]));
+    perturbation->dvx = radius * cosf(2.0f * (float)M_PI * u[1]);
+    perturbation->dvy = radius * sinf(2.0f * (float)M_PI * u[1]);
+
+    float threat = fminf(fmaxf(first->threat_score, 0.0f), 1.0f);
+    float switch_probability = BASE_SWITCH_PROBABILITY + THREAT_SWITCH_PROBABILITY * threat;
+
+    perturbation->switch_step = NO_SWITCH;
+    perturbation->kind = SWITCH_NONE;
+    perturbation->a = 1.0f;
+    perturbation->b = 0.0f;
+    if (u[2] >= switch_probability || base->num_predictions < 2) {
+        return;
+    }
+
+    // Switch time uniform over the horizon, whatever the step lengths
+    const PredictedState* states = base->predictions;
+    uint32_t n = base->num_predictions;
+    uint64_t span_ms = states[n - 1].timestamp_ms - states[0].timestamp_ms;
+    uint32_t step = first_step_at(states, n, states[0].timestamp_ms +
+                                  (uint64_t)(u[3] * (float)span_ms));
+    perturbation->switch_step = (int32_t)(step > 0 ? step : 1);
+
+    if (u[4] < 1.0f / 3.0f) {
+        perturbation->kind = SWITCH_STOP;
+        perturbation->a = 0.0f;
+    } else if (u[4] < 2.0f / 3.0f) {
+        float angle = (2.0f * u[5] - 1.0f) * (float)MAX_TURN;
+        perturbation->kind = SWITCH_TURN;
+        perturbation->a = cosf(angle);
+        perturbation->b = sinf(angle);
+    } else {
+        perturbation->kind = SWITCH_RUN;
+        perturbation->a = 1.5f + u[5];
+    }
+}
+
+// ============================================================================
+// Rollout
+// ============================================================================
+
+static uint64_t get_monotonic_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/**
+ * Steps at the end of each third of the horizon time
+ */
+static void checkpoint_steps(const PredictedState* states, uint32_t num_steps, uint32_t* steps) {
+    if (num_steps == 0) {
+        memset(steps, 0, NUM_CHECKPOINTS * sizeof(uint32_t));
+        return;
+    }
+    uint64_t start_ms = states[0].timestamp_ms;
+    uint64_t span_ms = states[num_steps - 1].timestamp_ms - start_ms;
+    for (uint32_t c = 0; c < NUM_CHECKPOINTS; c++) {
+        steps[c] = first_step_at(states, num_steps,
+                                 start_ms + span_ms * (c + 1) / NUM_CHECKPOINTS);
+    }
+}
+
+static size_t signature_offset(const ParticleSampler* sampler, uint32_t checkpoint,
+                               uint32_t track, uint32_t particle) {
+    return ((size_t)checkpoint * PARTICLE_SAMPLER_MAX_TRACKS + track) *
+           sampler->config.max_particles + particle;
+}
+
+/**
+ * Length of step k in seconds
+ */
+static float step_seconds(const PredictedState* states, uint32_t k) {
+    return (float)(states[k].timestamp_ms - states[k - 1].timestamp_ms) * 0.001f;
+}
+
+/**
+ * Roll out one batch of particles for every track
+ */
+static void rollout_batch(void* context, uint32_t batch) {
+    ParticleSampler* sampler = context;
+
+    if (batch > 0 && sampler->deadline_us && get_monotonic_us() >= sampler->deadline_us) {
+        sampler->batch_done[batch] = false;
+        return;
+    }
+
+    uint32_t first_particle = batch * PARTICLE_SAMPLER_BATCH;
+    ParticleBatch particles;
+
+    for (uint32_t t = 0; t < sampler->num_trajectories; t++) {
+        const PredictedTrajectory* base = sampler->trajectories[t];
+        const PredictedState* states = base->predictions;
+        uint32_t n = base->num_predictions;
+
+        for (uint32_t i = 0; i < PARTICLE_SAMPLER_BATCH; i++) {
+            Perturbation perturbation;
+            draw_perturbation(sampler->config.seed, base, first_particle + i, &perturbation);
+            particles.x[i] = states[0].x;
+            particles.y[i] = states[0].y;
+            particles.dvx[i] = perturbation.dvx;
+            particles.dvy[i] = perturbation.dvy;
+            particles.da[i] = perturbation.a - 1.0f;
+            particles.b[i] = perturbation.b;
+            particles.switch_step[i] = perturbation.switch_step;
+        }
+
+        uint32_t checkpoints[NUM_CHECKPOINTS];
+        checkpoint_steps(states, n, checkpoints);
+        uint32_t next_checkpoint = 0;
+
+        for (uint32_t k = 0; k < n; k++) {
+            if (k > 0) {
+                float dt = step_seconds(states, k);
+                float base_vx = states[k].vx;
+                float base_vy = states[k].vy;
+
+                // The switch is a 0/1 factor, not a branch, so the loop
+                // vectorizes without relaxed floating point
+                for (uint32_t i = 0; i < PARTICLE_SAMPLER_BATCH; i++) {
+                    float vx = base_vx + particles.dvx[i];
+                    float vy = base_vy + particles.dvy[i];
+                    float on = (float)((int32_t)k >= particles.switch_step[i]);
+                    float a = 1.0f + on * particles.da[i];
+                    float b = on * particles.b[i];
+                    particles.x[i] += (a * vx - b * vy) * dt;
+                    particles.y[i] += (b * vx + a * vy) * dt;
+                }
+            }
+
+            while (next_checkpoint < NUM_CHECKPOINTS && checkpoints[next_checkpoint] == k) {
+                size_t offset = signature_offset(sampler, next_checkpoint, t, first_particle);
+                float* signature_x = &sampler->signature_x[offset];
+                float* signature_y = &sampler->signature_y[offset];
+                float lookahead = (float)(states[k].timestamp_ms - states[0].timestamp_ms) * 0.001f;
+                float scale = CLUSTER_LOOKAHEAD_S / fmaxf(lookahead, 1.0f);
+                for (uint32_t i = 0; i < PARTICLE_SAMPLER_BATCH; i++) {
+                    signature_x[i] = (particles.x[i] - states[k].x) * scale;
+                    signature_y[i] = (particles.y[i] - states[k].y) * scale;
+                }
+                next_checkpoint++;
+            }
+        }
+    }
+
+    sampler->batch_done[batch] = true;
+}
+
+// ============================================================================
+// Clustering
+// ============================================================================
+
+/**
+ * Largest squared distance between two particles over tracks and checkpoints
+ */
+static float particle_distance2(const ParticleSampler* sampler, uint32_t p, uint32_t q) {
+    float worst = 0.0f;
+    for (uint32_t c = 0; c < NUM_CHECKPOINTS; c++) {
+        for (uint32_t t = 0; t < sampler->num_trajectories; t++) {
+            size_t base = signature_offset(sampler, c, t, 0);
+            float dx = sampler->signature_x[base + p] - sampler->signature_x[base + q];
+            float dy = sampler->signature_y[base + p] - sampler->signature_y[base + q];
+            worst = fmaxf(worst, dx * dx + dy * dy);
+        }
+    }
+    return worst;
+}
+
+typedef struct {
+    uint32_t leader;
+    uint32_t num_particles;
+    uint32_t representative;
+    float nearest2;                 // Representative's squared distance to the mean
+    float mean_x[NUM_CHECKPOINTS][PARTICLE_SAMPLER_MAX_TRACKS];
+    float mean_y[NUM_CHECKPOINTS][PARTICLE_SAMPLER_MAX_TRACKS];
+} Cluster;
+
+/**
+ * Whether cluster a reports before b: more particles, then earlier leader
+ */
+static bool cluster_before(const Cluster* a, const Cluster* b) {
+    if (a->num_particles != b->num_particles) {
+        return a->num_particles > b->num_particles;
+    }
+    return a->leader < b->leader;
+}
+
+static uint32_t cluster_particles(
+    ParticleSampler* sampler,
+    ParticleCluster* clusters,
+    uint32_t max_clusters
+) {
+    uint32_t num_particles = sampler->num_sampled;
+    uint32_t num_tracks = sampler->num_trajectories;
+    float radius2 = sampler->config.cluster_radius * sampler->config.cluster_radius;
+
+    Cluster found[PARTICLE_SAMPLER_MAX_CLUSTERS];
+    uint32_t num_found = 0;
+
+    // Leaders, in particle order
+    for (uint32_t p = 0; p < num_particles; p++) {
+        uint32_t nearest = 0;
+        float nearest2 = INFINITY;
+        uint32_t joined = UINT32_MAX;
+
+        for (uint32_t c = 0; c < num_found; c++) {
+            float d2 = particle_distance2(sampler, found[c].leader, p);
+            if (d2 <= radius2) {
+                joined = c;
+                break;
+            }
+            if (d2 < nearest2) {
+                nearest2 = d2;
+                nearest = c;
+            }
+        }
+
+        if (joined == UINT32_MAX) {
+            if (num_found < PARTICLE_SAMPLER_MAX_CLUSTERS) {
+                joined = num_found++;
+                memset(&found[joined], 0, sizeof(Cluster));
+                found[joined].leader = p;
+            } else {
+                joined = nearest;
+            }
+        }
+
+        found[joined].num_particles++;
+        sampler->cluster_of[p] = joined;
+    }
+
+    // Means, then the member nearest each mean
+    for (uint32_t p = 0; p < num_particles; p++) {
+        Cluster* cluster = &found[sampler->cluster_of[p]];
+        for (uint32_t c = 0; c < NUM_CHECKPOINTS; c++) {
+            for (uint32_t t = 0; t < num_tracks; t++) {
+                size_t offset = signature_offset(sampler, c, t, p);
+                cluster->mean_x[c][t] += sampler->signature_x[offset] / cluster->num_particles;
+                cluster->mean_y[c][t] += sampler->signature_y[offset] / cluster->num_particles;
+            }
+        }
+    }
+
+    for (uint32_t c = 0; c < num_found; c++) {
+        found[c].representative = found[c].leader;
+        found[c].nearest2 = INFINITY;
+    }
+    for (uint32_t p = 0; p < num_particles; p++) {
+        Cluster* cluster = &found[sampler->cluster_of[p]];
+        float d2 = 0.0f;
+        for (uint32_t c = 0; c < NUM_CHECKPOINTS; c++) {
+            for (uint32_t t = 0; t < num_tracks; t++) {
+                size_t offset = signature_offset(sampler, c, t, p);
+                float dx = sampler->signature_x[offset] - cluster->mean_x[c][t];
+                float dy = sampler->signature_y[offset] - cluster->mean_y[c][t];
+                d2 = fmaxf(d2, dx * dx + dy * dy);
+            }
+        }
+        if (d2 < cluster->nearest2) {
+            cluster->nearest2 = d2;
+            cluster->representative = p;
+        }
+    }
+
+    // Insertion sort: few clusters, and unlike qsort() it never allocates
+    for (uint32_t c = 1; c < num_found; c++) {
+        Cluster cluster = found[c];
+        uint32_t pos = c;
+        while (pos > 0 && cluster_before(&cluster, &found[pos - 1])) {
+            found[pos] = found[pos - 1];
+            pos--;
+        }
+        found[pos] = cluster;
+    }
+
+    uint32_t num_clusters = num_found < max_clusters ? num_found : max_clusters;
+    for (uint32_t c = 0; c < num_clusters; c++) {
+        clusters[c].particle = found[c].representative;
+        clusters[c].num_particles = found[c].num_particles;
+        clusters[c].probability = (float)found[c].num_particles / (float)num_particles;
+    }
+    return num_clusters;
+}
+
+// ============================================================================
+// Public API Implementation
+// ============================================================================
+
+ParticleSampler* particle_sampler_create(const ParticleSamplerConfig* config) {
+    if (!config) {
+        fprintf(stderr, "[ParticleSampler] ERROR: NULL config\n");
+        return NULL;
+    }
+
+    ParticleSampler* sampler = calloc(1, sizeof(ParticleSampler));
+    if (!sampler) {
+        fprintf(stderr, "[ParticleSampler] ERROR: Failed to allocate sampler\n");
+        return NULL;
+    }
+
+    sampler->config = *config;
+    uint32_t num_batches = (config->max_particles + PARTICLE_SAMPLER_BATCH - 1) /
+                           PARTICLE_SAMPLER_BATCH;
+    if (num_batches == 0) num_batches = 1;
+    if (num_batches > MAX_BATCHES) num_batches = MAX_BATCHES;
+    sampler->num_batches = num_batches;
+    sampler->config.max_particles = num_batches * PARTICLE_SAMPLER_BATCH;
+    if (sampler->config.cluster_radius <= 0.0f) {
+        sampler->config.cluster_radius = DEFAULT_CLUSTER_RADIUS;
+    }
+
+    size_t signature_floats = (size_t)NUM_CHECKPOINTS * PARTICLE_SAMPLER_MAX_TRACKS *
+                              sampler->config.max_particles;
+    sampler->signature_x = malloc(signature_floats * sizeof(float));
+    sampler->signature_y = malloc(signature_floats * sizeof(float));
+    sampler->cluster_of = malloc(sampler->config.max_particles * sizeof(uint32_t));
+    if (!sampler->signature_x || !sampler->signature_y || !sampler->cluster_of) {
+        fprintf(stderr, "[ParticleSampler] ERROR: Failed to allocate %u particles\n",
+                sampler->config.max_particles);
+        particle_sampler_destroy(sampler);
+        return NULL;
+    }
+
+    return sampler;
+}
+
+uint32_t particle_sampler_run(
+    ParticleSampler* sampler,
+    const PredictedTrajectory* const* trajectories,
+    uint32_t num_trajectories,
+    ParticleCluster* clusters,
+    uint32_t max_clusters
+) {
+    if (!sampler || !trajectories || !clusters || max_clusters == 0 ||
+        num_trajectories == 0 || num_trajectories > PARTICLE_SAMPLER_MAX_TRACKS) {
+        return 0;
+    }
+    for (uint32_t t = 0; t < num_trajectories; t++) {
+        if (trajectories[t]->num_predictions == 0) {
+            return 0;
+        }
+    }
+
+    sampler->trajectories = trajectories;
+    sampler->num_trajectories = num_trajectories;
+    sampler->deadline_us = sampler->config.budget_us > 0 ?
+        get_monotonic_us() + sampler->config.budget_us : 0;
+
+    worker_pool_run(sampler->config.workers, sampler->num_batches, rollout_batch, sampler);
+
+    uint32_t num_done = 0;
+    while (num_done < sampler->num_batches && sampler->batch_done[num_done]) {
+        num_done++;
+    }
+    sampler->num_sampled = num_done * PARTICLE_SAMPLER_BATCH;
+
+    uint32_t num_clusters = cluster_particles(sampler, clusters, max_clusters);
+    sampler->trajectories = NULL;
+    return num_clusters;
+}
+
+uint32_t particle_sampler_num_sampled(const ParticleSampler* sampler) {
+    return sampler ? sampler->num_sampled : 0;
+}
+
+void particle_sampler_replay(
+    const ParticleSampler* sampler,
+    const PredictedTrajectory* base,
+    uint32_t particle,
+    PredictedTrajectory* future
+) {
+    if (!sampler || !base || !future) {
+        return;
+    }
+
+    future->track_id = base->track_id;
+    future->num_predictions = base->num_predictions;
+    future->overall_confidence = base->overall_confidence;
+    if (base->num_predictions == 0) {
+        return;
+    }
+
+    Perturbation perturbation;
+    draw_perturbation(sampler->config.seed, base, particle, &perturbation);
+
+    BehaviorFlags switched = perturbation.kind == SWITCH_STOP ? BEHAVIOR_LOITERING :
+                             perturbation.kind == SWITCH_RUN ? BEHAVIOR_RUNNING :
+                             BEHAVIOR_NORMAL;
+
+    const PredictedState* states = base->predictions;
+    float x = states[0].x;
+    float y = states[0].y;
+    future->predictions[0] = states[0];
+
+    for (uint32_t k = 1; k < base->num_predictions; k++) {
+        float dt = step_seconds(states, k);
+        float vx = states[k].vx + perturbation.dvx;
+        float vy = states[k].vy + perturbation.dvy;
+        float on = (float)((int32_t)k >= perturbation.switch_step);
+        float a = 1.0f + on * (perturbation.a - 1.0f);
+        float b = on * perturbation.b;
+        x += (a * vx - b * vy) * dt;
+        y += (b * vx + a * vy) * dt;
+
+        PredictedState* state = &future->predictions[k];
+        *state = states[k];
+        state->x = x;
+        state->y = y;
+        state->vx = a * vx - b * vy;
+        state->vy = b * vx + a * vy;
+        if ((int32_t)k >= perturbation.switch_step) {
+            state->behaviors |= switched;
+        }
+    }
+}
+
+void particle_sampler_destroy(ParticleSampler* sampler) {
+    if (!sampler) return;
+    free(sampler->signature_x);
+    free(sampler->signature_y);
+    free(sampler->cluster_of);
+    free(sampler);
+}
@@ -0,0 +1,128 @@
+/**
+ * @file particle_sampler.h
+ * @brief Monte Carlo sampling of track futures for Timeline Threading
+ *
+ * Rolls out K stochastic futures (particles) of a few tracks. In each
+ * particle a track's velocity is perturbed, and the track may switch
+ * behavior (stop, turn or run) at a random step. Random numbers come from
+ * a counter-based generator keyed by (seed, particle, track, draw), so a
+ * single particle can be replayed on its own and the same seed always
+ * gives the same futures.
+ *
+ * Particles are stepped in SoA batches of PARTICLE_SAMPLER_BATCH, one
+ * batch per worker pool task. The futures are then clustered by where the
+ * tracks are at a few checkpoints; each cluster reports a representative
+ * particle and its share of all particles.
+ */
+
+#ifndef OMNISIGHT_PARTICLE_SAMPLER_H
+#define OMNISIGHT_PARTICLE_SAMPLER_H
+
+#include "trajectory_predictor.h"
+#include "worker_pool.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PARTICLE_SAMPLER_BATCH 64
+#define PARTICLE_SAMPLER_MAX_PARTICLES 4096
+#define PARTICLE_SAMPLER_MAX_TRACKS 8
+#define PARTICLE_SAMPLER_MAX_CLUSTERS 32
+
+typedef struct ParticleSampler ParticleSampler;
+
+/**
+ * Particle sampler configuration
+ */
+typedef struct {
+    uint32_t max_particles;     // K, in whole batches (max PARTICLE_SAMPLER_MAX_PARTICLES)
+    uint32_t budget_us;         // Rollout time; later batches are skipped (0 = no limit,
+                                // the only setting where runs are reproducible)
+    uint64_t seed;              // Key of the random stream
+    float cluster_radius;       // Futures this close per 10 s ahead cluster (0 = 100 px)
+    WorkerPool* workers;        // Shared, not owned (NULL = single-threaded)
+} ParticleSamplerConfig;
+
+/**
+ * A group of similar futures
+ */
+typedef struct {
+    uint32_t particle;          // Representative: the member nearest the cluster mean
+    uint32_t num_particles;     // Members
+    float probability;          // Share of the particles sampled
+} ParticleCluster;
+
+/**
+ * Create a sampler
+ *
+ * @param config Sampler configuration
+ * @return Sampler instance, NULL on failure
+ */
+ParticleSampler* particle_sampler_create(const ParticleSamplerConfig* config);
+
+/**
+ * Sample futures of a set of trajectories and cluster them
+ *
+ * The time budget is checked before each batch; batch 0 always runs, and
+ * the particles sampled are the batches before the first one skipped.
+ * Results depend only on the seed, the trajectories and that count, so
+ * they are reproducible when budget_us is 0 (all max_particles sampled);
+ * under a budget the count, and with it the clusters, follow timing.
+ *
+ * @param sampler Sampler instance
+ * @param trajectories Base trajectories of the sampled tracks
+ * @param num_trajectories Number of trajectories
+ *                         (at most PARTICLE_SAMPLER_MAX_TRACKS)
+ * @param clusters Output clusters, most probable first
+ * @param max_clusters Capacity of clusters
+ * @return Number of clusters written
+ */
+uint32_t particle_sampler_run(
+    ParticleSampler* sampler,
+    const PredictedTrajectory* const* trajectories,
+    uint32_t num_trajectories,
+    ParticleCluster* clusters,
+    uint32_t max_clusters
+);
+
+/**
+ * Particles sampled by the latest run
+ *
+ * @param sampler Sampler instance
+ * @return Particle count
+ */
+uint32_t particle_sampler_num_sampled(const ParticleSampler* sampler);
+
+/**
+ * Future of one trajectory in one particle
+ *
+ * Steps the particle exactly as the rollout did. States after a behavior
+ * switch carry the new behavior (stop: loitering, run: running).
+ *
+ * @param sampler Sampler instance
+ * @param base Base trajectory, as passed to particle_sampler_run()
+ * @param particle Particle number
+ * @param future Output trajectory
+ */
+void particle_sampler_replay(
+    const ParticleSampler* sampler,
+    const PredictedTrajectory* base,
+    uint32_t particle,
+    PredictedTrajectory* future
+);
+
+/**
+ * Destroy a sampler
+ *
+ * @param sampler Sampler instance
+ */
+void particle_sampler_destroy(ParticleSampler* sampler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OMNISIGHT_PARTICLE_SAMPLER_H
@@ -0,0 +1,426 @@
+/**
+ * @file proximity_index.c
+ * @brief Spatio-temporal index over predicted trajectory positions
+ *
+ * Every step gets a square grid of the same side, placed over that step's
+ * bounding box, so early steps (tracks still close together) and late
+ * steps (spread over the horizon) both split into useful cells. The side
+ * grows with the square root of the trajectory count, for about one
+ * trajectory per cell, and cells are never narrower than the contact
+ * radius, so contacts are found in the 3x3 cells around a position.
+ */
+
+#include "proximity_index.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdio.h>
+
+#define MAX_GRID_SIDE 32
+#define CELL_MARGIN 1.01f   // Keeps rounding from pushing a neighbour a cell further
+#define CONTACT_SLACK 1.0001f  // Squared-radius slack: contacts may only over-report
+
+struct ProximityIndex {
+    const PredictedTrajectory* trajectories;
+    uint32_t num_trajectories;
+    uint32_t num_steps;
+    uint32_t side;              // Cells per side, every step
+
+    // Grid placement per step
+    float* origin_x;
+    float* origin_y;
+    float* inv_cell;
+    float* extent_x;            // Build scratch: bounding box maxima
+    float* extent_y;
+    uint32_t steps_capacity;
+
+    // Entries sorted by (step, cell), trajectories ascending within a cell
+    uint32_t* cell_start;       // num_steps * side * side + 1
+    uint32_t keys_capacity;
+    uint32_t* entry_trajectory;
+    float* entry_x;
+    float* entry_y;
+    uint32_t entries_capacity;
+
+    // Contact sets, PROXIMITY_INDEX_WORDS(num_trajectories) words per trajectory
+    uint64_t* contacts;
+    uint32_t contacts_capacity;  // Words
+};
+
+// ============================================================================
+// Storage
+// ============================================================================
+
+static bool grow_floats(float** array, uint32_t count) {
+    float* grown = realloc(*array, count * sizeof(float));
+    if (!grown) return false;
+    *array = grown;
+    return true;
+}
+
+static bool grow_indices(uint32_t** array, uint32_t count) {
+    uint32_t* grown = realloc(*array, count * sizeof(uint32_t));
+    if (!grown) return false;
+    *array = grown;
+    return true;
+}
+
+static bool reserve(ProximityIndex* index, uint32_t num_steps, uint32_t num_keys,
+                    uint32_t num_entries, uint32_t num_contact_words) {
+    if (num_steps > index->steps_capacity) {
+        if (!grow_floats(&index->origin_x, num_steps) ||
+            !grow_floats(&index->origin_y, num_steps) ||
+            !grow_floats(&index->inv_cell, num_steps) ||
+            !grow_floats(&index->extent_x, num_steps) ||
+            !grow_floats(&index->extent_y, num_steps)) {
+            return false;
+        }
+        index->steps_capacity = num_steps;
+    }
+
+    if (num_keys + 1 > index->keys_capacity) {
+        if (!grow_indices(&index->cell_start, num_keys + 1)) {
+            return false;
+        }
+        index->keys_capacity = num_keys + 1;
+    }
+
+    if (num_entries > index->entries_capacity) {
+        if (!grow_indices(&index->entry_trajectory, num_entries) ||
+            !grow_floats(&index->entry_x, num_entries) ||
+            !grow_floats(&index->entry_y, num_entries)) {
+            return false;
+        }
+        index->entries_capacity = num_entries;
+    }
+
+    if (num_contact_words > index->contacts_capacity) {
+        uint64_t* contacts = realloc(index->contacts, num_contact_words * sizeof(uint64_t));
+        if (!contacts) {
+            return false;
+        }
+        index->contacts = contacts;
+        index->contacts_capacity = num_contact_words;
+    }
+
+    return true;
+}
+
+// ============================================================================
+// Grid
+// ============================================================================
+
+static void cell_coords(const ProximityIndex* index, uint32_t step, float x, float y,
+                        uint32_t* cx, uint32_t* cy) {
+    float last = (float)(index->side - 1);
+    float inv_cell = index->inv_cell[step];
+
+    // fmaxf() sends NaN positions to cell 0
+    *cx = (uint32_t)fminf(fmaxf((x - index->origin_x[step]) * inv_cell, 0.0f), last);
+    *cy = (uint32_t)fminf(fmaxf((y - index->origin_y[step]) * inv_cell, 0.0f), last);
+}
+
+static uint32_t cell_key(const ProximityIndex* index, uint32_t step, float x, float y) {
+    uint32_t cx, cy;
+    cell_coords(index, step, x, y, &cx, &cy);
+    return (step * index->side + cy) * index->side + cx;
+}
+
+/**
+ * Cells a query must reach on each side to cover a radius at a step
+ */
+static uint32_t cell_reach(const ProximityIndex* index, uint32_t step, float radius) {
+    float cells = radius * index->inv_cell[step] * CELL_MARGIN;
+    if (!(cells < (float)index->side)) {
+        return index->side;
+    }
+    return (uint32_t)cells + 1;
+}
+
+static void add_contact(uint64_t* contacts, uint32_t words, uint32_t i, uint32_t j) {
+    contacts[i * words + j / 64] |= 1ull << (j % 64);
+    contacts[j * words + i / 64] |= 1ull << (i % 64);
+}
+
+/**
+ * Fill every trajectory's contact set in one sweep over the grid
+ *
+ * Each entry is compared with the later entries of its cell and the cell
+ * to its right, and with the three cells below, so every pair of
+ * neighbouring cells is visited once. The test is on squared distance
+ * with a little slack, so it never misses a pair the exact checks accept.
+ */
+static void find_contacts(ProximityIndex* index, uint32_t num_trajectories,
+                          uint32_t num_steps, float radius) {
+    uint32_t words = PROXIMITY_INDEX_WORDS(num_trajectories);
+    uint32_t side = index->side;
+    float reach_sq = radius * radius * CONTACT_SLACK;
+    uint64_t* contacts = index->contacts;
+
+    memset(contacts, 0, num_trajectories * words * sizeof(uint64_t));
+
+    for (uint32_t s = 0; s < num_steps; s++) {
+        for (uint32_t cy = 0; cy < side; cy++) {
+            uint32_t row = (s * side + cy) * side;
+            uint32_t below = row + side;
+
+            for (uint32_t cx = 0; cx < side; cx++) {
+                uint32_t cell = row + cx;
+                uint32_t cell_end = index->cell_start[cell + 1];
+
+                // Same cell and the one to its right are contiguous
+                uint32_t right_end = cx + 1 < side ? index->cell_start[cell + 2] : cell_end;
+
+                // Cells below: (cx - 1 .. cx + 1, cy + 1)
+                uint32_t below_begin = 0, below_end = 0;
+                if (cy + 1 < side) {
+                    below_begin = index->cell_start[below + (cx > 0 ? cx - 1 : 0)];
+                    below_end = index->cell_start[below + (cx + 1 < side ? cx + 1 : cx) + 1];
+                }
+
+                for (uint32_t a = index->cell_start[cell]; a < cell_end; a++) {
+                    uint32_t i = index->entry_trajectory[a];
+                    float x = index->entry_x[a];
+                    float y = index->entry_y[a];
+                    const uint64_t* known = &contacts[i * words];
+
+                    for (uint32_t pass = 0; pass < 2; pass++) {
+                        uint32_t begin = pass == 0 ? a + 1 : below_begin;
+                        uint32_t end = pass == 0 ? right_end : below_end;
+
+                        for (uint32_t k = begin; k < end; k++) {
+                            uint32_t j = index->entry_trajectory[k];
+                            if (known[j / 64] & (1ull << (j % 64))) continue;
+
+                            float dx = index->entry_x[k] - x;
+                            float dy = index->entry_y[k] - y;
+                            if (dx*dx + dy*dy <= reach_sq) {
+                                add_contact(contacts, words, i, j);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+ProximityIndex* proximity_index_create(void) {
+    ProximityIndex* index = calloc(1, sizeof(ProximityIndex));
+    if (!index) {
+        fprintf(stderr, "[ProxIndex] ERROR: Failed to allocate memory\n");
+        return NULL;
+    }
+    index->side = 1;
+    return index;
+}
+
+bool proximity_index_build(
+    ProximityIndex* index,
+    const PredictedTrajectory* trajectories,
+    uint32_t num_trajectories,
+    float radius
+) {
+    if (!index) {
+        return false;
+    }
+
+    index->trajectories = trajectories;
+    index->num_trajectories = 0;
+    index->num_steps = 0;
+
+    if (!trajectories || num_trajectories > PROXIMITY_INDEX_MAX_TRAJECTORIES) {
+        return false;
+    }
+
+    uint32_t num_steps = 0;
+    uint32_t num_entries = 0;
+    for (uint32_t i = 0; i < num_trajectories; i++) {
+        uint32_t n = trajectories[i].num_predictions;
+        if (n > num_steps) num_steps = n;
+        num_entries += n;
+    }
+
+    uint32_t side = 1;
+    while (side * side < num_trajectories && side < MAX_GRID_SIDE) {
+        side++;
+    }
+    uint32_t num_cells = side * side;
+    uint32_t num_keys = num_steps * num_cells;
+
+    uint32_t words = PROXIMITY_INDEX_WORDS(num_trajectories);
+    if (!reserve(index, num_steps, num_keys, num_entries, num_trajectories * words)) {
+        fprintf(stderr, "[ProxIndex] ERROR: Failed to grow index to %u positions\n",
+                num_entries);
+        return false;
+    }
+
+    // Bounding box of each step
+    for (uint32_t s = 0; s < num_steps; s++) {
+        index->origin_x[s] = INFINITY;
+        index->origin_y[s] = INFINITY;
+        index->extent_x[s] = -INFINITY;
+        index->extent_y[s] = -INFINITY;
+    }
+    for (uint32_t i = 0; i < num_trajectories; i++) {
+        const PredictedTrajectory* traj = &trajectories[i];
+        for (uint32_t s = 0; s < traj->num_predictions; s++) {
+            float x = traj->predictions[s].x;
+            float y = traj->predictions[s].y;
+            if (x < index->origin_x[s]) index->origin_x[s] = x;
+            if (x > index->extent_x[s]) index->extent_x[s] = x;
+            if (y < index->origin_y[s]) index->origin_y[s] = y;
+            if (y > index->extent_y[s]) index->extent_y[s] = y;
+        }
+    }
+
+    float min_cell = radius * CELL_MARGIN;
+    for (uint32_t s = 0; s < num_steps; s++) {
+        float extent = fmaxf(index->extent_x[s] - index->origin_x[s],
+                             index->extent_y[s] - index->origin_y[s]);
+        if (!(extent >= 0.0f)) {
+            // No finite positions at this step
+            index->origin_x[s] = 0.0f;
+            index->origin_y[s] = 0.0f;
+            extent = 0.0f;
+        }
+        float cell = fmaxf(min_cell, extent / side);
+        index->inv_cell[s] = cell > 0.0f ? 1.0f / cell : 0.0f;
+    }
+
+    index->side = side;
+
+    // Counting sort by (step, cell); trajectory order is kept within a cell
+    memset(index->cell_start, 0, (num_keys + 1) * sizeof(uint32_t));
+    for (uint32_t i = 0; i < num_trajectories; i++) {
+        const PredictedTrajectory* traj = &trajectories[i];
+        for (uint32_t s = 0; s < traj->num_predictions; s++) {
+            uint32_t key = cell_key(index, s, traj->predictions[s].x, traj->predictions[s].y);
+            index->cell_start[key + 1]++;
+        }
+    }
+    for (uint32_t k = 0; k < num_keys; k++) {
+        index->cell_start[k + 1] += index->cell_start[k];
+    }
+
+    for (uint32_t i = 0; i < num_trajectories; i++) {
+        const PredictedTrajectory* traj = &trajectories[i];
+        for (uint32_t s = 0; s < traj->num_predictions; s++) {
+            float x = traj->predictions[s].x;
+            float y = traj->predictions[s].y;
+            uint32_t slot = index->cell_start[cell_key(index, s, x, y)]++;
+            index->entry_trajectory[slot] = i;
+            index->entry_x[slot] = x;
+            index->entry_y[slot] = y;
+        }
+    }
+    for (uint32_t k = num_keys; k > 0; k--) {
+        index->cell_start[k] = index->cell_start[k - 1];
+    }
+    index->cell_start[0] = 0;
+
+    find_contacts(index, num_trajectories, num_steps, radius);
+
+    index->num_trajectories = num_trajectories;
+    index->num_steps = num_steps;
+    return true;
+}
+
+uint32_t proximity_index_contacts(
+    const ProximityIndex* index,
+    uint32_t trajectory,
+    uint64_t* contacts
+) {
+    if (!index || !contacts) {
+        return 0;
+    }
+
+    uint32_t words = PROXIMITY_INDEX_WORDS(index->num_trajectories);
+    if (trajectory >= index->num_trajectories) {
+        memset(contacts, 0, words * sizeof(uint64_t));
+        return 0;
+    }
+
+    const uint64_t* row = &index->contacts[trajectory * words];
+    uint32_t num_contacts = 0;
+    for (uint32_t w = 0; w < words; w++) {
+        contacts[w] = row[w];
+        num_contacts += (uint32_t)__builtin_popcountll(row[w]);
+    }
+
+    return num_contacts;
+}
+
+uint32_t proximity_index_nearby(
+    const ProximityIndex* index,
+    uint32_t trajectory,
+    uint32_t step,
+    float radius,
+    uint32_t* nearby,
+    uint32_t max_nearby
+) {
+    if (!index || !nearby || max_nearby == 0 || trajectory >= index->num_trajectories) {
+        return 0;
+    }
+
+    const PredictedTrajectory* traj = &index->trajectories[trajectory];
+    if (step >= traj->num_predictions) {
+        return 0;
+    }
+
+    float x = traj->predictions[step].x;
+    float y = traj->predictions[step].y;
+    uint32_t side = index->side;
+    uint32_t reach = cell_reach(index, step, radius);
+
+    uint32_t cx, cy;
+    cell_coords(index, step, x, y, &cx, &cy);
+    uint32_t x0 = cx > reach ? cx - reach : 0;
+    uint32_t y0 = cy > reach ? cy - reach : 0;
+    uint32_t x1 = cx + reach < side ? cx + reach : side - 1;
+    uint32_t y1 = cy + reach < side ? cy + reach : side - 1;
+
+    uint32_t num_nearby = 0;
+    for (uint32_t gy = y0; gy <= y1; gy++) {
+        uint32_t row = (step * side + gy) * side;
+        for (uint32_t k = index->cell_start[row + x0]; k < index->cell_start[row + x1 + 1]; k++) {
+            uint32_t j = index->entry_trajectory[k];
+            if (j == trajectory) continue;
+            if (num_nearby == max_nearby && j > nearby[max_nearby - 1]) continue;
+
+            float dx = index->entry_x[k] - x;
+            float dy = index->entry_y[k] - y;
+            if (!(sqrtf(dx*dx + dy*dy) < radius)) continue;
+
+            // Keep the lowest max_nearby trajectories, ascending
+            uint32_t pos = num_nearby < max_nearby ? num_nearby++ : max_nearby - 1;
+            while (pos > 0 && nearby[pos - 1] > j) {
+                nearby[pos] = nearby[pos - 1];
+                pos--;
+            }
+            nearby[pos] = j;
+        }
+    }
+
+    return num_nearby;
+}
+
+void proximity_index_destroy(ProximityIndex* index) {
+    if (!index) return;
+
+    free(index->origin_x);
+    free(index->origin_y);
+    free(index->inv_cell);
+    free(index->extent_x);
+    free(index->extent_y);
+    free(index->cell_start);
+    free(index->entry_trajectory);
+    free(index->entry_x);
+    free(index->entry_y);
+    free(index->contacts);
+    free(index);
+}
@@ -0,0 +1,117 @@
+/**
+ * @file proximity_index.h
+ * @brief Spatio-temporal index over predicted trajectory positions
+ *
+ * One uniform grid per prediction step, each over the bounding box of
+ * that step's positions, all stored in a single counting sort keyed by
+ * (step, cell). Proximity queries look at the cells around a position
+ * instead of every other trajectory, which turns the all-pairs event
+ * checks into cell lookups. Within a cell, entries keep trajectory order,
+ * so queries report the same trajectories a sequential scan would.
+ *
+ * Rebuilt for each event prediction pass; storage grows to the largest
+ * scene and is reused. Queries only read the index, so several threads
+ * may run them at once.
+ */
+
+#ifndef OMNISIGHT_PROXIMITY_INDEX_H
+#define OMNISIGHT_PROXIMITY_INDEX_H
+
+#include "trajectory_predictor.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PROXIMITY_INDEX_MAX_TRAJECTORIES 1024
+
+/** Words in a contact set for n trajectories */
+#define PROXIMITY_INDEX_WORDS(n) (((n) + 63) / 64)
+
+typedef struct ProximityIndex ProximityIndex;
+
+/**
+ * Create an empty index
+ *
+ * @return Index instance, NULL on failure
+ */
+ProximityIndex* proximity_index_create(void);
+
+/**
+ * Index every predicted position of a set of trajectories
+ *
+ * The index keeps a pointer to the trajectories, which must stay
+ * unchanged while it is queried.
+ *
+ * @param index Index instance
+ * @param trajectories Trajectories to index
+ * @param num_trajectories Number of trajectories
+ *                         (at most PROXIMITY_INDEX_MAX_TRAJECTORIES)
+ * @param radius Contact radius, and the smallest cell size
+ * @return true on success; false when there are too many trajectories or
+ *         storage could not grow (the index is then empty)
+ */
+bool proximity_index_build(
+    ProximityIndex* index,
+    const PredictedTrajectory* trajectories,
+    uint32_t num_trajectories,
+    float radius
+);
+
+/**
+ * Trajectories that come within the contact radius of one trajectory
+ *
+ * A trajectory j is in contact when, at some step both predict,
+ * distance(i, j) <= radius. Contact sets are found while building, with a
+ * slack of a few parts in 100000 on the radius: they may include a pair
+ * just outside it, never leave one out.
+ *
+ * @param index Built index
+ * @param trajectory Trajectory i
+ * @param contacts Output set, PROXIMITY_INDEX_WORDS(num_trajectories)
+ *                 words: bit j is set for every j != i in contact
+ * @return Number of trajectories in contact
+ */
+uint32_t proximity_index_contacts(
+    const ProximityIndex* index,
+    uint32_t trajectory,
+    uint64_t* contacts
+);
+
+/**
+ * Trajectories closer than a radius to one trajectory at one step
+ *
+ * Reports the lowest-numbered matches first, as a scan over all
+ * trajectories in order would.
+ *
+ * @param index Built index
+ * @param trajectory Trajectory i
+ * @param step Prediction step
+ * @param radius Distance; any size, larger ones visit more cells
+ * @param nearby Output trajectory numbers, ascending
+ * @param max_nearby Capacity of nearby
+ * @return Number of trajectories written
+ */
+uint32_t proximity_index_nearby(
+    const ProximityIndex* index,
+    uint32_t trajectory,
+    uint32_t step,
+    float radius,
+    uint32_t* nearby,
+    uint32_t max_nearby
+);
+
+/**
+ * Destroy an index
+ *
+ * @param index Index instance
+ */
+void proximity_index_destroy(ProximityIndex* index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OMNISIGHT_PROXIMITY_INDEX_H
@@ -10,60 +10,224 @@
  * - Branch prediction for alternative futures
  * - Event prediction on each timeline
  * - Intervention recommendation
+ *
+ * timeline_update() runs on the caller's thread. With monitoring started,
+ * a monitor thread runs it instead, on the latest snapshot the perception
+ * thread submitted (a TrackSnapshot used as a mailbox): submitting never
+ * waits for prediction, and frames that arrive during an update are
+ * coalesced into the next one. timeline_clear() is handed over the same
+ * way and applied by the monitor thread between updates.
  */
 
 #include "timeline.h"
 #include "trajectory_predictor.h"
 #include "event_predictor.h"
+#include "track_index.h"
+#include "track_snapshot.h"
+#include "worker_pool.h"
+#include "particle_sampler.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <time.h>
 #include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define MAX_BRANCH_DEPTH 3              // Decision points per tree
+#define MAX_ALTERNATIVES 5              // trajectory_predict_branches() limit
+#define MAX_BEAM_WIDTH 32
+#define DEFAULT_BEAM_WIDTH 8
+#define DEFAULT_BRANCH_THRESHOLD 0.3f
+#define DEFAULT_MERGE_THRESHOLD 0.8f
+#define DEFAULT_MAX_NODES 1000
+#define ARENA_INITIAL_BYTES (64 * 1024)
+#define ARENA_ALIGN 16
+#define MAX_SCENE_TRACKS 100
+#define DEFAULT_REPLAN_TOLERANCE 0.25f
+#define REPLAN_THREAT_DELTA 0.1f        // Threat score change that forces re-prediction
+#define MAX_REUSE_MS 10000              // Re-predict every track at least this often
+#define LATENCY_WINDOW 256              // Updates in the latency percentiles
 
 /**
- * Timeline node structure (internal)
+ * Node of the timeline tree (internal)
+ *
+ * Lives in the node arena for one update; the public Timeline copies what
+ * it needs out of its path, so callers never see these.
  */
-struct TimelineNode {
+typedef struct BranchNode BranchNode;
+
+struct BranchNode {
     uint32_t node_id;
     uint64_t timestamp_ms;
-    float probability;
+    float probability;              // Probability of the path from the root
+
+    // Decision taken on entering this node: alternative `branch` of the
+    // decision point at `depth` (root: depth 0)
+    uint32_t depth;
+    uint32_t branch;
 
-    // Predicted states at this node
+    // Predicted states at this node, one per track (arena block)
     uint32_t num_states;
-    PredictedState states[100];
+    PredictedState* states;
 
-    // Events predicted at this node
+    // Events predicted at this node (arena block, or shared with the
+    // parent / scene when identical)
     uint32_t num_events;
-    PredictedEvent events[20];
+    const PredictedEvent* events;
 
     // Branching
     uint32_t num_children;
-    struct TimelineNode* children[5];  // Max 5 branches
+    struct BranchNode* children[5];  // Max 5 branches
 
     // Parent node (NULL for root)
-    struct TimelineNode* parent;
+    struct BranchNode* parent;
 };
 
 /**
- * Timeline structure (internal)
+ * Arena block; data follows the (aligned) header
  */
-struct Timeline {
-    uint32_t timeline_id;
-    float overall_probability;
+typedef struct ArenaBlock {
+    struct ArenaBlock* next;        // Older block
+    size_t capacity;
+    size_t used;
+} ArenaBlock;
 
-    // Tree structure
-    TimelineNode* root;
-    uint32_t total_nodes;
+#define ARENA_HEADER_BYTES ((sizeof(ArenaBlock) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
 
-    // Predicted events on this timeline
-    uint32_t num_predicted_events;
-    PredictedEvent predicted_events[50];
+/**
+ * Bump allocator for the nodes of one update
+ *
+ * Node headers and their state / event blocks are carved from the newest
+ * block; a full arena grows by a new block (existing allocations never
+ * move). Reset is O(1): blocks outgrown during an update are folded into
+ * one block of the combined size, so steady state runs on a single block
+ * sized by the scene, not by the worst case.
+ */
+typedef struct {
+    ArenaBlock* head;
+    size_t capacity;                // All blocks
+    size_t bytes_used;              // This update
+    size_t high_water_bytes;        // Largest bytes_used of any update
+} NodeArena;
 
-    // Recommended interventions
-    uint32_t num_interventions;
-    InterventionPoint interventions[20];
-};
+/**
+ * Observed state a trajectory was predicted from
+ *
+ * Step i of the trajectory lies step_offset_ms[i] after origin_ms.
+ */
+typedef struct {
+    float x, y;                     // Box centre
+    float vx, vy;
+    uint64_t origin_ms;
+    uint64_t predicted_ms;          // Last prediction from scratch
+    BehaviorFlags behaviors;
+    float threat_score;
+    uint32_t slot;                  // TrackIndex slot of the track
+} TrajectoryOrigin;
+
+/**
+ * A track queued for prediction from scratch
+ */
+typedef struct {
+    uint32_t position;              // Position in ScenePrediction.trajectories
+    uint32_t slot;                  // TrackIndex slot of the track
+    bool is_new;                    // Track had no trajectory yet
+} PendingPrediction;
+
+/**
+ * Predictions shared by every timeline of one update
+ *
+ * Base trajectories, and the events found on them (including the pairwise
+ * collision / assault / theft checks), do not depend on the timeline, so
+ * they are computed once per timeline_update() and read by all timelines.
+ *
+ * They also persist across updates: each track keeps its position in
+ * trajectories[] while it is seen, so a track still moving as predicted
+ * keeps its trajectory (time-shifted) and only changed tracks are
+ * re-predicted and re-checked for events.
+ */
+typedef struct {
+    PredictedTrajectory trajectories[MAX_SCENE_TRACKS];
+    TrajectoryOrigin origins[MAX_SCENE_TRACKS];
+    bool changed[MAX_SCENE_TRACKS]; // Re-predicted this update
+    bool seen[MAX_SCENE_TRACKS];    // Scratch: track present this update
+
+    // Scratch: tracks to predict this update, for trajectory_predict_batch()
+    PendingPrediction pending[MAX_SCENE_TRACKS];
+    const TrackedObject* pending_tracks[MAX_SCENE_TRACKS];
+    PredictedTrajectory* pending_trajectories[MAX_SCENE_TRACKS];
+    bool pending_ok[MAX_SCENE_TRACKS];
+
+    uint32_t num_trajectories;
+    uint32_t num_changed;
+
+    PredictedEvent events[20];
+    uint32_t num_events;
+    PredictedEvent fresh_events[20]; // Scratch for incremental event updates
+    bool valid;                     // Events match the trajectories
+
+    float mean_confidence;          // Mean overall_confidence of the trajectories
+} ScenePrediction;
+
+/**
+ * A track whose future branches, with its surviving alternatives
+ *
+ * Alternative 0 is the base trajectory; alternatives similar to an
+ * earlier one are merged into it and unlikely ones dropped.
+ */
+typedef struct {
+    uint32_t slot;                  // Index into ScenePrediction.trajectories
+    uint32_t num_alternatives;
+    PredictedTrajectory alternatives[MAX_ALTERNATIVES];
+    float weight[MAX_ALTERNATIVES]; // Conditional probability, sums to 1
+} DecisionPoint;
+
+/**
+ * Branching state of the current update
+ */
+typedef struct {
+    DecisionPoint decisions[MAX_BRANCH_DEPTH];
+    uint32_t num_decisions;
+
+    PredictedTrajectory swap;       // Scratch for substituting alternatives
+    PredictedEvent events[20];      // Scratch for a node's events before sizing
+
+    // Sampling mode: the sampled tracks, and one particle's futures of them
+    uint32_t sampled_slots[PARTICLE_SAMPLER_MAX_TRACKS];
+    uint32_t num_sampled;
+    PredictedTrajectory futures[PARTICLE_SAMPLER_MAX_TRACKS];
+
+    // Most probable leaves, best first
+    BranchNode* leaves[MAX_BEAM_WIDTH];
+    uint32_t num_leaves;
+    float leaf_mass;                // Probability the leaves were drawn from
+
+    uint32_t num_nodes;
+    bool budget_exhausted;          // Node (or time) budget cut the search short
+} TimelineTree;
+
+/**
+ * Beam search candidate: a child not yet allocated
+ */
+typedef struct {
+    BranchNode* parent;
+    uint32_t branch;
+    float probability;
+} BranchCandidate;
+
+/**
+ * Everything timeline_update() writes, allocated once at init
+ *
+ * Together with the node arena (which stops growing once it has seen the
+ * largest scene) this keeps steady-state updates free of malloc.
+ */
+typedef struct {
+    ScenePrediction scene;
+    TimelineTree tree;
+    BranchCandidate candidates[MAX_BEAM_WIDTH * MAX_ALTERNATIVES];
+    Timeline timelines[10];
+} TimelineWorkspace;
 
 /**
  * Timeline Threading engine state
@@ -74,6 +238,19 @@ struct TimelineEngine {
     // Subsystems
     TrajectoryPredictor* trajectory_predictor;
     EventPredictor* event_predictor;
+    WorkerPool* workers;            // Shards trajectory and event prediction
+    ParticleSampler* sampler;       // Sampling mode (NULL = branch search)
+
+    // Per-update scratch (~1.2 MB, kept off the caller's stack)
+    TimelineWorkspace* workspace;
+    ScenePrediction* scene;         // &workspace->scene
+    TimelineTree* tree;             // &workspace->tree
+
+    // Track -> position in scene->trajectories, via TrackIndex slots
+    TrackIndex* track_index;
+    uint32_t slot_position[MAX_SCENE_TRACKS];
+    const uint64_t* step_offset_ms; // Lookahead of each prediction step (predictor-owned)
+    uint32_t num_steps;
 
     // Active timelines
     uint32_t num_timelines;
@@ -84,13 +261,38 @@ struct TimelineEngine {
         uint64_t num_updates;
         uint64_t total_events_predicted;
         uint64_t total_interventions;
-        float avg_timeline_confidence;
+        uint64_t total_timelines;
+
+        uint64_t tracks_predicted;
+        uint64_t tracks_reused;
+        uint64_t full_event_passes;
+        uint64_t incremental_event_passes;
+        float latency_ms[LATENCY_WINDOW]; // Ring of recent update latencies
+        uint32_t latency_next;
+        uint32_t particles_sampled;
     } stats;
 
-    // Node pool for efficient allocation
-    TimelineNode* node_pool;
-    uint32_t node_pool_size;
-    uint32_t next_free_node;
+    // Nodes of the current update
+    NodeArena arena;
+    uint32_t next_node_id;
+    uint32_t high_water_nodes;
+
+    // Monitor thread (timeline_start_monitoring)
+    struct {
+        TrackSnapshot* mailbox;     // Latest submitted tracks
+        pthread_t thread;
+        pthread_mutex_t mutex;
+        pthread_cond_t wake;        // Signalled on submit and stop (CLOCK_MONOTONIC)
+        bool running;               // Guarded by mutex
+        bool stopping;
+        bool clear_requested;       // timeline_clear() pending for the monitor thread
+        TimelineCallback callback;
+        void* user_data;
+        uint64_t version_seen;      // Latest snapshot taken (monitor thread)
+        atomic_uint_fast64_t coalesced;
+        TrackedObject tracks[TRACK_SNAPSHOT_MAX_TRACKS]; // Monitor thread's copy
+        Timeline timelines[10];     // Monitor thread's results, passed to the callback
+    } monitor;
 };
 
 // ============================================================================
@@ -103,6 +305,12 @@ static uint64_t get_current_time_ms() {
     return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
 }
 
+static uint64_t get_monotonic_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
 static float clamp(float value, float min, float max) {
     if (value < min) return min;
     if (value > max) return max;
@@ -110,33 +318,121 @@ static float clamp(float value, float min, float max) {
 }
 
 // ============================================================================
-// Timeline Node Management
+// Node Arena
 // ============================================================================
 
-static TimelineNode* timeline_node_create(TimelineEngine* engine) {
-    if (engine->next_free_node >= engine->node_pool_size) {
-        fprintf(stderr, "[Timeline] ERROR: Node pool exhausted\n");
+static ArenaBlock* arena_block_create(size_t capacity, ArenaBlock* next) {
+    ArenaBlock* block = malloc(ARENA_HEADER_BYTES + capacity);
+    if (!block) {
+        fprintf(stderr, "[Timeline] ERROR: Failed to allocate %zu byte arena block\n", capacity);
         return NULL;
     }
 
-    TimelineNode* node = &engine->node_pool[engine->next_free_node++];
-    memset(node, 0, sizeof(TimelineNode));
-    node->node_id = engine->next_free_node - 1;
+    block->next = next;
+    block->capacity = capacity;
+    block->used = 0;
+    return block;
+}
 
-    return node;
+static bool arena_init(NodeArena* arena, size_t capacity) {
+    memset(arena, 0, sizeof(NodeArena));
+    arena->head = arena_block_create(capacity, NULL);
+    if (!arena->head) {
+        return false;
+    }
+    arena->capacity = capacity;
+    return true;
+}
+
+static void* arena_alloc(NodeArena* arena, size_t size) {
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    ArenaBlock* block = arena->head;
+    if (block->used + size > block->capacity) {
+        size_t capacity = block->capacity * 2;
+        if (capacity < size) {
+            capacity = size;
+        }
+
+        block = arena_block_create(capacity, arena->head);
+        if (!block) {
+            return NULL;
+        }
+        arena->head = block;
+        arena->capacity += capacity;
+    }
+
+    void* ptr = (uint8_t*)block + ARENA_HEADER_BYTES + block->used;
+    block->used += size;
+
+    arena->bytes_used += size;
+    if (arena->bytes_used > arena->high_water_bytes) {
+        arena->high_water_bytes = arena->bytes_used;
+    }
+    return ptr;
+}
+
+static void arena_reset(NodeArena* arena) {
+    // Fold blocks added during the last update into one (rare)
+    if (arena->head->next) {
+        ArenaBlock* block = arena->head;
+        while (block) {
+            ArenaBlock* next = block->next;
+            free(block);
+            block = next;
+        }
+
+        arena->head = arena_block_create(arena->capacity, NULL);
+        if (!arena->head) {
+            // Keep running on a fresh minimal block
+            arena->capacity = ARENA_INITIAL_BYTES;
+            arena->head = arena_block_create(arena->capacity, NULL);
+        }
+    }
+
+    if (arena->head) {
+        arena->head->used = 0;
+    }
+    arena->bytes_used = 0;
+}
+
+static void arena_destroy(NodeArena* arena) {
+    ArenaBlock* block = arena->head;
+    while (block) {
+        ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->head = NULL;
 }
 
-static void timeline_node_destroy_recursive(TimelineNode* node) {
-    if (!node) return;
+// ============================================================================
+// Timeline Node Management
+// ============================================================================
+
+/**
+ * Allocate a node with room for one state per track
+ */
+static BranchNode* timeline_node_create(TimelineEngine* engine, uint32_t max_states) {
+    if (!engine->arena.head) {
+        return NULL;
+    }
 
-    for (uint32_t i = 0; i < node->num_children; i++) {
-        timeline_node_destroy_recursive(node->children[i]);
+    BranchNode* node = arena_alloc(&engine->arena, sizeof(BranchNode));
+    PredictedState* states = arena_alloc(&engine->arena, max_states * sizeof(PredictedState));
+    if (!node || !states) {
+        fprintf(stderr, "[Timeline] ERROR: Node arena exhausted\n");
+        return NULL;
     }
 
-    // Note: nodes are in pool, don't free individually
+    memset(node, 0, sizeof(BranchNode));
+    node->node_id = engine->next_node_id++;
+    node->states = states;
+
+    return node;
 }
 
-static void timeline_node_add_child(TimelineNode* parent, TimelineNode* child) {
+static void timeline_node_add_child(BranchNode* parent, BranchNode* child) {
     if (!parent || !child) return;
 
     if (parent->num_children >= 5) {
@@ -152,109 +448,978 @@ static void timeline_node_add_child(TimelineNode* parent, TimelineNode* child) {
 // Timeline Management
 // ============================================================================
 
-static Timeline* timeline_create(TimelineEngine* engine, uint32_t id) {
-    Timeline* timeline = calloc(1, sizeof(Timeline));
-    if (!timeline) {
-        fprintf(stderr, "[Timeline] ERROR: Failed to allocate timeline\n");
+/**
+ * Take the next timeline slot of the workspace
+ */
+static Timeline* timeline_create(TimelineEngine* engine, uint32_t id, uint64_t current_time_ms) {
+    if (engine->num_timelines >= 10) {
         return NULL;
     }
 
-    timeline->timeline_id = id;
-    timeline->overall_probability = 1.0f;
-    timeline->root = timeline_node_create(engine);
-    timeline->total_nodes = 1;
+    Timeline* timeline = &engine->workspace->timelines[engine->num_timelines];
+    memset(timeline, 0, sizeof(Timeline));
+
+    timeline->timeline_id = id;
+    timeline->overall_probability = 1.0f;
+    timeline->prediction_start_ms = current_time_ms;
+    timeline->prediction_end_ms = current_time_ms +
+        (engine->num_steps > 0 ? engine->step_offset_ms[engine->num_steps - 1] : 0);
+    timeline->num_nodes = engine->tree->num_nodes;
+    timeline->created_ms = current_time_ms;
+    timeline->last_updated_ms = current_time_ms;
+
+    return timeline;
+}
+
+// ============================================================================
+// Timeline Building
+// ============================================================================
+
+/**
+ * Steps of a trajectory that lie at or before a time
+ */
+static uint32_t steps_passed(
+    const uint64_t* step_offset_ms,
+    uint32_t num_steps,
+    const TrajectoryOrigin* origin,
+    uint64_t time_ms
+) {
+    uint64_t elapsed_ms = time_ms > origin->origin_ms ? time_ms - origin->origin_ms : 0;
+    uint32_t k = 0;
+    while (k < num_steps && step_offset_ms[k] <= elapsed_ms) {
+        k++;
+    }
+    return k;
+}
+
+/**
+ * Predicted position of a trajectory at a time, interpolating between steps
+ */
+static void trajectory_position_at(
+    const PredictedTrajectory* trajectory,
+    const TrajectoryOrigin* origin,
+    const uint64_t* step_offset_ms,
+    uint64_t time_ms,
+    float* x,
+    float* y
+) {
+    uint32_t i = steps_passed(step_offset_ms, trajectory->num_predictions, origin, time_ms);
+
+    float x0 = origin->x, y0 = origin->y;
+    uint64_t start_ms = 0;
+    if (i > 0) {
+        x0 = trajectory->predictions[i - 1].x;
+        y0 = trajectory->predictions[i - 1].y;
+        start_ms = step_offset_ms[i - 1];
+    }
+
+    if (i < trajectory->num_predictions) {
+        uint64_t elapsed_ms = time_ms > origin->origin_ms ? time_ms - origin->origin_ms : 0;
+        float t = (float)(elapsed_ms - start_ms) / (float)(step_offset_ms[i] - start_ms);
+        *x = x0 + t * (trajectory->predictions[i].x - x0);
+        *y = y0 + t * (trajectory->predictions[i].y - y0);
+    } else {
+        *x = x0;
+        *y = y0;
+    }
+}
+
+/**
+ * Check whether a track still follows its previous trajectory
+ *
+ * It must be within replan_tolerance box sizes of the predicted position,
+ * its velocity must not move it further than that from the prediction
+ * within one step, its behaviors must be unchanged and its threat score
+ * close, and the trajectory must be younger than MAX_REUSE_MS.
+ */
+static bool trajectory_reusable(
+    const TimelineEngine* engine,
+    const PredictedTrajectory* trajectory,
+    const TrajectoryOrigin* origin,
+    const TrackedObject* track
+) {
+    if (track->last_seen_ms < origin->origin_ms ||
+        track->last_seen_ms - origin->predicted_ms > MAX_REUSE_MS) {
+        return false;
+    }
+    if (track->behaviors != origin->behaviors ||
+        fabsf(track->threat_score - origin->threat_score) > REPLAN_THREAT_DELTA) {
+        return false;
+    }
+
+    float size = track->current_bbox.width > track->current_bbox.height ? track->current_bbox.width : track->current_bbox.height;
+    float tolerance = engine->config.replan_tolerance * size;
+
+    float px, py;
+    trajectory_position_at(trajectory, origin, engine->step_offset_ms, track->last_seen_ms,
+                           &px, &py);
+    float dx = track->current_bbox.x + track->current_bbox.width / 2 - px;
+    float dy = track->current_bbox.y + track->current_bbox.height / 2 - py;
+    if (dx * dx + dy * dy > tolerance * tolerance) {
+        return false;
+    }
+
+    float first_step_s = (float)engine->step_offset_ms[0] / 1000.0f;
+    float dvx = (track->velocity_x - origin->vx) * first_step_s;
+    float dvy = (track->velocity_y - origin->vy) * first_step_s;
+    return dvx * dvx + dvy * dvy <= tolerance * tolerance;
+}
+
+/**
+ * Advance a reused trajectory to a new time
+ *
+ * The origin moves to the last step that has passed, and every step is
+ * resampled at its lookahead from there: interpolated between the old
+ * steps around it, or extended at the last predicted velocity past the
+ * old horizon. With uniform steps this drops whole steps. Confidence stays
+ * with the step index, as a fresh prediction would have it.
+ */
+static void trajectory_time_shift(
+    PredictedTrajectory* trajectory,
+    TrajectoryOrigin* origin,
+    const uint64_t* step_offset_ms,
+    uint64_t time_ms
+) {
+    uint32_t n = trajectory->num_predictions;
+    uint32_t k = steps_passed(step_offset_ms, n, origin, time_ms);
+    if (k == 0) {
+        return;
+    }
+
+    // New origin: the last step passed
+    const PredictedState* last_passed = &trajectory->predictions[k - 1];
+    uint64_t shift_ms = step_offset_ms[k - 1];
+    origin->x = last_passed->x;
+    origin->y = last_passed->y;
+    origin->vx = last_passed->vx;
+    origin->vy = last_passed->vy;
+    origin->origin_ms += shift_ms;
+
+    // Step i reads old steps after i only, so it can be rewritten in place
+    PredictedState* p = trajectory->predictions;
+    uint32_t next = k;              // First old step at or after the target
+    for (uint32_t i = 0; i < n; i++) {
+        uint64_t target_ms = shift_ms + step_offset_ms[i];
+        while (next < n && step_offset_ms[next] < target_ms) {
+            next++;
+        }
+
+        PredictedState state;
+        if (next < n) {
+            state = p[next];
+            if (step_offset_ms[next] != target_ms) {
+                const PredictedState* before = &p[next - 1];
+                float t = (float)(target_ms - step_offset_ms[next - 1]) /
+                          (float)(step_offset_ms[next] - step_offset_ms[next - 1]);
+                state.x = before->x + t * (state.x - before->x);
+                state.y = before->y + t * (state.y - before->y);
+            }
+        } else {
+            const PredictedState* prev = i > 0 ? &p[i - 1] : NULL;
+            uint64_t prev_ms = i > 0 ? step_offset_ms[i - 1] : 0;
+            float dt = (float)(step_offset_ms[i] - prev_ms) / 1000.0f;
+            if (prev) {
+                state = *prev;
+                state.x += prev->vx * dt;
+                state.y += prev->vy * dt;
+            } else {
+                state = *last_passed;
+                state.x = origin->x + origin->vx * dt;
+                state.y = origin->y + origin->vy * dt;
+            }
+        }
+
+        state.timestamp_ms = origin->origin_ms + step_offset_ms[i];
+        state.confidence = p[i].confidence;
+        p[i] = state;
+    }
+}
+
+/**
+ * Remove the trajectories of tracks absent from this update
+ *
+ * The last trajectory moves into each hole so the array stays dense.
+ */
+static void scene_drop_departed(
+    TimelineEngine* engine,
+    const TrackedObject* tracks,
+    uint32_t num_tracks,
+    ScenePrediction* scene
+) {
+    memset(scene->seen, 0, scene->num_trajectories * sizeof(bool));
+    for (uint32_t i = 0; i < num_tracks; i++) {
+        int32_t slot = track_index_find(engine->track_index, tracks[i].track_id);
+        if (slot >= 0) {
+            scene->seen[engine->slot_position[slot]] = true;
+        }
+    }
+
+    uint32_t p = 0;
+    while (p < scene->num_trajectories) {
+        if (scene->seen[p]) {
+            p++;
+            continue;
+        }
+
+        track_index_remove(engine->track_index, scene->trajectories[p].track_id);
+
+        uint32_t last = --scene->num_trajectories;
+        if (p != last) {
+            memcpy(&scene->trajectories[p], &scene->trajectories[last], sizeof(PredictedTrajectory));
+            scene->origins[p] = scene->origins[last];
+            scene->seen[p] = scene->seen[last];
+            engine->slot_position[scene->origins[p].slot] = p;
+        }
+    }
+}
+
+/**
+ * Order in which event_predictor_predict() reports event types
+ */
+static int event_rank(EventType type) {
+    switch (type) {
+        case EVENT_COLLISION: return 0;
+        case EVENT_ASSAULT: return 1;
+        case EVENT_THEFT: return 2;
+        case EVENT_CROWD_FORMATION: return 3;
+        default: return 4;
+    }
+}
+
+/**
+ * Update the scene's events after some trajectories changed
+ *
+ * Previous events survive if every track involved is still present and
+ * unchanged and the event still lies ahead; theft and crowd formation are
+ * always recomputed. The rest comes from event_predictor_predict_changed().
+ * A collision or assault between two unchanged tracks hidden behind the
+ * previous first hit is found by the next full pass (every track is
+ * re-predicted within MAX_REUSE_MS).
+ */
+static void scene_update_events(
+    TimelineEngine* engine,
+    ScenePrediction* scene,
+    uint64_t current_time_ms
+) {
+    uint32_t num_fresh = event_predictor_predict_changed(
+        engine->event_predictor,
+        scene->trajectories,
+        scene->num_trajectories,
+        scene->changed,
+        scene->fresh_events,
+        20
+    );
+
+    // Previous events still valid
+    PredictedEvent kept[20];
+    uint32_t num_kept = 0;
+    for (uint32_t e = 0; e < scene->num_events; e++) {
+        const PredictedEvent* event = &scene->events[e];
+        if (event->type == EVENT_THEFT || event->type == EVENT_CROWD_FORMATION ||
+            event->timestamp_ms < current_time_ms) {
+            continue;
+        }
+
+        bool valid = true;
+        for (uint32_t k = 0; k < event->num_involved && valid; k++) {
+            int32_t slot = track_index_find(engine->track_index, event->involved_tracks[k]);
+            valid = slot >= 0 && !scene->changed[engine->slot_position[slot]];
+        }
+        if (valid) {
+            kept[num_kept++] = *event;
+        }
+    }
+
+    // Merge in reporting order; one collision and one assault (the earliest)
+    scene->num_events = 0;
+    for (int rank = 0; rank <= 4; rank++) {
+        const PredictedEvent* single = NULL;
+        const PredictedEvent* sources[2] = {kept, scene->fresh_events};
+        uint32_t counts[2] = {num_kept, num_fresh};
+
+        for (int s = 0; s < 2; s++) {
+            for (uint32_t e = 0; e < counts[s]; e++) {
+                const PredictedEvent* event = &sources[s][e];
+                if (event_rank(event->type) != rank) continue;
+
+                if (rank <= 1) {
+                    if (!single || event->timestamp_ms < single->timestamp_ms) {
+                        single = event;
+                    }
+                } else if (scene->num_events < 20) {
+                    scene->events[scene->num_events++] = *event;
+                }
+            }
+        }
+
+        if (single && scene->num_events < 20) {
+            scene->events[scene->num_events++] = *single;
+        }
+    }
+}
+
+/**
+ * Predict every track's base trajectory and the events on them
+ *
+ * Runs once per update; timelines only add what differs from this. Tracks
+ * that still follow their previous trajectory keep it, time-shifted; with
+ * few changes, events are updated incrementally too.
+ */
+static bool scene_predict(
+    TimelineEngine* engine,
+    const TrackedObject* tracks,
+    uint32_t num_tracks,
+    uint64_t current_time_ms,
+    ScenePrediction* scene
+) {
+    bool incremental = engine->config.replan_tolerance > 0.0f;
+    if (num_tracks > MAX_SCENE_TRACKS) {
+        num_tracks = MAX_SCENE_TRACKS;
+    }
+
+    if (!incremental) {
+        track_index_clear(engine->track_index);
+        scene->num_trajectories = 0;
+        scene->valid = false;
+    }
+
+    scene_drop_departed(engine, tracks, num_tracks, scene);
+
+    // Reuse what still holds; queue the rest. New tracks are queued at
+    // provisional positions past the end of the array.
+    scene->num_changed = 0;
+    uint32_t num_reused = 0;
+    uint32_t num_pending = 0;
+    uint32_t next_position = scene->num_trajectories;
+    for (uint32_t i = 0; i < num_tracks; i++) {
+        const TrackedObject* track = &tracks[i];
+
+        bool is_new = false;
+        int32_t slot = track_index_acquire(engine->track_index, track->track_id, &is_new, NULL);
+        if (slot < 0) {
+            continue;
+        }
+
+        uint32_t p = is_new ? next_position++ : engine->slot_position[slot];
+        PredictedTrajectory* trajectory = &scene->trajectories[p];
+        TrajectoryOrigin* origin = &scene->origins[p];
+
+        if (!is_new && trajectory_reusable(engine, trajectory, origin, track)) {
+            trajectory_time_shift(trajectory, origin, engine->step_offset_ms, track->last_seen_ms);
+            scene->changed[p] = false;
+            num_reused++;
+            continue;
+        }
+
+        PendingPrediction* pending = &scene->pending[num_pending];
+        pending->position = p;
+        pending->slot = (uint32_t)slot;
+        pending->is_new = is_new;
+        scene->pending_tracks[num_pending] = track;
+        scene->pending_trajectories[num_pending] = trajectory;
+        num_pending++;
+    }
+
+    // Predict the queued tracks on the worker pool
+    trajectory_predict_batch(
+        engine->trajectory_predictor,
+        scene->pending_tracks,
+        num_pending,
+        tracks,
+        num_tracks,
+        engine->config.scene_context,
+        scene->pending_trajectories,
+        scene->pending_ok,
+        engine->workers
+    );
+
+    // Commit in track order; new tracks close the gaps failed ones leave
+    for (uint32_t k = 0; k < num_pending; k++) {
+        const TrackedObject* track = scene->pending_tracks[k];
+        const PendingPrediction* pending = &scene->pending[k];
+        uint32_t p = pending->position;
+
+        if (!scene->pending_ok[k]) {
+            if (pending->is_new) {
+                track_index_remove(engine->track_index, track->track_id);
+            }
+            continue;
+        }
+
+        if (pending->is_new && p != scene->num_trajectories) {
+            memcpy(&scene->trajectories[scene->num_trajectories], &scene->trajectories[p],
+                   sizeof(PredictedTrajectory));
+            p = scene->num_trajectories;
+        }
+
+        TrajectoryOrigin* origin = &scene->origins[p];
+        origin->x = track->current_bbox.x + track->current_bbox.width / 2;
+        origin->y = track->current_bbox.y + track->current_bbox.height / 2;
+        origin->vx = track->velocity_x;
+        origin->vy = track->velocity_y;
+        origin->origin_ms = track->last_seen_ms;
+        origin->predicted_ms = track->last_seen_ms;
+        origin->behaviors = track->behaviors;
+        origin->threat_score = track->threat_score;
+        origin->slot = pending->slot;
+        scene->changed[p] = true;
+        scene->num_changed++;
+
+        if (pending->is_new) {
+            engine->slot_position[pending->slot] = p;
+            scene->num_trajectories++;
+        }
+    }
+
+    engine->stats.tracks_predicted += scene->num_changed;
+    engine->stats.tracks_reused += num_reused;
+
+    if (scene->num_trajectories == 0) {
+        scene->valid = false;
+        return false;
+    }
+
+    // Events: full pass unless only a few trajectories changed
+    if (!scene->valid || scene->num_changed * 2 >= scene->num_trajectories) {
+        scene->num_events = event_predictor_predict(
+            engine->event_predictor,
+            scene->trajectories,
+            scene->num_trajectories,
+            scene->events,
+            20
+        );
+        engine->stats.full_event_passes++;
+    } else {
+        scene_update_events(engine, scene, current_time_ms);
+        engine->stats.incremental_event_passes++;
+    }
+    scene->valid = true;
+
+    float sum_confidence = 0.0f;
+    for (uint32_t i = 0; i < scene->num_trajectories; i++) {
+        sum_confidence += scene->trajectories[i].overall_confidence;
+    }
+    scene->mean_confidence = sum_confidence / scene->num_trajectories;
+
+    return true;
+}
+
+/**
+ * Swap two trajectories through a scratch buffer
+ */
+static void swap_trajectories(
+    PredictedTrajectory* a,
+    PredictedTrajectory* b,
+    PredictedTrajectory* scratch
+) {
+    memcpy(scratch, a, sizeof(PredictedTrajectory));
+    memcpy(a, b, sizeof(PredictedTrajectory));
+    memcpy(b, scratch, sizeof(PredictedTrajectory));
+}
+
+/**
+ * The most significant moving tracks (threat score, flagged behavior)
+ *
+ * Stationary tracks are skipped: their futures would coincide.
+ *
+ * @param max_slots At most PARTICLE_SAMPLER_MAX_TRACKS
+ * @param slots Output positions in scene->trajectories, best first
+ * @return Number of tracks selected
+ */
+static uint32_t select_significant_tracks(
+    const ScenePrediction* scene,
+    uint32_t max_slots,
+    uint32_t* slots
+) {
+    float scores[PARTICLE_SAMPLER_MAX_TRACKS];
+    uint32_t num_slots = 0;
+
+    for (uint32_t i = 0; i < scene->num_trajectories; i++) {
+        if (scene->trajectories[i].num_predictions == 0) continue;
+
+        const PredictedState* first = &scene->trajectories[i].predictions[0];
+        if (first->vx * first->vx + first->vy * first->vy < 1e-6f) continue;
+
+        float score = first->threat_score +
+                      (first->behaviors != BEHAVIOR_NORMAL ? 0.5f : 0.0f);
+        if (num_slots == max_slots && score <= scores[num_slots - 1]) continue;
+
+        // Insert into the top max_slots, best first
+        uint32_t pos = num_slots < max_slots ? num_slots++ : num_slots - 1;
+        while (pos > 0 && scores[pos - 1] < score) {
+            scores[pos] = scores[pos - 1];
+            slots[pos] = slots[pos - 1];
+            pos--;
+        }
+        scores[pos] = score;
+        slots[pos] = i;
+    }
+
+    return num_slots;
+}
+
+/**
+ * Choose the decision points of this update and their alternatives
+ *
+ * The most significant moving tracks branch. Alternatives at least
+ * merge_threshold similar to an earlier one are merged into it, and ones
+ * less than branch_threshold as likely as the base trajectory are dropped.
+ */
+static void tree_select_decisions(
+    TimelineEngine* engine,
+    const TrackedObject* tracks,
+    uint32_t num_tracks,
+    const ScenePrediction* scene,
+    TimelineTree* tree
+) {
+    uint32_t slots[MAX_BRANCH_DEPTH];
+    uint32_t num_slots = select_significant_tracks(scene, MAX_BRANCH_DEPTH, slots);
+
+    tree->num_decisions = 0;
+    for (uint32_t k = 0; k < num_slots; k++) {
+        uint32_t track_id = scene->trajectories[slots[k]].track_id;
+        const TrackedObject* track = NULL;
+        for (uint32_t j = 0; j < num_tracks; j++) {
+            if (tracks[j].track_id == track_id) {
+                track = &tracks[j];
+                break;
+            }
+        }
+        if (!track) continue;
+
+        DecisionPoint* decision = &tree->decisions[tree->num_decisions];
+        uint32_t num_alternatives = trajectory_predict_branches(
+            engine->trajectory_predictor,
+            track,
+            MAX_ALTERNATIVES,
+            tracks,
+            num_tracks,
+            engine->config.scene_context,
+            decision->alternatives
+        );
+
+        float total = 0.0f;
+        for (uint32_t b = 0; b < num_alternatives; b++) {
+            total += decision->alternatives[b].overall_confidence;
+        }
+        if (num_alternatives < 2 || total <= 0.0f) continue;
+
+        // Merge alternatives into a similar earlier one
+        uint32_t kept = 0;
+        for (uint32_t b = 0; b < num_alternatives; b++) {
+            float weight = decision->alternatives[b].overall_confidence / total;
+
+            bool merged = false;
+            for (uint32_t a = 0; a < kept; a++) {
+                if (trajectory_similarity(&decision->alternatives[a], &decision->alternatives[b]) >=
+                    engine->config.merge_threshold) {
+                    decision->weight[a] += weight;
+                    merged = true;
+                    break;
+                }
+            }
+            if (merged) continue;
+
+            if (b != kept) {
+                memcpy(&decision->alternatives[kept], &decision->alternatives[b],
+                       sizeof(PredictedTrajectory));
+            }
+            decision->weight[kept++] = weight;
+        }
+
+        // Drop unlikely alternatives (the base, 0, always stays)
+        uint32_t num_likely = 1;
+        for (uint32_t b = 1; b < kept; b++) {
+            if (decision->weight[b] < engine->config.branch_threshold * decision->weight[0]) {
+                continue;
+            }
+            if (b != num_likely) {
+                memcpy(&decision->alternatives[num_likely], &decision->alternatives[b],
+                       sizeof(PredictedTrajectory));
+                decision->weight[num_likely] = decision->weight[b];
+            }
+            num_likely++;
+        }
+        if (num_likely < 2) continue;
+
+        float sum_weight = 0.0f;
+        for (uint32_t b = 0; b < num_likely; b++) {
+            sum_weight += decision->weight[b];
+        }
+        for (uint32_t b = 0; b < num_likely; b++) {
+            decision->weight[b] /= sum_weight;
+        }
+
+        decision->slot = slots[k];
+        decision->num_alternatives = num_likely;
+        tree->num_decisions++;
+    }
+}
+
+/**
+ * Substitute the alternatives chosen on the path to a node into the scene
+ *
+ * Every decision point branches a different track, so applying the same
+ * path a second time restores the base trajectories.
+ */
+static void tree_apply_path(
+    ScenePrediction* scene,
+    TimelineTree* tree,
+    const BranchNode* node
+) {
+    for (; node && node->depth > 0; node = node->parent) {
+        if (node->branch == 0) continue;
+
+        DecisionPoint* decision = &tree->decisions[node->depth - 1];
+        swap_trajectories(&scene->trajectories[decision->slot],
+                          &decision->alternatives[node->branch],
+                          &tree->swap);
+    }
+}
+
+/**
+ * Predict a node's events on the scene as it stands (arena block)
+ */
+static void node_predict_events(
+    TimelineEngine* engine,
+    const ScenePrediction* scene,
+    TimelineTree* tree,
+    BranchNode* node
+) {
+    uint32_t num_events = event_predictor_predict(
+        engine->event_predictor,
+        scene->trajectories,
+        scene->num_trajectories,
+        tree->events,
+        20
+    );
+
+    PredictedEvent* events = NULL;
+    if (num_events > 0) {
+        events = arena_alloc(&engine->arena, num_events * sizeof(PredictedEvent));
+    }
+    if (events) {
+        memcpy(events, tree->events, num_events * sizeof(PredictedEvent));
+        node->num_events = num_events;
+    }
+    node->events = events;
+}
+
+/**
+ * Fill a node's states and events from its path
+ *
+ * A node at depth d holds the states at the end of the d-th time slice of
+ * the horizon. Events are predicted on the whole scene with the path's
+ * alternatives substituted; taking the base alternative changes nothing,
+ * so such a node inherits its parent's events.
+ */
+static void tree_fill_node(
+    TimelineEngine* engine,
+    ScenePrediction* scene,
+    TimelineTree* tree,
+    BranchNode* node
+) {
+    tree_apply_path(scene, tree, node);
+
+    // Last step within the slice's share of the horizon time
+    uint32_t num_steps = scene->trajectories[0].num_predictions;
+    uint32_t step = 0;
+    if (node->depth > 0 && num_steps > 0) {
+        uint64_t end_ms = engine->step_offset_ms[num_steps - 1] * node->depth /
+                          tree->num_decisions;
+        while (step + 1 < num_steps && engine->step_offset_ms[step + 1] <= end_ms) {
+            step++;
+        }
+    }
+
+    node->num_states = 0;
+    for (uint32_t i = 0; i < scene->num_trajectories; i++) {
+        if (scene->trajectories[i].num_predictions > step) {
+            node->states[node->num_states++] = scene->trajectories[i].predictions[step];
+        }
+    }
+    if (node->depth > 0 && node->num_states > 0) {
+        node->timestamp_ms = node->states[0].timestamp_ms;
+    }
+
+    if (node->parent && node->branch == 0) {
+        node->num_events = node->parent->num_events;
+        node->events = node->parent->events;
+    } else if (node->parent) {
+        node_predict_events(engine, scene, tree, node);
+    } else {
+        node->num_events = scene->num_events;
+        node->events = scene->events;
+    }
+
+    tree_apply_path(scene, tree, node);
+}
+
+/**
+ * Substitute one particle's futures of the sampled tracks into the scene
+ *
+ * Swaps with tree->futures, so a second call restores the base.
+ */
+static void tree_swap_futures(ScenePrediction* scene, TimelineTree* tree) {
+    for (uint32_t k = 0; k < tree->num_sampled; k++) {
+        swap_trajectories(&scene->trajectories[tree->sampled_slots[k]],
+                          &tree->futures[k], &tree->swap);
+    }
+}
+
+/**
+ * Expand the root into one child per cluster of sampled futures
+ *
+ * The most significant moving tracks are sampled; every other track keeps
+ * its base trajectory. A child holds the cluster's representative future,
+ * with states at the end of the horizon, and the cluster's share of the
+ * particles as its probability.
+ *
+ * @return Number of leaves in engine->tree
+ */
+static uint32_t tree_sample(
+    TimelineEngine* engine,
+    ScenePrediction* scene,
+    BranchNode* root
+) {
+    TimelineTree* tree = engine->tree;
+    engine->stats.particles_sampled = 0;
+
+    tree->num_sampled = select_significant_tracks(scene, PARTICLE_SAMPLER_MAX_TRACKS,
+                                                  tree->sampled_slots);
+    if (tree->num_sampled == 0) {
+        return tree->num_leaves;
+    }
+
+    const PredictedTrajectory* bases[PARTICLE_SAMPLER_MAX_TRACKS];
+    for (uint32_t k = 0; k < tree->num_sampled; k++) {
+        bases[k] = &scene->trajectories[tree->sampled_slots[k]];
+    }
+
+    ParticleCluster clusters[5];  // Children per node
+    uint32_t max_clusters = engine->config.max_timelines < 5 ? engine->config.max_timelines : 5;
+    uint32_t num_clusters = particle_sampler_run(engine->sampler, bases, tree->num_sampled,
+                                                 clusters, max_clusters);
+    engine->stats.particles_sampled = particle_sampler_num_sampled(engine->sampler);
+    if (num_clusters == 0) {
+        return tree->num_leaves;
+    }
+
+    uint32_t num_leaves = 0;
+    for (uint32_t c = 0; c < num_clusters && tree->num_nodes < engine->config.max_nodes; c++) {
+        BranchNode* node = timeline_node_create(engine, scene->num_trajectories);
+        if (!node) {
+            tree->budget_exhausted = true;
+            break;
+        }
+        node->depth = 1;
+        node->branch = c;
+        node->probability = clusters[c].probability;
+        timeline_node_add_child(root, node);
+
+        for (uint32_t k = 0; k < tree->num_sampled; k++) {
+            particle_sampler_replay(engine->sampler, bases[k], clusters[c].particle,
+                                    &tree->futures[k]);
+        }
+        tree_swap_futures(scene, tree);
+
+        node->num_states = 0;
+        for (uint32_t i = 0; i < scene->num_trajectories; i++) {
+            const PredictedTrajectory* trajectory = &scene->trajectories[i];
+            if (trajectory->num_predictions > 0) {
+                node->states[node->num_states++] =
+                    trajectory->predictions[trajectory->num_predictions - 1];
+            }
+        }
+        node->timestamp_ms = node->num_states > 0 ? node->states[0].timestamp_ms :
+                                                    root->timestamp_ms;
+        node_predict_events(engine, scene, tree, node);
+
+        tree_swap_futures(scene, tree);
+
+        tree->leaves[num_leaves++] = node;
+        tree->num_nodes++;
+    }
+
+    if (num_leaves > 0) {
+        tree->num_leaves = num_leaves;  // leaf_mass stays 1: shares of every particle
+    }
+    return tree->num_leaves;
+}
+
+/**
+ * Order beam candidates by probability, highest first (ties: creation order)
+ */
+static int compare_candidates(const BranchCandidate* ca, const BranchCandidate* cb) {
+    if (ca->probability > cb->probability) return -1;
+    if (ca->probability < cb->probability) return 1;
+    if (ca->parent->node_id != cb->parent->node_id) {
+        return ca->parent->node_id < cb->parent->node_id ? -1 : 1;
+    }
+    return (ca->branch > cb->branch) - (ca->branch < cb->branch);
+}
+
+/**
+ * Build the timeline tree of this update
+ *
+ * The root holds the base prediction. With branching, each decision
+ * point expands every leaf into one child per alternative, and only the
+ * beam_width most probable children are allocated and evaluated (beam
+ * search). Expansion stops early when the node budget (or, if set, the
+ * time budget) runs out; the leaves are then the best nodes built so far.
+ * The node budget is a count, so the same scene gives the same tree on any
+ * machine and thread count; a time budget gives that up. In sampling
+ * mode the root's children are clusters of sampled futures instead.
+ *
+ * @return Number of leaves in engine->tree (0 on failure)
+ */
+static uint32_t tree_build(
+    TimelineEngine* engine,
+    const TrackedObject* tracks,
+    uint32_t num_tracks,
+    ScenePrediction* scene,
+    bool branching
+) {
+    TimelineTree* tree = engine->tree;
+    tree->num_decisions = 0;
+    tree->num_leaves = 0;
+    tree->num_nodes = 0;
+    tree->num_sampled = 0;
+    tree->leaf_mass = 1.0f;
+    tree->budget_exhausted = false;
+
+    uint64_t deadline_us = engine->config.max_tree_us > 0 ?
+        get_monotonic_us() + engine->config.max_tree_us : UINT64_MAX;
+
+    BranchNode* root = timeline_node_create(engine, scene->num_trajectories);
+    if (!root) {
+        return 0;
+    }
+    root->timestamp_ms = get_current_time_ms();
+    root->probability = 1.0f;
+    tree_fill_node(engine, scene, tree, root);
+
+    tree->num_nodes = 1;
+    tree->leaves[tree->num_leaves++] = root;
+
+    if (!branching) {
+        return tree->num_leaves;
+    }
+    if (engine->sampler) {
+        return tree_sample(engine, scene, root);
+    }
+
+    tree_select_decisions(engine, tracks, num_tracks, scene, tree);
 
-    if (!timeline->root) {
-        free(timeline);
-        return NULL;
-    }
+    uint32_t max_nodes = engine->config.max_nodes;
 
-    timeline->root->timestamp_ms = get_current_time_ms();
-    timeline->root->probability = 1.0f;
+    BranchCandidate* candidates = engine->workspace->candidates;
+    BranchNode* next[MAX_BEAM_WIDTH];
 
-    return timeline;
-}
+    for (uint32_t d = 0; d < tree->num_decisions && !tree->budget_exhausted; d++) {
+        const DecisionPoint* decision = &tree->decisions[d];
 
-static void timeline_destroy(Timeline* timeline) {
-    if (!timeline) return;
+        uint32_t num_candidates = 0;
+        for (uint32_t l = 0; l < tree->num_leaves; l++) {
+            for (uint32_t b = 0; b < decision->num_alternatives; b++) {
+                BranchCandidate* candidate = &candidates[num_candidates++];
+                candidate->parent = tree->leaves[l];
+                candidate->branch = b;
+                candidate->probability = tree->leaves[l]->probability * decision->weight[b];
+            }
+        }
 
-    timeline_node_destroy_recursive(timeline->root);
-    free(timeline);
-}
+        // Beam: keep the most probable children only. Insertion sort: at
+        // most a few hundred candidates, and unlike qsort() it never allocates
+        for (uint32_t c = 1; c < num_candidates; c++) {
+            BranchCandidate candidate = candidates[c];
+            uint32_t pos = c;
+            while (pos > 0 && compare_candidates(&candidate, &candidates[pos - 1]) < 0) {
+                candidates[pos] = candidates[pos - 1];
+                pos--;
+            }
+            candidates[pos] = candidate;
+        }
+        if (num_candidates > engine->config.beam_width) {
+            num_candidates = engine->config.beam_width;
+        }
 
-// ============================================================================
-// Timeline Building
-// ============================================================================
+        uint32_t num_next = 0;
+        for (uint32_t c = 0; c < num_candidates; c++) {
+            if (tree->num_nodes >= max_nodes ||
+                (deadline_us != UINT64_MAX && get_monotonic_us() >= deadline_us)) {
+                tree->budget_exhausted = true;
+                break;
+            }
 
-/**
- * Build timeline tree by predicting trajectories and events
- */
-static bool timeline_build_tree(
-    TimelineEngine* engine,
-    Timeline* timeline,
-    const TrackedObject* tracks,
-    uint32_t num_tracks,
-    uint64_t current_time_ms
-) {
-    // Predict trajectories for each track
-    PredictedTrajectory trajectories[100];
-    uint32_t num_trajectories = 0;
+            BranchNode* node = timeline_node_create(engine, scene->num_trajectories);
+            if (!node) {
+                tree->budget_exhausted = true;
+                break;
+            }
+            node->depth = d + 1;
+            node->branch = candidates[c].branch;
+            node->probability = candidates[c].probability;
+            node->timestamp_ms = candidates[c].parent->timestamp_ms;
+            timeline_node_add_child(candidates[c].parent, node);
 
-    for (uint32_t i = 0; i < num_tracks && num_trajectories < 100; i++) {
-        if (!trajectory_predict_single(
-            engine->trajectory_predictor,
-            &tracks[i],
-            tracks,
-            num_tracks,
-            engine->config.scene_context,
-            &trajectories[num_trajectories]
-        )) {
-            continue;
+            tree_fill_node(engine, scene, tree, node);
+
+            next[num_next++] = node;
+            tree->num_nodes++;
         }
-        num_trajectories++;
-    }
 
-    if (num_trajectories == 0) {
-        return false;
+        if (num_next == 0) {
+            break;
+        }
+        memcpy(tree->leaves, next, num_next * sizeof(BranchNode*));
+        tree->num_leaves = num_next;
     }
 
-    // Update root node with current predicted states
-    TimelineNode* root = timeline->root;
-    root->num_states = 0;
-
-    for (uint32_t i = 0; i < num_trajectories && root->num_states < 100; i++) {
-        if (trajectories[i].num_predictions > 0) {
-            root->states[root->num_states++] = trajectories[i].predictions[0];
-        }
+    tree->leaf_mass = 0.0f;
+    for (uint32_t l = 0; l < tree->num_leaves; l++) {
+        tree->leaf_mass += tree->leaves[l]->probability;
     }
+    return tree->num_leaves;
+}
 
-    // Predict events on this timeline
-    root->num_events = event_predictor_predict(
-        engine->event_predictor,
-        trajectories,
-        num_trajectories,
-        root->events,
-        20
-    );
+/**
+ * Fill a timeline from the leaf ending its path
+ *
+ * The tree itself stays in the node arena (root is NULL): everything the
+ * timeline reports is copied out, so it stays valid after the next update.
+ *
+ * @param leaf_mass Probability the leaves were drawn from (all leaves, or
+ *                  every sampled future); timelines share the scene's mean
+ *                  confidence in proportion to their leaf
+ */
+static bool timeline_build_from_leaf(
+    Timeline* timeline,
+    const BranchNode* leaf,
+    const ScenePrediction* scene,
+    float leaf_mass
+) {
+    timeline->tree_depth = leaf->depth + 1;
 
     // Store events in timeline
     timeline->num_predicted_events = 0;
-    for (uint32_t i = 0; i < root->num_events && timeline->num_predicted_events < 50; i++) {
-        timeline->predicted_events[timeline->num_predicted_events++] = root->events[i];
+    timeline->worst_case_severity = SEVERITY_NONE;
+    for (uint32_t i = 0; i < leaf->num_events && timeline->num_predicted_events < 50; i++) {
+        timeline->predicted_events[timeline->num_predicted_events++] = leaf->events[i];
+        if (leaf->events[i].severity > timeline->worst_case_severity) {
+            timeline->worst_case_severity = leaf->events[i].severity;
+        }
     }
 
-    // Create branch timelines if configured
-    if (engine->config.num_timelines > 1 && engine->config.branching_enabled) {
-        // For now, create linear timeline (branching is complex)
-        // TODO: Implement full branching based on decision points
+    timeline->total_threat_score = 0.0f;
+    for (uint32_t i = 0; i < leaf->num_states; i++) {
+        timeline->total_threat_score += leaf->states[i].threat_score;
     }
 
-    // Calculate overall timeline probability
-    float sum_confidence = 0.0f;
-    for (uint32_t i = 0; i < num_trajectories; i++) {
-        sum_confidence += trajectories[i].overall_confidence;
+    if (leaf_mass <= 0.0f) {
+        return false;
     }
-    timeline->overall_probability = sum_confidence / num_trajectories;
+    timeline->overall_probability = scene->mean_confidence * leaf->probability / leaf_mass;
 
     return true;
 }
@@ -263,11 +1428,26 @@ static bool timeline_build_tree(
 // Intervention Recommendation
 // ============================================================================
 
+/**
+ * Relative effort of an intervention [0.0, 1.0]
+ */
+static float intervention_cost(InterventionType type) {
+    switch (type) {
+        case INTERVENTION_DISPLAY_WARNING: return 0.05f;
+        case INTERVENTION_ACTIVATE_SPEAKER: return 0.1f;
+        case INTERVENTION_INCREASE_LIGHTING: return 0.1f;
+        case INTERVENTION_LOCK_DOOR: return 0.3f;
+        case INTERVENTION_ALERT_SECURITY: return 0.5f;
+        case INTERVENTION_POSITION_GUARD: return 0.7f;
+        case INTERVENTION_NOTIFY_POLICE: return 0.9f;
+        default: return 0.0f;
+    }
+}
+
 /**
  * Recommend best intervention to prevent predicted events
  */
 static bool timeline_recommend_interventions(
-    TimelineEngine* engine,
     Timeline* timeline,
     uint64_t current_time_ms
 ) {
@@ -289,44 +1469,29 @@ static bool timeline_recommend_interventions(
         InterventionPoint* intervention = &timeline->interventions[timeline->num_interventions++];
         memset(intervention, 0, sizeof(InterventionPoint));
 
-        intervention->event_id = i;
-        intervention->trigger_time_ms = current_time_ms;
-        intervention->event_time_ms = event->timestamp_ms;
-        intervention->location_x = event->location_x;
-        intervention->location_y = event->location_y;
-        intervention->target_track_id = event->involved_tracks[0];
-        intervention->success_probability = event->probability * 0.8f;  // Assume 80% intervention success
+        intervention->timestamp_ms = current_time_ms;  // Act now
+        intervention->effectiveness = event->probability * 0.8f;  // Assume 80% intervention success
+        intervention->prevented_event = *event;
 
         // Recommend intervention type based on event severity and type
-        switch (event->severity) {
-            case SEVERITY_CRITICAL:
-                intervention->intervention = INTERVENTION_ALERT_SECURITY;
-                intervention->urgency = URGENCY_IMMEDIATE;
-                break;
-
-            case SEVERITY_HIGH:
-                if (event->type == EVENT_TYPE_ASSAULT || event->type == EVENT_TYPE_THEFT) {
-                    intervention->intervention = INTERVENTION_ALERT_SECURITY;
-                    intervention->urgency = URGENCY_HIGH;
-                } else {
-                    intervention->intervention = INTERVENTION_ACTIVATE_SPEAKER;
-                    intervention->urgency = URGENCY_HIGH;
-                }
-                break;
-
-            case SEVERITY_MEDIUM:
-                intervention->intervention = INTERVENTION_ACTIVATE_SPEAKER;
-                intervention->urgency = URGENCY_MEDIUM;
-                break;
-
-            default:
-                intervention->intervention = INTERVENTION_LOG_ONLY;
-                intervention->urgency = URGENCY_LOW;
-                break;
+        if (event->severity == SEVERITY_CRITICAL ||
+            (event->severity == SEVERITY_HIGH &&
+             (event->type == EVENT_ASSAULT || event->type == EVENT_THEFT))) {
+            intervention->type = INTERVENTION_ALERT_SECURITY;
+            snprintf(intervention->recommendation, sizeof(intervention->recommendation),
+                     "Alert security: %s expected at (%.2f, %.2f) in %.0f s",
+                     timeline_event_to_string(event->type), event->location_x, event->location_y,
+                     event->timestamp_ms > current_time_ms ?
+                         (event->timestamp_ms - current_time_ms) / 1000.0f : 0.0f);
+        } else {
+            intervention->type = INTERVENTION_ACTIVATE_SPEAKER;
+            snprintf(intervention->recommendation, sizeof(intervention->recommendation),
+                     "Activate audio warning: %s expected at (%.2f, %.2f) in %.0f s",
+                     timeline_event_to_string(event->type), event->location_x, event->location_y,
+                     event->timestamp_ms > current_time_ms ?
+                         (event->timestamp_ms - current_time_ms) / 1000.0f : 0.0f);
         }
-
-        // Calculate time to act
-        intervention->time_to_act_ms = event->timestamp_ms - current_time_ms;
+        intervention->cost = intervention_cost(intervention->type);
     }
 
     return timeline->num_interventions > 0;
@@ -348,21 +1513,68 @@ TimelineEngine* timeline_init(const TimelineConfig* config) {
         return NULL;
     }
 
-    // Copy configuration
+    // Copy configuration (zero branching fields take the defaults)
     memcpy(&engine->config, config, sizeof(TimelineConfig));
+    if (engine->config.branch_threshold <= 0.0f) {
+        engine->config.branch_threshold = DEFAULT_BRANCH_THRESHOLD;
+    }
+    if (engine->config.merge_threshold <= 0.0f) {
+        engine->config.merge_threshold = DEFAULT_MERGE_THRESHOLD;
+    }
+    if (engine->config.beam_width == 0) {
+        engine->config.beam_width = DEFAULT_BEAM_WIDTH;
+    }
+    if (engine->config.beam_width > MAX_BEAM_WIDTH) {
+        engine->config.beam_width = MAX_BEAM_WIDTH;
+    }
+    if (engine->config.replan_tolerance == 0.0f) {
+        engine->config.replan_tolerance = DEFAULT_REPLAN_TOLERANCE;
+    }
+
+    // Worker pool for trajectory and event prediction
+    if (engine->config.worker_threads == 0) {
+        engine->config.worker_threads = worker_pool_default_threads(engine->config.reserved_cores);
+    }
+    engine->workers = worker_pool_create(engine->config.worker_threads);
+    if (!engine->workers) {
+        free(engine);
+        return NULL;
+    }
+    engine->config.worker_threads = worker_pool_num_threads(engine->workers);
+
+    // Sampling mode: futures rolled out on the same pool
+    if (engine->config.num_particles > 0) {
+        ParticleSamplerConfig sampler_config = {
+            .max_particles = engine->config.num_particles,
+            .budget_us = engine->config.max_sampling_us,
+            .seed = engine->config.sampling_seed,
+            .workers = engine->workers
+        };
+        engine->sampler = particle_sampler_create(&sampler_config);
+        if (!engine->sampler) {
+            worker_pool_destroy(engine->workers);
+            free(engine);
+            return NULL;
+        }
+    }
 
     // Initialize trajectory predictor
     TrajectoryPredictorConfig traj_config = {
-        .motion_model = MOTION_MODEL_KALMAN,
-        .prediction_horizon_s = config->prediction_horizon_s,
-        .prediction_step_s = 1.0f,
-        .max_branch_depth = 3
+        .motion_model = MOTION_KALMAN_FILTER,
+        .prediction_horizon_s = config->prediction_horizon_ms / 1000.0f,
+        .prediction_step_s = config->time_step_ms > 0 ? config->time_step_ms / 1000.0f : 1.0f,
+        .max_branch_depth = MAX_BRANCH_DEPTH,
+        .step_schedule = config->step_schedule
     };
     engine->trajectory_predictor = trajectory_predictor_init(&traj_config);
     if (!engine->trajectory_predictor) {
+        particle_sampler_destroy(engine->sampler);
+        worker_pool_destroy(engine->workers);
         free(engine);
         return NULL;
     }
+    engine->num_steps = trajectory_predictor_get_steps(engine->trajectory_predictor,
+                                                       &engine->step_offset_ms);
 
     // Initialize event predictor
     EventPredictorConfig event_config = {
@@ -374,34 +1586,60 @@ TimelineEngine* timeline_init(const TimelineConfig* config) {
         .behavior_weight = 0.3f,
         .context_weight = 0.2f,
         .history_weight = 0.2f,
-        .scene = config->scene_context
+        .scene = config->scene_context,
+        .workers = engine->workers
     };
     engine->event_predictor = event_predictor_init(&event_config);
     if (!engine->event_predictor) {
         trajectory_predictor_destroy(engine->trajectory_predictor);
+        particle_sampler_destroy(engine->sampler);
+        worker_pool_destroy(engine->workers);
         free(engine);
         return NULL;
     }
 
-    // Allocate node pool
-    engine->node_pool_size = 1000;  // Support 1000 nodes
-    engine->node_pool = calloc(engine->node_pool_size, sizeof(TimelineNode));
-    if (!engine->node_pool) {
+    // Allocate node arena and per-update workspace
+    bool have_arena = arena_init(&engine->arena, ARENA_INITIAL_BYTES);
+    engine->workspace = calloc(1, sizeof(TimelineWorkspace));
+    engine->track_index = track_index_create(MAX_SCENE_TRACKS);
+    engine->monitor.mailbox = track_snapshot_create();
+    if (!have_arena || !engine->workspace || !engine->track_index || !engine->monitor.mailbox) {
+        arena_destroy(&engine->arena);
+        free(engine->workspace);
+        track_index_destroy(engine->track_index);
+        track_snapshot_destroy(engine->monitor.mailbox);
         event_predictor_destroy(engine->event_predictor);
         trajectory_predictor_destroy(engine->trajectory_predictor);
+        particle_sampler_destroy(engine->sampler);
+        worker_pool_destroy(engine->workers);
         free(engine);
         return NULL;
     }
-    engine->next_free_node = 0;
+    if (engine->config.max_nodes == 0) {
+        engine->config.max_nodes = DEFAULT_MAX_NODES;
+    }
+    engine->scene = &engine->workspace->scene;
+    engine->tree = &engine->workspace->tree;
 
     // Initialize statistics
     memset(&engine->stats, 0, sizeof(engine->stats));
 
+    // Monitor thread waits against the monotonic clock
+    pthread_condattr_t wake_attr;
+    pthread_condattr_init(&wake_attr);
+    pthread_condattr_setclock(&wake_attr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&engine->monitor.mutex, NULL);
+    pthread_cond_init(&engine->monitor.wake, &wake_attr);
+    pthread_condattr_destroy(&wake_attr);
+    atomic_init(&engine->monitor.coalesced, 0);
+
     printf("[Timeline] Timeline Threading™ engine initialized\n");
-    printf("[Timeline] Horizon: %.1fs, Timelines: %u, Branching: %s\n",
-           config->prediction_horizon_s,
-           config->num_timelines,
-           config->branching_enabled ? "enabled" : "disabled");
+    printf("[Timeline] Horizon: %.1fs (%u steps), Timelines: %u, Branching: %s, Threads: %u\n",
+           config->prediction_horizon_ms / 1000.0f,
+           engine->num_steps,
+           config->max_timelines,
+           config->branching_enabled ? "enabled" : "disabled",
+           engine->config.worker_threads);
 
     return engine;
 }
@@ -409,88 +1647,166 @@ TimelineEngine* timeline_init(const TimelineConfig* config) {
 void timeline_destroy(TimelineEngine* engine) {
     if (!engine) return;
 
-    // Destroy all timelines
-    for (uint32_t i = 0; i < engine->num_timelines; i++) {
-        timeline_destroy(engine->timelines[i]);
-    }
+    timeline_stop_monitoring(engine);
+    pthread_cond_destroy(&engine->monitor.wake);
+    pthread_mutex_destroy(&engine->monitor.mutex);
+    track_snapshot_destroy(engine->monitor.mailbox);
 
     // Destroy subsystems
     event_predictor_destroy(engine->event_predictor);
     trajectory_predictor_destroy(engine->trajectory_predictor);
+    particle_sampler_destroy(engine->sampler);
+    worker_pool_destroy(engine->workers);
 
-    // Free node pool
-    free(engine->node_pool);
+    // Free node arena
+    arena_destroy(&engine->arena);
+    free(engine->workspace);
+    track_index_destroy(engine->track_index);
 
     free(engine);
 }
 
-uint32_t timeline_update(
+/**
+ * Time of a snapshot: its newest track, or now when it has none
+ */
+static uint64_t snapshot_time_ms(const TrackedObject* tracks, uint32_t num_tracks) {
+    uint64_t time_ms = 0;
+    for (uint32_t i = 0; i < num_tracks; i++) {
+        if (tracks[i].last_seen_ms > time_ms) {
+            time_ms = tracks[i].last_seen_ms;
+        }
+    }
+    return time_ms > 0 ? time_ms : get_current_time_ms();
+}
+
+/**
+ * Predict the timelines of one snapshot into the workspace
+ *
+ * @return Number of timelines in engine->timelines
+ */
+static uint32_t engine_update(
     TimelineEngine* engine,
     const TrackedObject* tracks,
     uint32_t num_tracks,
-    uint64_t current_time_ms,
-    Timeline** timelines_out
+    uint64_t current_time_ms
 ) {
-    if (!engine || !tracks || num_tracks == 0) {
+    if (!tracks || num_tracks == 0) {
         return 0;
     }
 
-    // Clear old timelines
-    for (uint32_t i = 0; i < engine->num_timelines; i++) {
-        timeline_destroy(engine->timelines[i]);
-        engine->timelines[i] = NULL;
-    }
+    uint64_t start_us = get_monotonic_us();
+
+    // Clear old timelines (workspace slots are reused)
     engine->num_timelines = 0;
 
-    // Reset node pool
-    engine->next_free_node = 0;
+    // Reset node arena
+    arena_reset(&engine->arena);
+    engine->next_node_id = 0;
+
+    // Trajectories and events common to all timelines, computed once
+    bool have_scene = scene_predict(engine, tracks, num_tracks, current_time_ms, engine->scene);
+
+    // One tree per update; each timeline follows a path to one of its leaves
+    bool branching = engine->config.max_timelines > 1 && engine->config.branching_enabled;
+    uint32_t num_leaves = have_scene ?
+        tree_build(engine, tracks, num_tracks, engine->scene, branching) : 0;
+    if (num_leaves > 0 && engine->tree->num_nodes > engine->high_water_nodes) {
+        engine->high_water_nodes = engine->tree->num_nodes;
+    }
+
+    float leaf_mass = num_leaves > 0 ? engine->tree->leaf_mass : 0.0f;
 
-    // Create timelines
-    uint32_t num_timelines_to_create = engine->config.num_timelines;
+    // Create timelines: the most probable leaves, or copies of the
+    // root-only tree when branching is off
+    uint32_t num_timelines_to_create = engine->config.max_timelines;
     if (num_timelines_to_create > 10) {
         num_timelines_to_create = 10;
     }
+    if (branching && num_timelines_to_create > num_leaves) {
+        num_timelines_to_create = num_leaves;
+    }
 
-    for (uint32_t i = 0; i < num_timelines_to_create; i++) {
-        Timeline* timeline = timeline_create(engine, i);
+    for (uint32_t i = 0; i < num_timelines_to_create && num_leaves > 0; i++) {
+        BranchNode* leaf = engine->tree->leaves[branching ? i : 0];
+        Timeline* timeline = timeline_create(engine, i, current_time_ms);
         if (!timeline) {
             continue;
         }
 
-        // Build timeline tree
-        if (!timeline_build_tree(engine, timeline, tracks, num_tracks, current_time_ms)) {
-            timeline_destroy(timeline);
+        if (!timeline_build_from_leaf(timeline, leaf, engine->scene, leaf_mass)) {
             continue;
         }
 
         // Recommend interventions
-        timeline_recommend_interventions(engine, timeline, current_time_ms);
+        timeline_recommend_interventions(timeline, current_time_ms);
 
         engine->timelines[engine->num_timelines++] = timeline;
 
         // Update statistics
+        engine->stats.total_timelines++;
         engine->stats.total_events_predicted += timeline->num_predicted_events;
         engine->stats.total_interventions += timeline->num_interventions;
     }
 
     // Update statistics
     engine->stats.num_updates++;
+    engine->stats.latency_ms[engine->stats.latency_next] = (get_monotonic_us() - start_us) / 1000.0f;
+    engine->stats.latency_next = (engine->stats.latency_next + 1) % LATENCY_WINDOW;
 
-    // Calculate average confidence
-    float sum_confidence = 0.0f;
-    for (uint32_t i = 0; i < engine->num_timelines; i++) {
-        sum_confidence += engine->timelines[i]->overall_probability;
+    return engine->num_timelines;
+}
+
+uint32_t timeline_update(
+    TimelineEngine* engine,
+    const TrackedObject* tracks,
+    uint32_t num_tracks,
+    Timeline* timelines,
+    uint32_t max_timelines
+) {
+    if (!engine || !tracks || num_tracks == 0) {
+        return 0;
     }
-    engine->stats.avg_timeline_confidence = sum_confidence / engine->num_timelines;
 
-    // Return timelines
-    if (timelines_out) {
-        for (uint32_t i = 0; i < engine->num_timelines; i++) {
-            timelines_out[i] = engine->timelines[i];
-        }
+    uint32_t num_timelines = engine_update(engine, tracks, num_tracks,
+                                           snapshot_time_ms(tracks, num_tracks));
+    if (!timelines) {
+        return num_timelines;
     }
+    return timeline_get_timelines(engine, timelines, max_timelines);
+}
 
-    return engine->num_timelines;
+uint32_t timeline_get_timelines(
+    TimelineEngine* engine,
+    Timeline* timelines,
+    uint32_t max_timelines
+) {
+    if (!engine || !timelines) {
+        return 0;
+    }
+
+    uint32_t count = engine->num_timelines < max_timelines ? engine->num_timelines : max_timelines;
+    for (uint32_t i = 0; i < count; i++) {
+        timelines[i] = *engine->timelines[i];
+    }
+    return count;
+}
+
+bool timeline_get_by_id(
+    TimelineEngine* engine,
+    uint32_t timeline_id,
+    Timeline* timeline
+) {
+    if (!engine || !timeline) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < engine->num_timelines; i++) {
+        if (engine->timelines[i]->timeline_id == timeline_id) {
+            *timeline = *engine->timelines[i];
+            return true;
+        }
+    }
+    return false;
 }
 
 bool timeline_get_best_intervention(
@@ -511,9 +1827,9 @@ bool timeline_get_best_intervention(
         for (uint32_t j = 0; j < timeline->num_interventions; j++) {
             InterventionPoint* candidate = &timeline->interventions[j];
 
-            // Score = probability * urgency * timeline_confidence
-            float score = candidate->success_probability *
-                         (float)candidate->urgency *
+            // Score = effectiveness * severity * timeline_confidence
+            float score = candidate->effectiveness *
+                         (float)candidate->prevented_event.severity *
                          timeline->overall_probability;
 
             if (score > best_score) {
@@ -532,57 +1848,360 @@ bool timeline_get_best_intervention(
     return true;
 }
 
-uint32_t timeline_get_events(
-    const Timeline* timeline,
-    PredictedEvent* events,
-    uint32_t max_events
+uint32_t timeline_apply_intervention(
+    TimelineEngine* engine,
+    const InterventionPoint* intervention,
+    Timeline* new_timelines,
+    uint32_t max_timelines
 ) {
-    if (!timeline || !events || max_events == 0) {
+    if (!engine || !intervention || !new_timelines) {
         return 0;
     }
 
-    uint32_t num_to_copy = timeline->num_predicted_events < max_events ?
-                          timeline->num_predicted_events : max_events;
+    // The prevented event, and the interventions aimed at it, leave every
+    // timeline; the rest of each future is unchanged
+    const PredictedEvent* prevented = &intervention->prevented_event;
+    for (uint32_t i = 0; i < engine->num_timelines; i++) {
+        Timeline* timeline = engine->timelines[i];
+
+        uint32_t kept = 0;
+        timeline->worst_case_severity = SEVERITY_NONE;
+        for (uint32_t j = 0; j < timeline->num_predicted_events; j++) {
+            const PredictedEvent* event = &timeline->predicted_events[j];
+            if (event->type == prevented->type &&
+                event->involved_tracks[0] == prevented->involved_tracks[0]) {
+                timeline->incident_prevented = true;
+                continue;
+            }
+            if (event->severity > timeline->worst_case_severity) {
+                timeline->worst_case_severity = event->severity;
+            }
+            timeline->predicted_events[kept++] = *event;
+        }
+        timeline->num_predicted_events = kept;
+
+        kept = 0;
+        for (uint32_t j = 0; j < timeline->num_interventions; j++) {
+            const PredictedEvent* event = &timeline->interventions[j].prevented_event;
+            if (event->type == prevented->type &&
+                event->involved_tracks[0] == prevented->involved_tracks[0]) {
+                continue;
+            }
+            timeline->interventions[kept++] = timeline->interventions[j];
+        }
+        timeline->num_interventions = kept;
+        timeline->last_updated_ms = get_current_time_ms();
+    }
 
-    memcpy(events, timeline->predicted_events, num_to_copy * sizeof(PredictedEvent));
-    return num_to_copy;
+    return timeline_get_timelines(engine, new_timelines, max_timelines);
 }
 
-uint32_t timeline_get_interventions(
-    const Timeline* timeline,
-    InterventionPoint* interventions,
-    uint32_t max_interventions
+void timeline_get_stats(
+    TimelineEngine* engine,
+    uint64_t* total_timelines,
+    uint64_t* total_events,
+    uint64_t* total_interventions,
+    float* avg_prediction_ms
 ) {
-    if (!timeline || !interventions || max_interventions == 0) {
-        return 0;
-    }
+    if (!engine) return;
 
-    uint32_t num_to_copy = timeline->num_interventions < max_interventions ?
-                          timeline->num_interventions : max_interventions;
+    if (total_timelines) *total_timelines = engine->stats.total_timelines;
+    if (total_events) *total_events = engine->stats.total_events_predicted;
+    if (total_interventions) *total_interventions = engine->stats.total_interventions;
 
-    memcpy(interventions, timeline->interventions, num_to_copy * sizeof(InterventionPoint));
-    return num_to_copy;
+    // Mean over the latest updates
+    if (avg_prediction_ms) {
+        uint32_t n = engine->stats.num_updates < LATENCY_WINDOW ?
+                     (uint32_t)engine->stats.num_updates : LATENCY_WINDOW;
+        float sum_ms = 0.0f;
+        for (uint32_t i = 0; i < n; i++) {
+            sum_ms += engine->stats.latency_ms[i];
+        }
+        *avg_prediction_ms = n > 0 ? sum_ms / n : 0.0f;
+    }
 }
 
-float timeline_get_probability(const Timeline* timeline) {
-    return timeline ? timeline->overall_probability : 0.0f;
+void timeline_get_arena_stats(
+    const TimelineEngine* engine,
+    size_t* bytes_used,
+    size_t* high_water_bytes,
+    size_t* capacity_bytes,
+    uint32_t* high_water_nodes
+) {
+    if (!engine) return;
+
+    if (bytes_used) *bytes_used = engine->arena.bytes_used;
+    if (high_water_bytes) *high_water_bytes = engine->arena.high_water_bytes;
+    if (capacity_bytes) *capacity_bytes = engine->arena.capacity;
+    if (high_water_nodes) *high_water_nodes = engine->high_water_nodes;
 }
 
-uint32_t timeline_get_id(const Timeline* timeline) {
-    return timeline ? timeline->timeline_id : 0;
+static int compare_floats(const void* a, const void* b) {
+    float fa = *(const float*)a;
+    float fb = *(const float*)b;
+    return (fa > fb) - (fa < fb);
 }
 
-void timeline_get_stats(
+void timeline_get_update_stats(
     const TimelineEngine* engine,
-    uint64_t* num_updates,
-    uint64_t* total_events,
-    uint64_t* total_interventions,
-    float* avg_confidence
+    TimelineUpdateStats* stats
+) {
+    if (!engine || !stats) return;
+
+    memset(stats, 0, sizeof(TimelineUpdateStats));
+    stats->num_updates = engine->stats.num_updates;
+    stats->tracks_predicted = engine->stats.tracks_predicted;
+    stats->tracks_reused = engine->stats.tracks_reused;
+    stats->full_event_passes = engine->stats.full_event_passes;
+    stats->incremental_event_passes = engine->stats.incremental_event_passes;
+    stats->worker_threads = engine->config.worker_threads;
+    stats->particles_sampled = engine->stats.particles_sampled;
+    stats->snapshots_submitted = track_snapshot_version(engine->monitor.mailbox);
+    stats->snapshots_coalesced = atomic_load_explicit(&engine->monitor.coalesced,
+                                                      memory_order_relaxed);
+
+    uint64_t total = stats->tracks_predicted + stats->tracks_reused;
+    stats->reuse_fraction = total > 0 ? (float)stats->tracks_reused / total : 0.0f;
+
+    // Percentiles over the latest updates
+    uint32_t n = engine->stats.num_updates < LATENCY_WINDOW ?
+                 (uint32_t)engine->stats.num_updates : LATENCY_WINDOW;
+    if (n == 0) {
+        return;
+    }
+
+    float sorted[LATENCY_WINDOW];
+    memcpy(sorted, engine->stats.latency_ms, n * sizeof(float));
+    qsort(sorted, n, sizeof(float), compare_floats);
+
+    stats->latency_p50_ms = sorted[(n - 1) * 50 / 100];
+    stats->latency_p90_ms = sorted[(n - 1) * 90 / 100];
+    stats->latency_p99_ms = sorted[(n - 1) * 99 / 100];
+    stats->latency_max_ms = sorted[n - 1];
+}
+
+// ============================================================================
+// Monitor Thread
+// ============================================================================
+
+/**
+ * Forget the timelines and the cached scene, so the next update predicts
+ * every track from scratch. Runs on whichever thread owns the engine.
+ */
+static void engine_clear(TimelineEngine* engine) {
+    engine->num_timelines = 0;
+    track_index_clear(engine->track_index);
+    engine->scene->num_trajectories = 0;
+    engine->scene->valid = false;
+    engine->tree->num_nodes = 0;
+    arena_reset(&engine->arena);
+    engine->next_node_id = 0;
+}
+
+static void* monitor_main(void* arg) {
+    TimelineEngine* engine = arg;
+    uint64_t next_due_us = 0;
+
+    pthread_mutex_lock(&engine->monitor.mutex);
+    for (;;) {
+        // Sleep until a new snapshot is in and the cadence allows an update
+        while (!engine->monitor.stopping && !engine->monitor.clear_requested &&
+               track_snapshot_version(engine->monitor.mailbox) == engine->monitor.version_seen) {
+            pthread_cond_wait(&engine->monitor.wake, &engine->monitor.mutex);
+        }
+        if (engine->monitor.stopping) {
+            break;
+        }
+        if (engine->monitor.clear_requested) {
+            engine->monitor.clear_requested = false;
+            pthread_mutex_unlock(&engine->monitor.mutex);
+            engine_clear(engine);
+            pthread_mutex_lock(&engine->monitor.mutex);
+            continue;
+        }
+
+        uint64_t now_us = get_monotonic_us();
+        if (now_us < next_due_us) {
+            struct timespec due = {
+                .tv_sec = (time_t)(next_due_us / 1000000),
+                .tv_nsec = (long)(next_due_us % 1000000) * 1000
+            };
+            pthread_cond_timedwait(&engine->monitor.wake, &engine->monitor.mutex, &due);
+            continue;
+        }
+        pthread_mutex_unlock(&engine->monitor.mutex);
+
+        // Take the newest snapshot; the ones it replaced are coalesced
+        uint64_t version;
+        uint32_t num_tracks = track_snapshot_read(engine->monitor.mailbox, engine->monitor.tracks,
+                                                  TRACK_SNAPSHOT_MAX_TRACKS, &version);
+        atomic_fetch_add_explicit(&engine->monitor.coalesced,
+                                  version - engine->monitor.version_seen - 1,
+                                  memory_order_relaxed);
+        engine->monitor.version_seen = version;
+
+        uint32_t num_timelines = timeline_update(engine, engine->monitor.tracks, num_tracks,
+                                                 engine->monitor.timelines, 10);
+
+        if (engine->monitor.callback) {
+            engine->monitor.callback(engine->monitor.timelines, num_timelines,
+                                     engine->monitor.user_data);
+        }
+
+        next_due_us = now_us + (uint64_t)engine->config.monitor_interval_ms * 1000;
+        pthread_mutex_lock(&engine->monitor.mutex);
+    }
+    pthread_mutex_unlock(&engine->monitor.mutex);
+
+    return NULL;
+}
+
+bool timeline_start_monitoring(
+    TimelineEngine* engine,
+    TimelineCallback callback,
+    void* user_data
+) {
+    if (!engine) {
+        return false;
+    }
+
+    // Held across pthread_create so submit and clear never see a half-started monitor
+    pthread_mutex_lock(&engine->monitor.mutex);
+    if (engine->monitor.running) {
+        pthread_mutex_unlock(&engine->monitor.mutex);
+        return false;
+    }
+
+    engine->monitor.callback = callback;
+    engine->monitor.user_data = user_data;
+    engine->monitor.stopping = false;
+
+    if (pthread_create(&engine->monitor.thread, NULL, monitor_main, engine) != 0) {
+        pthread_mutex_unlock(&engine->monitor.mutex);
+        fprintf(stderr, "[Timeline] ERROR: Failed to start monitor thread\n");
+        return false;
+    }
+    engine->monitor.running = true;
+    pthread_mutex_unlock(&engine->monitor.mutex);
+
+    printf("[Timeline] Monitoring (update every %u ms at most)\n",
+           engine->config.monitor_interval_ms);
+    return true;
+}
+
+void timeline_stop_monitoring(TimelineEngine* engine) {
+    if (!engine) {
+        return;
+    }
+
+    pthread_mutex_lock(&engine->monitor.mutex);
+    if (!engine->monitor.running) {
+        pthread_mutex_unlock(&engine->monitor.mutex);
+        return;
+    }
+    engine->monitor.stopping = true;
+    pthread_cond_signal(&engine->monitor.wake);
+    pthread_mutex_unlock(&engine->monitor.mutex);
+
+    pthread_join(engine->monitor.thread, NULL);
+
+    // A clear the monitor thread did not get to still applies
+    pthread_mutex_lock(&engine->monitor.mutex);
+    engine->monitor.running = false;
+    bool clear_pending = engine->monitor.clear_requested;
+    engine->monitor.clear_requested = false;
+    pthread_mutex_unlock(&engine->monitor.mutex);
+
+    if (clear_pending) {
+        engine_clear(engine);
+    }
+}
+
+bool timeline_submit_tracks(
+    TimelineEngine* engine,
+    const TrackedObject* tracks,
+    uint32_t num_tracks
 ) {
+    if (!engine || (!tracks && num_tracks > 0)) {
+        return false;
+    }
+
+    // Nobody would drain the mailbox; the caller updates synchronously instead
+    pthread_mutex_lock(&engine->monitor.mutex);
+    bool running = engine->monitor.running;
+    pthread_mutex_unlock(&engine->monitor.mutex);
+    if (!running) {
+        return false;
+    }
+
+    // Single writer; the monitor thread copies without blocking it
+    track_snapshot_publish(engine->monitor.mailbox, tracks, num_tracks);
+
+    pthread_mutex_lock(&engine->monitor.mutex);
+    pthread_cond_signal(&engine->monitor.wake);
+    pthread_mutex_unlock(&engine->monitor.mutex);
+
+    return true;
+}
+
+void timeline_clear(TimelineEngine* engine) {
     if (!engine) return;
 
-    if (num_updates) *num_updates = engine->stats.num_updates;
-    if (total_events) *total_events = engine->stats.total_events_predicted;
-    if (total_interventions) *total_interventions = engine->stats.total_interventions;
-    if (avg_confidence) *avg_confidence = engine->stats.avg_timeline_confidence;
+    // While monitoring the engine belongs to the monitor thread
+    pthread_mutex_lock(&engine->monitor.mutex);
+    if (engine->monitor.running) {
+        engine->monitor.clear_requested = true;
+        pthread_cond_signal(&engine->monitor.wake);
+        pthread_mutex_unlock(&engine->monitor.mutex);
+        return;
+    }
+    pthread_mutex_unlock(&engine->monitor.mutex);
+
+    engine_clear(engine);
+}
+
+int timeline_export_json(
+    const Timeline* timeline,
+    char* buffer,
+    size_t buffer_size
+) {
+    if (!timeline || !buffer) return -1;
+
+    int written = snprintf(buffer, buffer_size,
+        "{\"timeline_id\":%u,\"probability\":%.2f,\"events\":%u,\"interventions\":%u}",
+        timeline->timeline_id,
+        timeline->overall_probability,
+        timeline->num_predicted_events,
+        timeline->num_interventions);
+
+    return written < (int)buffer_size ? written : -1;
+}
+
+const char* timeline_event_to_string(EventType event_type) {
+    switch (event_type) {
+        case EVENT_LOITERING: return "Loitering";
+        case EVENT_THEFT: return "Theft";
+        case EVENT_ASSAULT: return "Assault";
+        case EVENT_VANDALISM: return "Vandalism";
+        case EVENT_TRESPASSING: return "Trespassing";
+        case EVENT_SUSPICIOUS_BEHAVIOR: return "Suspicious Behavior";
+        case EVENT_COLLISION: return "Collision";
+        case EVENT_FALL: return "Fall";
+        case EVENT_ABANDONED_OBJECT: return "Abandoned Object";
+        case EVENT_CROWD_FORMATION: return "Crowd Formation";
+        default: return "Unknown";
+    }
+}
+
+const char* timeline_intervention_to_string(InterventionType intervention_type) {
+    switch (intervention_type) {
+        case INTERVENTION_ALERT_SECURITY: return "Alert Security";
+        case INTERVENTION_ACTIVATE_SPEAKER: return "Activate Speaker";
+        case INTERVENTION_INCREASE_LIGHTING: return "Increase Lighting";
+        case INTERVENTION_POSITION_GUARD: return "Position Guard";
+        case INTERVENTION_LOCK_DOOR: return "Lock Door";
+        case INTERVENTION_NOTIFY_POLICE: return "Notify Police";
+        case INTERVENTION_DISPLAY_WARNING: return "Display Warning";
+        default: return "None";
+    }
 }
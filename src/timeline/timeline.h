@@ -33,6 +33,7 @@ typedef struct TimelineEngine TimelineEngine;
 typedef struct Timeline Timeline;
 typedef struct TimelineNode TimelineNode;
 typedef struct InterventionPoint InterventionPoint;
+typedef struct SceneContext SceneContext;  // event_predictor.h
 
 /**
  * Event types that can occur in timelines
@@ -172,6 +173,24 @@ struct Timeline {
     uint64_t last_updated_ms;
 };
 
+#define MAX_STEP_SEGMENTS 4
+
+/**
+ * Non-uniform prediction steps
+ *
+ * Segment i steps by step_ms until end_ms ahead, where the next segment
+ * takes over; the last one runs to the horizon. For example
+ * {200, 10000}, {1000, 60000}, {5000, 0}: 200 ms steps for the first 10 s,
+ * 1 s to 60 s, then 5 s.
+ */
+typedef struct {
+    uint32_t num_segments;           // 0 = uniform steps
+    struct {
+        uint32_t step_ms;            // Step length
+        uint32_t end_ms;             // Lookahead where the next segment starts
+    } segments[MAX_STEP_SEGMENTS];
+} StepSchedule;
+
 /**
  * Timeline engine configuration
  */
@@ -179,7 +198,10 @@ typedef struct {
     // Prediction parameters
     uint32_t prediction_horizon_ms;  // How far to predict (default: 300000 = 5min)
     uint32_t time_step_ms;           // Prediction granularity (default: 1000 = 1s)
+    StepSchedule step_schedule;      // Finer steps near term (no segments: time_step_ms)
     uint32_t max_timelines;          // Maximum branches (default: 5)
+    bool branching_enabled;          // Alternative futures (false: max_timelines
+                                     // copies of the most likely one)
 
     // Branching thresholds
     float branch_threshold;          // Min probability for branch (default: 0.3)
@@ -188,12 +210,60 @@ typedef struct {
     // Event detection
     float event_threshold;           // Min probability for event (default: 0.5)
     bool enable_intervention_search; // Find intervention points
+    const SceneContext* scene_context; // Protected zones and incident history (may be NULL)
 
     // Performance
     uint32_t max_iterations;         // Max prediction iterations
     bool use_gpu;                    // Use ML model on DLPU (future)
+
+    // Incremental updates
+    float replan_tolerance;          // Deviation that forces re-prediction, in box sizes
+                                     // (default: 0.25, < 0: re-predict every update)
+
+    // Prediction threads; results do not depend on the count
+    uint32_t worker_threads;         // Threads incl. the caller (0 = cores not reserved)
+    uint32_t reserved_cores;         // Cores left to perception when worker_threads is 0
+
+    // Branch search budget per update (0 = default)
+    uint32_t beam_width;             // Leaves kept per tree depth (default: 8, max: 32)
+    uint32_t max_nodes;              // Tree nodes per update (default: 1000)
+    uint32_t max_tree_us;            // Tree expansion time cap (default: none; a cap
+                                     // makes the timelines depend on machine speed)
+
+    // Monte Carlo sampling instead of the branch search (num_particles > 0)
+    uint32_t num_particles;          // Futures sampled per update (max 4096)
+    uint32_t max_sampling_us;        // Sampling time cap; fewer futures past it (default:
+                                     // none; a cap makes K depend on machine speed)
+    uint64_t sampling_seed;          // Same seed and scene, same timelines (no time cap)
+
+    // Monitor thread (timeline_start_monitoring)
+    uint32_t monitor_interval_ms;    // Min time between monitored updates (0 = per snapshot)
 } TimelineConfig;
 
+/**
+ * Incremental update statistics
+ */
+typedef struct {
+    uint64_t num_updates;
+    uint64_t tracks_predicted;       // Trajectories predicted from scratch
+    uint64_t tracks_reused;          // Trajectories kept and time-shifted
+    float reuse_fraction;            // tracks_reused / all trajectories
+    uint64_t full_event_passes;      // Updates that re-checked every event
+    uint64_t incremental_event_passes; // Updates that re-checked changed tracks only
+    uint32_t worker_threads;         // Threads sharing trajectory and event prediction
+    uint32_t particles_sampled;      // Futures sampled by the latest update (sampling mode)
+
+    // Monitor thread mailbox
+    uint64_t snapshots_submitted;    // timeline_submit_tracks() calls
+    uint64_t snapshots_coalesced;    // Replaced by a newer snapshot before an update took them
+
+    // timeline_update() latency over the last 256 updates
+    float latency_p50_ms;
+    float latency_p90_ms;
+    float latency_p99_ms;
+    float latency_max_ms;
+} TimelineUpdateStats;
+
 /**
  * Timeline callback for real-time updates
  */
@@ -214,14 +284,17 @@ TimelineEngine* timeline_init(const TimelineConfig* config);
 /**
  * Update timeline predictions with current track data
  *
- * Call this each frame with updated tracked objects from perception engine
+ * Call this each frame with updated tracked objects from perception engine.
+ * Predictions start at the newest last_seen_ms of the tracks. Timelines are
+ * copied out, most likely first, and stay valid across later updates.
  *
  * @param engine Timeline engine instance
  * @param tracks Current tracked objects
  * @param num_tracks Number of tracked objects
- * @param timelines Output array for generated timelines
- * @param max_timelines Maximum timelines to generate
- * @return Number of timelines generated
+ * @param timelines Output array for generated timelines (NULL: keep them in
+ *                  the engine only, see timeline_get_timelines())
+ * @param max_timelines Maximum timelines to copy out
+ * @return Number of timelines copied out (generated, if timelines is NULL)
  */
 uint32_t timeline_update(
     TimelineEngine* engine,
@@ -292,7 +365,13 @@ uint32_t timeline_apply_intervention(
 /**
  * Start real-time timeline monitoring
  *
- * Automatically updates timelines as new track data arrives
+ * Starts a monitor thread that updates timelines from the latest snapshot
+ * passed to timeline_submit_tracks(), at most once per
+ * monitor_interval_ms. Snapshots arriving faster are coalesced: only the
+ * newest is predicted. The callback runs on the monitor thread after each
+ * update; its timelines are valid until it returns. While monitoring, the
+ * engine belongs to that thread: do not call timeline_update() or the
+ * result getters from elsewhere.
  *
  * @param engine Timeline engine instance
  * @param callback Function called with updated timelines
@@ -308,13 +387,41 @@ bool timeline_start_monitoring(
 /**
  * Stop real-time monitoring
  *
+ * Waits for an update in progress; a snapshot not yet taken is dropped.
+ *
  * @param engine Timeline engine instance
  */
 void timeline_stop_monitoring(TimelineEngine* engine);
 
+/**
+ * Hand the current tracks to the monitor thread
+ *
+ * Copies the tracks into a latest-value mailbox and wakes the monitor
+ * thread; never waits for an update, so the caller's frame rate does not
+ * depend on the scene. Call from one thread only (the perception thread).
+ * The snapshot's time is the newest last_seen_ms of its tracks.
+ *
+ * @param engine Timeline engine instance
+ * @param tracks Current tracked objects
+ * @param num_tracks Number of tracked objects (the first 50 are kept)
+ * @return true if handed over; false when not monitoring (nothing would
+ *         take the snapshot; call timeline_update() instead)
+ */
+bool timeline_submit_tracks(
+    TimelineEngine* engine,
+    const TrackedObject* tracks,
+    uint32_t num_tracks
+);
+
 /**
  * Clear all timelines and reset engine
  *
+ * Drops the current timelines and the cached scene, so the next update
+ * predicts every track from scratch; statistics are kept. While
+ * monitoring, the reset is queued for the monitor thread and applied
+ * before its next update. Call from the thread that starts and stops
+ * monitoring.
+ *
  * @param engine Timeline engine instance
  */
 void timeline_clear(TimelineEngine* engine);
@@ -336,6 +443,42 @@ void timeline_get_stats(
     float* avg_prediction_ms
 );
 
+/**
+ * Get incremental update statistics
+ *
+ * Tracks that still follow their previous trajectory (within
+ * replan_tolerance, same behaviors and threat) keep it, time-shifted,
+ * and only events touching changed tracks are recomputed.
+ *
+ * @param engine Timeline engine instance
+ * @param stats Output statistics
+ */
+void timeline_get_update_stats(
+    const TimelineEngine* engine,
+    TimelineUpdateStats* stats
+);
+
+/**
+ * Get timeline node arena usage
+ *
+ * Tree nodes and their per-track state / event blocks live in an arena
+ * reset on every update, so usage follows the scene rather than the
+ * worst case.
+ *
+ * @param engine Timeline engine instance
+ * @param bytes_used Arena bytes used by the latest update
+ * @param high_water_bytes Most arena bytes used by any update
+ * @param capacity_bytes Arena bytes currently reserved
+ * @param high_water_nodes Most tree nodes built by any update
+ */
+void timeline_get_arena_stats(
+    const TimelineEngine* engine,
+    size_t* bytes_used,
+    size_t* high_water_bytes,
+    size_t* capacity_bytes,
+    uint32_t* high_water_nodes
+);
+
 /**
  * Destroy timeline engine and free resources
  *
@@ -352,6 +352,22 @@ void timeline_stop_monitoring(TimelineEngine* engine) {
     printf("[Timeline] ✓ Monitoring stopped\n");
 }
 
+bool timeline_submit_tracks(TimelineEngine* engine,
+                            const TrackedObject* tracks,
+                            uint32_t num_tracks) {
+    if (!engine || !engine->monitoring_active) return false;
+
+    // Stub: simulated timelines are cheap, so update on the caller's thread
+    if (engine->callback) {
+        Timeline timelines[5];
+        uint32_t num_timelines = timeline_update(engine, tracks, num_tracks,
+                                                 timelines, 5);
+        engine->callback(timelines, num_timelines, engine->callback_user_data);
+    }
+
+    return true;
+}
+
 void timeline_clear(TimelineEngine* engine) {
     if (!engine) return;
 
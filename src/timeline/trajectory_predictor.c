@@ -19,11 +19,53 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+#define MAX_PREDICTION_STEPS 300     // PredictedTrajectory capacity
+#define SOCIAL_FORCE_RADIUS 100.0f   // Pixels; farther agents do not interact
+#define SOCIAL_GRID_SIDE 64          // Max grid cells per side
+
+/**
+ * Per-step values shared by every trajectory, filled once at init
+ *
+ * Step k lies t[k] ahead: (k + 1) * dt with uniform steps, or wherever the
+ * step schedule puts it. Linear models evaluate x0 + v * t[k] directly
+ * instead of carrying x from step to step. Confidence decays with the
+ * seconds s past the first step, so it follows time, not the step count.
+ */
+typedef struct {
+    uint32_t num_steps;
+    float t[MAX_PREDICTION_STEPS];                  // Seconds ahead
+    float dt[MAX_PREDICTION_STEPS];                 // Seconds since the previous step
+    uint64_t offset_ms[MAX_PREDICTION_STEPS];       // Timestamp offset
+    float confidence_cv[MAX_PREDICTION_STEPS];      // 1 / (1 + 0.1s)
+    float confidence_kalman[MAX_PREDICTION_STEPS];  // 1 / (1 + 0.05s)
+    float confidence_ml[MAX_PREDICTION_STEPS];      // 0.9 / (1 + 0.05s)
+    float confidence_social[MAX_PREDICTION_STEPS];  // 1 / (1 + 0.08s)
+} HorizonTable;
+
+/**
+ * Social force workspace: one entry per agent, struct-of-arrays
+ */
+typedef struct {
+    uint32_t capacity;
+    float* x;
+    float* y;
+    float* vx;
+    float* vy;
+    float* fx;
+    float* fy;
+    uint32_t* cell;                   // Grid cell of each agent
+    uint32_t* order;                  // Agents sorted by cell
+    const TrackedObject** source;
+    PredictedTrajectory** output;     // NULL for neighbours only
+    uint32_t cell_start[SOCIAL_GRID_SIDE * SOCIAL_GRID_SIDE + 1];
+} SocialForceSim;
+
 /**
  * Internal trajectory predictor state
  */
 struct TrajectoryPredictor {
     TrajectoryPredictorConfig config;
+    HorizonTable horizon;
 
     // Statistics
     struct {
@@ -34,24 +76,10 @@ struct TrajectoryPredictor {
 
     // ML model handle (placeholder for TFLite interpreter)
     void* ml_model;
-};
 
-/**
- * Simple Kalman filter for trajectory smoothing
- */
-typedef struct {
-    // State: [x, y, vx, vy]
-    float state[4];
-
-    // Covariance matrix (4x4, stored as 16 elements)
-    float P[16];
-
-    // Process noise
-    float Q[16];
-
-    // Measurement noise
-    float R[4];
-} KalmanFilter;
+    // Social force agents, grown on demand
+    SocialForceSim social;
+};
 
 // ============================================================================
 // Utility Functions
@@ -70,51 +98,104 @@ static float distance(float x1, float y1, float x2, float y2) {
 }
 
 // ============================================================================
-// Kalman Filter Implementation
+// Social Force Workspace
 // ============================================================================
 
-static void kalman_init(KalmanFilter* kf, float x, float y, float vx, float vy) {
-    // Initialize state
-    kf->state[0] = x;
-    kf->state[1] = y;
-    kf->state[2] = vx;
-    kf->state[3] = vy;
-
-    // Initialize covariance (identity * 10)
-    memset(kf->P, 0, sizeof(kf->P));
-    kf->P[0] = kf->P[5] = kf->P[10] = kf->P[15] = 10.0f;
-
-    // Process noise (small, tuned for smooth motion)
-    memset(kf->Q, 0, sizeof(kf->Q));
-    kf->Q[0] = kf->Q[5] = 1.0f;      // Position noise
-    kf->Q[10] = kf->Q[15] = 0.1f;    // Velocity noise
-
-    // Measurement noise
-    kf->R[0] = kf->R[1] = 2.0f;      // Position measurement noise
-    kf->R[2] = kf->R[3] = 0.5f;      // Velocity measurement noise
+static void social_free(SocialForceSim* sim) {
+    free(sim->x);
+    free(sim->y);
+    free(sim->vx);
+    free(sim->vy);
+    free(sim->fx);
+    free(sim->fy);
+    free(sim->cell);
+    free(sim->order);
+    free(sim->source);
+    free(sim->output);
+    sim->x = sim->y = sim->vx = sim->vy = sim->fx = sim->fy = NULL;
+    sim->cell = sim->order = NULL;
+    sim->source = NULL;
+    sim->output = NULL;
+    sim->capacity = 0;
 }
 
-static void kalman_predict(KalmanFilter* kf, float dt) {
-    // State transition: x' = x + vx*dt, y' = y + vy*dt
-    kf->state[0] += kf->state[2] * dt;
-    kf->state[1] += kf->state[3] * dt;
+static bool social_reserve(SocialForceSim* sim, uint32_t num_agents) {
+    if (num_agents <= sim->capacity) {
+        return true;
+    }
 
-    // Update covariance: P' = F*P*F^T + Q
-    // Simplified for constant velocity model
-    for (int i = 0; i < 16; i++) {
-        kf->P[i] += kf->Q[i];
+    uint32_t capacity = (num_agents + 63) & ~63u;
+    social_free(sim);
+
+    sim->x = malloc(capacity * sizeof(float));
+    sim->y = malloc(capacity * sizeof(float));
+    sim->vx = malloc(capacity * sizeof(float));
+    sim->vy = malloc(capacity * sizeof(float));
+    sim->fx = malloc(capacity * sizeof(float));
+    sim->fy = malloc(capacity * sizeof(float));
+    sim->cell = malloc(capacity * sizeof(uint32_t));
+    sim->order = malloc(capacity * sizeof(uint32_t));
+    sim->source = malloc(capacity * sizeof(*sim->source));
+    sim->output = malloc(capacity * sizeof(*sim->output));
+
+    if (!sim->x || !sim->y || !sim->vx || !sim->vy || !sim->fx || !sim->fy ||
+        !sim->cell || !sim->order || !sim->source || !sim->output) {
+        fprintf(stderr, "[TrajPredict] ERROR: Failed to allocate social force agents\n");
+        social_free(sim);
+        return false;
     }
+
+    sim->capacity = capacity;
+    return true;
 }
 
-static void kalman_update(KalmanFilter* kf, float x, float y, float vx, float vy) {
-    // Kalman gain (simplified)
-    float K[4] = {0.3f, 0.3f, 0.2f, 0.2f};  // Tuned values
+/**
+ * Counting-sort agents into a square grid over their bounding box
+ *
+ * Cells are at least SOCIAL_FORCE_RADIUS wide, so every neighbour within
+ * the radius sits in the agent's cell or one of the eight around it.
+ *
+ * @return Cells per side
+ */
+static uint32_t social_bucket(SocialForceSim* sim, uint32_t n) {
+    float min_x = sim->x[0], max_x = sim->x[0];
+    float min_y = sim->y[0], max_y = sim->y[0];
+    for (uint32_t a = 1; a < n; a++) {
+        if (sim->x[a] < min_x) min_x = sim->x[a];
+        if (sim->x[a] > max_x) max_x = sim->x[a];
+        if (sim->y[a] < min_y) min_y = sim->y[a];
+        if (sim->y[a] > max_y) max_y = sim->y[a];
+    }
+
+    float extent = fmaxf(max_x - min_x, max_y - min_y);
+    float cell_size = fmaxf(SOCIAL_FORCE_RADIUS, extent / (SOCIAL_GRID_SIDE - 1));
+    float inv_cell = 1.0f / cell_size;
+    uint32_t side = (uint32_t)fminf(fmaxf(extent * inv_cell, 0.0f), SOCIAL_GRID_SIDE - 1) + 1;
+    uint32_t num_cells = side * side;
+
+    memset(sim->cell_start, 0, (num_cells + 1) * sizeof(uint32_t));
+    for (uint32_t a = 0; a < n; a++) {
+        // fmaxf() sends NaN positions to cell 0
+        uint32_t cx = (uint32_t)fminf(fmaxf((sim->x[a] - min_x) * inv_cell, 0.0f), side - 1);
+        uint32_t cy = (uint32_t)fminf(fmaxf((sim->y[a] - min_y) * inv_cell, 0.0f), side - 1);
+        sim->cell[a] = cy * side + cx;
+        sim->cell_start[sim->cell[a] + 1]++;
+    }
+    for (uint32_t c = 0; c < num_cells; c++) {
+        sim->cell_start[c + 1] += sim->cell_start[c];
+    }
 
-    // Update state with measurement
-    kf->state[0] += K[0] * (x - kf->state[0]);
-    kf->state[1] += K[1] * (y - kf->state[1]);
-    kf->state[2] += K[2] * (vx - kf->state[2]);
-    kf->state[3] += K[3] * (vy - kf->state[3]);
+    // Stable scatter: each cell lists its agents in index order
+    for (uint32_t a = 0; a < n; a++) {
+        uint32_t c = sim->cell[a];
+        sim->order[sim->cell_start[c]++] = a;
+    }
+    for (uint32_t c = num_cells; c > 0; c--) {
+        sim->cell_start[c] = sim->cell_start[c - 1];
+    }
+    sim->cell_start[0] = 0;
+
+    return side;
 }
 
 // ============================================================================
@@ -122,126 +203,263 @@ static void kalman_update(KalmanFilter* kf, float x, float y, float vx, float vy
 // ============================================================================
 
 /**
- * Constant velocity model
- * Simplest model: assumes object continues at current velocity
+ * Step times of a schedule, up to the horizon
+ *
+ * @return false if a segment has no step length
  */
-static void predict_constant_velocity(
+static bool fill_schedule_steps(HorizonTable* horizon, const StepSchedule* schedule,
+                                float horizon_s) {
+    uint64_t horizon_ms = (uint64_t)(horizon_s * 1000.0f);
+    uint64_t elapsed_ms = 0;
+    uint32_t segment = 0;
+    uint32_t num_steps = 0;
+
+    while (num_steps < MAX_PREDICTION_STEPS) {
+        uint32_t step_ms = schedule->segments[segment].step_ms;
+        if (step_ms == 0) {
+            return false;
+        }
+        if (elapsed_ms + step_ms > horizon_ms) {
+            break;
+        }
+
+        elapsed_ms += step_ms;
+        horizon->offset_ms[num_steps] = elapsed_ms;
+        horizon->t[num_steps] = (float)elapsed_ms / 1000.0f;
+        horizon->dt[num_steps] = (float)step_ms / 1000.0f;
+        num_steps++;
+
+        if (segment + 1 < schedule->num_segments &&
+            elapsed_ms >= schedule->segments[segment].end_ms) {
+            segment++;
+        }
+    }
+
+    horizon->num_steps = num_steps;
+    return true;
+}
+
+static bool fill_horizon_table(HorizonTable* horizon, float dt, const StepSchedule* schedule,
+                               float horizon_s) {
+    if (schedule->num_segments > MAX_STEP_SEGMENTS) {
+        return false;
+    }
+
+    if (schedule->num_segments > 0) {
+        if (!fill_schedule_steps(horizon, schedule, horizon_s)) {
+            return false;
+        }
+    } else {
+        uint32_t num_steps = (uint32_t)(horizon_s / dt);
+        horizon->num_steps = num_steps > MAX_PREDICTION_STEPS ? MAX_PREDICTION_STEPS : num_steps;
+        for (uint32_t i = 0; i < MAX_PREDICTION_STEPS; i++) {
+            horizon->t[i] = (i + 1) * dt;
+            horizon->dt[i] = dt;
+            horizon->offset_ms[i] = (uint64_t)((i + 1) * dt * 1000);
+        }
+    }
+
+    for (uint32_t i = 0; i < horizon->num_steps; i++) {
+        float s = horizon->t[i] - horizon->t[0];
+        horizon->confidence_cv[i] = 1.0f / (1.0f + 0.1f * s);  // Decreases with time
+        horizon->confidence_kalman[i] = 1.0f / (1.0f + 0.05f * s);  // Slower decay than CV
+        horizon->confidence_ml[i] = horizon->confidence_kalman[i] * 0.9f;
+        horizon->confidence_social[i] = 1.0f / (1.0f + 0.08f * s);
+    }
+    return true;
+}
+
+/**
+ * Straight-line horizon from the track's current position and velocity
+ *
+ * Every step is independent, so the loop vectorizes across steps.
+ */
+static void predict_linear(
+    const HorizonTable* horizon,
+    const float* confidence,
     const TrackedObject* track,
-    uint32_t num_steps,
-    float dt,
     PredictedState* predictions
 ) {
-    float x = track->box.x + track->box.width / 2;
-    float y = track->box.y + track->box.height / 2;
-    float vx = track->velocity_x;
-    float vy = track->velocity_y;
-
-    for (uint32_t i = 0; i < num_steps; i++) {
-        x += vx * dt;
-        y += vy * dt;
-
-        predictions[i].timestamp_ms = track->last_seen_ms + (uint64_t)((i + 1) * dt * 1000);
-        predictions[i].x = x;
-        predictions[i].y = y;
+    const float x0 = track->current_bbox.x + track->current_bbox.width / 2;
+    const float y0 = track->current_bbox.y + track->current_bbox.height / 2;
+    const float vx = track->velocity_x;
+    const float vy = track->velocity_y;
+    const uint64_t base_ms = track->last_seen_ms;
+    const BehaviorFlags behaviors = track->behaviors;
+    const float threat_score = track->threat_score;
+
+    for (uint32_t i = 0; i < horizon->num_steps; i++) {
+        predictions[i].timestamp_ms = base_ms + horizon->offset_ms[i];
+        predictions[i].x = x0 + vx * horizon->t[i];
+        predictions[i].y = y0 + vy * horizon->t[i];
         predictions[i].vx = vx;
         predictions[i].vy = vy;
-        predictions[i].confidence = 1.0f / (1.0f + 0.1f * i);  // Decreases with time
-        predictions[i].behaviors = track->behaviors;
-        predictions[i].threat_score = track->threat_score;
+        predictions[i].confidence = confidence[i];
+        predictions[i].behaviors = behaviors;
+        predictions[i].threat_score = threat_score;
     }
 }
 
+/**
+ * Constant velocity model
+ * Simplest model: assumes object continues at current velocity
+ */
+static void predict_constant_velocity(
+    const HorizonTable* horizon,
+    const TrackedObject* track,
+    PredictedState* predictions
+) {
+    predict_linear(horizon, horizon->confidence_cv, track, predictions);
+}
+
 /**
  * Kalman filter model
  * Smoother predictions with noise handling
+ *
+ * With no measurements inside the horizon only the predict step runs, and
+ * its transition x' = x + v * dt leaves the velocity unchanged, so the
+ * state at step k is the straight line x0 + v * t[k]. The covariance grows
+ * as P0 + kQ but does not feed the output; the slower confidence decay
+ * stands in for it.
  */
 static void predict_kalman(
+    const HorizonTable* horizon,
     const TrackedObject* track,
-    uint32_t num_steps,
-    float dt,
     PredictedState* predictions
 ) {
-    KalmanFilter kf;
-
-    float x = track->box.x + track->box.width / 2;
-    float y = track->box.y + track->box.height / 2;
-
-    kalman_init(&kf, x, y, track->velocity_x, track->velocity_y);
-
-    for (uint32_t i = 0; i < num_steps; i++) {
-        kalman_predict(&kf, dt);
-
-        predictions[i].timestamp_ms = track->last_seen_ms + (uint64_t)((i + 1) * dt * 1000);
-        predictions[i].x = kf.state[0];
-        predictions[i].y = kf.state[1];
-        predictions[i].vx = kf.state[2];
-        predictions[i].vy = kf.state[3];
-        predictions[i].confidence = 1.0f / (1.0f + 0.05f * i);  // Slower decay than CV
-        predictions[i].behaviors = track->behaviors;
-        predictions[i].threat_score = track->threat_score;
-    }
+    predict_linear(horizon, horizon->confidence_kalman, track, predictions);
 }
 
 /**
  * Social force model
- * Models interactions between objects (attraction/repulsion)
+ * Models interactions between objects (repulsion within a cutoff radius)
+ *
+ * Every track in the scene is an agent and all agents step together, so
+ * neighbours move along their own predicted paths instead of standing
+ * still. Agents only push each other within SOCIAL_FORCE_RADIUS; each
+ * step buckets them into a uniform grid with cells at least that wide,
+ * so an agent visits its 3x3 neighbourhood rather than the whole scene.
+ * State lives in the predictor's struct-of-arrays workspace.
+ *
+ * Targets replace the agent with the same track_id (or join as extra
+ * agents) and their predictions are written to the matching output.
+ *
+ * @return false if the workspace could not grow
  */
-static void predict_social_force(
-    const TrackedObject* track,
+static bool predict_social_force(
+    TrajectoryPredictor* predictor,
+    const TrackedObject* const* targets,
+    uint32_t num_targets,
     const TrackedObject* other_tracks,
     uint32_t num_other_tracks,
-    uint32_t num_steps,
-    float dt,
-    PredictedState* predictions
+    PredictedTrajectory* const* trajectories
 ) {
-    float x = track->box.x + track->box.width / 2;
-    float y = track->box.y + track->box.height / 2;
-    float vx = track->velocity_x;
-    float vy = track->velocity_y;
-
-    for (uint32_t i = 0; i < num_steps; i++) {
-        // Self-propulsion force (goal-directed)
-        float desired_speed = sqrtf(vx*vx + vy*vy);
-        float fx = vx;  // Continue in current direction
-        float fy = vy;
-
-        // Interaction forces with other objects
-        for (uint32_t j = 0; j < num_other_tracks; j++) {
-            if (other_tracks[j].track_id == track->track_id) continue;
+    const HorizonTable* horizon = &predictor->horizon;
+    SocialForceSim* sim = &predictor->social;
+    if (!social_reserve(sim, num_other_tracks + num_targets)) {
+        return false;
+    }
 
-            float ox = other_tracks[j].box.x + other_tracks[j].box.width / 2;
-            float oy = other_tracks[j].box.y + other_tracks[j].box.height / 2;
+    uint32_t n = 0;
+    for (uint32_t j = 0; j < num_other_tracks; j++) {
+        sim->source[n] = &other_tracks[j];
+        sim->output[n] = NULL;
+        n++;
+    }
+    for (uint32_t t = 0; t < num_targets; t++) {
+        uint32_t a = 0;
+        while (a < num_other_tracks && other_tracks[a].track_id != targets[t]->track_id) {
+            a++;
+        }
+        if (a == num_other_tracks) {
+            a = n++;
+        }
+        sim->source[a] = targets[t];
+        sim->output[a] = trajectories[t];
+    }
 
-            float dx = x - ox;
-            float dy = y - oy;
-            float dist = sqrtf(dx*dx + dy*dy);
+    for (uint32_t a = 0; a < n; a++) {
+        const TrackedObject* track = sim->source[a];
+        sim->x[a] = track->current_bbox.x + track->current_bbox.width / 2;
+        sim->y[a] = track->current_bbox.y + track->current_bbox.height / 2;
+        sim->vx[a] = track->velocity_x;
+        sim->vy[a] = track->velocity_y;
+    }
 
-            if (dist < 0.01f) dist = 0.01f;  // Avoid division by zero
+    const float radius_sq = SOCIAL_FORCE_RADIUS * SOCIAL_FORCE_RADIUS;
+
+    for (uint32_t i = 0; i < horizon->num_steps; i++) {
+        uint32_t side = social_bucket(sim, n);
+        const float dt = horizon->dt[i];
+
+        // Velocity relaxes towards the force by 10% per second (0.9 damping
+        // at 1 s steps), so longer steps relax further
+        const float relax = fminf(0.1f * dt, 1.0f);
+        const float keep = 1.0f - relax;
+
+        // Forces from the current positions of every agent
+        for (uint32_t a = 0; a < n; a++) {
+            // Self-propulsion force: continue in current direction
+            float fx = sim->vx[a];
+            float fy = sim->vy[a];
+
+            uint32_t cx = sim->cell[a] % side;
+            uint32_t cy = sim->cell[a] / side;
+            uint32_t x0 = cx > 0 ? cx - 1 : 0;
+            uint32_t y0 = cy > 0 ? cy - 1 : 0;
+            uint32_t x1 = cx + 1 < side ? cx + 1 : cx;
+            uint32_t y1 = cy + 1 < side ? cy + 1 : cy;
+
+            for (uint32_t gy = y0; gy <= y1; gy++) {
+                for (uint32_t gx = x0; gx <= x1; gx++) {
+                    uint32_t c = gy * side + gx;
+                    for (uint32_t k = sim->cell_start[c]; k < sim->cell_start[c + 1]; k++) {
+                        uint32_t b = sim->order[k];
+                        if (b == a) continue;
+
+                        float dx = sim->x[a] - sim->x[b];
+                        float dy = sim->y[a] - sim->y[b];
+                        float dist_sq = dx*dx + dy*dy;
+                        if (!(dist_sq < radius_sq)) continue;
+
+                        float dist = sqrtf(dist_sq);
+                        if (dist < 0.01f) dist = 0.01f;  // Avoid division by zero
+
+                        // Repulsion force (inversely proportional to distance)
+                        float repulsion_strength = 100.0f / (dist * dist);
+                        fx += repulsion_strength * dx / dist;
+                        fy += repulsion_strength * dy / dist;
+                    }
+                }
+            }
 
-            // Repulsion force (inversely proportional to distance)
-            float repulsion_strength = 100.0f / (dist * dist);
-            fx += repulsion_strength * dx / dist;
-            fy += repulsion_strength * dy / dist;
+            sim->fx[a] = fx;
+            sim->fy[a] = fy;
         }
 
-        // Update velocity with forces (damping factor)
-        float damping = 0.9f;
-        vx = damping * vx + 0.1f * fx;
-        vy = damping * vy + 0.1f * fy;
-
-        // Update position
-        x += vx * dt;
-        y += vy * dt;
-
-        predictions[i].timestamp_ms = track->last_seen_ms + (uint64_t)((i + 1) * dt * 1000);
-        predictions[i].x = x;
-        predictions[i].y = y;
-        predictions[i].vx = vx;
-        predictions[i].vy = vy;
-        predictions[i].confidence = 1.0f / (1.0f + 0.08f * i);
-        predictions[i].behaviors = track->behaviors;
-        predictions[i].threat_score = track->threat_score;
+        // Then move everyone at once
+        for (uint32_t a = 0; a < n; a++) {
+            sim->vx[a] = keep * sim->vx[a] + relax * sim->fx[a];
+            sim->vy[a] = keep * sim->vy[a] + relax * sim->fy[a];
+            sim->x[a] += sim->vx[a] * dt;
+            sim->y[a] += sim->vy[a] * dt;
+
+            if (!sim->output[a]) continue;
+
+            const TrackedObject* track = sim->source[a];
+            PredictedState* state = &sim->output[a]->predictions[i];
+            state->timestamp_ms = track->last_seen_ms + horizon->offset_ms[i];
+            state->x = sim->x[a];
+            state->y = sim->y[a];
+            state->vx = sim->vx[a];
+            state->vy = sim->vy[a];
+            state->confidence = horizon->confidence_social[i];
+            state->behaviors = track->behaviors;
+            state->threat_score = track->threat_score;
+        }
     }
+
+    return true;
 }
 
 /**
@@ -252,18 +470,12 @@ static void predict_ml(
     TrajectoryPredictor* predictor,
     const TrackedObject* track,
     const SceneContext* context,
-    uint32_t num_steps,
-    float dt,
     PredictedState* predictions
 ) {
     // TODO: Implement TFLite model inference when ML model is ready
-    // For now, fall back to Kalman filter
-    predict_kalman(track, num_steps, dt, predictions);
-
-    // Adjust confidence based on historical accuracy
-    for (uint32_t i = 0; i < num_steps; i++) {
-        predictions[i].confidence *= 0.9f;  // ML model typically more confident
-    }
+    // For now, fall back to Kalman filter, with confidence adjusted for
+    // historical accuracy
+    predict_linear(&predictor->horizon, predictor->horizon.confidence_ml, track, predictions);
 }
 
 // ============================================================================
@@ -284,6 +496,12 @@ TrajectoryPredictor* trajectory_predictor_init(const TrajectoryPredictorConfig*
 
     // Copy configuration
     memcpy(&predictor->config, config, sizeof(TrajectoryPredictorConfig));
+    if (!fill_horizon_table(&predictor->horizon, config->prediction_step_s,
+                            &config->step_schedule, config->prediction_horizon_s)) {
+        fprintf(stderr, "[TrajPredict] ERROR: Invalid step schedule\n");
+        free(predictor);
+        return NULL;
+    }
 
     // Initialize statistics
     predictor->stats.num_predictions = 0;
@@ -293,8 +511,8 @@ TrajectoryPredictor* trajectory_predictor_init(const TrajectoryPredictorConfig*
     // TODO: Load ML model if configured
     predictor->ml_model = NULL;
 
-    printf("[TrajPredict] Initialized (model=%d, horizon=%.1fs)\n",
-           config->motion_model, config->prediction_horizon_s);
+    printf("[TrajPredict] Initialized (model=%d, horizon=%.1fs, %u steps)\n",
+           config->motion_model, config->prediction_horizon_s, predictor->horizon.num_steps);
 
     return predictor;
 }
@@ -304,10 +522,26 @@ void trajectory_predictor_destroy(TrajectoryPredictor* predictor) {
 
     // TODO: Unload ML model if loaded
 
+    social_free(&predictor->social);
     free(predictor);
 }
 
-bool trajectory_predict_single(
+static void set_overall_confidence(PredictedTrajectory* trajectory) {
+    float sum_confidence = 0.0f;
+    for (uint32_t i = 0; i < trajectory->num_predictions; i++) {
+        sum_confidence += trajectory->predictions[i].confidence;
+    }
+    trajectory->overall_confidence = sum_confidence / trajectory->num_predictions;
+}
+
+/**
+ * Predict one trajectory without touching the statistics
+ *
+ * Only reads the predictor, so several threads may run it at once, except
+ * under the social force model, which simulates in the predictor's
+ * workspace.
+ */
+static bool predict_trajectory(
     TrajectoryPredictor* predictor,
     const TrackedObject* track,
     const TrackedObject* other_tracks,
@@ -315,41 +549,32 @@ bool trajectory_predict_single(
     const SceneContext* context,
     PredictedTrajectory* trajectory
 ) {
-    if (!predictor || !track || !trajectory) {
-        fprintf(stderr, "[TrajPredict] ERROR: NULL parameter\n");
-        return false;
-    }
-
-    // Calculate number of prediction steps
-    float dt = predictor->config.prediction_step_s;
-    uint32_t num_steps = (uint32_t)(predictor->config.prediction_horizon_s / dt);
-    if (num_steps > 300) num_steps = 300;  // Safety limit
+    const HorizonTable* horizon = &predictor->horizon;
 
     trajectory->track_id = track->track_id;
-    trajectory->num_predictions = num_steps;
+    trajectory->num_predictions = horizon->num_steps;
 
     // Choose motion model
     switch (predictor->config.motion_model) {
-        case MOTION_MODEL_CONSTANT_VELOCITY:
-            predict_constant_velocity(track, num_steps, dt, trajectory->predictions);
+        case MOTION_CONSTANT_VELOCITY:
+            predict_constant_velocity(horizon, track, trajectory->predictions);
             break;
 
-        case MOTION_MODEL_KALMAN:
-            predict_kalman(track, num_steps, dt, trajectory->predictions);
+        case MOTION_KALMAN_FILTER:
+            predict_kalman(horizon, track, trajectory->predictions);
             break;
 
-        case MOTION_MODEL_SOCIAL_FORCE:
-            if (other_tracks && num_other_tracks > 0) {
-                predict_social_force(track, other_tracks, num_other_tracks,
-                                   num_steps, dt, trajectory->predictions);
-            } else {
+        case MOTION_SOCIAL_FORCE:
+            if (!other_tracks || num_other_tracks == 0 ||
+                !predict_social_force(predictor, &track, 1, other_tracks, num_other_tracks,
+                                      &trajectory)) {
                 // Fall back to Kalman if no other tracks
-                predict_kalman(track, num_steps, dt, trajectory->predictions);
+                predict_kalman(horizon, track, trajectory->predictions);
             }
             break;
 
-        case MOTION_MODEL_ML:
-            predict_ml(predictor, track, context, num_steps, dt, trajectory->predictions);
+        case MOTION_ML_MODEL:
+            predict_ml(predictor, track, context, trajectory->predictions);
             break;
 
         default:
@@ -358,22 +583,138 @@ bool trajectory_predict_single(
             return false;
     }
 
-    // Calculate overall confidence
-    float sum_confidence = 0.0f;
-    for (uint32_t i = 0; i < num_steps; i++) {
-        sum_confidence += trajectory->predictions[i].confidence;
-    }
-    trajectory->overall_confidence = sum_confidence / num_steps;
+    set_overall_confidence(trajectory);
+    return true;
+}
 
-    // Update statistics
+static void record_prediction(TrajectoryPredictor* predictor, const PredictedTrajectory* trajectory) {
     predictor->stats.num_predictions++;
     predictor->stats.avg_confidence =
         (predictor->stats.avg_confidence * (predictor->stats.num_predictions - 1) +
          trajectory->overall_confidence) / predictor->stats.num_predictions;
+}
 
+bool trajectory_predict_single(
+    TrajectoryPredictor* predictor,
+    const TrackedObject* track,
+    const TrackedObject* other_tracks,
+    uint32_t num_other_tracks,
+    const SceneContext* context,
+    PredictedTrajectory* trajectory
+) {
+    if (!predictor || !track || !trajectory) {
+        fprintf(stderr, "[TrajPredict] ERROR: NULL parameter\n");
+        return false;
+    }
+
+    if (!predict_trajectory(predictor, track, other_tracks, num_other_tracks,
+                            context, trajectory)) {
+        return false;
+    }
+
+    record_prediction(predictor, trajectory);
     return true;
 }
 
+/**
+ * Shared state of one trajectory_predict_batch() run
+ */
+typedef struct {
+    TrajectoryPredictor* predictor;
+    const TrackedObject* const* targets;
+    const TrackedObject* other_tracks;
+    uint32_t num_other_tracks;
+    const SceneContext* context;
+    PredictedTrajectory* const* trajectories;
+    bool* ok;
+} BatchJob;
+
+static void predict_batch_task(void* context, uint32_t task) {
+    BatchJob* job = context;
+    job->ok[task] = predict_trajectory(job->predictor, job->targets[task],
+                                       job->other_tracks, job->num_other_tracks,
+                                       job->context, job->trajectories[task]);
+}
+
+/**
+ * Whole batch as one social force simulation
+ *
+ * Targets interact with each other, so the batch is not sharded; the
+ * grid keeps the joint step cheap instead.
+ */
+static void predict_batch_social(
+    TrajectoryPredictor* predictor,
+    const TrackedObject* const* targets,
+    uint32_t num_targets,
+    const TrackedObject* other_tracks,
+    uint32_t num_other_tracks,
+    PredictedTrajectory* const* trajectories,
+    bool* ok
+) {
+    const HorizonTable* horizon = &predictor->horizon;
+
+    for (uint32_t t = 0; t < num_targets; t++) {
+        trajectories[t]->track_id = targets[t]->track_id;
+        trajectories[t]->num_predictions = horizon->num_steps;
+    }
+
+    bool simulated = predict_social_force(predictor, targets, num_targets,
+                                          other_tracks, num_other_tracks, trajectories);
+
+    for (uint32_t t = 0; t < num_targets; t++) {
+        if (!simulated) {
+            predict_kalman(horizon, targets[t], trajectories[t]->predictions);
+        }
+        set_overall_confidence(trajectories[t]);
+        ok[t] = true;
+    }
+}
+
+uint32_t trajectory_predict_batch(
+    TrajectoryPredictor* predictor,
+    const TrackedObject* const* targets,
+    uint32_t num_targets,
+    const TrackedObject* other_tracks,
+    uint32_t num_other_tracks,
+    const SceneContext* context,
+    PredictedTrajectory* const* trajectories,
+    bool* ok,
+    WorkerPool* pool
+) {
+    if (!predictor || !targets || !trajectories || !ok) {
+        fprintf(stderr, "[TrajPredict] ERROR: NULL parameter\n");
+        return 0;
+    }
+
+    if (predictor->config.motion_model == MOTION_SOCIAL_FORCE &&
+        other_tracks && num_other_tracks > 0) {
+        predict_batch_social(predictor, targets, num_targets, other_tracks,
+                             num_other_tracks, trajectories, ok);
+    } else {
+        BatchJob job = {
+            .predictor = predictor,
+            .targets = targets,
+            .other_tracks = other_tracks,
+            .num_other_tracks = num_other_tracks,
+            .context = context,
+            .trajectories = trajectories,
+            .ok = ok
+        };
+        worker_pool_run(pool, num_targets, predict_batch_task, &job);
+    }
+
+    // Statistics in target order, as sequential calls would leave them
+    uint32_t num_predicted = 0;
+    for (uint32_t i = 0; i < num_targets; i++) {
+        if (ok[i]) {
+            record_prediction(predictor, trajectories[i]);
+            num_predicted++;
+        }
+    }
+
+    return num_predicted;
+}
+
 uint32_t trajectory_predict_branches(
     TrajectoryPredictor* predictor,
     const TrackedObject* track,
@@ -545,6 +886,43 @@ float trajectory_calculate_time_to_location(
     return -1.0f;
 }
 
+float trajectory_similarity(
+    const PredictedTrajectory* traj1,
+    const PredictedTrajectory* traj2
+) {
+    if (!traj1 || !traj2) {
+        return 0.0f;
+    }
+
+    uint32_t num_steps = traj1->num_predictions < traj2->num_predictions ?
+                        traj1->num_predictions : traj2->num_predictions;
+    if (num_steps == 0) {
+        return 0.0f;
+    }
+
+    // Mean separation relative to mean distance travelled, so the score
+    // does not depend on the coordinate scale: paths 20 degrees apart
+    // score ~0.74 at any speed, identical paths 1.0
+    float x0 = (traj1->predictions[0].x + traj2->predictions[0].x) / 2;
+    float y0 = (traj1->predictions[0].y + traj2->predictions[0].y) / 2;
+    float sum_separation = 0.0f;
+    float sum_travel = 0.0f;
+
+    for (uint32_t i = 0; i < num_steps; i++) {
+        const PredictedState* s1 = &traj1->predictions[i];
+        const PredictedState* s2 = &traj2->predictions[i];
+
+        sum_separation += distance(s1->x, s1->y, s2->x, s2->y);
+        sum_travel += distance(x0, y0, (s1->x + s2->x) / 2, (s1->y + s2->y) / 2);
+    }
+
+    if (sum_separation <= 1e-6f) {
+        return 1.0f;
+    }
+
+    return clamp(1.0f - sum_separation / (sum_separation + sum_travel), 0.0f, 1.0f);
+}
+
 void trajectory_predictor_get_stats(
     const TrajectoryPredictor* predictor,
     uint64_t* num_predictions,
@@ -557,3 +935,13 @@ void trajectory_predictor_get_stats(
     if (num_branches) *num_branches = predictor->stats.num_branches;
     if (avg_confidence) *avg_confidence = predictor->stats.avg_confidence;
 }
+
+uint32_t trajectory_predictor_get_steps(
+    const TrajectoryPredictor* predictor,
+    const uint64_t** offset_ms
+) {
+    if (!predictor) return 0;
+
+    if (offset_ms) *offset_ms = predictor->horizon.offset_ms;
+    return predictor->horizon.num_steps;
+}
@@ -14,6 +14,7 @@
 
 #include "../perception/perception.h"
 #include "timeline.h"
+#include "worker_pool.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -22,6 +23,7 @@ extern "C" {
 #endif
 
 typedef struct TrajectoryPredictor TrajectoryPredictor;
+typedef struct SceneContext SceneContext;  // event_predictor.h (which includes this header)
 
 /**
  * Motion model types
@@ -38,13 +40,12 @@ typedef enum {
  * Trajectory predictor configuration
  */
 typedef struct {
-    MotionModel model;           // Motion model to use
-    uint32_t history_length;     // Frames of history to use
-    float uncertainty_growth;    // How fast uncertainty grows
-    bool consider_interactions;  // Model object interactions
-    bool consider_boundaries;    // Consider scene boundaries
-    const char* ml_model_path;   // Path to ML model (if using)
-} TrajectoryConfig;
+    MotionModel motion_model;    // Motion model to use
+    float prediction_horizon_s;  // How far to predict
+    float prediction_step_s;     // Step size when step_schedule is empty
+    uint32_t max_branch_depth;   // Branching limit (trajectory_predict_branches)
+    StepSchedule step_schedule;  // Non-uniform steps (num_ranges = 0: uniform)
+} TrajectoryPredictorConfig;
 
 /**
  * Complete predicted trajectory for one object
@@ -52,7 +53,7 @@ typedef struct {
 typedef struct {
     uint32_t track_id;              // Track being predicted
     uint32_t num_predictions;       // Number of future states
-    PredictedState predictions[300]; // Future states (5min @ 1s intervals)
+    PredictedState predictions[300]; // Future states (5min @ 1s intervals, or a step schedule)
     float overall_confidence;       // Overall trajectory confidence
 } PredictedTrajectory;
 
@@ -62,74 +63,84 @@ typedef struct {
  * @param config Predictor configuration
  * @return Predictor instance, NULL on failure
  */
-TrajectoryPredictor* trajectory_predictor_init(const TrajectoryConfig* config);
+TrajectoryPredictor* trajectory_predictor_init(const TrajectoryPredictorConfig* config);
 
 /**
  * Predict trajectory for a single tracked object
  *
+ * Steps follow the predictor's horizon (see trajectory_predictor_get_steps()).
+ *
  * @param predictor Predictor instance
  * @param track Tracked object
- * @param history Previous positions (optional, can be NULL)
- * @param history_length Number of history entries
- * @param prediction_horizon_ms How far to predict
- * @param time_step_ms Prediction granularity
+ * @param other_tracks All current tracks (for interactions, may be NULL)
+ * @param num_other_tracks Number of other tracks
+ * @param context Scene context (may be NULL)
  * @param trajectory Output predicted trajectory
  * @return true on success
  */
 bool trajectory_predict_single(
     TrajectoryPredictor* predictor,
     const TrackedObject* track,
-    const TrackedObject* history,
-    uint32_t history_length,
-    uint32_t prediction_horizon_ms,
-    uint32_t time_step_ms,
+    const TrackedObject* other_tracks,
+    uint32_t num_other_tracks,
+    const SceneContext* context,
     PredictedTrajectory* trajectory
 );
 
 /**
- * Predict trajectories for multiple objects (considers interactions)
+ * Predict trajectories for a set of tracks, sharded across a worker pool
+ *
+ * Each target is predicted as by trajectory_predict_single() against the
+ * same other_tracks. Results and statistics are identical for any number
+ * of threads. The social force model steps all tracks in one simulation
+ * on the calling thread instead, since every agent affects the others.
  *
  * @param predictor Predictor instance
- * @param tracks Current tracked objects
- * @param num_tracks Number of tracks
- * @param prediction_horizon_ms How far to predict
- * @param time_step_ms Prediction granularity
- * @param trajectories Output array for trajectories
- * @param max_trajectories Maximum trajectories to return
- * @return Number of trajectories generated
+ * @param targets Tracks to predict
+ * @param num_targets Number of targets
+ * @param other_tracks All current tracks (for interactions)
+ * @param num_other_tracks Number of other tracks
+ * @param context Scene context (may be NULL)
+ * @param trajectories Output trajectory per target
+ * @param ok Output per target: true if predicted
+ * @param pool Worker pool (NULL = on the calling thread)
+ * @return Number of trajectories predicted
  */
-uint32_t trajectory_predict_multiple(
+uint32_t trajectory_predict_batch(
     TrajectoryPredictor* predictor,
-    const TrackedObject* tracks,
-    uint32_t num_tracks,
-    uint32_t prediction_horizon_ms,
-    uint32_t time_step_ms,
-    PredictedTrajectory* trajectories,
-    uint32_t max_trajectories
+    const TrackedObject* const* targets,
+    uint32_t num_targets,
+    const TrackedObject* other_tracks,
+    uint32_t num_other_tracks,
+    const SceneContext* context,
+    PredictedTrajectory* const* trajectories,
+    bool* ok,
+    WorkerPool* pool
 );
 
 /**
  * Predict multiple possible trajectories (branching scenarios)
  *
- * Generates alternative futures based on uncertainty and decisions
+ * Branch 0 is the most likely trajectory; the others turn the track's
+ * heading in 20 degree steps, with lower confidence.
  *
  * @param predictor Predictor instance
  * @param track Tracked object
  * @param num_branches Number of alternative trajectories
- * @param prediction_horizon_ms How far to predict
- * @param time_step_ms Prediction granularity
+ * @param other_tracks All current tracks (for interactions, may be NULL)
+ * @param num_other_tracks Number of other tracks
+ * @param context Scene context (may be NULL)
  * @param trajectories Output array for alternative trajectories
- * @param probabilities Probability of each trajectory
  * @return Number of trajectories generated
  */
 uint32_t trajectory_predict_branches(
     TrajectoryPredictor* predictor,
     const TrackedObject* track,
     uint32_t num_branches,
-    uint32_t prediction_horizon_ms,
-    uint32_t time_step_ms,
-    PredictedTrajectory* trajectories,
-    float* probabilities
+    const TrackedObject* other_tracks,
+    uint32_t num_other_tracks,
+    const SceneContext* context,
+    PredictedTrajectory* trajectories
 );
 
 /**
@@ -137,37 +148,55 @@ uint32_t trajectory_predict_branches(
  *
  * @param traj1 First trajectory
  * @param traj2 Second trajectory
- * @param collision_threshold Distance threshold for collision
- * @param collision_time Output time of collision (ms from now)
- * @param collision_probability Output probability of collision
+ * @param collision_distance Distance threshold for collision
+ * @param collision_time_ms Output timestamp of collision (may be NULL)
+ * @param collision_x Output collision X (may be NULL)
+ * @param collision_y Output collision Y (may be NULL)
  * @return true if collision predicted
  */
 bool trajectory_detect_collision(
     const PredictedTrajectory* traj1,
     const PredictedTrajectory* traj2,
-    float collision_threshold,
-    uint64_t* collision_time,
-    float* collision_probability
+    float collision_distance,
+    uint64_t* collision_time_ms,
+    float* collision_x,
+    float* collision_y
 );
 
 /**
  * Detect if trajectory enters a zone
  *
  * @param trajectory Predicted trajectory
- * @param zone_x Zone center X (normalized)
- * @param zone_y Zone center Y (normalized)
- * @param zone_radius Zone radius (normalized)
- * @param entry_time Output time of zone entry (ms from now)
- * @param entry_probability Output probability of entry
+ * @param zone_x Zone center X
+ * @param zone_y Zone center Y
+ * @param zone_radius Zone radius
+ * @param entry_time_ms Output timestamp of zone entry (may be NULL)
+ * @param entry_confidence Output confidence at entry (may be NULL)
  * @return true if zone entry predicted
  */
-bool trajectory_detect_zone_entry(
+bool trajectory_check_zone_entry(
     const PredictedTrajectory* trajectory,
     float zone_x,
     float zone_y,
     float zone_radius,
-    uint64_t* entry_time,
-    float* entry_probability
+    uint64_t* entry_time_ms,
+    float* entry_confidence
+);
+
+/**
+ * Time until a trajectory comes closest to a location
+ *
+ * @param trajectory Predicted trajectory
+ * @param target_x Target X
+ * @param target_y Target Y
+ * @param proximity_threshold Distance that counts as reaching the target
+ * @return Seconds until the target is reached, -1.0 if never
+ */
+float trajectory_calculate_time_to_location(
+    const PredictedTrajectory* trajectory,
+    float target_x,
+    float target_y,
+    float proximity_threshold
 );
 
 /**
@@ -182,6 +211,37 @@ float trajectory_similarity(
     const PredictedTrajectory* traj2
 );
 
+/**
+ * Get predictor statistics
+ *
+ * @param predictor Predictor instance
+ * @param num_predictions Output trajectories predicted (may be NULL)
+ * @param num_branches Output branches predicted (may be NULL)
+ * @param avg_confidence Output average trajectory confidence (may be NULL)
+ */
+void trajectory_predictor_get_stats(
+    const TrajectoryPredictor* predictor,
+    uint64_t* num_predictions,
+    uint64_t* num_branches,
+    float* avg_confidence
+);
+
+/**
+ * Prediction steps of every trajectory
+ *
+ * Step k of a trajectory lies offset_ms[k] after the track's last_seen_ms.
+ * Uniform steps unless the predictor was given a step schedule.
+ *
+ * @param predictor Predictor instance
+ * @param offset_ms Output: lookahead of each step, ascending (owned by the
+ *                  predictor)
+ * @return Number of steps
+ */
+uint32_t trajectory_predictor_get_steps(
+    const TrajectoryPredictor* predictor,
+    const uint64_t** offset_ms
+);
+
 /**
  * Destroy trajectory predictor
  *
@@ -0,0 +1,166 @@
+/**
+ * @file worker_pool.c
+ * @brief Fixed worker pool for sharding timeline prediction
+ *
+ * Helpers sleep on a condition variable until a run bumps the generation.
+ * Everyone, the caller included, then claims task indices from an atomic
+ * counter until they run out; the last helper to finish signals the
+ * caller. Run parameters are published under the mutex and task outputs
+ * become visible to the caller through the same mutex.
+ */
+
+#include "worker_pool.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+struct WorkerPool {
+    pthread_t threads[WORKER_POOL_MAX_THREADS];
+    uint32_t num_helpers;        // Threads besides the caller
+
+    pthread_mutex_t mutex;
+    pthread_cond_t start;        // Signalled when a run begins
+    pthread_cond_t finished;     // Signalled when the last helper is done
+    uint64_t generation;         // Runs started
+    uint32_t active;             // Helpers still working on this run
+    bool stopping;
+
+    // Current run
+    WorkerTask task;
+    void* context;
+    uint32_t num_tasks;
+    atomic_uint next_task;
+};
+
+static void run_tasks(WorkerPool* pool) {
+    for (;;) {
+        uint32_t t = atomic_fetch_add_explicit(&pool->next_task, 1, memory_order_relaxed);
+        if (t >= pool->num_tasks) {
+            return;
+        }
+        pool->task(pool->context, t);
+    }
+}
+
+static void* worker_main(void* arg) {
+    WorkerPool* pool = arg;
+    uint64_t seen = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        while (!pool->stopping && pool->generation == seen) {
+            pthread_cond_wait(&pool->start, &pool->mutex);
+        }
+        if (pool->stopping) {
+            break;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->mutex);
+
+        run_tasks(pool);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->active == 0) {
+            pthread_cond_signal(&pool->finished);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+WorkerPool* worker_pool_create(uint32_t num_threads) {
+    if (num_threads == 0) {
+        num_threads = 1;
+    }
+    if (num_threads > WORKER_POOL_MAX_THREADS) {
+        num_threads = WORKER_POOL_MAX_THREADS;
+    }
+
+    WorkerPool* pool = calloc(1, sizeof(WorkerPool));
+    if (!pool) {
+        fprintf(stderr, "[WorkerPool] ERROR: Failed to allocate memory\n");
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->finished, NULL);
+    atomic_init(&pool->next_task, 0);
+
+    for (uint32_t i = 0; i + 1 < num_threads; i++) {
+        if (pthread_create(&pool->threads[i], NULL, worker_main, pool) != 0) {
+            fprintf(stderr, "[WorkerPool] ERROR: Failed to start thread %u\n", i);
+            worker_pool_destroy(pool);
+            return NULL;
+        }
+        pool->num_helpers++;
+    }
+
+    return pool;
+}
+
+uint32_t worker_pool_default_threads(uint32_t reserved_cores) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    if (online <= (long)reserved_cores) {
+        return 1;
+    }
+
+    uint32_t threads = (uint32_t)(online - reserved_cores);
+    return threads < WORKER_POOL_MAX_THREADS ? threads : WORKER_POOL_MAX_THREADS;
+}
+
+void worker_pool_run(WorkerPool* pool, uint32_t num_tasks, WorkerTask task, void* context) {
+    if (!task || num_tasks == 0) {
+        return;
+    }
+
+    if (!pool || pool->num_helpers == 0 || num_tasks == 1) {
+        for (uint32_t t = 0; t < num_tasks; t++) {
+            task(context, t);
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->task = task;
+    pool->context = context;
+    pool->num_tasks = num_tasks;
+    atomic_store_explicit(&pool->next_task, 0, memory_order_relaxed);
+    pool->active = pool->num_helpers;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mutex);
+
+    run_tasks(pool);
+
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->active > 0) {
+        pthread_cond_wait(&pool->finished, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+uint32_t worker_pool_num_threads(const WorkerPool* pool) {
+    return pool ? pool->num_helpers + 1 : 1;
+}
+
+void worker_pool_destroy(WorkerPool* pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (uint32_t i = 0; i < pool->num_helpers; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&pool->finished);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool);
+}
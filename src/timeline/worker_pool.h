@@ -0,0 +1,86 @@
+/**
+ * @file worker_pool.h
+ * @brief Fixed worker pool for sharding timeline prediction
+ *
+ * A run hands out task indices [0, num_tasks) to the pool's threads and
+ * the calling thread, and returns once every task has finished. Tasks
+ * are claimed from a shared counter, so uneven tasks balance themselves.
+ * Results stay deterministic as long as each task writes only its own
+ * outputs and the caller merges them in task order.
+ *
+ * Threads are created once; a run takes no locks per task and does not
+ * allocate.
+ */
+
+#ifndef OMNISIGHT_WORKER_POOL_H
+#define OMNISIGHT_WORKER_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WORKER_POOL_MAX_THREADS 16
+
+typedef struct WorkerPool WorkerPool;
+
+/**
+ * Task body
+ *
+ * @param context Caller's context
+ * @param task Task index in [0, num_tasks)
+ */
+typedef void (*WorkerTask)(void* context, uint32_t task);
+
+/**
+ * Create a pool
+ *
+ * @param num_threads Threads working on a run, the caller included
+ *                    (1 = run inline, capped at WORKER_POOL_MAX_THREADS)
+ * @return Pool instance, NULL on failure
+ */
+WorkerPool* worker_pool_create(uint32_t num_threads);
+
+/**
+ * Threads left when some cores are reserved for other work
+ *
+ * @param reserved_cores Cores kept for other threads (e.g. perception)
+ * @return Online cores minus reserved_cores, at least 1
+ */
+uint32_t worker_pool_default_threads(uint32_t reserved_cores);
+
+/**
+ * Run tasks [0, num_tasks) and wait for all of them
+ *
+ * Runs inline on the caller when pool is NULL. One run at a time; tasks
+ * must not start runs on the same pool.
+ *
+ * @param pool Pool instance (may be NULL)
+ * @param num_tasks Number of tasks
+ * @param task Task body
+ * @param context Passed to every task
+ */
+void worker_pool_run(WorkerPool* pool, uint32_t num_tasks, WorkerTask task, void* context);
+
+/**
+ * Threads working on a run, the caller included
+ *
+ * @param pool Pool instance (may be NULL)
+ * @return Thread count, 1 for a NULL pool
+ */
+uint32_t worker_pool_num_threads(const WorkerPool* pool);
+
+/**
+ * Stop the threads and destroy the pool
+ *
+ * @param pool Pool instance
+ */
+void worker_pool_destroy(WorkerPool* pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OMNISIGHT_WORKER_POOL_H
@@ -0,0 +1,389 @@
+/**
+ * @file bench_perception.c
+ * @brief Micro-benchmarks for OMNISIGHT perception hot paths
+ *
+ * Build and run:
+ *   cd tests
+ *   gcc -O3 -o bench_perception bench_perception.c \
+ *       ../src/perception/kalman_batch.c \
+ *       ../src/perception/motion_estimator.c \
+ *       ../src/perception/behavior.c \
+ *       ../src/perception/behavior_analysis.c \
+ *       ../src/perception/behavior_batch.c \
+ *       ../src/perception/track_index.c \
+ *       ../src/perception/track_summary.c \
+ *       ../src/perception/zone_map.c \
+ *       ../src/perception/occupancy_grid.c \
+ *       ../src/perception/group_analyzer.c \
+ *       -I../src/perception -lm -lpthread
+ *   ./bench_perception
+ */
+
+#include "../src/perception/kalman_batch.h"
+#include "../src/perception/motion_estimator.h"
+#include "../src/perception/behavior.h"
+#include "../src/perception/behavior_analysis.h"
+#include "../src/perception/behavior_batch.h"
+#include "../src/perception/occupancy_grid.h"
+#include "../src/perception/group_analyzer.h"
+#include "kalman_dense_reference.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_FRAMES 1000
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static KalmanBatchConfig bench_kalman_config(void) {
+    KalmanBatchConfig config;
+
+    for (int c = 0; c < KALMAN_BATCH_CHANNELS; c++) {
+        config.process_noise_pos[c] = 1e-5f;
+        config.process_noise_vel[c] = (c < 2) ? 1e-5f : 0.0f;
+        config.measurement_noise[c] = 1e-4f;
+        config.initial_pos_variance[c] = 10.0f;
+        config.initial_vel_variance[c] = (c < 2) ? 10.0f : 0.0f;
+    }
+
+    return config;
+}
+
+// ============================================================================
+// Kalman: dense per-track vs batched SoA
+// ============================================================================
+
+static void bench_kalman(uint32_t num_tracks) {
+    KalmanBatchConfig config = bench_kalman_config();
+    float (*z)[4] = malloc(num_tracks * sizeof(*z));
+    DenseKalman* dense = malloc(num_tracks * sizeof(DenseKalman));
+    KalmanBatch* batch = kalman_batch_init(num_tracks, &config);
+
+    if (!z || !dense || !batch) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+
+    for (uint32_t t = 0; t < num_tracks; t++) {
+        z[t][0] = (float)rand() / RAND_MAX;
+        z[t][1] = (float)rand() / RAND_MAX;
+        z[t][2] = 0.1f;
+        z[t][3] = 0.2f;
+        dense_kalman_init(&dense[t], &config, z[t]);
+        kalman_batch_init_slot(batch, t, z[t]);
+    }
+
+    double start = now_ns();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        for (uint32_t t = 0; t < num_tracks; t++) {
+            z[t][0] += 0.001f;
+            dense_kalman_predict(&dense[t], 1.0f);
+            dense_kalman_update(&dense[t], z[t]);
+        }
+    }
+    double dense_ns = (now_ns() - start) / ((double)BENCH_FRAMES * num_tracks);
+
+    start = now_ns();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        kalman_batch_predict(batch, 1.0f);
+        for (uint32_t t = 0; t < num_tracks; t++) {
+            z[t][0] += 0.001f;
+            kalman_batch_set_measurement(batch, t, z[t]);
+        }
+        kalman_batch_update(batch);
+    }
+    double batch_ns = (now_ns() - start) / ((double)BENCH_FRAMES * num_tracks);
+
+    // Keep results observable so the loops are not optimized away
+    float pos[KALMAN_BATCH_CHANNELS];
+    kalman_batch_get_state(batch, 0, pos, NULL);
+    volatile float sink = pos[0] + dense[0].x[0];
+    (void)sink;
+
+    printf("  %5u tracks: dense %8.1f ns/track  batched %6.1f ns/track  (%5.1fx)\n",
+           num_tracks, dense_ns, batch_ns, dense_ns / batch_ns);
+
+    kalman_batch_destroy(batch);
+    free(dense);
+    free(z);
+}
+
+// ============================================================================
+// Camera motion: phase correlation per frame
+// ============================================================================
+
+static void bench_motion_estimator(uint32_t width, uint32_t height) {
+    uint8_t* frames[2];
+    for (int f = 0; f < 2; f++) {
+        frames[f] = malloc((size_t)width * height);
+        if (!frames[f]) {
+            fprintf(stderr, "allocation failed\n");
+            exit(1);
+        }
+        for (uint32_t y = 0; y < height; y++) {
+            for (uint32_t x = 0; x < width; x++) {
+                frames[f][(size_t)y * width + x] = (uint8_t)((x * 7 + y * 13 + f * 21) ^ (x * y));
+            }
+        }
+    }
+
+    MotionEstimator* estimator = motion_estimator_init(0.0f);
+    CameraMotion motion;
+
+    for (int i = 0; i < 200; i++) {
+        motion_estimator_process_luma(estimator, frames[i & 1], width, height, width, &motion);
+    }
+
+    MotionEstimatorStats stats;
+    motion_estimator_get_stats(estimator, &stats);
+    printf("  %4ux%-4u: avg %.3f ms/frame  max %.3f ms\n",
+           width, height, stats.avg_ms, stats.max_ms);
+
+    motion_estimator_destroy(estimator);
+    free(frames[0]);
+    free(frames[1]);
+}
+
+// ============================================================================
+// Behavior analysis: per-frame cost with full history windows
+// ============================================================================
+
+static void bench_behavior(uint32_t num_tracks) {
+    BehaviorConfig config = {
+        .loitering_threshold_ms = 30000,
+        .loitering_movement_threshold = 0.05f,
+        .running_velocity_threshold = 50.0f,
+        .running_frames_threshold = 5,
+        .repeated_passes_count = 3,
+        .repeated_passes_window_ms = 60000,
+        .loitering_weight = 0.3f,
+        .running_weight = 0.5f,
+        .repeated_passes_weight = 0.4f,
+        .max_tracks = num_tracks
+    };
+    BehaviorAnalyzerConfig analysis_config = {
+        .loitering_dwell_time_ms = 30000,
+        .loitering_velocity_threshold = 0.5f,
+        .loitering_radius_meters = 2.0f,
+        .running_velocity_threshold = 3.0f,
+        .running_duration_ms = 1000,
+        .zigzag_threshold = 45.0f,
+        .zigzag_count_threshold = 5,
+        .max_tracks = num_tracks,
+        .meters_per_normalized_unit = 10.0f,
+        .weight_loitering = 0.3f,
+        .weight_running = 0.4f,
+        .weight_unusual_movement = 0.5f,
+        .weight_dwell_time = 0.2f
+    };
+
+    BehaviorBatchConfig batch_config = {
+        .rules = BEHAVIOR_RULES_BASIC,
+        .basic = config,
+        .trajectory = analysis_config
+    };
+
+    BehaviorAnalyzer* behavior = behavior_init(&config);
+    BehaviorAnalyzer* analysis = behavior_analyzer_init(&analysis_config);
+    BehaviorBatch* batch_basic = behavior_batch_create(&batch_config);
+    batch_config.rules = BEHAVIOR_RULES_TRAJECTORY;
+    BehaviorBatch* batch_trajectory = behavior_batch_create(&batch_config);
+    TrackedObject* tracks = calloc(num_tracks, sizeof(TrackedObject));
+
+    if (!behavior || !analysis || !batch_basic || !batch_trajectory || !tracks) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+
+    for (uint32_t t = 0; t < num_tracks; t++) {
+        tracks[t].track_id = t + 1;
+        tracks[t].current_bbox = (BoundingBox){(float)rand() / RAND_MAX, (float)rand() / RAND_MAX, 0.05f, 0.1f};
+    }
+
+    // Warm up so every history window is full
+    double behavior_ns = 0.0;
+    double analysis_ns = 0.0;
+    double batch_basic_ns = 0.0;
+    double batch_trajectory_ns = 0.0;
+    int warmup = 200;
+
+    for (int frame = 0; frame < warmup + BENCH_FRAMES; frame++) {
+        uint64_t now_ms = (uint64_t)frame * 100;
+        for (uint32_t t = 0; t < num_tracks; t++) {
+            tracks[t].current_bbox.x += 0.002f * ((float)rand() / RAND_MAX - 0.5f);
+            tracks[t].current_bbox.y += 0.002f * ((float)rand() / RAND_MAX - 0.5f);
+            tracks[t].last_seen_ms = now_ms;
+        }
+
+        double start = now_ns();
+        behavior_analyze(behavior, tracks, num_tracks);
+        double mid = now_ns();
+        for (uint32_t t = 0; t < num_tracks; t++) {
+            behavior_analyzer_update_history(analysis, tracks[t].track_id,
+                                             &tracks[t].current_bbox, now_ms);
+            behavior_analyzer_analyze(analysis, &tracks[t]);
+        }
+        double end = now_ns();
+        behavior_batch_analyze(batch_basic, tracks, num_tracks);
+        double batch_mid = now_ns();
+        behavior_batch_analyze(batch_trajectory, tracks, num_tracks);
+        double batch_end = now_ns();
+
+        if (frame >= warmup) {
+            behavior_ns += mid - start;
+            analysis_ns += end - mid;
+            batch_basic_ns += batch_mid - end;
+            batch_trajectory_ns += batch_end - batch_mid;
+        }
+    }
+
+    double per_track = (double)BENCH_FRAMES * num_tracks;
+    printf("  %5u tracks: behavior.c %6.1f ns/track  behavior_analysis.c %6.1f ns/track  (%.3f / %.3f ms/frame)\n",
+           num_tracks,
+           behavior_ns / per_track,
+           analysis_ns / per_track,
+           behavior_ns / BENCH_FRAMES / 1e6,
+           analysis_ns / BENCH_FRAMES / 1e6);
+    printf("  %5u tracks: batch basic %6.1f ns/track  batch trajectory %6.1f ns/track  (%.3f / %.3f ms/frame)\n",
+           num_tracks,
+           batch_basic_ns / per_track,
+           batch_trajectory_ns / per_track,
+           batch_basic_ns / BENCH_FRAMES / 1e6,
+           batch_trajectory_ns / BENCH_FRAMES / 1e6);
+
+    behavior_destroy(behavior);
+    behavior_analyzer_destroy(analysis);
+    behavior_batch_destroy(batch_basic);
+    behavior_batch_destroy(batch_trajectory);
+    free(tracks);
+}
+
+// ============================================================================
+// Occupancy heatmap: per-frame update and export
+// ============================================================================
+
+static void bench_occupancy(uint32_t num_tracks) {
+    OccupancyGrid* grid = occupancy_grid_create(0, 0, num_tracks);
+    TrackedObject* tracks = calloc(num_tracks, sizeof(TrackedObject));
+    uint8_t* buffer = malloc(OCCUPANCY_EXPORT_SIZE(64, 64));
+
+    if (!grid || !tracks || !buffer) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+
+    for (uint32_t t = 0; t < num_tracks; t++) {
+        tracks[t].track_id = t + 1;
+        tracks[t].current_bbox = (BoundingBox){(float)rand() / RAND_MAX, (float)rand() / RAND_MAX, 0.05f, 0.1f};
+    }
+
+    double update_ns = 0.0;
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        for (uint32_t t = 0; t < num_tracks; t++) {
+            tracks[t].current_bbox.x += 0.004f * ((float)rand() / RAND_MAX - 0.5f);
+            tracks[t].current_bbox.y += 0.004f * ((float)rand() / RAND_MAX - 0.5f);
+        }
+
+        double start = now_ns();
+        occupancy_grid_update(grid, tracks, num_tracks, (uint64_t)frame * 100);
+        update_ns += now_ns() - start;
+    }
+
+    double start = now_ns();
+    size_t len = 0;
+    for (int i = 0; i < 100; i++) {
+        len = occupancy_grid_export(grid, 64, 64, buffer, OCCUPANCY_EXPORT_SIZE(64, 64));
+    }
+    double export_us = (now_ns() - start) / 100 / 1e3;
+
+    printf("  %5u tracks: update %6.2f us/frame  export 64x64 %6.1f us (%zu bytes)\n",
+           num_tracks, update_ns / BENCH_FRAMES / 1e3, export_us, len);
+
+    occupancy_grid_destroy(grid);
+    free(tracks);
+    free(buffer);
+}
+
+static void bench_groups(uint32_t num_tracks) {
+    GroupAnalyzerConfig config = { .max_tracks = num_tracks };
+    GroupAnalyzer* analyzer = group_analyzer_create(&config);
+    TrackedObject* tracks = calloc(num_tracks, sizeof(TrackedObject));
+
+    if (!analyzer || !tracks) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+
+    // Half in groups of eight around shared centres, half walking alone
+    for (uint32_t t = 0; t < num_tracks; t++) {
+        float cx = (float)rand() / RAND_MAX;
+        float cy = (float)rand() / RAND_MAX;
+        float vx = 0.004f * ((float)rand() / RAND_MAX - 0.5f);
+        if (t < num_tracks / 2 && t % 8 != 0) {
+            cx = tracks[t - 1].current_bbox.x + 0.02f * ((float)rand() / RAND_MAX - 0.5f);
+            cy = tracks[t - 1].current_bbox.y + 0.02f * ((float)rand() / RAND_MAX - 0.5f);
+            vx = tracks[t - 1].velocity_x;
+        }
+        tracks[t].track_id = t + 1;
+        tracks[t].current_bbox = (BoundingBox){cx, cy, 0.03f, 0.08f};
+        tracks[t].velocity_x = vx;
+    }
+
+    double update_ns = 0.0;
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        for (uint32_t t = 0; t < num_tracks; t++) {
+            tracks[t].current_bbox.x += tracks[t].velocity_x;
+        }
+
+        double start = now_ns();
+        group_analyzer_update(analyzer, tracks, num_tracks, (uint64_t)frame * 100);
+        update_ns += now_ns() - start;
+    }
+
+    GroupAnalyzerStats stats;
+    group_analyzer_get_stats(analyzer, &stats);
+    printf("  %5u tracks: update %6.2f us/frame  %4u groups  %6u pairs tested (all-pairs %u)\n",
+           num_tracks, update_ns / BENCH_FRAMES / 1e3, stats.active_groups,
+           stats.candidate_pairs, num_tracks * (num_tracks - 1) / 2);
+
+    group_analyzer_destroy(analyzer);
+    free(tracks);
+}
+
+int main(void) {
+    printf("========================================\n");
+    printf("OMNISIGHT Perception Benchmarks\n");
+    printf("========================================\n\n");
+
+    srand(1);
+
+    printf("Kalman predict + update per frame:\n");
+    uint32_t sizes[] = {10, 50, 100, 500, 1000};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        bench_kalman(sizes[i]);
+    }
+
+    printf("\nCamera motion estimation (luma phase correlation):\n");
+    bench_motion_estimator(640, 360);
+    bench_motion_estimator(1280, 720);
+    bench_motion_estimator(1920, 1080);
+
+    printf("\nBehavior analysis per frame (full history windows):\n");
+    bench_behavior(100);
+    bench_behavior(500);
+
+    printf("\nOccupancy heatmap:\n");
+    bench_occupancy(50);
+    bench_occupancy(500);
+
+    printf("\nGroup / crowd clustering:\n");
+    bench_groups(100);
+    bench_groups(500);
+
+    return 0;
+}
@@ -0,0 +1,521 @@
+/**
+ * @file bench_timeline.c
+ * @brief Micro-benchmarks for Timeline Threading™ hot paths
+ *
+ * Build and run (same sources as test_timeline.c):
+ *   cd tests
+ *   gcc -O3 -o bench_timeline bench_timeline.c \
+ *       ../src/timeline/timeline.c \
+ *       ../src/timeline/trajectory_predictor.c \
+ *       ../src/timeline/event_predictor.c \
+ *       ../src/perception/zone_map.c \
+ *       ../src/perception/group_analyzer.c \
+ *       ../src/perception/track_index.c \
+ *       ../src/perception/track_snapshot.c \
+ *       ../src/timeline/worker_pool.c \
+ *       ../src/timeline/proximity_index.c \
+ *       ../src/timeline/particle_sampler.c \
+ *       -I../src/timeline -I../src/perception -lm -lpthread
+ *   ./bench_timeline
+ */
+
+#include "../src/timeline/timeline.h"
+#include "../src/timeline/trajectory_predictor.h"
+#include "../src/timeline/event_predictor.h"
+#include "../src/perception/perception.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_UPDATES 20
+#define BENCH_HORIZON_S 300.0f     // 5 minutes at 1 s steps
+#define BENCH_TIMELINES 5
+#define BENCH_MONITOR_FRAMES 100
+#define BENCH_MONITOR_FRAME_MS 2   // 500 fps, faster than most updates
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * Pedestrians walking across a 416x416 frame (pixels, pixels/second)
+ */
+static void make_scene(TrackedObject* tracks, uint32_t num_tracks, uint64_t time_ms) {
+    for (uint32_t i = 0; i < num_tracks; i++) {
+        TrackedObject* track = &tracks[i];
+        memset(track, 0, sizeof(TrackedObject));
+
+        track->track_id = i + 1;
+        track->current_bbox.x = (float)(rand() % 400);
+        track->current_bbox.y = (float)(rand() % 400);
+        track->current_bbox.width = 20;
+        track->current_bbox.height = 50;
+        track->confidence = 0.9f;
+        track->velocity_x = (float)(rand() % 21 - 10);
+        track->velocity_y = (float)(rand() % 21 - 10);
+        track->behaviors = (i % 7 == 0) ? BEHAVIOR_LOITERING : BEHAVIOR_NORMAL;
+        track->threat_score = (float)(rand() % 100) / 100.0f;
+        track->last_seen_ms = time_ms;
+        track->frame_count = 30;
+    }
+}
+
+// ============================================================================
+// timeline_update() end to end
+// ============================================================================
+
+static void bench_update(uint32_t num_tracks, const StepSchedule* schedule) {
+    SceneContext scene;
+    memset(&scene, 0, sizeof(SceneContext));
+    scene.time_of_day_risk = 1.0f;
+    scene.num_zones = 1;
+    scene.zones[0].x = 200;
+    scene.zones[0].y = 200;
+    scene.zones[0].radius = 40;
+    scene.zones[0].protected_event = EVENT_TRESPASSING;
+    scene.zones[0].sensitivity = 0.9f;
+
+    TimelineConfig config = {
+        .prediction_horizon_ms = (uint32_t)(BENCH_HORIZON_S * 1000),
+        .max_timelines = BENCH_TIMELINES,
+        .branching_enabled = true,
+        .scene_context = &scene
+    };
+    if (schedule) config.step_schedule = *schedule;
+
+    TimelineEngine* engine = timeline_init(&config);
+    TrackedObject* tracks = calloc(num_tracks, sizeof(TrackedObject));
+    if (!engine || !tracks) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+
+    double total_ns = 0.0;
+    double worst_ns = 0.0;
+    uint32_t num_timelines = 0;
+    for (int update = 0; update < BENCH_UPDATES; update++) {
+        uint64_t time_ms = now_ms();
+        make_scene(tracks, num_tracks, time_ms);
+
+        Timeline timelines[10];
+        double start = now_ns();
+        num_timelines = timeline_update(engine, tracks, num_tracks, timelines, 10);
+        double elapsed = now_ns() - start;
+
+        total_ns += elapsed;
+        if (elapsed > worst_ns) worst_ns = elapsed;
+    }
+
+    printf("  %4u tracks: timeline_update %8.3f ms avg  %8.3f ms worst  (%u timelines)\n",
+           num_tracks, total_ns / BENCH_UPDATES / 1e6, worst_ns / 1e6, num_timelines);
+
+    timeline_destroy(engine);
+    free(tracks);
+}
+
+// ============================================================================
+// Incremental updates: tracks moving as predicted between updates
+// ============================================================================
+
+static void bench_incremental(uint32_t num_tracks) {
+    SceneContext scene;
+    memset(&scene, 0, sizeof(SceneContext));
+    scene.time_of_day_risk = 1.0f;
+
+    TimelineConfig config = {
+        .prediction_horizon_ms = (uint32_t)(BENCH_HORIZON_S * 1000),
+        .max_timelines = BENCH_TIMELINES,
+        .branching_enabled = true,
+        .scene_context = &scene
+    };
+
+    TimelineEngine* engine = timeline_init(&config);
+    TrackedObject* tracks = calloc(num_tracks, sizeof(TrackedObject));
+    if (!engine || !tracks) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+
+    uint64_t time_ms = now_ms();
+    make_scene(tracks, num_tracks, time_ms);
+
+    double total_ns = 0.0;
+    for (int update = 0; update < BENCH_UPDATES; update++) {
+        Timeline timelines[10];
+        double start = now_ns();
+        timeline_update(engine, tracks, num_tracks, timelines, 10);
+        total_ns += now_ns() - start;
+
+        time_ms += 100;
+        for (uint32_t i = 0; i < num_tracks; i++) {
+            tracks[i].current_bbox.x += tracks[i].velocity_x * 0.1f;
+            tracks[i].current_bbox.y += tracks[i].velocity_y * 0.1f;
+            tracks[i].last_seen_ms = time_ms;
+        }
+    }
+
+    TimelineUpdateStats stats;
+    timeline_get_update_stats(engine, &stats);
+    printf("  %4u tracks: timeline_update %8.3f ms avg  p50 %.3f  p99 %.3f ms  (%.0f%% reused)\n",
+           num_tracks, total_ns / BENCH_UPDATES / 1e6,
+           stats.latency_p50_ms, stats.latency_p99_ms, stats.reuse_fraction * 100.0f);
+
+    timeline_destroy(engine);
+    free(tracks);
+}
+
+// ============================================================================
+// Monitor thread: the perception thread only pays for the hand-over
+// ============================================================================
+
+static void bench_monitor(uint32_t num_tracks) {
+    SceneContext scene;
+    memset(&scene, 0, sizeof(SceneContext));
+    scene.time_of_day_risk = 1.0f;
+
+    TimelineConfig config = {
+        .prediction_horizon_ms = (uint32_t)(BENCH_HORIZON_S * 1000),
+        .max_timelines = BENCH_TIMELINES,
+        .branching_enabled = true,
+        .scene_context = &scene,
+        .monitor_interval_ms = 0
+    };
+
+    TimelineEngine* engine = timeline_init(&config);
+    TrackedObject* tracks = calloc(num_tracks, sizeof(TrackedObject));
+    if (!engine || !tracks || !timeline_start_monitoring(engine, NULL, NULL)) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+
+    uint64_t time_ms = now_ms();
+    make_scene(tracks, num_tracks, time_ms);
+
+    double total_ns = 0.0;
+    double worst_ns = 0.0;
+    for (int frame = 0; frame < BENCH_MONITOR_FRAMES; frame++) {
+        double start = now_ns();
+        timeline_submit_tracks(engine, tracks, num_tracks);
+        double elapsed = now_ns() - start;
+        total_ns += elapsed;
+        if (elapsed > worst_ns) worst_ns = elapsed;
+
+        struct timespec frame_time = { 0, BENCH_MONITOR_FRAME_MS * 1000000L };
+        nanosleep(&frame_time, NULL);
+
+        time_ms += BENCH_MONITOR_FRAME_MS;
+        for (uint32_t i = 0; i < num_tracks; i++) {
+            tracks[i].current_bbox.x += tracks[i].velocity_x * BENCH_MONITOR_FRAME_MS / 1000.0f;
+            tracks[i].current_bbox.y += tracks[i].velocity_y * BENCH_MONITOR_FRAME_MS / 1000.0f;
+            tracks[i].last_seen_ms = time_ms;
+        }
+    }
+    timeline_stop_monitoring(engine);
+
+    TimelineUpdateStats stats;
+    timeline_get_update_stats(engine, &stats);
+    printf("  %4u tracks: submit %6.2f us avg  %6.2f us worst  (update p50 %.3f ms, "
+           "%llu of %d frames coalesced)\n",
+           num_tracks, total_ns / BENCH_MONITOR_FRAMES / 1e3, worst_ns / 1e3,
+           stats.latency_p50_ms, (unsigned long long)stats.snapshots_coalesced,
+           BENCH_MONITOR_FRAMES);
+
+    timeline_destroy(engine);
+    free(tracks);
+}
+
+// ============================================================================
+// Worker pool scaling: full re-prediction on 1-4 threads
+// ============================================================================
+
+static void bench_threads(uint32_t num_tracks, uint32_t worker_threads) {
+    SceneContext scene;
+    memset(&scene, 0, sizeof(SceneContext));
+    scene.time_of_day_risk = 1.0f;
+    scene.num_zones = 1;
+    scene.zones[0].x = 200;
+    scene.zones[0].y = 200;
+    scene.zones[0].radius = 40;
+    scene.zones[0].protected_event = EVENT_TRESPASSING;
+    scene.zones[0].sensitivity = 0.9f;
+
+    TimelineConfig config = {
+        .prediction_horizon_ms = (uint32_t)(BENCH_HORIZON_S * 1000),
+        .max_timelines = BENCH_TIMELINES,
+        .branching_enabled = true,
+        .scene_context = &scene,
+        .replan_tolerance = -1.0f,      // Every update predicts every track
+        .worker_threads = worker_threads
+    };
+
+    TimelineEngine* engine = timeline_init(&config);
+    TrackedObject* tracks = calloc(num_tracks, sizeof(TrackedObject));
+    if (!engine || !tracks) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+
+    srand(num_tracks);
+    double total_ns = 0.0;
+    for (int update = 0; update < BENCH_UPDATES; update++) {
+        uint64_t time_ms = now_ms();
+        make_scene(tracks, num_tracks, time_ms);
+
+        Timeline timelines[10];
+        double start = now_ns();
+        timeline_update(engine, tracks, num_tracks, timelines, 10);
+        total_ns += now_ns() - start;
+    }
+
+    printf("  %4u tracks, %u threads: timeline_update %8.3f ms avg\n",
+           num_tracks, worker_threads, total_ns / BENCH_UPDATES / 1e6);
+
+    timeline_destroy(engine);
+    free(tracks);
+}
+
+// ============================================================================
+// timeline_update() with Monte Carlo sampling
+// ============================================================================
+
+static void bench_sampling(uint32_t num_tracks, uint32_t num_particles,
+                           uint32_t worker_threads, uint32_t max_sampling_us) {
+    SceneContext scene;
+    memset(&scene, 0, sizeof(SceneContext));
+    scene.time_of_day_risk = 1.0f;
+
+    TimelineConfig config = {
+        .prediction_horizon_ms = (uint32_t)(BENCH_HORIZON_S * 1000),
+        .max_timelines = BENCH_TIMELINES,
+        .branching_enabled = true,
+        .scene_context = &scene,
+        .replan_tolerance = -1.0f,
+        .worker_threads = worker_threads,
+        .num_particles = num_particles,
+        .max_sampling_us = max_sampling_us,
+        .sampling_seed = 1
+    };
+
+    TimelineEngine* engine = timeline_init(&config);
+    TrackedObject* tracks = calloc(num_tracks, sizeof(TrackedObject));
+    if (!engine || !tracks) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+
+    srand(num_tracks);
+    double total_ns = 0.0;
+    uint64_t particles = 0;
+    for (int update = 0; update < BENCH_UPDATES; update++) {
+        uint64_t time_ms = now_ms();
+        make_scene(tracks, num_tracks, time_ms);
+
+        Timeline timelines[10];
+        double start = now_ns();
+        timeline_update(engine, tracks, num_tracks, timelines, 10);
+        total_ns += now_ns() - start;
+
+        TimelineUpdateStats stats;
+        timeline_get_update_stats(engine, &stats);
+        particles += stats.particles_sampled;
+    }
+
+    printf("  %4u tracks, K=%4u, %u threads%s: timeline_update %8.3f ms avg, %4llu particles\n",
+           num_tracks, num_particles, worker_threads,
+           max_sampling_us == 0 ? "" : ", budget",
+           total_ns / BENCH_UPDATES / 1e6,
+           (unsigned long long)(particles / BENCH_UPDATES));
+
+    timeline_destroy(engine);
+    free(tracks);
+}
+
+// ============================================================================
+// trajectory_predict_batch() per motion model
+// ============================================================================
+
+static void bench_batch(MotionModel model, const char* name, uint32_t num_tracks) {
+    TrajectoryPredictorConfig config = {
+        .motion_model = model,
+        .prediction_horizon_s = BENCH_HORIZON_S,
+        .prediction_step_s = 1.0f,
+        .max_branch_depth = 3
+    };
+
+    TrajectoryPredictor* predictor = trajectory_predictor_init(&config);
+    TrackedObject* tracks = calloc(num_tracks, sizeof(TrackedObject));
+    PredictedTrajectory* trajectories = calloc(num_tracks, sizeof(PredictedTrajectory));
+    const TrackedObject** targets = calloc(num_tracks, sizeof(*targets));
+    PredictedTrajectory** outputs = calloc(num_tracks, sizeof(*outputs));
+    bool* ok = calloc(num_tracks, sizeof(bool));
+    if (!predictor || !tracks || !trajectories || !targets || !outputs || !ok) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+
+    srand(num_tracks);
+    double total_ns = 0.0;
+    for (int update = 0; update < BENCH_UPDATES; update++) {
+        make_scene(tracks, num_tracks, now_ms());
+        for (uint32_t i = 0; i < num_tracks; i++) {
+            targets[i] = &tracks[i];
+            outputs[i] = &trajectories[i];
+        }
+
+        double start = now_ns();
+        trajectory_predict_batch(predictor, targets, num_tracks, tracks, num_tracks,
+                                 NULL, outputs, ok, NULL);
+        total_ns += now_ns() - start;
+    }
+
+    printf("  %4u tracks: %-12s %8.3f ms avg\n",
+           num_tracks, name, total_ns / BENCH_UPDATES / 1e6);
+
+    trajectory_predictor_destroy(predictor);
+    free(ok);
+    free(outputs);
+    free(targets);
+    free(trajectories);
+    free(tracks);
+}
+
+// ============================================================================
+// event_predictor_predict() on a fixed set of trajectories
+// ============================================================================
+
+static void bench_events(uint32_t num_tracks) {
+    SceneContext scene;
+    memset(&scene, 0, sizeof(SceneContext));
+    scene.time_of_day_risk = 1.0f;
+    scene.num_zones = 1;
+    scene.zones[0].x = 200;
+    scene.zones[0].y = 200;
+    scene.zones[0].radius = 40;
+    scene.zones[0].protected_event = EVENT_THEFT;
+    scene.zones[0].sensitivity = 0.9f;
+
+    TrajectoryPredictorConfig trajectory_config = {
+        .motion_model = MOTION_KALMAN_FILTER,
+        .prediction_horizon_s = BENCH_HORIZON_S,
+        .prediction_step_s = 1.0f,
+        .max_branch_depth = 3
+    };
+    EventPredictorConfig event_config = {
+        .loitering_threshold_ms = 60000.0f,
+        .theft_proximity_threshold = 0.5f,
+        .assault_velocity_threshold = 50.0f,
+        .collision_distance_threshold = 30.0f,
+        .scene = &scene
+    };
+
+    TrajectoryPredictor* trajectory_predictor = trajectory_predictor_init(&trajectory_config);
+    EventPredictor* event_predictor = event_predictor_init(&event_config);
+    TrackedObject* tracks = calloc(num_tracks, sizeof(TrackedObject));
+    PredictedTrajectory* trajectories = calloc(num_tracks, sizeof(PredictedTrajectory));
+    if (!trajectory_predictor || !event_predictor || !tracks || !trajectories) {
+        fprintf(stderr, "allocation failed\n");
+        exit(1);
+    }
+
+    srand(num_tracks);
+    make_scene(tracks, num_tracks, now_ms());
+    for (uint32_t i = 0; i < num_tracks; i++) {
+        trajectory_predict_single(trajectory_predictor, &tracks[i], NULL, 0, NULL,
+                                  &trajectories[i]);
+    }
+
+    double total_ns = 0.0;
+    uint32_t num_events = 0;
+    for (int update = 0; update < BENCH_UPDATES; update++) {
+        PredictedEvent events[20];
+        double start = now_ns();
+        num_events = event_predictor_predict(event_predictor, trajectories, num_tracks,
+                                             events, 20);
+        total_ns += now_ns() - start;
+    }
+
+    printf("  %4u tracks: event_predictor_predict %8.3f ms avg  (%u events)\n",
+           num_tracks, total_ns / BENCH_UPDATES / 1e6, num_events);
+
+    event_predictor_destroy(event_predictor);
+    trajectory_predictor_destroy(trajectory_predictor);
+    free(trajectories);
+    free(tracks);
+}
+
+int main(void) {
+    printf("========================================\n");
+    printf("OMNISIGHT Timeline Benchmarks\n");
+    printf("========================================\n\n");
+
+    srand(1);
+
+    printf("timeline_update() per call (%.0f s horizon, %d timelines):\n",
+           BENCH_HORIZON_S, BENCH_TIMELINES);
+    uint32_t sizes[] = {2, 10, 20, 50, 100};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        bench_update(sizes[i], NULL);
+    }
+
+    // 148 states per track instead of 300
+    StepSchedule schedule = {
+        .num_segments = 3,
+        .segments = { { 200, 10000 }, { 1000, 60000 }, { 5000, 0 } }
+    };
+    printf("\ntimeline_update() with steps of 200 ms to 10 s, 1 s to 60 s, then 5 s:\n");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        bench_update(sizes[i], &schedule);
+    }
+
+    printf("\ntimeline_update() with tracks following their prediction:\n");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        bench_incremental(sizes[i]);
+    }
+
+    printf("\ntimeline_submit_tracks() at %d fps, updates on the monitor thread:\n",
+           1000 / BENCH_MONITOR_FRAME_MS);
+    uint32_t monitor_sizes[] = {2, 20, 50};
+    for (size_t i = 0; i < sizeof(monitor_sizes) / sizeof(monitor_sizes[0]); i++) {
+        bench_monitor(monitor_sizes[i]);
+    }
+
+    printf("\ntimeline_update() worker pool scaling:\n");
+    uint32_t scaling_sizes[] = {20, 100};
+    for (size_t i = 0; i < sizeof(scaling_sizes) / sizeof(scaling_sizes[0]); i++) {
+        for (uint32_t threads = 1; threads <= 4; threads++) {
+            bench_threads(scaling_sizes[i], threads);
+        }
+    }
+
+    printf("\ntimeline_update() with Monte Carlo sampling:\n");
+    uint32_t particle_counts[] = {256, 1024, 4096};
+    for (size_t i = 0; i < sizeof(particle_counts) / sizeof(particle_counts[0]); i++) {
+        bench_sampling(20, particle_counts[i], 1, 0);
+        bench_sampling(20, particle_counts[i], 4, 0);
+    }
+    bench_sampling(20, 4096, 1, 5000);
+
+    printf("\ntrajectory_predict_batch() (%.0f s horizon):\n", BENCH_HORIZON_S);
+    uint32_t batch_sizes[] = {20, 100, 300};
+    for (size_t i = 0; i < sizeof(batch_sizes) / sizeof(batch_sizes[0]); i++) {
+        bench_batch(MOTION_KALMAN_FILTER, "kalman", batch_sizes[i]);
+        bench_batch(MOTION_SOCIAL_FORCE, "social force", batch_sizes[i]);
+    }
+
+    printf("\nevent_predictor_predict() (%.0f s horizon):\n", BENCH_HORIZON_S);
+    uint32_t event_sizes[] = {20, 100, 300};
+    for (size_t i = 0; i < sizeof(event_sizes) / sizeof(event_sizes[0]); i++) {
+        bench_events(event_sizes[i]);
+    }
+
+    return 0;
+}
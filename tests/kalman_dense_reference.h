@@ -0,0 +1,144 @@
+/**
+ * @file kalman_dense_reference.h
+ * @brief Dense per-track Kalman filter used as a reference for kalman_batch
+ *
+ * Textbook formulation with full matrices and generic loops:
+ * state [x, y, w, h, vx, vy, vw, vh], measurement [x, y, w, h].
+ * Shared by test_perception.c and bench_perception.c.
+ */
+
+#ifndef OMNISIGHT_KALMAN_DENSE_REFERENCE_H
+#define OMNISIGHT_KALMAN_DENSE_REFERENCE_H
+
+#include "../src/perception/kalman_batch.h"
+#include <string.h>
+
+#define DENSE_DIM_X 8
+#define DENSE_DIM_Z 4
+
+typedef struct {
+    float x[DENSE_DIM_X];
+    float P[DENSE_DIM_X][DENSE_DIM_X];
+    float Q[DENSE_DIM_X][DENSE_DIM_X];
+    float R[DENSE_DIM_Z][DENSE_DIM_Z];
+} DenseKalman;
+
+static inline void dense_kalman_init(
+    DenseKalman* k,
+    const KalmanBatchConfig* config,
+    const float* z
+) {
+    memset(k, 0, sizeof(*k));
+
+    for (int c = 0; c < DENSE_DIM_Z; c++) {
+        k->x[c] = z[c];
+        k->P[c][c] = config->initial_pos_variance[c];
+        k->P[c + 4][c + 4] = config->initial_vel_variance[c];
+        k->Q[c][c] = config->process_noise_pos[c];
+        k->Q[c + 4][c + 4] = config->process_noise_vel[c];
+        k->R[c][c] = config->measurement_noise[c];
+    }
+}
+
+static inline void dense_kalman_predict(DenseKalman* k, float dt) {
+    float F[DENSE_DIM_X][DENSE_DIM_X] = {{0}};
+    float FP[DENSE_DIM_X][DENSE_DIM_X] = {{0}};
+    float x[DENSE_DIM_X] = {0};
+
+    for (int i = 0; i < DENSE_DIM_X; i++) F[i][i] = 1.0f;
+    for (int c = 0; c < DENSE_DIM_Z; c++) F[c][c + 4] = dt;
+
+    // x = F x
+    for (int i = 0; i < DENSE_DIM_X; i++)
+        for (int j = 0; j < DENSE_DIM_X; j++)
+            x[i] += F[i][j] * k->x[j];
+    memcpy(k->x, x, sizeof(x));
+
+    // P = F P F^T + Q
+    for (int i = 0; i < DENSE_DIM_X; i++)
+        for (int j = 0; j < DENSE_DIM_X; j++)
+            for (int m = 0; m < DENSE_DIM_X; m++)
+                FP[i][j] += F[i][m] * k->P[m][j];
+
+    for (int i = 0; i < DENSE_DIM_X; i++) {
+        for (int j = 0; j < DENSE_DIM_X; j++) {
+            float sum = k->Q[i][j];
+            for (int m = 0; m < DENSE_DIM_X; m++)
+                sum += FP[i][m] * F[j][m];
+            k->P[i][j] = sum;
+        }
+    }
+}
+
+static inline void dense_kalman_update(DenseKalman* k, const float* z) {
+    float H[DENSE_DIM_Z][DENSE_DIM_X] = {{0}};
+    float PHt[DENSE_DIM_X][DENSE_DIM_Z] = {{0}};
+    float S[DENSE_DIM_Z][2 * DENSE_DIM_Z] = {{0}};
+    float K[DENSE_DIM_X][DENSE_DIM_Z] = {{0}};
+    float y[DENSE_DIM_Z];
+    float KH[DENSE_DIM_X][DENSE_DIM_X] = {{0}};
+    float P[DENSE_DIM_X][DENSE_DIM_X] = {{0}};
+
+    for (int c = 0; c < DENSE_DIM_Z; c++) H[c][c] = 1.0f;
+
+    // y = z - H x
+    for (int i = 0; i < DENSE_DIM_Z; i++) {
+        y[i] = z[i];
+        for (int j = 0; j < DENSE_DIM_X; j++)
+            y[i] -= H[i][j] * k->x[j];
+    }
+
+    // S = H P H^T + R, augmented with I for Gauss-Jordan inversion
+    for (int i = 0; i < DENSE_DIM_X; i++)
+        for (int j = 0; j < DENSE_DIM_Z; j++)
+            for (int m = 0; m < DENSE_DIM_X; m++)
+                PHt[i][j] += k->P[i][m] * H[j][m];
+
+    for (int i = 0; i < DENSE_DIM_Z; i++) {
+        for (int j = 0; j < DENSE_DIM_Z; j++) {
+            S[i][j] = k->R[i][j];
+            for (int m = 0; m < DENSE_DIM_X; m++)
+                S[i][j] += H[i][m] * PHt[m][j];
+        }
+        S[i][DENSE_DIM_Z + i] = 1.0f;
+    }
+
+    for (int col = 0; col < DENSE_DIM_Z; col++) {
+        float pivot = S[col][col];
+        for (int j = 0; j < 2 * DENSE_DIM_Z; j++) S[col][j] /= pivot;
+        for (int i = 0; i < DENSE_DIM_Z; i++) {
+            if (i == col) continue;
+            float factor = S[i][col];
+            for (int j = 0; j < 2 * DENSE_DIM_Z; j++) S[i][j] -= factor * S[col][j];
+        }
+    }
+
+    // K = P H^T S^-1
+    for (int i = 0; i < DENSE_DIM_X; i++)
+        for (int j = 0; j < DENSE_DIM_Z; j++)
+            for (int m = 0; m < DENSE_DIM_Z; m++)
+                K[i][j] += PHt[i][m] * S[m][DENSE_DIM_Z + j];
+
+    // x = x + K y
+    for (int i = 0; i < DENSE_DIM_X; i++)
+        for (int j = 0; j < DENSE_DIM_Z; j++)
+            k->x[i] += K[i][j] * y[j];
+
+    // P = (I - K H) P
+    for (int i = 0; i < DENSE_DIM_X; i++)
+        for (int j = 0; j < DENSE_DIM_X; j++)
+            for (int m = 0; m < DENSE_DIM_Z; m++)
+                KH[i][j] += K[i][m] * H[m][j];
+
+    for (int i = 0; i < DENSE_DIM_X; i++) {
+        for (int j = 0; j < DENSE_DIM_X; j++) {
+            float sum = k->P[i][j];
+            for (int m = 0; m < DENSE_DIM_X; m++)
+                sum -= KH[i][m] * k->P[m][j];
+            P[i][j] = sum;
+        }
+    }
+    memcpy(k->P, P, sizeof(P));
+}
+
+#endif // OMNISIGHT_KALMAN_DENSE_REFERENCE_H
@@ -6,9 +6,22 @@
 #include "../src/perception/perception.h"
 #include "../src/perception/tracker.h"
 #include "../src/perception/behavior.h"
+#include "../src/perception/behavior_analysis.h"
+#include "../src/perception/behavior_batch.h"
+#include "../src/perception/kalman_batch.h"
+#include "../src/perception/track_snapshot.h"
+#include "../src/perception/motion_estimator.h"
+#include "../src/perception/track_index.h"
+#include "../src/perception/track_summary.h"
+#include "../src/perception/zone_map.h"
+#include "../src/perception/occupancy_grid.h"
+#include "../src/perception/group_analyzer.h"
+#include "kalman_dense_reference.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+#include <pthread.h>
 #include <assert.h>
 
 // Test configuration
@@ -41,6 +54,10 @@ void test_perception_init() {
     PerceptionEngine* engine = perception_init(&config);
 
     if (engine) {
+        // heatmap_resolution 0 selects the default grid
+        assert(perception_get_heatmap_resolution(engine) == OCCUPANCY_GRID_DEFAULT_RESOLUTION);
+        assert(perception_get_heatmap_resolution(NULL) == 0);
+        assert(perception_get_zone_map(engine) != NULL);
         perception_destroy(engine);
         printf("PASS\n");
     } else {
@@ -106,6 +123,551 @@ void test_tracker() {
     printf("PASS\n");
 }
 
+void test_tracker_motion_regression() {
+    printf("[TEST] tracker motion on a fixed detection sequence... ");
+
+    // Pins the output of the Kalman motion model (see src/perception/README.md)
+    TrackerConfig config = {
+        .iou_threshold = 0.3,
+        .max_age = 5,
+        .min_hits = 1,
+        .max_tracks = 50,
+        .use_kalman_filter = true,
+        .high_confidence_threshold = 0.5,
+        .low_confidence_threshold = 0.1
+    };
+
+    Tracker* tracker = tracker_init(&config);
+    assert(tracker != NULL);
+
+    // Walks right and slightly down with +-0.002 of jitter in x; occluded
+    // on frames 12 and 13
+    static const struct {
+        int frame;
+        float x, y, vx;
+    } expected[] = {
+        { 1, 0.210000f, 0.304000f, 0.006000f},
+        { 5, 0.248891f, 0.320000f, 0.009395f},
+        {11, 0.309469f, 0.344000f, 0.009873f},
+        {14, 0.340689f, 0.356000f, 0.010293f},
+        {24, 0.440539f, 0.396000f, 0.010164f}
+    };
+
+    DetectedObject det = {
+        .id = 1,
+        .class_id = OBJECT_CLASS_PERSON,
+        .confidence = 0.9,
+        .bbox = {0.0, 0.0, 0.1, 0.2}
+    };
+    TrackedObject tracks[4];
+    uint32_t next = 0;
+
+    for (int frame = 0; frame < 25; frame++) {
+        det.bbox.x = 0.2f + 0.01f * frame + ((frame * 7) % 5 - 2) * 0.001f;
+        det.bbox.y = 0.3f + 0.004f * frame;
+        det.timestamp_ms = 1000 + 100 * frame;
+
+        bool occluded = frame == 12 || frame == 13;
+        uint32_t num_tracks = tracker_update(tracker, &det, occluded ? 0 : 1, tracks, 4);
+        assert(num_tracks == 1);
+        assert(tracks[0].track_id == 1);
+
+        if (next < sizeof(expected) / sizeof(expected[0]) && expected[next].frame == frame) {
+            assert(fabsf(tracks[0].current_bbox.x - expected[next].x) < 1e-5f);
+            assert(fabsf(tracks[0].current_bbox.y - expected[next].y) < 1e-5f);
+            assert(fabsf(tracks[0].velocity_x - expected[next].vx) < 1e-5f);
+            assert(fabsf(tracks[0].current_bbox.width - 0.1f) < 1e-5f);
+            next++;
+        }
+    }
+    assert(next == sizeof(expected) / sizeof(expected[0]));
+
+    tracker_destroy(tracker);
+    printf("PASS\n");
+}
+
+void test_tracker_low_score_association() {
+    printf("[TEST] tracker two-stage association... ");
+
+    TrackerConfig config = {
+        .iou_threshold = 0.3,
+        .max_age = 30,
+        .min_hits = 1,
+        .max_tracks = 50,
+        .use_kalman_filter = true,
+        .feature_similarity_weight = 0.0,
+        .high_confidence_threshold = 0.5,
+        .low_confidence_threshold = 0.1,
+        .low_score_iou_threshold = 0.5
+    };
+
+    Tracker* tracker = tracker_init(&config);
+    assert(tracker != NULL);
+
+    DetectedObject det = {
+        .id = 1,
+        .class_id = OBJECT_CLASS_PERSON,
+        .confidence = 0.9,
+        .bbox = {0.4, 0.4, 0.1, 0.2},
+        .timestamp_ms = 1000
+    };
+
+    TrackedObject tracks[10];
+    uint32_t num_tracks = tracker_update(tracker, &det, 1, tracks, 10);
+    assert(num_tracks == 1);
+    uint32_t track_id = tracks[0].track_id;
+
+    // Partially occluded: score drops below the high threshold
+    det.confidence = 0.2;
+    det.timestamp_ms += 100;
+    num_tracks = tracker_update(tracker, &det, 1, tracks, 10);
+    assert(num_tracks == 1);
+    assert(tracks[0].track_id == track_id);
+    assert(tracks[0].miss_count == 0);
+
+    // A low-score detection with no track to extend never spawns one
+    DetectedObject stray = det;
+    stray.bbox.x = 0.05;
+    stray.bbox.y = 0.05;
+    num_tracks = tracker_update(tracker, &stray, 1, tracks, 10);
+
+    TrackerStats stats;
+    tracker_get_detailed_stats(tracker, &stats);
+    assert(stats.total_tracks == 1);
+    assert(stats.low_score_matches == 1);
+    assert(stats.fragmentations == 1);
+    assert(stats.id_switches == 0);
+
+    tracker_destroy(tracker);
+    printf("PASS\n");
+}
+
+void test_tracker_reid_gallery() {
+    printf("[TEST] tracker re-identification gallery... ");
+
+    TrackerConfig config = {
+        .iou_threshold = 0.3,
+        .max_age = 3,
+        .min_hits = 1,
+        .max_tracks = 50,
+        .use_kalman_filter = true,
+        .feature_similarity_weight = 0.0,
+        .high_confidence_threshold = 0.5,
+        .low_confidence_threshold = 0.1,
+        .reid_gallery_size = 8,
+        .reid_ttl_ms = 5000,
+        .reid_similarity_threshold = 0.9,
+        .reid_max_distance = 0.25
+    };
+
+    Tracker* tracker = tracker_init(&config);
+    assert(tracker != NULL);
+
+    DetectedObject person = {
+        .id = 1,
+        .class_id = OBJECT_CLASS_PERSON,
+        .confidence = 0.9,
+        .bbox = {0.4, 0.4, 0.1, 0.2},
+        .timestamp_ms = 1000
+    };
+    for (int k = 0; k < 128; k++) {
+        person.features[k] = (k % 2) ? 1.0f : 0.0f;
+    }
+
+    TrackedObject tracks[10];
+    tracker_update(tracker, &person, 1, tracks, 10);
+    uint32_t track_id = tracks[0].track_id;
+
+    // Hidden behind a pillar until the track is deleted
+    for (int frame = 0; frame < 3; frame++) {
+        tracker_update(tracker, &person, 0, tracks, 10);
+    }
+
+    TrackerStats stats;
+    tracker_get_detailed_stats(tracker, &stats);
+    assert(stats.active_tracks == 0);
+    assert(stats.gallery_entries == 1);
+
+    // Still re-identifiable, so its per-track history must be kept
+    uint32_t deleted[4];
+    assert(tracker_drain_deleted_tracks(tracker, deleted, 4) == 0);
+
+    // Reappears nearby with the same appearance: same identity
+    person.bbox.x = 0.45;
+    person.timestamp_ms = 3000;
+    uint32_t num_tracks = tracker_update(tracker, &person, 1, tracks, 10);
+    assert(num_tracks == 1);
+    assert(tracks[0].track_id == track_id);
+    assert(tracks[0].first_seen_ms == 1000);
+
+    // A different-looking person is not matched to the gallery
+    for (int frame = 0; frame < 3; frame++) {
+        tracker_update(tracker, &person, 0, tracks, 10);
+    }
+    DetectedObject stranger = person;
+    for (int k = 0; k < 128; k++) {
+        stranger.features[k] = (k % 2) ? 0.0f : 1.0f;
+    }
+    stranger.timestamp_ms = 4000;
+
+    // Nor is another class with the same appearance in the same place
+    DetectedObject cart = person;
+    cart.class_id = OBJECT_CLASS_VEHICLE;
+    cart.timestamp_ms = 4000;
+
+    DetectedObject newcomers[2] = {stranger, cart};
+    num_tracks = tracker_update(tracker, newcomers, 2, tracks, 10);
+    assert(num_tracks == 2);
+    assert(tracks[0].track_id != track_id);
+    assert(tracks[1].track_id != track_id);
+
+    tracker_get_detailed_stats(tracker, &stats);
+    assert(stats.reid_lookups == 3);
+    assert(stats.reid_hits == 1);
+    assert(stats.total_tracks == 3);
+
+    // Entries expire after the TTL
+    for (int frame = 0; frame < 3; frame++) {
+        tracker_update(tracker, &person, 0, tracks, 10);
+    }
+    person.timestamp_ms = 20000;
+    num_tracks = tracker_update(tracker, &person, 1, tracks, 10);
+    assert(tracks[0].track_id != track_id);
+
+    // Expired entries are reported deleted: the person, the stranger and the cart
+    assert(tracker_drain_deleted_tracks(tracker, deleted, 4) == 3);
+    assert(deleted[0] == track_id || deleted[1] == track_id || deleted[2] == track_id);
+
+    // Clearing reports the gallery entry and the active track alike
+    uint32_t lost_id = tracks[0].track_id;
+    for (int frame = 0; frame < 3; frame++) {
+        tracker_update(tracker, &person, 0, tracks, 10);
+    }
+    cart.timestamp_ms = 20100;
+    num_tracks = tracker_update(tracker, &cart, 1, tracks, 10);
+    assert(num_tracks == 1);
+    uint32_t active_id = tracks[0].track_id;
+
+    tracker_clear(tracker);
+    assert(tracker_drain_deleted_tracks(tracker, deleted, 4) == 2);
+    assert((deleted[0] == lost_id && deleted[1] == active_id) ||
+           (deleted[0] == active_id && deleted[1] == lost_id));
+
+    tracker_destroy(tracker);
+
+    // A revived track resumes its motion instead of restarting at rest
+    tracker = tracker_init(&config);
+    assert(tracker != NULL);
+
+    DetectedObject walker = person;
+    for (int frame = 0; frame < 10; frame++) {
+        walker.bbox.x = 0.1f + 0.02f * frame;
+        walker.timestamp_ms = 1000 + 100 * frame;
+        tracker_update(tracker, &walker, 1, tracks, 10);
+    }
+    uint32_t walker_id = tracks[0].track_id;
+    for (int frame = 0; frame < 3; frame++) {
+        tracker_update(tracker, &walker, 0, tracks, 10);
+    }
+
+    walker.bbox.x = 0.1f + 0.02f * 14;
+    walker.timestamp_ms = 1000 + 100 * 14;
+    num_tracks = tracker_update(tracker, &walker, 1, tracks, 10);
+    assert(num_tracks == 1);
+    assert(tracks[0].track_id == walker_id);
+    assert(fabsf(tracks[0].velocity_x - 0.02f) < 0.005f);
+    assert(fabsf(tracks[0].current_bbox.x - walker.bbox.x) < 0.01f);
+
+    tracker_destroy(tracker);
+    printf("PASS\n");
+}
+
+static uint8_t textured_luma(int x, int y) {
+    float v = 128.0f + 40.0f * sinf(x * 0.07f) * cosf(y * 0.05f) +
+              30.0f * sinf(x * 0.013f + y * 0.031f) +
+              20.0f * cosf(x * 0.11f - y * 0.023f) +
+              (float)(((x * 73856093) ^ (y * 19349663)) & 31);
+    return (uint8_t)fminf(255.0f, fmaxf(0.0f, v));
+}
+
+void test_motion_estimator() {
+    printf("[TEST] camera motion estimation... ");
+
+    #define ME_WIDTH 320
+    #define ME_HEIGHT 240
+    static uint8_t frame_a[ME_HEIGHT * ME_WIDTH];
+    static uint8_t frame_b[ME_HEIGHT * ME_WIDTH];
+    int shift_x = 10;
+    int shift_y = -6;
+
+    for (int y = 0; y < ME_HEIGHT; y++) {
+        for (int x = 0; x < ME_WIDTH; x++) {
+            frame_a[y * ME_WIDTH + x] = textured_luma(x, y);
+            frame_b[y * ME_WIDTH + x] = textured_luma(x - shift_x, y - shift_y);
+        }
+    }
+
+    MotionEstimator* estimator = motion_estimator_init(0.0f);
+    assert(estimator != NULL);
+
+    CameraMotion motion;
+    assert(!motion_estimator_process_luma(estimator, frame_a, ME_WIDTH, ME_HEIGHT, ME_WIDTH, &motion));
+
+    // Static scene: no motion reported
+    assert(!motion_estimator_process_luma(estimator, frame_a, ME_WIDTH, ME_HEIGHT, ME_WIDTH, &motion));
+
+    assert(motion_estimator_process_luma(estimator, frame_b, ME_WIDTH, ME_HEIGHT, ME_WIDTH, &motion));
+    assert(fabsf(motion.dx - (float)shift_x / ME_WIDTH) < 0.005f);
+    assert(fabsf(motion.dy - (float)shift_y / ME_HEIGHT) < 0.005f);
+    assert(motion.scale == 1.0f);
+
+    // After a reset the next frame is a new reference
+    motion_estimator_reset(estimator);
+    assert(!motion_estimator_process_luma(estimator, frame_a, ME_WIDTH, ME_HEIGHT, ME_WIDTH, &motion));
+
+    MotionEstimatorStats stats;
+    motion_estimator_get_stats(estimator, &stats);
+    assert(stats.frames == 4);
+    assert(stats.frames_with_motion == 1);
+    assert(stats.avg_ms > 0.0f);
+
+    #undef ME_WIDTH
+    #undef ME_HEIGHT
+
+    motion_estimator_destroy(estimator);
+    printf("PASS (%.3f ms/frame)\n", stats.avg_ms);
+}
+
+void test_tracker_camera_motion() {
+    printf("[TEST] tracker camera motion compensation... ");
+
+    TrackerConfig config = {
+        .iou_threshold = 0.3,
+        .max_age = 30,
+        .min_hits = 1,
+        .max_tracks = 50,
+        .use_kalman_filter = true,
+        .feature_similarity_weight = 0.0,
+        .high_confidence_threshold = 0.5,
+        .low_confidence_threshold = 0.1
+    };
+
+    Tracker* tracker = tracker_init(&config);
+    assert(tracker != NULL);
+
+    DetectedObject det = {
+        .id = 1,
+        .class_id = OBJECT_CLASS_PERSON,
+        .confidence = 0.9,
+        .bbox = {0.6, 0.4, 0.1, 0.2},
+        .timestamp_ms = 1000
+    };
+
+    TrackedObject tracks[10];
+    tracker_update(tracker, &det, 1, tracks, 10);
+    uint32_t track_id = tracks[0].track_id;
+
+    // Camera pans right: the (static) person jumps left by 0.3
+    det.bbox.x -= 0.3f;
+    tracker_set_camera_motion(tracker, -0.3f, 0.0f, 1.0f);
+    uint32_t num_tracks = tracker_update(tracker, &det, 1, tracks, 10);
+    assert(num_tracks == 1);
+    assert(tracks[0].track_id == track_id);
+    assert(fabsf(tracks[0].current_bbox.x - det.bbox.x) < 0.01f);
+
+    // Zoom in 2x about the center
+    det.bbox.x = (det.bbox.x - 0.5f) * 2.0f + 0.5f;
+    det.bbox.y = (det.bbox.y - 0.5f) * 2.0f + 0.5f;
+    det.bbox.width *= 2.0f;
+    det.bbox.height *= 2.0f;
+    tracker_set_camera_motion(tracker, 0.0f, 0.0f, 2.0f);
+    num_tracks = tracker_update(tracker, &det, 1, tracks, 10);
+    assert(num_tracks == 1);
+    assert(tracks[0].track_id == track_id);
+
+    TrackerStats stats;
+    tracker_get_detailed_stats(tracker, &stats);
+    assert(stats.total_tracks == 1);
+
+    tracker_destroy(tracker);
+    printf("PASS\n");
+}
+
+#define SNAPSHOT_TEST_FRAMES 20000
+
+static void* snapshot_writer(void* arg) {
+    TrackSnapshot* snapshot = (TrackSnapshot*)arg;
+    static TrackedObject tracks[TRACK_SNAPSHOT_MAX_TRACKS];
+
+    // Every track of frame f carries track_id == f, count == f % 50 + 1
+    for (uint32_t frame = 1; frame <= SNAPSHOT_TEST_FRAMES; frame++) {
+        uint32_t count = frame % TRACK_SNAPSHOT_MAX_TRACKS + 1;
+        for (uint32_t i = 0; i < count; i++) {
+            tracks[i].track_id = frame;
+            tracks[i].last_seen_ms = frame;
+        }
+        track_snapshot_publish(snapshot, tracks, count);
+    }
+
+    return NULL;
+}
+
+void test_track_snapshot() {
+    printf("[TEST] lock-free track snapshots... ");
+
+    TrackSnapshot* snapshot = track_snapshot_create();
+    assert(snapshot != NULL);
+
+    TrackedObject out[TRACK_SNAPSHOT_MAX_TRACKS];
+    uint64_t version = 123;
+
+    // Nothing published yet
+    assert(track_snapshot_version(snapshot) == 0);
+    assert(track_snapshot_read(snapshot, out, TRACK_SNAPSHOT_MAX_TRACKS, &version) == 0);
+    assert(version == 0);
+
+    TrackedObject track = {.track_id = 7};
+    assert(track_snapshot_publish(snapshot, &track, 1) == 1);
+    assert(track_snapshot_read(snapshot, out, TRACK_SNAPSHOT_MAX_TRACKS, &version) == 1);
+    assert(version == 1 && out[0].track_id == 7);
+
+    // Unchanged data can be skipped by comparing versions
+    assert(track_snapshot_version(snapshot) == version);
+    assert(track_snapshot_publish(snapshot, &track, 0) == 2);
+    assert(track_snapshot_version(snapshot) != version);
+    assert(track_snapshot_read(snapshot, out, TRACK_SNAPSHOT_MAX_TRACKS, &version) == 0);
+
+    track_snapshot_destroy(snapshot);
+
+    // Concurrent writer: every read must be one frame's complete list
+    snapshot = track_snapshot_create();
+    pthread_t writer;
+    pthread_create(&writer, NULL, snapshot_writer, snapshot);
+
+    uint64_t last_version = 0;
+    while (last_version < SNAPSHOT_TEST_FRAMES + 1) {
+        uint32_t count = track_snapshot_read(snapshot, out, TRACK_SNAPSHOT_MAX_TRACKS, &version);
+        if (version == 0) continue;
+
+        // Versions never go backwards
+        assert(version >= last_version);
+        last_version = version;
+
+        uint32_t frame = out[0].track_id;
+        assert(count == frame % TRACK_SNAPSHOT_MAX_TRACKS + 1);
+        for (uint32_t i = 0; i < count; i++) {
+            assert(out[i].track_id == frame);
+            assert(out[i].last_seen_ms == frame);
+        }
+
+        if (version == SNAPSHOT_TEST_FRAMES) break;
+    }
+
+    pthread_join(writer, NULL);
+    track_snapshot_destroy(snapshot);
+    printf("PASS\n");
+}
+
+void test_kalman_batch_equivalence() {
+    printf("[TEST] Batched Kalman vs dense reference... ");
+
+    #define KB_TRACKS 16
+    #define KB_FRAMES 200
+
+    KalmanBatchConfig config;
+    for (int c = 0; c < KALMAN_BATCH_CHANNELS; c++) {
+        config.process_noise_pos[c] = 1e-3f;
+        config.process_noise_vel[c] = (c < 2) ? 1e-3f : 0.0f;
+        config.measurement_noise[c] = 1e-2f;
+        config.initial_pos_variance[c] = 1.0f;
+        config.initial_vel_variance[c] = (c < 2) ? 1.0f : 0.0f;
+    }
+
+    KalmanBatch* batch = kalman_batch_init(KB_TRACKS, &config);
+    assert(batch != NULL);
+
+    DenseKalman dense[KB_TRACKS];
+    float truth[KB_TRACKS][4];
+    float speed[KB_TRACKS][2];
+
+    srand(42);
+    for (int t = 0; t < KB_TRACKS; t++) {
+        truth[t][0] = (float)rand() / RAND_MAX;
+        truth[t][1] = (float)rand() / RAND_MAX;
+        truth[t][2] = 0.05f + 0.1f * (float)rand() / RAND_MAX;
+        truth[t][3] = 0.1f + 0.2f * (float)rand() / RAND_MAX;
+        speed[t][0] = 0.01f * ((float)rand() / RAND_MAX - 0.5f);
+        speed[t][1] = 0.01f * ((float)rand() / RAND_MAX - 0.5f);
+
+        kalman_batch_init_slot(batch, t, truth[t]);
+        dense_kalman_init(&dense[t], &config, truth[t]);
+    }
+
+    float max_error = 0.0f;
+
+    for (int frame = 0; frame < KB_FRAMES; frame++) {
+        kalman_batch_predict(batch, 1.0f);
+
+        for (int t = 0; t < KB_TRACKS; t++) {
+            dense_kalman_predict(&dense[t], 1.0f);
+
+            truth[t][0] += speed[t][0];
+            truth[t][1] += speed[t][1];
+
+            // Roughly a quarter of the frames are missed
+            if (rand() % 4 == 0) continue;
+
+            float z[4];
+            for (int c = 0; c < 4; c++) {
+                z[c] = truth[t][c] + 0.005f * ((float)rand() / RAND_MAX - 0.5f);
+            }
+
+            kalman_batch_set_measurement(batch, t, z);
+            dense_kalman_update(&dense[t], z);
+        }
+
+        kalman_batch_update(batch);
+
+        for (int t = 0; t < KB_TRACKS; t++) {
+            float pos[KALMAN_BATCH_CHANNELS];
+            float vel[KALMAN_BATCH_CHANNELS];
+            kalman_batch_get_state(batch, t, pos, vel);
+
+            for (int c = 0; c < KALMAN_BATCH_CHANNELS; c++) {
+                float p_pp, p_pv, p_vv;
+                kalman_batch_get_covariance(batch, t, c, &p_pp, &p_pv, &p_vv);
+
+                float errors[5] = {
+                    fabsf(pos[c] - dense[t].x[c]),
+                    fabsf(vel[c] - dense[t].x[c + 4]),
+                    fabsf(p_pp - dense[t].P[c][c]) / fmaxf(1.0f, fabsf(dense[t].P[c][c])),
+                    fabsf(p_pv - dense[t].P[c][c + 4]) / fmaxf(1.0f, fabsf(dense[t].P[c][c + 4])),
+                    fabsf(p_vv - dense[t].P[c + 4][c + 4]) / fmaxf(1.0f, fabsf(dense[t].P[c + 4][c + 4]))
+                };
+
+                for (int e = 0; e < 5; e++) {
+                    max_error = fmaxf(max_error, errors[e]);
+                }
+
+                // Cross-channel covariance stays exactly zero in the dense form
+                for (int d = 0; d < KALMAN_BATCH_CHANNELS; d++) {
+                    if (d == c) continue;
+                    assert(dense[t].P[c][d] == 0.0f);
+                    assert(dense[t].P[c][d + 4] == 0.0f);
+                }
+            }
+        }
+    }
+
+    assert(max_error < 1e-4f);
+
+    #undef KB_TRACKS
+    #undef KB_FRAMES
+
+    kalman_batch_destroy(batch);
+    printf("PASS (max error %.2e)\n", max_error);
+}
+
 void test_iou_calculation() {
     printf("[TEST] IoU calculation... ");
 
@@ -187,6 +749,774 @@ void test_behavior_analyzer() {
     printf("PASS\n");
 }
 
+void test_track_index() {
+    printf("[TEST] track index... ");
+
+    // LRU eviction: touching a track protects it
+    TrackIndex* index = track_index_create(3);
+    assert(index != NULL);
+
+    bool is_new;
+    uint32_t evicted;
+    assert(track_index_acquire(index, 10, &is_new, &evicted) >= 0 && is_new);
+    assert(track_index_acquire(index, 11, &is_new, &evicted) >= 0 && is_new);
+    assert(track_index_acquire(index, 12, &is_new, &evicted) >= 0 && is_new);
+    int32_t slot10 = track_index_acquire(index, 10, &is_new, &evicted);
+    assert(!is_new && evicted == 0);
+
+    int32_t slot13 = track_index_acquire(index, 13, &is_new, &evicted);
+    assert(is_new && evicted == 11);
+    assert(track_index_find(index, 11) < 0);
+    assert(track_index_find(index, 10) == slot10);
+    assert(track_index_count(index) == 3);
+
+    // Removal frees the slot for the next new track without evicting
+    assert(track_index_remove(index, 13) == slot13);
+    assert(track_index_remove(index, 13) < 0);
+    assert(track_index_acquire(index, 14, &is_new, &evicted) == slot13);
+    assert(is_new && evicted == 0);
+    track_index_destroy(index);
+
+    // Random churn against a brute-force table
+    enum { CAP = 100, IDS = 400 };
+    int32_t ref[IDS];
+    for (int i = 0; i < IDS; i++) ref[i] = -1;
+
+    index = track_index_create(CAP);
+    srand(7);
+    for (int op = 0; op < 20000; op++) {
+        uint32_t id = 1 + rand() % (IDS - 1);
+        if (rand() % 3 == 0) {
+            assert(track_index_remove(index, id) == ref[id]);
+            ref[id] = -1;
+        } else if (ref[id] >= 0 || track_index_count(index) < CAP) {
+            int32_t slot = track_index_acquire(index, id, &is_new, &evicted);
+            assert(evicted == 0);
+            assert(is_new == (ref[id] < 0));
+            assert(ref[id] < 0 || slot == ref[id]);
+            ref[id] = slot;
+        }
+
+        for (uint32_t j = 1; j < IDS; j++) {
+            assert(track_index_find(index, j) == ref[j]);
+        }
+    }
+    track_index_destroy(index);
+
+    // Behavior histories follow tracker deletions
+    TrackerConfig tracker_config = {
+        .iou_threshold = 0.3f,
+        .max_age = 2,
+        .min_hits = 1,
+        .max_tracks = 10,
+        .use_kalman_filter = true,
+        .high_confidence_threshold = 0.5f,
+        .low_confidence_threshold = 0.1f,
+        .low_score_iou_threshold = 0.5f
+    };
+    BehaviorConfig behavior_config = {
+        .loitering_threshold_ms = 5000,
+        .loitering_movement_threshold = 0.05f,
+        .running_velocity_threshold = 50.0f,
+        .running_frames_threshold = 5,
+        .repeated_passes_count = 3
+    };
+
+    Tracker* tracker = tracker_init(&tracker_config);
+    BehaviorAnalyzer* analyzer = behavior_init(&behavior_config);
+    assert(tracker && analyzer);
+
+    DetectedObject person = {
+        .class_id = OBJECT_CLASS_PERSON,
+        .bbox = {0.4f, 0.4f, 0.1f, 0.2f},
+        .confidence = 0.9f,
+        .timestamp_ms = 0
+    };
+    TrackedObject tracks[10];
+    uint32_t n = tracker_update(tracker, &person, 1, tracks, 10);
+    assert(n == 1);
+    behavior_analyze(analyzer, tracks, n);
+    uint32_t id = tracks[0].track_id;
+
+    uint32_t deleted[4];
+    for (int f = 0; f < 2; f++) {
+        tracker_update(tracker, &person, 0, tracks, 10);
+    }
+    assert(tracker_drain_deleted_tracks(tracker, deleted, 4) == 1);
+    assert(deleted[0] == id);
+    assert(tracker_drain_deleted_tracks(tracker, deleted, 4) == 0);
+    assert(behavior_remove_track(analyzer, id));
+    assert(!behavior_remove_track(analyzer, id));
+
+    behavior_destroy(analyzer);
+    tracker_destroy(tracker);
+    printf("PASS\n");
+}
+
+void test_behavior_sliding_window() {
+    printf("[TEST] behavior sliding-window aggregates... ");
+
+    BehaviorConfig config = {
+        .loitering_threshold_ms = 1000,
+        .loitering_movement_threshold = 0.005f,
+        .running_velocity_threshold = 1e9f,
+        .running_frames_threshold = 5,
+        .repeated_passes_count = 10
+    };
+
+    BehaviorAnalyzer* analyzer = behavior_init(&config);
+    assert(analyzer != NULL);
+
+    TrackedObject track = {
+        .track_id = 7,
+        .class_id = OBJECT_CLASS_PERSON,
+        .current_bbox = {0.5f, 0.5f, 0.1f, 0.2f},
+        .first_seen_ms = 0
+    };
+
+    // Pacing back and forth: repeated passes, too much movement to loiter
+    for (int frame = 0; frame < 40; frame++) {
+        track.current_bbox.x = (frame % 2) ? 0.55f : 0.45f;
+        track.last_seen_ms = frame * 100;
+        behavior_analyze(analyzer, &track, 1);
+    }
+    assert(track.behaviors & BEHAVIOR_REPEATED_PASSES);
+    assert(!(track.behaviors & BEHAVIOR_LOITERING));
+
+    // Standing still: once the pacing has left the 100-entry window the
+    // direction changes and movement it contributed are gone
+    bool passes_cleared = false;
+    for (int frame = 40; frame < 160; frame++) {
+        track.last_seen_ms = frame * 100;
+        behavior_analyze(analyzer, &track, 1);
+        if (!(track.behaviors & BEHAVIOR_REPEATED_PASSES)) {
+            passes_cleared = true;
+        }
+    }
+    assert(passes_cleared);
+    assert(!(track.behaviors & BEHAVIOR_REPEATED_PASSES));
+    assert(track.behaviors & BEHAVIOR_LOITERING);
+
+    behavior_destroy(analyzer);
+    printf("PASS\n");
+}
+
+void test_track_summary() {
+    printf("[TEST] decimated track history... ");
+
+    // Ten minutes at 10 FPS, moving right at 0.001 per frame
+    TrackSummary summary;
+    track_summary_reset(&summary);
+    for (uint32_t frame = 0; frame < 6000; frame++) {
+        track_summary_add(&summary, frame * 0.001f, 0.5f, 1.0f, frame * 100);
+    }
+
+    // The last 30 s come from 1 s buckets
+    HistoryBucket buckets[TRACK_SUMMARY_BUCKETS + 1];
+    uint32_t n = track_summary_window(&summary, 599900 - 30000, buckets, TRACK_SUMMARY_BUCKETS + 1);
+    assert(n >= 30 && n <= 32);
+    assert(buckets[n - 1].end_ms == 599900);
+    assert(buckets[1].end_ms - buckets[1].start_ms == 900);
+    assert(fabsf(buckets[1].centroid_x - (buckets[1].min_x + buckets[1].max_x) / 2) < 1e-4f);
+    assert(fabsf(buckets[1].mean_speed - 1.0f) < 1e-6f);
+
+    // Cached aggregates agree with the copied window
+    TrackSummaryStats stats;
+    assert(track_summary_window_stats(&summary, 599900 - 30000, 0.0f, &stats));
+    assert(stats.num_buckets == n);
+    assert(stats.start_x == buckets[0].centroid_x);
+    assert(stats.min_x == buckets[0].min_x && stats.max_x == buckets[n - 1].max_x);
+    assert(fabsf(stats.mean_speed - 1.0f) < 1e-6f);
+    assert(stats.reversals_x == 0);
+
+    // Four minutes back is beyond level 0, so 5 s buckets answer
+    n = track_summary_window(&summary, 599900 - 240000, buckets, TRACK_SUMMARY_BUCKETS + 1);
+    assert(n >= 48 && n <= 50);
+    assert(buckets[0].start_ms <= 599900 - 240000);
+    assert(buckets[1].num_samples == 50);
+
+    // Slow pacing: 15 s legs back and forth, far longer than the ring
+    BehaviorConfig config = {
+        .loitering_threshold_ms = 1000,
+        .loitering_movement_threshold = 0.02f,
+        .running_velocity_threshold = 1e9f,
+        .running_frames_threshold = 5,
+        .repeated_passes_count = 3,
+        .repeated_passes_window_ms = 60000
+    };
+    BehaviorAnalyzer* analyzer = behavior_init(&config);
+    assert(analyzer != NULL);
+
+    TrackedObject track = {
+        .track_id = 3,
+        .class_id = OBJECT_CLASS_PERSON,
+        .current_bbox = {0.2f, 0.5f, 0.05f, 0.1f}
+    };
+    for (uint32_t frame = 0; frame < 700; frame++) {
+        uint32_t leg = frame / 150;
+        uint32_t step = frame % 150;
+        track.current_bbox.x = 0.2f + 0.004f * ((leg % 2) ? 150 - step : step);
+        track.last_seen_ms = frame * 100;
+        behavior_analyze(analyzer, &track, 1);
+
+        // Only one reversal fits in the first 30 s
+        if (frame == 299) {
+            assert(!(track.behaviors & BEHAVIOR_REPEATED_PASSES));
+        }
+    }
+    assert(track.behaviors & BEHAVIOR_REPEATED_PASSES);
+
+    behavior_destroy(analyzer);
+    printf("PASS\n");
+}
+
+static bool zone_reference(const Zone* zone, float x, float y) {
+    if (zone->shape == ZONE_SHAPE_CIRCLE) {
+        return hypotf(x - zone->center_x, y - zone->center_y) < zone->radius;
+    }
+
+    bool inside = false;
+    for (uint32_t i = 0, j = zone->num_vertices - 1; i < zone->num_vertices; j = i++) {
+        const float* a = zone->vertices[i];
+        const float* b = zone->vertices[j];
+        if ((a[1] > y) != (b[1] > y) &&
+            x < (b[0] - a[0]) * (y - a[1]) / (b[1] - a[1]) + a[0]) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+static void* zone_editor_thread(void* arg) {
+    ZoneMap* map = (ZoneMap*)arg;
+    Zone zones[2] = {
+        {.zone_id = 1, .shape = ZONE_SHAPE_CIRCLE, .center_x = 0.3f, .center_y = 0.5f,
+         .radius = 0.1f, .classes = 1, .sensitivity = 0.5f},
+        {.zone_id = 2, .shape = ZONE_SHAPE_CIRCLE, .center_x = 0.7f, .center_y = 0.5f,
+         .radius = 0.1f, .classes = 1, .sensitivity = 0.5f}
+    };
+
+    // Alternate between one and two zones
+    for (int i = 0; i < 2000; i++) {
+        zone_map_replace_all(map, zones, 1 + (i & 1));
+    }
+    return NULL;
+}
+
+void test_zone_map() {
+    printf("[TEST] rasterized zone map... ");
+
+    ZoneMap* map = zone_map_create(32);
+    assert(map != NULL);
+
+    const ZoneGrid* grid = zone_map_acquire(map);
+    assert(zone_grid_count(grid) == 0);
+    assert(zone_grid_query(grid, 0.5f, 0.5f, ZONE_CLASS_ALL) == 0);
+    zone_map_release(map, grid);
+
+    // Circle, concave L-shaped polygon, and a triangle in another class
+    Zone circle = {.zone_id = 10, .shape = ZONE_SHAPE_CIRCLE,
+                   .center_x = 0.3f, .center_y = 0.3f, .radius = 0.15f,
+                   .classes = 0x1, .sensitivity = 0.9f};
+    Zone ell = {.zone_id = 20, .shape = ZONE_SHAPE_POLYGON, .num_vertices = 6,
+                .vertices = {{0.5f, 0.5f}, {0.9f, 0.5f}, {0.9f, 0.6f},
+                             {0.6f, 0.6f}, {0.6f, 0.9f}, {0.5f, 0.9f}},
+                .classes = 0x1, .sensitivity = 0.6f};
+    Zone tri = {.zone_id = 30, .shape = ZONE_SHAPE_POLYGON, .num_vertices = 3,
+                .vertices = {{0.1f, 0.9f}, {0.45f, 0.35f}, {0.45f, 0.9f}},
+                .classes = 0x2, .sensitivity = 0.3f};
+    assert(zone_map_set(map, &circle));
+    assert(zone_map_set(map, &ell));
+    assert(zone_map_set(map, &tri));
+
+    Zone bad = {.zone_id = 40, .shape = ZONE_SHAPE_POLYGON, .num_vertices = 2};
+    assert(!zone_map_set(map, &bad));
+
+    // Grid answers match exact tests everywhere, including near edges
+    grid = zone_map_acquire(map);
+    assert(zone_grid_count(grid) == 3);
+    assert(zone_grid_version(grid) == 3);
+    srand(7);
+    for (int i = 0; i < 200000; i++) {
+        float x = (float)rand() / RAND_MAX * 1.2f - 0.1f;
+        float y = (float)rand() / RAND_MAX * 1.2f - 0.1f;
+        uint32_t expected = 0;
+        for (uint32_t slot = 0; slot < zone_grid_count(grid); slot++) {
+            if (zone_reference(zone_grid_zone(grid, slot), x, y)) {
+                expected |= 1u << slot;
+            }
+        }
+        assert(zone_grid_query(grid, x, y, ZONE_CLASS_ALL) == expected);
+    }
+
+    // Class filter, and the L's notch is outside it
+    assert(zone_grid_query(grid, 0.4f, 0.8f, 0x1) == 0);
+    assert(zone_grid_query(grid, 0.4f, 0.8f, 0x2) == 0x4);
+    assert(zone_grid_query(grid, 0.8f, 0.8f, ZONE_CLASS_ALL) == 0);
+    assert(zone_grid_query(grid, 0.55f, 0.8f, ZONE_CLASS_ALL) == 0x2);
+    assert(zone_grid_query(grid, NAN, 0.5f, ZONE_CLASS_ALL) == 0);
+
+    // An edit does not disturb a pinned grid
+    assert(zone_map_remove(map, 10));
+    assert(!zone_map_remove(map, 10));
+    assert(zone_grid_query(grid, 0.3f, 0.3f, ZONE_CLASS_ALL) == 0x1);
+    zone_map_release(map, grid);
+
+    grid = zone_map_acquire(map);
+    assert(zone_grid_count(grid) == 2);
+    assert(zone_grid_query(grid, 0.3f, 0.3f, ZONE_CLASS_ALL) == 0);
+    assert(zone_grid_zone(grid, 0)->zone_id == 20);
+    zone_map_release(map, grid);
+
+    // Readers always see a complete zone set while edits run
+    assert(zone_map_replace_all(map, NULL, 0));
+    pthread_t editor;
+    pthread_create(&editor, NULL, zone_editor_thread, map);
+    for (int i = 0; i < 20000; i++) {
+        grid = zone_map_acquire(map);
+        uint32_t n = zone_grid_count(grid);
+        if (n > 0) {
+            bool second = zone_grid_query(grid, 0.7f, 0.5f, 1) != 0;
+            assert(zone_grid_query(grid, 0.3f, 0.5f, 1) == 0x1);
+            assert(second == (n == 2));
+        }
+        zone_map_release(map, grid);
+    }
+    pthread_join(editor, NULL);
+
+    zone_map_destroy(map);
+    printf("PASS\n");
+}
+
+void test_occupancy_grid() {
+    printf("[TEST] occupancy heatmap... ");
+
+    // 8x8 cells, 1 s half-life
+    OccupancyGrid* grid = occupancy_grid_create(8, 1000, 10);
+    assert(grid != NULL);
+    assert(occupancy_grid_resolution(grid) == 8);
+
+    // One person whose feet are at (0.5, 0.5) -> cell (4, 4), for 1 s
+    TrackedObject track = {
+        .track_id = 1,
+        .class_id = OBJECT_CLASS_PERSON,
+        .current_bbox = {0.45f, 0.3f, 0.1f, 0.2f}
+    };
+    double expected = 0.0;
+    for (uint64_t t = 0; t <= 1000; t += 100) {
+        occupancy_grid_update(grid, &track, 1, t);
+        if (t > 0) {
+            expected += 0.1 * exp2(-(1000.0 - t) / 1000.0);
+        }
+    }
+
+    uint32_t cols = 0, rows = 0;
+    float presence[64], visits[64];
+    uint64_t timestamp_ms = 0;
+    assert(occupancy_grid_read(grid, &cols, &rows, presence, visits, &timestamp_ms));
+    assert(cols == 8 && rows == 8 && timestamp_ms == 1000);
+    assert(fabs(presence[4 * 8 + 4] - expected) < 1e-4);
+    assert(fabsf(visits[4 * 8 + 4] - 0.5f) < 1e-4f);  // Entered at t = 0
+
+    float total = 0.0f;
+    for (int i = 0; i < 64; i++) {
+        total += presence[i];
+    }
+    assert(fabs(total - expected) < 1e-4);
+
+    // Step into the next cell: a new visit there, none added to the old one
+    track.current_bbox.x += 0.125f;
+    occupancy_grid_update(grid, &track, 1, 1100);
+    occupancy_grid_update(grid, &track, 1, 1200);
+    cols = rows = 0;
+    occupancy_grid_read(grid, &cols, &rows, presence, visits, NULL);
+    assert(visits[4 * 8 + 5] > 0.9f && visits[4 * 8 + 5] < 1.0f);
+    assert(visits[4 * 8 + 4] < 0.5f);
+
+    // Coarser reads keep totals
+    float coarse[4];
+    uint32_t c2 = 2, r2 = 2;
+    occupancy_grid_read(grid, &c2, &r2, coarse, NULL, NULL);
+    assert(c2 == 2 && r2 == 2);
+    float fine_total = 0.0f;
+    for (int i = 0; i < 64; i++) {
+        fine_total += presence[i];
+    }
+    assert(fabsf(coarse[3] - fine_total) < 1e-4f);
+    assert(coarse[0] == 0.0f && coarse[1] == 0.0f && coarse[2] == 0.0f);
+
+    // Nobody around for 30 s (forces a rescale): everything decays ~2^-30
+    for (uint64_t t = 1300; t <= 31200; t += 100) {
+        occupancy_grid_update(grid, NULL, 0, t);
+    }
+    cols = rows = 0;
+    occupancy_grid_read(grid, &cols, &rows, presence, visits, NULL);
+    assert(presence[4 * 8 + 5] > 0.0f && presence[4 * 8 + 5] < 1e-8f);
+
+    // Binary export
+    occupancy_grid_update(grid, &track, 1, 31300);
+    occupancy_grid_update(grid, &track, 1, 31400);
+    uint8_t buffer[OCCUPANCY_EXPORT_SIZE(8, 8)];
+    assert(occupancy_grid_export(grid, 8, 8, buffer, sizeof(buffer) - 1) == 0);
+    assert(occupancy_grid_export(grid, 8, 8, buffer, sizeof(buffer)) == sizeof(buffer));
+    assert(memcmp(buffer, "OHM1", 4) == 0);
+    assert(buffer[4] == 8 && buffer[5] == 0 && buffer[6] == 8 && buffer[7] == 0);
+    uint32_t cell = OCCUPANCY_EXPORT_HEADER_SIZE + (4 * 8 + 5) * 2;
+    assert(buffer[cell] == 0xFF && buffer[cell + 1] == 0xFF);  // Hottest cell = 65535
+
+    occupancy_grid_reset(grid);
+    cols = rows = 0;
+    occupancy_grid_read(grid, &cols, &rows, presence, NULL, NULL);
+    assert(presence[4 * 8 + 5] == 0.0f);
+
+    occupancy_grid_destroy(grid);
+    printf("PASS\n");
+}
+
+static void place_person(TrackedObject* track, uint32_t id, float cx, float cy,
+                         float vx, float vy) {
+    memset(track, 0, sizeof(TrackedObject));
+    track->track_id = id;
+    track->class_id = OBJECT_CLASS_PERSON;
+    track->current_bbox = (BoundingBox){cx - 0.02f, cy - 0.05f, 0.04f, 0.1f};
+    track->velocity_x = vx;
+    track->velocity_y = vy;
+}
+
+static uint32_t brute_find(uint32_t* parent, uint32_t i) {
+    while (parent[i] != i) {
+        i = parent[i];
+    }
+    return i;
+}
+
+void test_group_analyzer() {
+    printf("[TEST] group / crowd analyzer... ");
+
+    GroupAnalyzerConfig config = {
+        .link_distance = 0.08f,
+        .velocity_tolerance = 0.01f,
+        .crowd_size = 6,
+        .growth_window_ms = 1000,
+        .max_tracks = 500
+    };
+    GroupAnalyzer* analyzer = group_analyzer_create(&config);
+    assert(analyzer != NULL);
+
+    // Two walking groups of three, a loner, and a runner crossing group A
+    TrackedObject tracks[500];
+    GroupInfo groups[250];
+    uint32_t id_a = 0, id_b = 0;
+    for (uint32_t f = 0; f < 20; f++) {
+        float t = (float)f * 0.005f;
+        place_person(&tracks[0], 1, 0.20f + t, 0.30f, 0.005f, 0.0f);
+        place_person(&tracks[1], 2, 0.25f + t, 0.32f, 0.005f, 0.0f);
+        place_person(&tracks[2], 3, 0.22f + t, 0.36f, 0.005f, 0.0f);
+        place_person(&tracks[3], 4, 0.70f, 0.70f - t, 0.0f, -0.005f);
+        place_person(&tracks[4], 5, 0.74f, 0.72f - t, 0.0f, -0.005f);
+        place_person(&tracks[5], 6, 0.71f, 0.76f - t, 0.0f, -0.005f);
+        place_person(&tracks[6], 7, 0.50f, 0.90f, 0.0f, 0.0f);
+        place_person(&tracks[7], 8, 0.23f + t, 0.33f, 0.04f, 0.0f);
+
+        assert(group_analyzer_update(analyzer, tracks, 8, 1000 + f * 100) == 2);
+        uint32_t n = group_analyzer_get_groups(analyzer, groups, 250);
+        assert(n == 2);
+        assert(groups[0].num_members == 3 && groups[1].num_members == 3);
+        if (f == 0) {
+            id_a = group_analyzer_get_track_group(analyzer, 1);
+            id_b = group_analyzer_get_track_group(analyzer, 4);
+            assert(id_a != 0 && id_b != 0 && id_a != id_b);
+        }
+        assert(group_analyzer_get_track_group(analyzer, 2) == id_a);
+        assert(group_analyzer_get_track_group(analyzer, 6) == id_b);
+        assert(group_analyzer_get_track_group(analyzer, 7) == 0);   // Alone
+        assert(group_analyzer_get_track_group(analyzer, 8) == 0);   // Too fast
+        assert(!groups[0].is_crowd);
+    }
+    assert(fabsf(groups[0].velocity_x + groups[0].velocity_y) > 0.004f);
+
+    // Group B joins A, then four more arrive: A's id survives (older id
+    // wins the tie), the merged group grows into a crowd
+    for (uint32_t i = 0; i < 3; i++) {
+        place_person(&tracks[3 + i], 4 + i, 0.26f + 0.03f * (float)i, 0.40f, 0.0f, 0.0f);
+    }
+    for (uint32_t i = 0; i < 3; i++) {
+        place_person(&tracks[i], 1 + i, 0.24f + 0.03f * (float)i, 0.34f, 0.0f, 0.0f);
+    }
+    group_analyzer_update(analyzer, tracks, 7, 3000);
+    assert(group_analyzer_get_groups(analyzer, groups, 250) == 1);
+    assert(groups[0].group_id == id_a && groups[0].num_members == 6);
+    assert(groups[0].is_crowd && groups[0].growth_rate > 0.0f);
+    assert(groups[0].first_seen_ms == 1000);
+    assert(groups[0].density > 0.0f);
+    float merged_growth = groups[0].growth_rate;
+
+    GroupAnalyzerStats stats;
+    group_analyzer_get_stats(analyzer, &stats);
+    assert(stats.active_groups == 1 && stats.active_crowds == 1 && stats.crowds_formed == 1);
+    assert(stats.grouped_tracks == 6 && stats.groups_formed == 2);
+
+    // Split off two: the larger part keeps the id, the rest gets a new one
+    place_person(&tracks[4], 5, 0.80f, 0.80f, 0.0f, 0.0f);
+    place_person(&tracks[5], 6, 0.84f, 0.80f, 0.0f, 0.0f);
+    group_analyzer_update(analyzer, tracks, 7, 3100);
+    assert(group_analyzer_get_groups(analyzer, groups, 250) == 2);
+    assert(groups[0].group_id == id_a && groups[0].num_members == 4);
+    assert(groups[0].growth_rate < merged_growth);
+    assert(groups[0].peak_members == 6 && !groups[0].is_crowd);
+    assert(groups[1].group_id != id_a && groups[1].group_id != id_b);
+
+    // Partition matches all-pairs union-find on a random scene
+    group_analyzer_reset(analyzer);
+    srand(37);
+    for (uint32_t round = 0; round < 20; round++) {
+        uint32_t n = 300 + (uint32_t)(rand() % 200);
+        for (uint32_t i = 0; i < n; i++) {
+            float cx = (float)rand() / RAND_MAX * 1.2f - 0.1f;
+            float cy = (float)rand() / RAND_MAX * 1.2f - 0.1f;
+            float vx = (float)(rand() % 3) * 0.008f;
+            place_person(&tracks[i], 1000 + i, cx, cy, vx, 0.0f);
+        }
+        group_analyzer_update(analyzer, tracks, n, 10000 + round * 100);
+
+        uint32_t parent[500], size[500];
+        for (uint32_t i = 0; i < n; i++) {
+            parent[i] = i;
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            for (uint32_t j = i + 1; j < n; j++) {
+                float dx = (tracks[i].current_bbox.x - tracks[j].current_bbox.x);
+                float dy = (tracks[i].current_bbox.y - tracks[j].current_bbox.y);
+                float dv = tracks[i].velocity_x - tracks[j].velocity_x;
+                if (dx * dx + dy * dy <= 0.08f * 0.08f && dv * dv <= 0.01f * 0.01f) {
+                    parent[brute_find(parent, i)] = brute_find(parent, j);
+                }
+            }
+        }
+        memset(size, 0, sizeof(size));
+        for (uint32_t i = 0; i < n; i++) {
+            size[brute_find(parent, i)]++;
+        }
+
+        uint32_t group_of[500];
+        for (uint32_t i = 0; i < n; i++) {
+            group_of[i] = group_analyzer_get_track_group(analyzer, 1000 + i);
+            assert((group_of[i] != 0) == (size[brute_find(parent, i)] >= 2));
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            for (uint32_t j = i + 1; j < n; j++) {
+                if (group_of[i] == 0 || group_of[j] == 0) continue;
+                bool same = brute_find(parent, i) == brute_find(parent, j);
+                assert(same == (group_of[i] == group_of[j]));
+            }
+        }
+    }
+
+    group_analyzer_destroy(analyzer);
+    printf("PASS\n");
+}
+
+/**
+ * Move one synthetic track a frame: idle jitter, fast straight runs,
+ * slow pacing, regular reversals or zig-zag, by kind
+ */
+static void behavior_scene_step(TrackedObject* track, uint32_t kind, uint32_t frame) {
+    BoundingBox* box = &track->current_bbox;
+    float jitter = 0.002f * ((float)rand() / RAND_MAX - 0.5f);
+    float dx = 0.0f;
+    float dy = 0.0f;
+
+    switch (kind) {
+    case 0:
+        dx = jitter;
+        dy = 0.002f * ((float)rand() / RAND_MAX - 0.5f);
+        break;
+    case 1:
+        dx = (frame / 20) % 2 ? -0.04f : 0.04f;
+        dy = jitter;
+        break;
+    case 2:
+        dx = (frame / 60) % 2 ? -0.006f : 0.006f;
+        break;
+    case 3:
+        // Reversal counts that hover around the detector thresholds
+        dx = (frame / 12) % 2 ? -0.004f : 0.004f;
+        break;
+    case 4:
+        dx = (frame / 30) % 2 ? -0.004f : 0.004f;
+        break;
+    default:
+        dx = 0.01f * ((float)rand() / RAND_MAX - 0.5f);
+        dy = (frame % 2) ? 0.01f : -0.01f;
+        break;
+    }
+
+    box->x += dx;
+    box->y += dy;
+    track->velocity_x = dx;
+    track->velocity_y = dy;
+    track->frame_count++;
+}
+
+/**
+ * Run the same scene through an old analyzer and the batch analyzer and
+ * require identical flags and scores on every track of every frame (up to
+ * rounding, which -ffast-math may reorder)
+ */
+static void behavior_batch_differential(BehaviorRules rules, uint32_t window_ms,
+                                        ZoneMap* zones) {
+    enum { NUM_TRACKS = 40, FRAMES = 1500 };
+
+    BehaviorBatchConfig config = {
+        .rules = rules,
+        .basic = {
+            .loitering_threshold_ms = 5000,
+            .loitering_movement_threshold = 0.005f,
+            .running_velocity_threshold = 50.0f,
+            .running_frames_threshold = 5,
+            .repeated_passes_count = 3,
+            .repeated_passes_window_ms = window_ms,
+            .max_tracks = 64,
+            .loitering_weight = 0.3f,
+            .running_weight = 0.5f,
+            .repeated_passes_weight = 0.4f
+        },
+        .trajectory = {
+            .loitering_dwell_time_ms = (float)window_ms,
+            .loitering_velocity_threshold = 0.5f,
+            .loitering_radius_meters = 0.5f,
+            .running_velocity_threshold = 3.0f,
+            .running_duration_ms = 1000,
+            .zigzag_threshold = 45.0f,
+            .zigzag_count_threshold = 5,
+            .enable_zone_analysis = zones != NULL,
+            .zone_map = zones,
+            .weight_zone = 0.25f,
+            .max_tracks = 64,
+            .meters_per_normalized_unit = 10.0f,
+            .weight_loitering = 0.3f,
+            .weight_running = 0.4f,
+            .weight_unusual_movement = 0.5f,
+            .weight_dwell_time = 0.2f
+        }
+    };
+
+    BehaviorBatch* batch = behavior_batch_create(&config);
+    BehaviorAnalyzer* basic = rules == BEHAVIOR_RULES_BASIC ? behavior_init(&config.basic) : NULL;
+    BehaviorAnalyzer* trajectory = rules == BEHAVIOR_RULES_TRAJECTORY ?
+                                   behavior_analyzer_init(&config.trajectory) : NULL;
+    assert(batch && (basic || trajectory));
+
+    TrackedObject tracks[NUM_TRACKS];
+    TrackedObject expected[NUM_TRACKS];
+    memset(tracks, 0, sizeof(tracks));
+    uint32_t next_id = 1;
+    for (uint32_t t = 0; t < NUM_TRACKS; t++) {
+        tracks[t].track_id = next_id++;
+        tracks[t].current_bbox = (BoundingBox){0.1f + 0.02f * t, 0.5f, 0.05f, 0.1f};
+    }
+
+    uint32_t flagged = 0;
+    srand(36);
+    for (uint32_t frame = 0; frame < FRAMES; frame++) {
+        uint64_t now_ms = 100 + (uint64_t)frame * 100;
+
+        // Churn: every 10 s a few tracks leave and new ones take over
+        if (frame > 0 && frame % 100 == 0) {
+            for (uint32_t t = (frame / 100) % 7; t < NUM_TRACKS; t += 7) {
+                if (basic) {
+                    assert(behavior_remove_track(basic, tracks[t].track_id));
+                } else {
+                    behavior_analyzer_clear_history(trajectory, tracks[t].track_id);
+                }
+                assert(behavior_batch_remove_track(batch, tracks[t].track_id));
+                tracks[t].track_id = next_id++;
+                tracks[t].frame_count = 0;
+                tracks[t].first_seen_ms = now_ms;
+            }
+        }
+
+        for (uint32_t t = 0; t < NUM_TRACKS; t++) {
+            behavior_scene_step(&tracks[t], t % 6, frame);
+            if (frame == 0) {
+                tracks[t].first_seen_ms = now_ms;
+            }
+            tracks[t].last_seen_ms = now_ms;
+        }
+
+        memcpy(expected, tracks, sizeof(tracks));
+        if (basic) {
+            behavior_analyze(basic, expected, NUM_TRACKS);
+        } else {
+            for (uint32_t t = 0; t < NUM_TRACKS; t++) {
+                behavior_analyzer_update_history(trajectory, expected[t].track_id,
+                                                 &expected[t].current_bbox, now_ms);
+                behavior_analyzer_analyze(trajectory, &expected[t]);
+            }
+        }
+
+        behavior_batch_analyze(batch, tracks, NUM_TRACKS);
+
+        for (uint32_t t = 0; t < NUM_TRACKS; t++) {
+            assert(tracks[t].behaviors == expected[t].behaviors);
+            assert(fabsf(tracks[t].threat_score - expected[t].threat_score) < 1e-6f);
+            flagged += tracks[t].behaviors != BEHAVIOR_NORMAL;
+        }
+    }
+
+    // The scene has to exercise the detectors for the comparison to mean anything
+    assert(flagged > FRAMES);
+
+    BehaviorBatchStats stats;
+    behavior_batch_get_stats(batch, &stats);
+    assert(stats.frames == FRAMES);
+    assert(stats.active_tracks == NUM_TRACKS);
+    assert(stats.total_tracks_analyzed == next_id - 1);
+    if (trajectory) {
+        uint32_t analyzed, loitering, running, unusual;
+        behavior_analyzer_get_stats(trajectory, &analyzed, &loitering, &running, &unusual);
+        assert(stats.loitering_detections == loitering);
+        assert(stats.running_detections == running);
+        assert(stats.unusual_movement_detections == unusual);
+        assert(loitering > 0 && running > 0 && unusual > 0);
+        behavior_analyzer_destroy(trajectory);
+    } else {
+        assert(stats.loitering_detections > 0 && stats.running_detections > 0 &&
+               stats.unusual_movement_detections > 0);
+        behavior_destroy(basic);
+    }
+
+    behavior_batch_destroy(batch);
+}
+
+void test_behavior_batch() {
+    printf("[TEST] batched behavior analyzer vs. both analyzers... ");
+
+    // Short windows are answered from the rings, long ones from the
+    // decimated histories
+    behavior_batch_differential(BEHAVIOR_RULES_BASIC, 5000, NULL);
+    behavior_batch_differential(BEHAVIOR_RULES_BASIC, 30000, NULL);
+
+    ZoneMap* zones = zone_map_create(0);
+    assert(zones != NULL);
+    Zone zone = {
+        .zone_id = 1,
+        .shape = ZONE_SHAPE_CIRCLE,
+        .center_x = 0.5f,
+        .center_y = 0.5f,
+        .radius = 0.2f,
+        .classes = ZONE_CLASS_ALL,
+        .sensitivity = 0.8f
+    };
+    assert(zone_map_set(zones, &zone));
+
+    behavior_batch_differential(BEHAVIOR_RULES_TRAJECTORY, 3000, zones);
+    behavior_batch_differential(BEHAVIOR_RULES_TRAJECTORY, 30000, NULL);
+
+    zone_map_destroy(zones);
+    printf("PASS\n");
+}
+
 void test_behavior_flags() {
     printf("[TEST] behavior flags... ");
 
@@ -218,6 +1548,20 @@ int main(int argc, char** argv) {
     test_iou_calculation();
     test_behavior_flags();
     test_tracker();
+    test_tracker_motion_regression();
+    test_tracker_low_score_association();
+    test_tracker_reid_gallery();
+    test_kalman_batch_equivalence();
+    test_track_snapshot();
+    test_motion_estimator();
+    test_tracker_camera_motion();
+    test_track_index();
+    test_behavior_sliding_window();
+    test_track_summary();
+    test_zone_map();
+    test_occupancy_grid();
+    test_behavior_batch();
+    test_group_analyzer();
     test_behavior_analyzer();
     test_perception_init();  // May skip without hardware
 
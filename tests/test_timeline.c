@@ -6,6 +6,8 @@
 #include "../src/timeline/timeline.h"
 #include "../src/timeline/trajectory_predictor.h"
 #include "../src/timeline/event_predictor.h"
+#include "../src/timeline/proximity_index.h"
+#include "../src/timeline/particle_sampler.h"
 #include "../src/perception/perception.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -13,6 +15,7 @@
 #include <assert.h>
 #include <math.h>
 #include <time.h>
+#include <stdatomic.h>
 
 #define TEST_ASSERT(condition, message) \
     do { \
@@ -28,6 +31,41 @@
         return true; \
     } while(0)
 
+// ============================================================================
+// Allocation Hook
+// ============================================================================
+
+/*
+ * Counts heap allocations while armed, by interposing malloc and friends
+ * on the glibc entry points. Not available under sanitizers, which
+ * interpose them themselves.
+ */
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+#define HAVE_ALLOC_HOOK 1
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t nmemb, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+
+static volatile bool g_count_allocs = false;
+static volatile uint32_t g_num_allocs = 0;
+
+void* malloc(size_t size) {
+    if (g_count_allocs) g_num_allocs++;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t nmemb, size_t size) {
+    if (g_count_allocs) g_num_allocs++;
+    return __libc_calloc(nmemb, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    if (g_count_allocs) g_num_allocs++;
+    return __libc_realloc(ptr, size);
+}
+#endif
+
 // ============================================================================
 // Test Utilities
 // ============================================================================
@@ -38,6 +76,13 @@ static uint64_t get_current_time_ms() {
     return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
 }
 
+static uint32_t copy_events(const Timeline* timeline, PredictedEvent* events, uint32_t max_events) {
+    uint32_t n = timeline->num_predicted_events < max_events ?
+                 timeline->num_predicted_events : max_events;
+    memcpy(events, timeline->predicted_events, n * sizeof(PredictedEvent));
+    return n;
+}
+
 static TrackedObject create_test_track(
     uint32_t id,
     float x, float y,
@@ -49,17 +94,17 @@ static TrackedObject create_test_track(
     memset(&track, 0, sizeof(TrackedObject));
 
     track.track_id = id;
-    track.box.x = x;
-    track.box.y = y;
-    track.box.width = 50;
-    track.box.height = 100;
+    track.current_bbox.x = x;
+    track.current_bbox.y = y;
+    track.current_bbox.width = 50;
+    track.current_bbox.height = 100;
     track.confidence = 0.9f;
     track.velocity_x = vx;
     track.velocity_y = vy;
     track.behaviors = behaviors;
     track.threat_score = threat_score;
     track.last_seen_ms = get_current_time_ms();
-    track.frames_tracked = 30;
+    track.frame_count = 30;
 
     return track;
 }
@@ -70,7 +115,7 @@ static TrackedObject create_test_track(
 
 bool test_trajectory_predictor_init() {
     TrajectoryPredictorConfig config = {
-        .motion_model = MOTION_MODEL_KALMAN,
+        .motion_model = MOTION_KALMAN_FILTER,
         .prediction_horizon_s = 30.0f,
         .prediction_step_s = 1.0f,
         .max_branch_depth = 3
@@ -85,7 +130,7 @@ bool test_trajectory_predictor_init() {
 
 bool test_trajectory_constant_velocity() {
     TrajectoryPredictorConfig config = {
-        .motion_model = MOTION_MODEL_CONSTANT_VELOCITY,
+        .motion_model = MOTION_CONSTANT_VELOCITY,
         .prediction_horizon_s = 10.0f,
         .prediction_step_s = 1.0f,
         .max_branch_depth = 3
@@ -110,13 +155,13 @@ bool test_trajectory_constant_velocity() {
     TEST_ASSERT(result, "Prediction succeeded");
     TEST_ASSERT(trajectory.num_predictions == 10, "Correct number of predictions");
 
-    // Check first prediction (1 second ahead)
-    float expected_x = 100 + 10 * 1;  // x + vx * t
+    // Check first prediction (1 second ahead), from the box centre
+    float expected_x = 125 + 10 * 1;  // x + width / 2 + vx * t
     TEST_ASSERT(fabsf(trajectory.predictions[0].x - expected_x) < 0.1f,
                "First prediction X coordinate");
 
     // Check last prediction (10 seconds ahead)
-    expected_x = 100 + 10 * 10;
+    expected_x = 125 + 10 * 10;
     TEST_ASSERT(fabsf(trajectory.predictions[9].x - expected_x) < 0.1f,
                "Last prediction X coordinate");
 
@@ -126,7 +171,7 @@ bool test_trajectory_constant_velocity() {
 
 bool test_trajectory_branching() {
     TrajectoryPredictorConfig config = {
-        .motion_model = MOTION_MODEL_KALMAN,
+        .motion_model = MOTION_KALMAN_FILTER,
         .prediction_horizon_s = 10.0f,
         .prediction_step_s = 1.0f,
         .max_branch_depth = 3
@@ -157,7 +202,7 @@ bool test_trajectory_branching() {
 
 bool test_trajectory_collision_detection() {
     TrajectoryPredictorConfig config = {
-        .motion_model = MOTION_MODEL_CONSTANT_VELOCITY,
+        .motion_model = MOTION_CONSTANT_VELOCITY,
         .prediction_horizon_s = 10.0f,
         .prediction_step_s = 1.0f,
         .max_branch_depth = 3
@@ -165,7 +210,7 @@ bool test_trajectory_collision_detection() {
 
     TrajectoryPredictor* predictor = trajectory_predictor_init(&config);
 
-    // Two tracks moving towards each other
+    // Two tracks moving towards each other, box centres 50 apart
     TrackedObject track1 = create_test_track(1, 100, 100, 10, 0, 0, 0.0f);
     TrackedObject track2 = create_test_track(2, 150, 100, -10, 0, 0, 0.0f);
 
@@ -179,14 +224,14 @@ bool test_trajectory_collision_detection() {
     bool collision = trajectory_detect_collision(
         &traj1,
         &traj2,
-        10.0f,  // Collision distance
+        15.0f,  // Collision distance
         &collision_time,
         &collision_x,
         &collision_y
     );
 
     TEST_ASSERT(collision, "Collision detected");
-    TEST_ASSERT(fabsf(collision_x - 125.0f) < 5.0f, "Collision X near midpoint");
+    TEST_ASSERT(fabsf(collision_x - 150.0f) < 5.0f, "Collision X near midpoint");
 
     trajectory_predictor_destroy(predictor);
     TEST_PASS("Collision detection");
@@ -194,7 +239,7 @@ bool test_trajectory_collision_detection() {
 
 bool test_trajectory_zone_entry() {
     TrajectoryPredictorConfig config = {
-        .motion_model = MOTION_MODEL_CONSTANT_VELOCITY,
+        .motion_model = MOTION_CONSTANT_VELOCITY,
         .prediction_horizon_s = 10.0f,
         .prediction_step_s = 1.0f,
         .max_branch_depth = 3
@@ -202,7 +247,7 @@ bool test_trajectory_zone_entry() {
 
     TrajectoryPredictor* predictor = trajectory_predictor_init(&config);
 
-    // Track moving towards zone at (200, 100)
+    // Box centre (125, 150) moving towards zone at (225, 150)
     TrackedObject track = create_test_track(1, 100, 100, 10, 0, 0, 0.0f);
 
     PredictedTrajectory trajectory;
@@ -213,7 +258,7 @@ bool test_trajectory_zone_entry() {
 
     bool enters = trajectory_check_zone_entry(
         &trajectory,
-        200, 100,  // Zone center
+        225, 150,  // Zone center
         20.0f,     // Zone radius
         &entry_time,
         &entry_confidence
@@ -226,6 +271,65 @@ bool test_trajectory_zone_entry() {
     TEST_PASS("Zone entry detection");
 }
 
+bool test_trajectory_social_force() {
+    TrajectoryPredictorConfig config = {
+        .motion_model = MOTION_SOCIAL_FORCE,
+        .prediction_horizon_s = 10.0f,
+        .prediction_step_s = 1.0f,
+        .max_branch_depth = 3
+    };
+
+    TrajectoryPredictor* predictor = trajectory_predictor_init(&config);
+    TEST_ASSERT(predictor != NULL, "Predictor created");
+
+    // Two tracks walking into each other, one far outside the cutoff
+    TrackedObject tracks[3] = {
+        create_test_track(1, 100, 100, 10, 0, 0, 0.0f),
+        create_test_track(2, 130, 100, -10, 0, 0, 0.0f),
+        create_test_track(3, 2000, 2000, 5, 0, 0, 0.0f)
+    };
+
+    PredictedTrajectory single[3];
+    for (uint32_t i = 0; i < 3; i++) {
+        TEST_ASSERT(trajectory_predict_single(predictor, &tracks[i], tracks, 3,
+                                              NULL, &single[i]),
+                   "Single prediction succeeded");
+    }
+
+    // Far track feels no force: constant velocity
+    float far_x = 2000 + 25 + 5 * 10;
+    TEST_ASSERT(fabsf(single[2].predictions[9].x - far_x) < 0.1f,
+               "Far track unaffected");
+
+    // Near tracks push each other back
+    TEST_ASSERT(single[0].predictions[9].x < 125 + 10 * 10, "First track repelled");
+    TEST_ASSERT(single[1].predictions[9].x > 155 - 10 * 10, "Second track repelled");
+
+    // One joint simulation gives the same paths as one target at a time
+    const TrackedObject* targets[3] = {&tracks[0], &tracks[1], &tracks[2]};
+    PredictedTrajectory batch[3];
+    PredictedTrajectory* outputs[3] = {&batch[0], &batch[1], &batch[2]};
+    bool ok[3];
+    uint32_t predicted = trajectory_predict_batch(predictor, targets, 3, tracks, 3,
+                                                  NULL, outputs, ok, NULL);
+    TEST_ASSERT(predicted == 3, "Batch predicted every track");
+
+    for (uint32_t i = 0; i < 3; i++) {
+        TEST_ASSERT(batch[i].num_predictions == single[i].num_predictions,
+                   "Batch step count matches");
+        for (uint32_t k = 0; k < single[i].num_predictions; k++) {
+            TEST_ASSERT(batch[i].predictions[k].x == single[i].predictions[k].x &&
+                       batch[i].predictions[k].y == single[i].predictions[k].y &&
+                       batch[i].predictions[k].vx == single[i].predictions[k].vx &&
+                       batch[i].predictions[k].vy == single[i].predictions[k].vy,
+                       "Batch path matches single prediction");
+        }
+    }
+
+    trajectory_predictor_destroy(predictor);
+    TEST_PASS("Social force prediction");
+}
+
 // ============================================================================
 // Event Predictor Tests
 // ============================================================================
@@ -273,7 +377,7 @@ bool test_event_predict_loitering() {
     EventPredictor* event_predictor = event_predictor_init(&config);
 
     TrajectoryPredictorConfig traj_config = {
-        .motion_model = MOTION_MODEL_CONSTANT_VELOCITY,
+        .motion_model = MOTION_CONSTANT_VELOCITY,
         .prediction_horizon_s = 10.0f,
         .prediction_step_s = 1.0f,
         .max_branch_depth = 3
@@ -292,7 +396,7 @@ bool test_event_predict_loitering() {
     bool detected = event_predict_loitering(event_predictor, &trajectory, &event);
 
     TEST_ASSERT(detected, "Loitering detected");
-    TEST_ASSERT(event.type == EVENT_TYPE_LOITERING, "Correct event type");
+    TEST_ASSERT(event.type == EVENT_LOITERING, "Correct event type");
     TEST_ASSERT(event.probability > 0.3f, "Reasonable probability");
 
     trajectory_predictor_destroy(traj_predictor);
@@ -319,7 +423,7 @@ bool test_event_predict_collision() {
     EventPredictor* event_predictor = event_predictor_init(&config);
 
     TrajectoryPredictorConfig traj_config = {
-        .motion_model = MOTION_MODEL_CONSTANT_VELOCITY,
+        .motion_model = MOTION_CONSTANT_VELOCITY,
         .prediction_horizon_s = 10.0f,
         .prediction_step_s = 1.0f,
         .max_branch_depth = 3
@@ -339,14 +443,165 @@ bool test_event_predict_collision() {
     bool detected = event_predict_collision(event_predictor, trajectories, 2, &event);
 
     TEST_ASSERT(detected, "Collision detected");
-    TEST_ASSERT(event.type == EVENT_TYPE_COLLISION, "Correct event type");
-    TEST_ASSERT(event.num_involved_tracks == 2, "Two tracks involved");
+    TEST_ASSERT(event.type == EVENT_COLLISION, "Correct event type");
+    TEST_ASSERT(event.num_involved == 2, "Two tracks involved");
 
     trajectory_predictor_destroy(traj_predictor);
     event_predictor_destroy(event_predictor);
     TEST_PASS("Collision prediction");
 }
 
+bool test_event_zone_entries() {
+    TrajectoryPredictorConfig traj_config = {
+        .motion_model = MOTION_CONSTANT_VELOCITY,
+        .prediction_horizon_s = 15.0f,
+        .prediction_step_s = 1.0f,
+        .max_branch_depth = 3
+    };
+    TrajectoryPredictor* traj_predictor = trajectory_predictor_init(&traj_config);
+
+    // 20 pixels per step, so a 5 pixel zone around a step holds only that step
+    TrackedObject track = create_test_track(1, 100, 100, 20, 0, BEHAVIOR_CONCEALING, 1.0f);
+    PredictedTrajectory trajectory;
+    trajectory_predict_single(traj_predictor, &track, NULL, 0, NULL, &trajectory);
+    const PredictedState* entry = &trajectory.predictions[5];
+
+    // A trespassing zone at step 7, and an older all-events zone at step 5
+    SceneContext scene;
+    memset(&scene, 0, sizeof(SceneContext));
+    scene.time_of_day_risk = 1.0f;
+    scene.num_zones = 2;
+    scene.zones[0].x = trajectory.predictions[7].x;
+    scene.zones[0].y = trajectory.predictions[7].y;
+    scene.zones[0].radius = 5.0f;
+    scene.zones[0].protected_event = EVENT_TRESPASSING;
+    scene.zones[0].sensitivity = 0.9f;
+    scene.zones[1].x = entry->x;
+    scene.zones[1].y = entry->y;
+    scene.zones[1].radius = 5.0f;
+    scene.zones[1].protected_event = EVENT_NONE;
+    scene.zones[1].sensitivity = 0.5f;
+
+    EventPredictorConfig config = {
+        .loitering_threshold_ms = 60000,
+        .theft_proximity_threshold = 0.3f,
+        .assault_velocity_threshold = 50.0f,
+        .collision_distance_threshold = 30.0f,
+        .scene = &scene
+    };
+    EventPredictor* event_predictor = event_predictor_init(&config);
+    TEST_ASSERT(traj_predictor && event_predictor, "Predictors created");
+
+    PredictedEvent trespass, theft;
+    TEST_ASSERT(event_predict_trespassing(event_predictor, &trajectory, &trespass),
+               "Trespassing detected");
+    TEST_ASSERT(trespass.timestamp_ms == entry->timestamp_ms &&
+               trespass.location_x == entry->x && trespass.location_y == entry->y,
+               "Trespassing reported at the first zone step");
+    TEST_ASSERT(trespass.probability == entry->confidence * 0.5f,
+               "Sensitivity of the first zone entered");
+
+    TEST_ASSERT(event_predict_theft(event_predictor, &trajectory, 1, &theft),
+               "Theft detected through the all-events zone");
+    TEST_ASSERT(theft.timestamp_ms == entry->timestamp_ms, "Theft reported at zone entry");
+
+    // The full pass reports the same events
+    PredictedEvent events[8];
+    uint32_t n = event_predictor_predict(event_predictor, &trajectory, 1, events, 8);
+    uint32_t matched = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        const PredictedEvent* expected = events[i].type == EVENT_THEFT ? &theft :
+                                         events[i].type == EVENT_TRESPASSING ? &trespass :
+                                         NULL;
+        if (expected && events[i].timestamp_ms == expected->timestamp_ms &&
+            events[i].probability == expected->probability) {
+            matched++;
+        }
+    }
+    TEST_ASSERT(matched == 2, "Full pass matches the single checks");
+
+    trajectory_predictor_destroy(traj_predictor);
+    event_predictor_destroy(event_predictor);
+    TEST_PASS("Zone entry events");
+}
+
+bool test_event_proximity_index() {
+    TrajectoryPredictorConfig traj_config = {
+        .motion_model = MOTION_CONSTANT_VELOCITY,
+        .prediction_horizon_s = 60.0f,
+        .prediction_step_s = 1.0f,
+        .max_branch_depth = 3
+    };
+    TrajectoryPredictor* traj_predictor = trajectory_predictor_init(&traj_config);
+    ProximityIndex* index = proximity_index_create();
+    TEST_ASSERT(traj_predictor && index, "Predictor and index created");
+
+    // Pedestrians crossing a 400x400 area, some with shorter horizons
+    enum { NUM = 80 };
+    static PredictedTrajectory trajectories[NUM];
+    srand(46);
+    for (uint32_t i = 0; i < NUM; i++) {
+        TrackedObject track = create_test_track(i + 1, rand() % 400, rand() % 400,
+                                                rand() % 21 - 10, rand() % 21 - 10,
+                                                0, 0.0f);
+        trajectory_predict_single(traj_predictor, &track, NULL, 0, NULL, &trajectories[i]);
+        if (i % 9 == 0) {
+            trajectories[i].num_predictions = 20;
+        }
+    }
+
+    const float radius = 50.0f;
+    TEST_ASSERT(proximity_index_build(index, trajectories, NUM, radius), "Index built");
+
+    // Contacts: every pair within the radius at a common step, nothing far
+    for (uint32_t i = 0; i < NUM; i++) {
+        uint64_t contacts[PROXIMITY_INDEX_WORDS(NUM)];
+        proximity_index_contacts(index, i, contacts);
+
+        for (uint32_t j = 0; j < NUM; j++) {
+            uint32_t steps = trajectories[i].num_predictions < trajectories[j].num_predictions ?
+                             trajectories[i].num_predictions : trajectories[j].num_predictions;
+            float closest = INFINITY;
+            for (uint32_t s = 0; s < steps; s++) {
+                float dx = trajectories[j].predictions[s].x - trajectories[i].predictions[s].x;
+                float dy = trajectories[j].predictions[s].y - trajectories[i].predictions[s].y;
+                closest = fminf(closest, sqrtf(dx*dx + dy*dy));
+            }
+
+            bool in_contact = (contacts[j / 64] >> (j % 64)) & 1;
+            TEST_ASSERT(j != i || !in_contact, "Trajectory not in contact with itself");
+            TEST_ASSERT(j == i || closest > radius || in_contact, "Close pair reported");
+            TEST_ASSERT(!in_contact || closest <= radius * 1.001f, "Far pair not reported");
+        }
+    }
+
+    // Nearby: the lowest-numbered trajectories within range, ascending
+    for (uint32_t i = 0; i < NUM; i++) {
+        uint32_t step = (i * 7) % 60;
+        uint32_t nearby[3];
+        uint32_t num_nearby = proximity_index_nearby(index, i, step, 100.0f, nearby, 3);
+
+        uint32_t expected[3];
+        uint32_t num_expected = 0;
+        for (uint32_t j = 0; j < NUM && num_expected < 3 && step < trajectories[i].num_predictions; j++) {
+            if (j == i || step >= trajectories[j].num_predictions) continue;
+            float dx = trajectories[j].predictions[step].x - trajectories[i].predictions[step].x;
+            float dy = trajectories[j].predictions[step].y - trajectories[i].predictions[step].y;
+            if (sqrtf(dx*dx + dy*dy) < 100.0f) {
+                expected[num_expected++] = j;
+            }
+        }
+
+        TEST_ASSERT(num_nearby == num_expected, "Nearby count matches scan");
+        TEST_ASSERT(memcmp(nearby, expected, num_nearby * sizeof(uint32_t)) == 0,
+                   "Nearby trajectories match scan");
+    }
+
+    proximity_index_destroy(index);
+    trajectory_predictor_destroy(traj_predictor);
+    TEST_PASS("Proximity index");
+}
+
 bool test_event_severity_calculation() {
     SceneContext scene;
     memset(&scene, 0, sizeof(SceneContext));
@@ -369,7 +624,7 @@ bool test_event_severity_calculation() {
     // Create high-probability assault event
     PredictedEvent event;
     memset(&event, 0, sizeof(PredictedEvent));
-    event.type = EVENT_TYPE_ASSAULT;
+    event.type = EVENT_ASSAULT;
     event.probability = 0.9f;
 
     SeverityLevel severity = event_calculate_severity(predictor, &event);
@@ -390,9 +645,8 @@ bool test_timeline_engine_init() {
     memset(&scene, 0, sizeof(SceneContext));
 
     TimelineConfig config = {
-        .prediction_horizon_s = 30.0f,
-        .update_interval_ms = 100,
-        .num_timelines = 3,
+        .prediction_horizon_ms = 30000,
+        .max_timelines = 3,
         .branching_enabled = true,
         .scene_context = &scene
     };
@@ -410,9 +664,8 @@ bool test_timeline_update() {
     scene.time_of_day_risk = 1.0f;
 
     TimelineConfig config = {
-        .prediction_horizon_s = 30.0f,
-        .update_interval_ms = 100,
-        .num_timelines = 3,
+        .prediction_horizon_ms = 30000,
+        .max_timelines = 3,
         .branching_enabled = true,
         .scene_context = &scene
     };
@@ -424,13 +677,13 @@ bool test_timeline_update() {
     tracks[0] = create_test_track(1, 100, 100, 10, 5, 0, 0.5f);
     tracks[1] = create_test_track(2, 200, 150, -5, 3, BEHAVIOR_LOITERING, 0.7f);
 
-    Timeline* timelines[10];
+    Timeline timelines[10];
     uint32_t num_timelines = timeline_update(
         engine,
         tracks,
         2,
-        get_current_time_ms(),
-        timelines
+        timelines,
+        10
     );
 
     TEST_ASSERT(num_timelines > 0, "Timelines created");
@@ -440,7 +693,7 @@ bool test_timeline_update() {
     uint64_t total_events = 0;
     for (uint32_t i = 0; i < num_timelines; i++) {
         PredictedEvent events[50];
-        uint32_t n = timeline_get_events(timelines[i], events, 50);
+        uint32_t n = copy_events(&timelines[i], events, 50);
         total_events += n;
     }
 
@@ -459,41 +712,56 @@ bool test_timeline_interventions() {
     scene.zones[0].x = 150;
     scene.zones[0].y = 150;
     scene.zones[0].radius = 50;
-    scene.zones[0].protected_event = EVENT_TYPE_TRESPASSING;
+    scene.zones[0].protected_event = EVENT_TRESPASSING;
     scene.zones[0].sensitivity = 0.9f;
 
     TimelineConfig config = {
-        .prediction_horizon_s = 30.0f,
-        .update_interval_ms = 100,
-        .num_timelines = 3,
+        .prediction_horizon_ms = 30000,
+        .max_timelines = 3,
         .branching_enabled = true,
         .scene_context = &scene
     };
 
     TimelineEngine* engine = timeline_init(&config);
 
-    // Track moving towards protected zone
+    // Track moving towards protected zone (box centre starts at (125, 150))
     TrackedObject tracks[1];
-    tracks[0] = create_test_track(1, 100, 150, 5, 0, 0, 0.6f);
+    tracks[0] = create_test_track(1, 100, 100, 5, 0, 0, 0.6f);
 
-    Timeline* timelines[10];
+    Timeline timelines[10];
     uint32_t num_timelines = timeline_update(
         engine,
         tracks,
         1,
-        get_current_time_ms(),
-        timelines
+        timelines,
+        10
     );
+    TEST_ASSERT(num_timelines > 0, "Timelines created");
+
+    Timeline by_id;
+    TEST_ASSERT(timeline_get_by_id(engine, timelines[0].timeline_id, &by_id), "Timeline found by ID");
+    TEST_ASSERT(by_id.num_predicted_events == timelines[0].num_predicted_events, "Same timeline");
 
     // Get best intervention
     InterventionPoint intervention;
     bool has_intervention = timeline_get_best_intervention(engine, &intervention);
 
     if (has_intervention) {
-        printf("  Intervention: type=%d, urgency=%d, time_to_act=%lums\n",
-               intervention.intervention,
-               intervention.urgency,
-               intervention.time_to_act_ms);
+        printf("  Intervention: %s, effectiveness=%.2f, prevents %s\n",
+               timeline_intervention_to_string(intervention.type),
+               intervention.effectiveness,
+               timeline_event_to_string(intervention.prevented_event.type));
+
+        // Applied, the event leaves every timeline
+        num_timelines = timeline_apply_intervention(engine, &intervention, timelines, 10);
+        for (uint32_t i = 0; i < num_timelines; i++) {
+            for (uint32_t j = 0; j < timelines[i].num_predicted_events; j++) {
+                const PredictedEvent* event = &timelines[i].predicted_events[j];
+                TEST_ASSERT(event->type != intervention.prevented_event.type ||
+                           event->involved_tracks[0] != intervention.prevented_event.involved_tracks[0],
+                           "Prevented event removed");
+            }
+        }
     }
 
     timeline_destroy(engine);
@@ -505,9 +773,8 @@ bool test_timeline_statistics() {
     memset(&scene, 0, sizeof(SceneContext));
 
     TimelineConfig config = {
-        .prediction_horizon_s = 30.0f,
-        .update_interval_ms = 100,
-        .num_timelines = 3,
+        .prediction_horizon_ms = 30000,
+        .max_timelines = 3,
         .branching_enabled = false,
         .scene_context = &scene
     };
@@ -520,27 +787,866 @@ bool test_timeline_statistics() {
         tracks[0] = create_test_track(1, 100 + i*10, 100, 10, 0, 0, 0.5f);
         tracks[1] = create_test_track(2, 200 - i*10, 150, -10, 0, 0, 0.5f);
 
-        timeline_update(engine, tracks, 2, get_current_time_ms(), NULL);
+        timeline_update(engine, tracks, 2, NULL, 0);
     }
 
     // Get statistics
-    uint64_t num_updates = 0;
+    uint64_t total_timelines = 0;
     uint64_t total_events = 0;
     uint64_t total_interventions = 0;
-    float avg_confidence = 0.0f;
+    float avg_prediction_ms = 0.0f;
 
-    timeline_get_stats(engine, &num_updates, &total_events,
-                      &total_interventions, &avg_confidence);
+    timeline_get_stats(engine, &total_timelines, &total_events,
+                      &total_interventions, &avg_prediction_ms);
 
-    printf("  Updates: %lu, Events: %lu, Interventions: %lu, Avg confidence: %.2f\n",
-           num_updates, total_events, total_interventions, avg_confidence);
+    printf("  Timelines: %lu, Events: %lu, Interventions: %lu, Avg prediction: %.2f ms\n",
+           total_timelines, total_events, total_interventions, avg_prediction_ms);
 
-    TEST_ASSERT(num_updates == 5, "Correct number of updates");
+    TimelineUpdateStats stats;
+    timeline_get_update_stats(engine, &stats);
+    TEST_ASSERT(stats.num_updates == 5, "Correct number of updates");
+    TEST_ASSERT(total_timelines == 15, "Three timelines per update");
 
     timeline_destroy(engine);
     TEST_PASS("Timeline statistics");
 }
 
+bool test_timeline_shared_prediction() {
+    SceneContext scene;
+    memset(&scene, 0, sizeof(SceneContext));
+    scene.time_of_day_risk = 1.0f;
+
+    TimelineConfig config = {
+        .prediction_horizon_ms = 30000,
+        .max_timelines = 3,
+        .branching_enabled = false,
+        .scene_context = &scene
+    };
+
+    TimelineEngine* engine = timeline_init(&config);
+
+    // Two tracks on collision course: the event must reach every timeline
+    TrackedObject tracks[2];
+    tracks[0] = create_test_track(1, 100, 100, 10, 0, 0, 0.3f);
+    tracks[1] = create_test_track(2, 200, 100, -10, 0, 0, 0.3f);
+
+    Timeline timelines[10];
+    uint32_t num_timelines = timeline_update(engine, tracks, 2, timelines, 10);
+    TEST_ASSERT(num_timelines == 3, "All timelines built");
+
+    PredictedEvent first[50];
+    uint32_t num_first = copy_events(&timelines[0], first, 50);
+    TEST_ASSERT(num_first > 0, "Collision predicted");
+    TEST_ASSERT(first[0].type == EVENT_COLLISION, "Collision first");
+
+    for (uint32_t i = 1; i < num_timelines; i++) {
+        PredictedEvent events[50];
+        uint32_t n = copy_events(&timelines[i], events, 50);
+        TEST_ASSERT(n == num_first, "Same event count on every timeline");
+        TEST_ASSERT(memcmp(events, first, n * sizeof(PredictedEvent)) == 0,
+                   "Same events on every timeline");
+        TEST_ASSERT(timelines[i].overall_probability ==
+                   timelines[0].overall_probability, "Same probability");
+    }
+
+    timeline_destroy(engine);
+    TEST_PASS("Shared per-update prediction");
+}
+
+bool test_timeline_branching() {
+    // Protected zone 20 degrees off the track's heading: only a branch reaches it
+    SceneContext scene;
+    memset(&scene, 0, sizeof(SceneContext));
+    scene.time_of_day_risk = 1.0f;
+    scene.num_zones = 1;
+    scene.zones[0].x = 266;
+    scene.zones[0].y = 99;
+    scene.zones[0].radius = 20;
+    scene.zones[0].protected_event = EVENT_TRESPASSING;
+    scene.zones[0].sensitivity = 0.9f;
+
+    TimelineConfig config = {
+        .prediction_horizon_ms = 30000,
+        .max_timelines = 5,
+        .branching_enabled = true,
+        .scene_context = &scene
+    };
+
+    TimelineEngine* engine = timeline_init(&config);
+    TEST_ASSERT(engine != NULL, "Timeline engine initialization");
+
+    // Box centre starts at (125, 150), heading +x
+    TrackedObject tracks[2];
+    tracks[0] = create_test_track(1, 100, 100, 10, 0, 0, 0.5f);
+
+    Timeline timelines[10];
+    uint32_t num_timelines = timeline_update(engine, tracks, 1, timelines, 10);
+    TEST_ASSERT(num_timelines > 1, "Alternative futures built");
+
+    float sum_probability = 0.0f;
+    bool base_trespasses = false;
+    bool branch_trespasses = false;
+    for (uint32_t i = 0; i < num_timelines; i++) {
+        float probability = timelines[i].overall_probability;
+        TEST_ASSERT(probability > 0.0f, "Positive probability");
+        if (i > 0) {
+            TEST_ASSERT(probability <= timelines[i - 1].overall_probability,
+                       "Most probable timeline first");
+        }
+        sum_probability += probability;
+
+        PredictedEvent events[50];
+        uint32_t n = copy_events(&timelines[i], events, 50);
+        for (uint32_t j = 0; j < n; j++) {
+            if (events[j].type == EVENT_TRESPASSING) {
+                if (i == 0) base_trespasses = true;
+                else branch_trespasses = true;
+            }
+        }
+    }
+    TEST_ASSERT(sum_probability <= 1.0f + 1e-4f, "Timelines share the probability mass");
+    TEST_ASSERT(!base_trespasses, "Base timeline misses the zone");
+    TEST_ASSERT(branch_trespasses, "A branch enters the zone");
+
+    // Stationary tracks: every alternative coincides and merges into one future
+    tracks[0] = create_test_track(1, 100, 100, 0, 0, 0, 0.5f);
+    tracks[1] = create_test_track(2, 300, 300, 0, 0, BEHAVIOR_LOITERING, 0.8f);
+    num_timelines = timeline_update(engine, tracks, 2, timelines, 10);
+    TEST_ASSERT(num_timelines == 1, "Identical futures merged");
+
+    timeline_destroy(engine);
+
+    // A one-node budget leaves only the root
+    config.max_nodes = 1;
+    engine = timeline_init(&config);
+    tracks[0] = create_test_track(1, 100, 100, 10, 0, 0, 0.5f);
+    num_timelines = timeline_update(engine, tracks, 1, timelines, 10);
+    TEST_ASSERT(num_timelines == 1, "Node budget respected");
+
+    timeline_destroy(engine);
+    TEST_PASS("Branching timeline tree");
+}
+
+bool test_timeline_arena() {
+    SceneContext scene;
+    memset(&scene, 0, sizeof(SceneContext));
+    scene.time_of_day_risk = 1.0f;
+
+    TimelineConfig config = {
+        .prediction_horizon_ms = 30000,
+        .max_timelines = 5,
+        .branching_enabled = true,
+        .scene_context = &scene
+    };
+
+    TimelineEngine* engine = timeline_init(&config);
+    TEST_ASSERT(engine != NULL, "Timeline engine initialization");
+
+    TrackedObject tracks[60];
+    for (uint32_t i = 0; i < 60; i++) {
+        tracks[i] = create_test_track(i + 1, (float)(i % 10) * 40, (float)(i / 10) * 60,
+                                      (float)(i % 5) - 2, 3, 0, 0.1f * (i % 10));
+    }
+
+    // Small scene
+    size_t small_bytes = 0, high_water = 0, capacity = 0;
+    uint32_t high_water_nodes = 0;
+    timeline_update(engine, tracks, 2, NULL, 0);
+    timeline_get_arena_stats(engine, &small_bytes, &high_water, &capacity, &high_water_nodes);
+    printf("  2 tracks: %zu bytes, %u nodes\n", small_bytes, high_water_nodes);
+    TEST_ASSERT(small_bytes > 0 && small_bytes == high_water, "Arena used");
+    TEST_ASSERT(small_bytes < 16 * 1024, "Small scene, small arena");
+
+    // Large scene grows the arena
+    size_t large_bytes = 0;
+    timeline_update(engine, tracks, 60, NULL, 0);
+    timeline_get_arena_stats(engine, &large_bytes, &high_water, &capacity, &high_water_nodes);
+    printf("  60 tracks: %zu bytes, %u nodes, %zu reserved\n", large_bytes, high_water_nodes, capacity);
+    TEST_ASSERT(large_bytes > small_bytes, "Arena scales with tracks");
+    TEST_ASSERT(capacity >= large_bytes, "Capacity covers usage");
+
+    // Back to the small scene: usage drops, the high-water mark stays
+    size_t bytes = 0;
+    timeline_update(engine, tracks, 2, NULL, 0);
+    timeline_get_arena_stats(engine, &bytes, &high_water, &capacity, NULL);
+    TEST_ASSERT(bytes == small_bytes, "Arena reset per update");
+    TEST_ASSERT(high_water == large_bytes, "High-water mark kept");
+
+    timeline_destroy(engine);
+    TEST_PASS("Timeline node arena");
+}
+
+bool test_timeline_incremental() {
+    SceneContext scene;
+    memset(&scene, 0, sizeof(SceneContext));
+    scene.time_of_day_risk = 1.0f;
+
+    TimelineConfig config = {
+        .prediction_horizon_ms = 30000,
+        .max_timelines = 3,
+        .branching_enabled = false,
+        .scene_context = &scene
+    };
+
+    TimelineEngine* engine = timeline_init(&config);
+    TEST_ASSERT(engine != NULL, "Timeline engine initialization");
+
+    // Tracks 1 and 2 on a collision course, the rest walking in parallel
+    TrackedObject tracks[10];
+    tracks[0] = create_test_track(1, 0, 100, 10, 0, 0, 0.2f);
+    tracks[1] = create_test_track(2, 200, 100, -10, 0, 0, 0.2f);
+    for (uint32_t i = 2; i < 10; i++) {
+        tracks[i] = create_test_track(i + 1, (float)i * 150, 600, 0, 5, 0, 0.1f);
+    }
+
+    // Tracks keep following their prediction: trajectories are reused
+    Timeline timelines[10];
+    uint32_t num_timelines = 0;
+    for (int update = 0; update < 5; update++) {
+        num_timelines = timeline_update(engine, tracks, 10, timelines, 10);
+        for (uint32_t i = 0; i < 10; i++) {
+            tracks[i].current_bbox.x += tracks[i].velocity_x * 0.5f;
+            tracks[i].current_bbox.y += tracks[i].velocity_y * 0.5f;
+            tracks[i].last_seen_ms += 500;
+        }
+    }
+
+    TimelineUpdateStats stats;
+    timeline_get_update_stats(engine, &stats);
+    printf("  Following: %llu predicted, %llu reused (%.0f%%), %llu incremental event passes\n",
+           (unsigned long long)stats.tracks_predicted, (unsigned long long)stats.tracks_reused,
+           stats.reuse_fraction * 100.0f, (unsigned long long)stats.incremental_event_passes);
+    TEST_ASSERT(stats.tracks_predicted == 10, "Only the first update predicts");
+    TEST_ASSERT(stats.tracks_reused == 40, "Later updates reuse every trajectory");
+    TEST_ASSERT(stats.incremental_event_passes == 4, "Events updated incrementally");
+    TEST_ASSERT(num_timelines > 0, "Timelines created");
+
+    PredictedEvent events[50];
+    uint32_t num_events = copy_events(&timelines[0], events, 50);
+    bool has_collision = false;
+    for (uint32_t e = 0; e < num_events; e++) {
+        if (events[e].type == EVENT_COLLISION) {
+            has_collision = true;
+        }
+    }
+    TEST_ASSERT(has_collision, "Collision kept across reused updates");
+
+    // One track turns: only it is re-predicted
+    tracks[4].velocity_x = 20.0f;
+    tracks[4].current_bbox.x += 60.0f;
+    timeline_update(engine, tracks, 10, timelines, 10);
+    timeline_get_update_stats(engine, &stats);
+    TEST_ASSERT(stats.tracks_predicted == 11, "Deviating track re-predicted");
+    TEST_ASSERT(stats.tracks_reused == 49, "Other tracks reused");
+
+    // A departed track is forgotten; when it comes back it is predicted anew
+    tracks[9].last_seen_ms += 500;
+    timeline_update(engine, tracks, 9, timelines, 10);
+    timeline_update(engine, tracks, 10, timelines, 10);
+    timeline_get_update_stats(engine, &stats);
+    TEST_ASSERT(stats.tracks_predicted == 12, "Returning track re-predicted");
+
+    TEST_ASSERT(stats.num_updates == 8, "Updates counted");
+    TEST_ASSERT(stats.latency_p50_ms > 0.0f, "Latency measured");
+    TEST_ASSERT(stats.latency_p50_ms <= stats.latency_p99_ms &&
+                stats.latency_p99_ms <= stats.latency_max_ms, "Latency percentiles ordered");
+    printf("  Latency: p50 %.3f ms, p99 %.3f ms\n", stats.latency_p50_ms, stats.latency_p99_ms);
+
+    timeline_destroy(engine);
+
+    // Negative tolerance: every update re-predicts every track
+    config.replan_tolerance = -1.0f;
+    engine = timeline_init(&config);
+    TEST_ASSERT(engine != NULL, "Timeline engine initialization");
+    for (int update = 0; update < 3; update++) {
+        timeline_update(engine, tracks, 10, timelines, 10);
+    }
+    timeline_get_update_stats(engine, &stats);
+    TEST_ASSERT(stats.tracks_reused == 0 && stats.tracks_predicted == 30, "Reuse disabled");
+    TEST_ASSERT(stats.incremental_event_passes == 0, "Full event passes only");
+
+    timeline_destroy(engine);
+    TEST_PASS("Incremental updates");
+}
+
+/**
+ * Run one update of a busy scene and copy out every timeline's events
+ */
+static uint32_t run_threaded_update(
+    uint32_t worker_threads,
+    const TrackedObject* tracks,
+    uint32_t num_tracks,
+    PredictedEvent events[10][50],
+    uint32_t num_events[10],
+    float probability[10]
+) {
+    SceneContext scene;
+    memset(&scene, 0, sizeof(SceneContext));
+    scene.time_of_day_risk = 1.0f;
+    scene.num_zones = 1;
+    scene.zones[0].x = 300;
+    scene.zones[0].y = 300;
+    scene.zones[0].radius = 60;
+    scene.zones[0].protected_event = EVENT_TRESPASSING;
+    scene.zones[0].sensitivity = 0.9f;
+
+    TimelineConfig config = {
+        .prediction_horizon_ms = 60000,
+        .max_timelines = 5,
+        .branching_enabled = true,
+        .scene_context = &scene,
+        .worker_threads = worker_threads
+    };
+
+    TimelineEngine* engine = timeline_init(&config);
+    if (!engine) {
+        return 0;
+    }
+
+    Timeline timelines[10];
+    uint32_t num_timelines = timeline_update(engine, tracks, num_tracks, timelines, 10);
+    for (uint32_t i = 0; i < num_timelines; i++) {
+        num_events[i] = copy_events(&timelines[i], events[i], 50);
+        probability[i] = timelines[i].overall_probability;
+    }
+
+    timeline_destroy(engine);
+    return num_timelines;
+}
+
+bool test_timeline_step_schedule() {
+    StepSchedule schedule = {
+        .num_segments = 3,
+        .segments = { { 200, 10000 }, { 1000, 60000 }, { 5000, 0 } }
+    };
+
+    // 50 steps to 10 s, 50 to 60 s, 48 to 300 s
+    TrajectoryPredictorConfig predictor_config = {
+        .motion_model = MOTION_CONSTANT_VELOCITY,
+        .prediction_horizon_s = 300.0f,
+        .prediction_step_s = 1.0f,
+        .max_branch_depth = 3,
+        .step_schedule = schedule
+    };
+    TrajectoryPredictor* predictor = trajectory_predictor_init(&predictor_config);
+    TEST_ASSERT(predictor != NULL, "Predictor created");
+
+    const uint64_t* offset_ms = NULL;
+    uint32_t num_steps = trajectory_predictor_get_steps(predictor, &offset_ms);
+    printf("  300 s horizon: %u states instead of 300 (%.0f%% fewer)\n",
+           num_steps, 100.0f * (300 - num_steps) / 300.0f);
+    TEST_ASSERT(num_steps == 148, "Scheduled step count");
+    TEST_ASSERT(offset_ms[0] == 200 && offset_ms[49] == 10000, "200 ms steps to 10 s");
+    TEST_ASSERT(offset_ms[50] == 11000 && offset_ms[99] == 60000, "1 s steps to 60 s");
+    TEST_ASSERT(offset_ms[100] == 65000 && offset_ms[147] == 300000, "5 s steps to the horizon");
+
+    TrackedObject track = create_test_track(1, 100, 100, 10, 0, 0, 0.0f);
+    PredictedTrajectory trajectory;
+    TEST_ASSERT(trajectory_predict_single(predictor, &track, NULL, 0, NULL, &trajectory),
+               "Prediction succeeded");
+    TEST_ASSERT(trajectory.num_predictions == 148, "One state per step");
+    for (uint32_t k = 0; k < trajectory.num_predictions; k++) {
+        const PredictedState* state = &trajectory.predictions[k];
+        TEST_ASSERT(state->timestamp_ms == track.last_seen_ms + offset_ms[k], "Step timestamp");
+        TEST_ASSERT(fabsf(state->x - (125.0f + 10.0f * offset_ms[k] / 1000.0f)) < 0.01f,
+                   "Position at the step's time");
+    }
+    trajectory_predictor_destroy(predictor);
+
+    // A schedule without step lengths is rejected
+    predictor_config.step_schedule.segments[1].step_ms = 0;
+    TEST_ASSERT(trajectory_predictor_init(&predictor_config) == NULL, "Invalid schedule rejected");
+
+    // Engine: head-on tracks 100 px apart at 20 px/s close within 30 px
+    // after 3.5 s, so the first 200 ms step past it is 3.6 s
+    SceneContext scene;
+    memset(&scene, 0, sizeof(SceneContext));
+    scene.time_of_day_risk = 1.0f;
+
+    TimelineConfig config = {
+        .prediction_horizon_ms = 300000,
+        .max_timelines = 1,
+        .branching_enabled = false,
+        .scene_context = &scene,
+        .step_schedule = schedule
+    };
+    TimelineEngine* engine = timeline_init(&config);
+    TEST_ASSERT(engine != NULL, "Timeline engine initialization");
+
+    TrackedObject tracks[2];
+    tracks[0] = create_test_track(1, 0, 100, 10, 0, 0, 0.0f);
+    tracks[1] = create_test_track(2, 100, 100, -10, 0, 0, 0.0f);
+    tracks[1].last_seen_ms = tracks[0].last_seen_ms;
+    uint64_t collision_ms = tracks[0].last_seen_ms + 3600;
+
+    // Tracks follow their prediction: reused trajectories keep the schedule
+    for (int update = 0; update < 4; update++) {
+        Timeline timelines[10];
+        uint32_t num_timelines = timeline_update(engine, tracks, 2, timelines, 10);
+        TEST_ASSERT(num_timelines == 1, "Timeline created");
+
+        PredictedEvent events[50];
+        uint32_t num_events = copy_events(&timelines[0], events, 50);
+        bool found = false;
+        for (uint32_t i = 0; i < num_events; i++) {
+            if (events[i].type == EVENT_COLLISION) {
+                TEST_ASSERT(events[i].timestamp_ms == collision_ms, "Collision at 3.6 s");
+                found = true;
+            }
+        }
+        TEST_ASSERT(found, "Collision predicted");
+
+        for (uint32_t i = 0; i < 2; i++) {
+            tracks[i].current_bbox.x += tracks[i].velocity_x * 0.3f;
+            tracks[i].last_seen_ms += 300;
+        }
+    }
+
+    TimelineUpdateStats stats;
+    timeline_get_update_stats(engine, &stats);
+    TEST_ASSERT(stats.tracks_reused == 6, "Later updates reuse both trajectories");
+
+    timeline_destroy(engine);
+    TEST_PASS("Non-uniform step schedule");
+}
+
+bool test_timeline_threads() {
+    // Tracks converging on a protected zone from a ring: collisions,
+    // trespassing and loitering all over the scene
+    TrackedObject tracks[24];
+    for (uint32_t i = 0; i < 24; i++) {
+        float angle = 6.2831853f * i / 24.0f;
+        float x = 300 + 200 * cosf(angle);
+        float y = 300 + 200 * sinf(angle);
+        BehaviorFlags behaviors = (i % 5 == 0) ? BEHAVIOR_LOITERING : 0;
+        tracks[i] = create_test_track(i + 1, x, y, -10 * cosf(angle), -10 * sinf(angle),
+                                      behaviors, (i % 4) * 0.25f);
+    }
+    static PredictedEvent serial_events[10][50];
+    static PredictedEvent threaded_events[10][50];
+    uint32_t serial_counts[10], threaded_counts[10];
+    float serial_probability[10], threaded_probability[10];
+
+    uint32_t num_serial = run_threaded_update(1, tracks, 24, serial_events,
+                                              serial_counts, serial_probability);
+    TEST_ASSERT(num_serial > 0, "Timelines on one thread");
+
+    uint32_t total_events = 0;
+    for (uint32_t i = 0; i < num_serial; i++) {
+        total_events += serial_counts[i];
+    }
+    TEST_ASSERT(total_events > 0, "Events predicted");
+
+    uint32_t thread_counts[] = {2, 4};
+    for (uint32_t t = 0; t < 2; t++) {
+        uint32_t num_threaded = run_threaded_update(thread_counts[t], tracks, 24,
+                                                    threaded_events, threaded_counts,
+                                                    threaded_probability);
+        TEST_ASSERT(num_threaded == num_serial, "Same timelines for any thread count");
+
+        for (uint32_t i = 0; i < num_serial; i++) {
+            TEST_ASSERT(threaded_counts[i] == serial_counts[i], "Same event count");
+            TEST_ASSERT(memcmp(threaded_events[i], serial_events[i],
+                               serial_counts[i] * sizeof(PredictedEvent)) == 0,
+                        "Same events for any thread count");
+            TEST_ASSERT(threaded_probability[i] == serial_probability[i], "Same probability");
+        }
+    }
+    printf("  %u timelines, %u events identical on 1, 2 and 4 threads\n",
+           num_serial, total_events);
+
+    TEST_PASS("Deterministic threaded prediction");
+}
+
+bool test_timeline_particles() {
+    TrajectoryPredictorConfig predictor_config = {
+        .motion_model = MOTION_CONSTANT_VELOCITY,
+        .prediction_horizon_s = 30.0f,
+        .prediction_step_s = 1.0f,
+        .max_branch_depth = 3
+    };
+    TrajectoryPredictor* predictor = trajectory_predictor_init(&predictor_config);
+    TEST_ASSERT(predictor != NULL, "Predictor created");
+
+    TrackedObject tracks[2];
+    tracks[0] = create_test_track(1, 100, 100, 10, 0, 0, 0.5f);
+    tracks[1] = create_test_track(2, 400, 300, 0, -8, 0, 0.2f);
+    PredictedTrajectory trajectories[2];
+    const PredictedTrajectory* bases[2] = { &trajectories[0], &trajectories[1] };
+    for (int i = 0; i < 2; i++) {
+        TEST_ASSERT(trajectory_predict_single(predictor, &tracks[i], NULL, 0, NULL, &trajectories[i]),
+                   "Prediction succeeded");
+    }
+
+    ParticleSamplerConfig config = {
+        .max_particles = 256,
+        .seed = 42
+    };
+    ParticleSampler* sampler = particle_sampler_create(&config);
+    TEST_ASSERT(sampler != NULL, "Sampler created");
+
+    ParticleCluster clusters[PARTICLE_SAMPLER_MAX_CLUSTERS];
+    ParticleCluster again[PARTICLE_SAMPLER_MAX_CLUSTERS];
+    uint32_t num_clusters = particle_sampler_run(sampler, bases, 2, clusters,
+                                                 PARTICLE_SAMPLER_MAX_CLUSTERS);
+    TEST_ASSERT(particle_sampler_num_sampled(sampler) == 256, "Every particle sampled");
+    TEST_ASSERT(num_clusters > 1, "Futures differ");
+
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < num_clusters; i++) {
+        total += clusters[i].num_particles;
+        if (i > 0) {
+            TEST_ASSERT(clusters[i].num_particles <= clusters[i - 1].num_particles,
+                       "Most probable cluster first");
+        }
+    }
+    printf("  256 particles, %u clusters, top %.2f\n", num_clusters, clusters[0].probability);
+    TEST_ASSERT(total == 256, "Clusters cover every particle");
+
+    // Same seed, same futures
+    TEST_ASSERT(particle_sampler_run(sampler, bases, 2, again, PARTICLE_SAMPLER_MAX_CLUSTERS)
+                == num_clusters, "Same cluster count");
+    TEST_ASSERT(memcmp(clusters, again, num_clusters * sizeof(ParticleCluster)) == 0,
+               "Same clusters");
+
+    // A particle replays alone, with the same future each time
+    PredictedTrajectory future, replayed;
+    particle_sampler_replay(sampler, &trajectories[0], clusters[0].particle, &future);
+    particle_sampler_replay(sampler, &trajectories[0], clusters[0].particle, &replayed);
+    TEST_ASSERT(future.num_predictions == trajectories[0].num_predictions, "Replay length");
+    for (uint32_t k = 0; k < future.num_predictions; k++) {
+        TEST_ASSERT(future.predictions[k].x == replayed.predictions[k].x &&
+                   future.predictions[k].y == replayed.predictions[k].y, "Replay deterministic");
+    }
+    particle_sampler_destroy(sampler);
+
+    // Another seed, other futures
+    config.seed = 43;
+    sampler = particle_sampler_create(&config);
+    particle_sampler_replay(sampler, &trajectories[0], clusters[0].particle, &replayed);
+    bool differs = false;
+    for (uint32_t k = 0; k < future.num_predictions; k++) {
+        differs |= future.predictions[k].x != replayed.predictions[k].x;
+    }
+    TEST_ASSERT(differs, "Seed keys the futures");
+    particle_sampler_destroy(sampler);
+    trajectory_predictor_destroy(predictor);
+
+    // Engine: with no sampling budget (the default) K is fixed, so the
+    // sampled timelines are identical on 1 and 4 threads and across runs
+    SceneContext scene;
+    memset(&scene, 0, sizeof(SceneContext));
+    scene.time_of_day_risk = 1.0f;
+
+    float probability[3][10];
+    uint32_t num_timelines[3];
+    uint32_t thread_counts[3] = { 1, 4, 1 };
+    for (int run = 0; run < 3; run++) {
+        TimelineConfig timeline_config = {
+            .prediction_horizon_ms = 30000,
+            .max_timelines = 5,
+            .branching_enabled = true,
+            .scene_context = &scene,
+            .worker_threads = thread_counts[run],
+            .num_particles = 512,
+            .sampling_seed = 7
+        };
+        TimelineEngine* engine = timeline_init(&timeline_config);
+        TEST_ASSERT(engine != NULL, "Timeline engine initialization");
+
+        Timeline timelines[10];
+        num_timelines[run] = timeline_update(engine, tracks, 2, timelines, 10);
+        TEST_ASSERT(num_timelines[run] > 1, "Sampled futures");
+
+        float sum_probability = 0.0f;
+        for (uint32_t i = 0; i < num_timelines[run]; i++) {
+            probability[run][i] = timelines[i].overall_probability;
+            TEST_ASSERT(probability[run][i] > 0.0f, "Positive probability");
+            if (i > 0) {
+                TEST_ASSERT(probability[run][i] <= probability[run][i - 1],
+                           "Most probable timeline first");
+            }
+            sum_probability += probability[run][i];
+        }
+        TEST_ASSERT(sum_probability <= 1.0f + 1e-4f, "Timelines share the probability mass");
+
+        TimelineUpdateStats stats;
+        timeline_get_update_stats(engine, &stats);
+        TEST_ASSERT(stats.particles_sampled == 512, "Particles sampled");
+        timeline_destroy(engine);
+    }
+    TEST_ASSERT(num_timelines[0] == num_timelines[1], "Same timelines on 1 and 4 threads");
+    TEST_ASSERT(num_timelines[0] == num_timelines[2], "Same timelines when run again");
+    for (uint32_t i = 0; i < num_timelines[0]; i++) {
+        TEST_ASSERT(probability[0][i] == probability[1][i], "Same probability on 1 and 4 threads");
+        TEST_ASSERT(probability[0][i] == probability[2][i], "Same probability when run again");
+    }
+    printf("  Engine: %u sampled timelines, top %.2f\n", num_timelines[0], probability[0][0]);
+
+    TEST_PASS("Monte Carlo particle sampling");
+}
+
+bool test_timeline_no_alloc() {
+#ifdef HAVE_ALLOC_HOOK
+    SceneContext scene;
+    memset(&scene, 0, sizeof(SceneContext));
+    scene.time_of_day_risk = 1.0f;
+    scene.num_zones = 1;
+    scene.zones[0].x = 200;
+    scene.zones[0].y = 200;
+    scene.zones[0].radius = 40;
+    scene.zones[0].protected_event = EVENT_TRESPASSING;
+    scene.zones[0].sensitivity = 0.9f;
+
+    TimelineConfig config = {
+        .prediction_horizon_ms = 60000,
+        .max_timelines = 5,
+        .branching_enabled = true,
+        .scene_context = &scene
+    };
+
+    TimelineEngine* engine = timeline_init(&config);
+    TEST_ASSERT(engine != NULL, "Timeline engine initialization");
+
+    TrackedObject tracks[80];
+    for (uint32_t i = 0; i < 80; i++) {
+        tracks[i] = create_test_track(i + 1, (float)(i % 10) * 40, (float)(i / 10) * 50,
+                                      (float)(i % 7) - 3, (float)(i % 3) - 1,
+                                      (i % 4 == 0) ? BEHAVIOR_LOITERING : 0, 0.1f * (i % 10));
+    }
+
+    // Warm up: the node arena grows to the largest scene once
+    Timeline timelines[10];
+    for (int i = 0; i < 3; i++) {
+        timeline_update(engine, tracks, 80, timelines, 10);
+    }
+
+    g_num_allocs = 0;
+    g_count_allocs = true;
+    uint32_t num_timelines = 0;
+    for (int i = 0; i < 5; i++) {
+        num_timelines = timeline_update(engine, tracks, 80 - i * 10, timelines, 10);
+    }
+    g_count_allocs = false;
+
+    printf("  Allocations in 5 steady-state updates: %u\n", g_num_allocs);
+    TEST_ASSERT(num_timelines > 0, "Timelines created");
+    TEST_ASSERT(g_num_allocs == 0, "timeline_update() does not allocate");
+
+    timeline_destroy(engine);
+    TEST_PASS("Allocation-free steady state");
+#else
+    TEST_PASS("Allocation-free steady state (no allocation hook, skipped)");
+#endif
+}
+
+// ============================================================================
+// Monitor Thread
+// ============================================================================
+
+typedef struct {
+    atomic_uint updates;
+    atomic_bool saw_collision;      // Latest update predicted a collision
+    uint64_t update_us[16];         // When each update was published
+} MonitorProbe;
+
+static uint64_t get_monotonic_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void sleep_ms(uint32_t ms) {
+    struct timespec ts = { .tv_sec = ms / 1000, .tv_nsec = (long)(ms % 1000) * 1000000 };
+    nanosleep(&ts, NULL);
+}
+
+static void monitor_probe_callback(const Timeline* timelines, uint32_t num_timelines,
+                                   void* user_data) {
+    MonitorProbe* probe = user_data;
+
+    bool collision = false;
+    PredictedEvent events[50];
+    uint32_t num_events = num_timelines > 0 ? copy_events(timelines, events, 50) : 0;
+    for (uint32_t i = 0; i < num_events; i++) {
+        if (events[i].type == EVENT_COLLISION) {
+            collision = true;
+        }
+    }
+
+    uint32_t k = atomic_load_explicit(&probe->updates, memory_order_relaxed);
+    if (k < 16) {
+        probe->update_us[k] = get_monotonic_us();
+    }
+    atomic_store_explicit(&probe->saw_collision, collision, memory_order_relaxed);
+    atomic_store_explicit(&probe->updates, k + 1, memory_order_release);
+}
+
+bool test_timeline_monitoring() {
+    SceneContext scene;
+    memset(&scene, 0, sizeof(SceneContext));
+    scene.time_of_day_risk = 1.0f;
+
+    TimelineConfig config = {
+        .prediction_horizon_ms = 30000,
+        .max_timelines = 1,
+        .branching_enabled = false,
+        .scene_context = &scene,
+        .monitor_interval_ms = 50
+    };
+    TimelineEngine* engine = timeline_init(&config);
+    TEST_ASSERT(engine != NULL, "Timeline engine initialization");
+
+    static MonitorProbe probe;
+    memset(&probe, 0, sizeof(probe));
+    TrackedObject early = create_test_track(1, 0, 100, 10, 0, 0, 0.0f);
+    TEST_ASSERT(!timeline_submit_tracks(engine, &early, 1),
+               "Snapshot refused before monitoring");
+    TEST_ASSERT(timeline_start_monitoring(engine, monitor_probe_callback, &probe),
+               "Monitoring started");
+    TEST_ASSERT(!timeline_start_monitoring(engine, monitor_probe_callback, &probe),
+               "Monitor thread already running");
+
+    // A burst of frames with one track, then one with two tracks head-on;
+    // submitting never waits for the monitor thread
+    TrackedObject tracks[2];
+    tracks[0] = create_test_track(1, 0, 100, 10, 0, 0, 0.0f);
+    tracks[1] = create_test_track(2, 100, 100, -10, 0, 0, 0.0f);
+    tracks[1].last_seen_ms = tracks[0].last_seen_ms;
+
+    uint64_t worst_submit_us = 0;
+    for (uint32_t frame = 0; frame <= 10; frame++) {
+        uint64_t start_us = get_monotonic_us();
+        TEST_ASSERT(timeline_submit_tracks(engine, tracks, frame < 10 ? 1 : 2),
+                   "Snapshot submitted");
+        uint64_t elapsed_us = get_monotonic_us() - start_us;
+        if (elapsed_us > worst_submit_us) worst_submit_us = elapsed_us;
+    }
+
+    // The newest snapshot is always predicted
+    for (int waited = 0; waited < 2000 &&
+         !atomic_load_explicit(&probe.saw_collision, memory_order_relaxed); waited += 5) {
+        sleep_ms(5);
+    }
+    TEST_ASSERT(atomic_load_explicit(&probe.saw_collision, memory_order_relaxed),
+               "Latest snapshot predicted");
+
+    // No new snapshot, no update
+    uint32_t updates = atomic_load_explicit(&probe.updates, memory_order_acquire);
+    sleep_ms(120);
+    TEST_ASSERT(atomic_load_explicit(&probe.updates, memory_order_acquire) == updates,
+               "Idle without snapshots");
+
+    // Frames every 10 ms: the monitor keeps its 50 ms cadence
+    for (uint32_t frame = 0; frame < 20; frame++) {
+        for (uint32_t i = 0; i < 2; i++) {
+            tracks[i].current_bbox.x += tracks[i].velocity_x * 0.01f;
+            tracks[i].last_seen_ms += 10;
+        }
+        TEST_ASSERT(timeline_submit_tracks(engine, tracks, 2), "Snapshot submitted");
+        sleep_ms(10);
+    }
+    sleep_ms(150);
+    updates = atomic_load_explicit(&probe.updates, memory_order_acquire);
+
+    timeline_stop_monitoring(engine);
+
+    TimelineUpdateStats stats;
+    timeline_get_update_stats(engine, &stats);
+    printf("  31 snapshots: %u updates, %llu coalesced, submit %llu us worst\n",
+           updates, (unsigned long long)stats.snapshots_coalesced,
+           (unsigned long long)worst_submit_us);
+    TEST_ASSERT(stats.snapshots_submitted == 31, "Snapshots counted");
+    TEST_ASSERT(stats.num_updates == updates, "One update per callback");
+    TEST_ASSERT(stats.num_updates + stats.snapshots_coalesced == 31,
+               "Every snapshot predicted or coalesced");
+    TEST_ASSERT(updates >= 3 && updates <= 12, "Frames coalesced");
+
+    // Updates start at least monitor_interval_ms apart
+    for (uint32_t k = 1; k < updates && k < 16; k++) {
+        float gap_ms = (probe.update_us[k] - probe.update_us[k - 1]) / 1000.0f;
+        TEST_ASSERT(gap_ms + stats.latency_max_ms + 1.0f >= 50.0f, "Update cadence");
+    }
+
+    timeline_destroy(engine);
+    TEST_PASS("Monitor thread coalesces snapshots");
+}
+
+static bool wait_for_updates(MonitorProbe* probe, uint32_t count) {
+    for (int waited = 0; waited < 2000; waited += 5) {
+        if (atomic_load_explicit(&probe->updates, memory_order_acquire) >= count) {
+            return true;
+        }
+        sleep_ms(5);
+    }
+    return false;
+}
+
+bool test_timeline_clear() {
+    SceneContext scene;
+    memset(&scene, 0, sizeof(SceneContext));
+
+    TimelineConfig config = {
+        .prediction_horizon_ms = 30000,
+        .max_timelines = 1,
+        .branching_enabled = false,
+        .scene_context = &scene
+    };
+    TimelineEngine* engine = timeline_init(&config);
+    TEST_ASSERT(engine != NULL, "Timeline engine initialization");
+
+    TrackedObject tracks[2];
+    tracks[0] = create_test_track(1, 0, 100, 10, 0, 0, 0.0f);
+    tracks[1] = create_test_track(2, 100, 300, -10, 0, 0, 0.0f);
+    tracks[1].last_seen_ms = tracks[0].last_seen_ms;
+
+    static MonitorProbe probe;
+    memset(&probe, 0, sizeof(probe));
+    TEST_ASSERT(timeline_start_monitoring(engine, monitor_probe_callback, &probe),
+               "Monitoring started");
+
+    TEST_ASSERT(timeline_submit_tracks(engine, tracks, 2), "Snapshot submitted");
+    TEST_ASSERT(wait_for_updates(&probe, 1), "First snapshot predicted");
+
+    // Cleared by the monitor thread before it predicts the next snapshot
+    timeline_clear(engine);
+    for (uint32_t i = 0; i < 2; i++) {
+        tracks[i].current_bbox.x += tracks[i].velocity_x * 0.1f;
+        tracks[i].last_seen_ms += 100;
+    }
+    TEST_ASSERT(timeline_submit_tracks(engine, tracks, 2), "Snapshot submitted");
+    TEST_ASSERT(wait_for_updates(&probe, 2), "Second snapshot predicted");
+    timeline_stop_monitoring(engine);
+
+    TimelineUpdateStats stats;
+    timeline_get_update_stats(engine, &stats);
+    TEST_ASSERT(stats.tracks_predicted == 4 && stats.tracks_reused == 0,
+               "Cleared scene predicted from scratch");
+
+    // Without a clear the same motion keeps the trajectories
+    for (uint32_t i = 0; i < 2; i++) {
+        tracks[i].current_bbox.x += tracks[i].velocity_x * 0.1f;
+        tracks[i].last_seen_ms += 100;
+    }
+    timeline_update(engine, tracks, 2, NULL, 0);
+    timeline_get_update_stats(engine, &stats);
+    TEST_ASSERT(stats.tracks_reused == 2, "Trajectories reused without a clear");
+
+    // Not monitoring: cleared on the caller's thread
+    timeline_clear(engine);
+    for (uint32_t i = 0; i < 2; i++) {
+        tracks[i].current_bbox.x += tracks[i].velocity_x * 0.1f;
+        tracks[i].last_seen_ms += 100;
+    }
+    timeline_update(engine, tracks, 2, NULL, 0);
+    timeline_get_update_stats(engine, &stats);
+    TEST_ASSERT(stats.tracks_predicted == 6 && stats.tracks_reused == 2,
+               "Cleared scene predicted from scratch");
+
+    timeline_destroy(engine);
+    TEST_PASS("Clear is applied by the engine's owner thread");
+}
+
 // ============================================================================
 // Main Test Runner
 // ============================================================================
@@ -565,11 +1671,14 @@ int main() {
         {"Trajectory Branching", test_trajectory_branching},
         {"Collision Detection", test_trajectory_collision_detection},
         {"Zone Entry Detection", test_trajectory_zone_entry},
+        {"Social Force Prediction", test_trajectory_social_force},
 
         // Event predictor tests
         {"Event Predictor Init", test_event_predictor_init},
         {"Loitering Prediction", test_event_predict_loitering},
         {"Collision Prediction", test_event_predict_collision},
+        {"Zone Entry Events", test_event_zone_entries},
+        {"Proximity Index", test_event_proximity_index},
         {"Severity Calculation", test_event_severity_calculation},
 
         // Timeline engine tests
@@ -577,6 +1686,16 @@ int main() {
         {"Timeline Update", test_timeline_update},
         {"Timeline Interventions", test_timeline_interventions},
         {"Timeline Statistics", test_timeline_statistics},
+        {"Shared Prediction", test_timeline_shared_prediction},
+        {"Timeline Branching", test_timeline_branching},
+        {"Timeline Arena", test_timeline_arena},
+        {"No Allocation", test_timeline_no_alloc},
+        {"Incremental Updates", test_timeline_incremental},
+        {"Step Schedule", test_timeline_step_schedule},
+        {"Threaded Prediction", test_timeline_threads},
+        {"Particle Sampling", test_timeline_particles},
+        {"Monitor Thread", test_timeline_monitoring},
+        {"Clear While Monitoring", test_timeline_clear},
     };
 
     int num_tests = sizeof(tests) / sizeof(TestCase);
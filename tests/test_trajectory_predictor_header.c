@@ -0,0 +1,23 @@
+/**
+ * @file test_trajectory_predictor_header.c
+ * @brief Checks that trajectory_predictor.h compiles on its own
+ *
+ * No other header may come first: this TU fails to build if
+ * trajectory_predictor.h relies on a type its includer declares.
+ */
+
+#include "../src/timeline/trajectory_predictor.h"
+
+int main(void) {
+    // Types used by the prototypes, each from the header alone
+    const SceneContext* context = NULL;
+    TrajectoryPredictorConfig config = {
+        .motion_model = MOTION_KALMAN_FILTER,
+        .prediction_horizon_s = 30.0f
+    };
+    PredictedTrajectory* trajectory = NULL;
+
+    (void)context;
+    (void)trajectory;
+    return config.motion_model == MOTION_KALMAN_FILTER ? 0 : 1;
+}